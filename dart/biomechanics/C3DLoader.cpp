@@ -2,10 +2,12 @@
 
 #include <algorithm> // std::sort
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <limits>
 #include <random>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -531,62 +533,140 @@ C3D C3DLoader::loadC3DWithGRFConvention(const std::string& uri, int convention)
   return result;
 }
 
+//==============================================================================
+/// For each marker in `markers` that's visible on both `lastTimestep` and
+/// `thisTimestep`, this finds the marker on `lastTimestep` that was closest to
+/// where it is now. This returns an index into `markers` for each marker, which
+/// is the marker itself if nothing was strictly closer (or the marker isn't
+/// visible on both timesteps), and -1 if the closest marker isn't in
+/// `markers`.
+std::vector<int> findClosestMarkersOnLastTimestep(
+    const std::vector<std::string>& markers,
+    const std::unordered_map<std::string, int>& markerIndices,
+    const std::map<std::string, Eigen::Vector3s>& lastTimestep,
+    const std::map<std::string, Eigen::Vector3s>& thisTimestep)
+{
+  std::vector<int> closest(markers.size());
+
+  // Pack last timestep's markers into columns, so we can get all the distances
+  // to a marker at once
+  Eigen::Matrix<s_t, 3, Eigen::Dynamic> lastPositions(3, lastTimestep.size());
+  std::vector<int> lastIndices;
+  std::unordered_map<std::string, int> lastColumns;
+  for (auto& pair : lastTimestep)
+  {
+    lastColumns[pair.first] = lastIndices.size();
+    lastPositions.col(lastIndices.size()) = pair.second;
+    lastIndices.push_back(
+        markerIndices.count(pair.first) ? markerIndices.at(pair.first) : -1);
+  }
+
+  for (int m = 0; m < markers.size(); m++)
+  {
+    closest[m] = m;
+
+    // If we see the marker on both timesteps, then evaluate which markers
+    // were the closest on last timestep to this marker
+    if (thisTimestep.count(markers[m]) > 0 && lastColumns.count(markers[m]) > 0)
+    {
+      Eigen::Matrix<s_t, 1, Eigen::Dynamic> dists
+          = (lastPositions.colwise() - thisTimestep.at(markers[m]))
+                .colwise()
+                .norm();
+      // minCoeff() picks the first of any ties, which matches scanning last
+      // timestep's markers in order and only moving on a strict improvement
+      Eigen::Index closestColumn;
+      s_t closestDist = dists.minCoeff(&closestColumn);
+      if (closestDist < dists(lastColumns.at(markers[m])))
+      {
+        closest[m] = lastIndices[closestColumn];
+      }
+    }
+  }
+  return closest;
+}
+
 //==============================================================================
 /// This will check if markers
 /// obviously "flip" during the trajectory, and unflip them.
 std::vector<std::vector<std::pair<std::string, std::string>>>
 C3DLoader::fixupMarkerFlips(C3D* c3d)
 {
+  std::unordered_map<std::string, int> markerIndices;
+  for (int m = 0; m < c3d->markers.size(); m++)
+  {
+    markerIndices.emplace(c3d->markers[m], m);
+  }
+
   std::vector<std::vector<std::pair<std::string, std::string>>> flips;
   // Include the 0 timestep in our list of flips, even though it's always empty
   flips.emplace_back();
-  for (int i = 1; i < c3d->markerTimesteps.size(); i++)
-  {
-    flips.emplace_back();
-    std::unordered_map<std::string, std::string> closestMarkerFromLastTimestep;
-
-    for (std::string& marker : c3d->markers)
-    {
-      closestMarkerFromLastTimestep[marker] = marker;
 
-      // If we see the marker on both timesteps, then evaluate which markers
-      // were the closest on last timestep to this marker
-      if (c3d->markerTimesteps[i].count(marker) > 0
-          && c3d->markerTimesteps[i - 1].count(marker) > 0)
-      {
-        Eigen::Vector3s thisTimestep = c3d->markerTimesteps[i].at(marker);
-        for (auto& pair : c3d->markerTimesteps[i - 1])
+  // Finding the closest markers on each timestep only depends on the timestep
+  // before it, so we do that for a chunk of timesteps at a time in parallel,
+  // against the raw data. Unflipping is a serial pass afterwards, and the only
+  // timesteps it has to redo are the ones right after a timestep we changed.
+  const int numTimesteps = c3d->markerTimesteps.size();
+  const int numThreads
+      = std::max(1, (int)std::thread::hardware_concurrency());
+  const int chunkSize = 4096;
+  for (int chunkStart = 1; chunkStart < numTimesteps; chunkStart += chunkSize)
+  {
+    const int chunkEnd = std::min(numTimesteps, chunkStart + chunkSize);
+    std::vector<std::vector<int>> closest(chunkEnd - chunkStart);
+    const int blockSize = (chunkEnd - chunkStart + numThreads - 1) / numThreads;
+    std::vector<std::future<void>> futures;
+    for (int start = chunkStart; start < chunkEnd; start += blockSize)
+    {
+      const int end = std::min(chunkEnd, start + blockSize);
+      futures.push_back(std::async([&, start, end]() {
+        for (int i = start; i < end; i++)
         {
-          s_t dist = (pair.second - thisTimestep).norm();
-          if (dist < (c3d->markerTimesteps[i - 1].at(
-                          closestMarkerFromLastTimestep.at(marker))
-                      - thisTimestep)
-                         .norm())
-          {
-            closestMarkerFromLastTimestep[marker] = pair.first;
-          }
+          closest[i - chunkStart] = findClosestMarkersOnLastTimestep(
+              c3d->markers,
+              markerIndices,
+              c3d->markerTimesteps[i - 1],
+              c3d->markerTimesteps[i]);
         }
-      }
+      }));
+    }
+    for (auto& future : futures)
+    {
+      future.get();
     }
 
-    for (std::string& marker : c3d->markers)
+    for (int i = chunkStart; i < chunkEnd; i++)
     {
-      // If we weren't closest to ourselves, and instead we were closest to
-      // another marker AND IT WAS CLOSEST TO US, then we've detected a trivial
-      // flip, and we can flip back.
-      if (closestMarkerFromLastTimestep[marker] != marker
-          && closestMarkerFromLastTimestep
-                     [closestMarkerFromLastTimestep[marker]]
-                 == marker)
+      std::vector<int>& closestMarkerFromLastTimestep = closest[i - chunkStart];
+      if (flips[flips.size() - 1].size() > 0)
       {
-        Eigen::Vector3s tmp = c3d->markerTimesteps[i][marker];
-        std::string otherMarker = closestMarkerFromLastTimestep[marker];
-
-        c3d->markerTimesteps[i][marker] = c3d->markerTimesteps[i][otherMarker];
-        c3d->markerTimesteps[i][otherMarker] = tmp;
-        closestMarkerFromLastTimestep[marker] = marker;
-        closestMarkerFromLastTimestep[otherMarker] = otherMarker;
-        flips[flips.size() - 1].emplace_back(marker, otherMarker);
+        closestMarkerFromLastTimestep = findClosestMarkersOnLastTimestep(
+            c3d->markers,
+            markerIndices,
+            c3d->markerTimesteps[i - 1],
+            c3d->markerTimesteps[i]);
+      }
+      flips.emplace_back();
+
+      for (int m = 0; m < c3d->markers.size(); m++)
+      {
+        // If we weren't closest to ourselves, and instead we were closest to
+        // another marker AND IT WAS CLOSEST TO US, then we've detected a
+        // trivial flip, and we can flip back.
+        const int other = closestMarkerFromLastTimestep[m];
+        if (other != m && other >= 0
+            && closestMarkerFromLastTimestep[other] == m)
+        {
+          const std::string& marker = c3d->markers[m];
+          const std::string& otherMarker = c3d->markers[other];
+          Eigen::Vector3s tmp = c3d->markerTimesteps[i][marker];
+          c3d->markerTimesteps[i][marker]
+              = c3d->markerTimesteps[i][otherMarker];
+          c3d->markerTimesteps[i][otherMarker] = tmp;
+          closestMarkerFromLastTimestep[m] = m;
+          closestMarkerFromLastTimestep[other] = other;
+          flips[flips.size() - 1].emplace_back(marker, otherMarker);
+        }
       }
     }
   }
@@ -1,13 +1,17 @@
 #include "dart/biomechanics/DynamicsFitter.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <climits>
+#include <cmath>
 #include <future>
 #include <iostream>
 #include <limits>
 #include <memory>
 #include <ostream>
 #include <queue>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <tuple>
@@ -56,7 +60,7 @@ using namespace Ipopt;
 //==============================================================================
 ResidualForceHelper::ResidualForceHelper(
     std::shared_ptr<dynamics::Skeleton> skeleton, std::vector<int> forceBodies)
-  : mSkel(skeleton), mForceBodies(forceBodies)
+  : mSkel(skeleton), mForceBodies(forceBodies), mNumThreads(16)
 {
   for (int i : forceBodies)
   {
@@ -64,6 +68,37 @@ ResidualForceHelper::ResidualForceHelper(
   }
 }
 
+//==============================================================================
+// This sets how many threads the trajectory-level linear systems split their
+// timesteps across.
+void ResidualForceHelper::setNumThreads(int numThreads)
+{
+  mNumThreads = std::max(1, numThreads);
+}
+
+//==============================================================================
+// This makes sure there are at least `numThreads` clones of the skeleton (and
+// helpers built on them), with the same body scales and masses as mSkel.
+void ResidualForceHelper::ensureThreadSkels(int numThreads)
+{
+  for (int threadIdx = mThreadSkels.size(); threadIdx < numThreads; threadIdx++)
+  {
+    mThreadSkels.push_back(mSkel->cloneSkeleton());
+  }
+  for (int threadIdx = mThreadHelpers.size(); threadIdx < numThreads;
+       threadIdx++)
+  {
+    mThreadHelpers.emplace_back(mThreadSkels[threadIdx], mForceBodies);
+  }
+  for (int threadIdx = 0; threadIdx < numThreads; threadIdx++)
+  {
+    mThreadSkels[threadIdx]->setGroupScales(mSkel->getGroupScales());
+    mThreadSkels[threadIdx]->setGroupCOMs(mSkel->getGroupCOMs());
+    mThreadSkels[threadIdx]->setGroupMasses(mSkel->getGroupMasses());
+    mThreadSkels[threadIdx]->setGroupInertias(mSkel->getGroupInertias());
+  }
+}
+
 //==============================================================================
 // Computes the full inverse dynamics vector for a specific timestep
 Eigen::VectorXs ResidualForceHelper::calculateInverseDynamics(
@@ -940,6 +975,68 @@ Eigen::Vector6s ResidualForceHelper::calculateResidualFreeRootAcceleration(
   return solve;
 }
 
+//==============================================================================
+// This computes the same root acceleration as
+// calculateResidualFreeRootAcceleration(), without forming the full mass
+// matrix. A single inverse dynamics pass gives us the root rows of
+// M * tailDdq + C, and the 6x6 root block of M only needs the root columns of
+// each body's Jacobian, since M = sum_b J_b^T I_b J_b.
+Eigen::Vector6s
+ResidualForceHelper::calculateResidualFreeRootAccelerationWithoutMassMatrix(
+    Eigen::VectorXs q,
+    Eigen::VectorXs dq,
+    Eigen::VectorXs ddq,
+    Eigen::VectorXs forcesConcat)
+{
+  Eigen::VectorXs originalPos = mSkel->getPositions();
+  Eigen::VectorXs originalVel = mSkel->getVelocities();
+  Eigen::VectorXs originalAcc = mSkel->getAccelerations();
+  Eigen::VectorXs originalForces = mSkel->getControlForces();
+
+  Eigen::VectorXs tailDdq = ddq;
+  tailDdq.head<6>().setZero();
+
+  mSkel->setPositions(q);
+  mSkel->setVelocities(dq);
+  mSkel->setAccelerations(tailDdq);
+
+  mSkel->computeInverseDynamics(false, false, false);
+  Eigen::Vector6s rootBias = mSkel->getControlForces().head<6>();
+
+  Eigen::Matrix6s rootM = Eigen::Matrix6s::Zero();
+  for (int i = 0; i < mSkel->getNumBodyNodes(); i++)
+  {
+    const dynamics::BodyNode* body = mSkel->getBodyNode(i);
+    const math::Jacobian& J = body->getJacobian();
+    Eigen::Matrix6s rootJ = Eigen::Matrix6s::Zero();
+    for (int k = 0; k < body->getNumDependentGenCoords(); k++)
+    {
+      int dof = body->getDependentGenCoordIndex(k);
+      if (dof < 6)
+      {
+        rootJ.col(dof) = J.col(k);
+      }
+    }
+    rootM += rootJ.transpose() * body->getSpatialInertia() * rootJ;
+  }
+
+  Eigen::Vector6s rootFs = Eigen::Vector6s::Zero();
+  for (int i = 0; i < mForces.size(); i++)
+  {
+    rootFs += mForces[i].computeTau(forcesConcat.segment<6>(i * 6)).head<6>();
+  }
+
+  Eigen::Vector6s solve
+      = -rootM.completeOrthogonalDecomposition().solve(rootBias - rootFs);
+
+  mSkel->setPositions(originalPos);
+  mSkel->setVelocities(originalVel);
+  mSkel->setAccelerations(originalAcc);
+  mSkel->setControlForces(originalForces);
+
+  return solve;
+}
+
 //==============================================================================
 // This computes the angular acceleration we would need at the root in order
 // to keep everything else the same, and end up with zero residuals at the
@@ -1969,12 +2066,15 @@ ResidualForceHelper::getRootTrajectoryLinearSystem(
   std::vector<Eigen::Matrix6s> dAcc_dOffsetVels;
   dAcc_dOffsetVels.resize(numTimesteps, Eigen::Matrix6s::Zero());
 
-  int numThreads = 16;
+  int numThreads = std::max(1, std::min(mNumThreads, numTimesteps));
+  ensureThreadSkels(numThreads);
   std::vector<std::future<void>> futures;
   for (int threadIdx = 0; threadIdx < numThreads; threadIdx++)
   {
-    std::shared_ptr<dynamics::Skeleton> skel = mSkel->cloneSkeleton();
+    std::shared_ptr<dynamics::Skeleton> skel = mThreadSkels[threadIdx];
+    ResidualForceHelper* threadHelper = &mThreadHelpers[threadIdx];
     futures.push_back(std::async([skel,
+                                  threadHelper,
                                   threadIdx,
                                   numTimesteps,
                                   numThreads,
@@ -1983,9 +2083,7 @@ ResidualForceHelper::getRootTrajectoryLinearSystem(
                                   &ddqs,
                                   &forces,
                                   &dAcc_dOffsetPoses,
-                                  &dAcc_dOffsetVels,
-                                  this] {
-      ResidualForceHelper threadHelper(skel, mForceBodies);
+                                  &dAcc_dOffsetVels] {
       for (int t = 1; t < numTimesteps; t++)
       {
         if ((t - threadIdx) % numThreads == 0)
@@ -1995,11 +2093,11 @@ ResidualForceHelper::getRootTrajectoryLinearSystem(
 
           dAcc_dOffsetPoses[t]
               = threadHelper
-                    .calculateResidualFreeRootAccelerationJacobianWrtPosition(
+                    ->calculateResidualFreeRootAccelerationJacobianWrtPosition(
                         qs.col(t), dqs.col(t), ddqs.col(t), forces.col(t));
           dAcc_dOffsetVels[t]
               = threadHelper
-                    .calculateResidualFreeRootAccelerationJacobianWrtVelocity(
+                    ->calculateResidualFreeRootAccelerationJacobianWrtVelocity(
                         qs.col(t), dqs.col(t), ddqs.col(t), forces.col(t));
         }
       }
@@ -3008,7 +3106,7 @@ ResidualForceHelper::getLinearTrajectoryLinearSystemParallel(
     accOffset.push_back(offset);
   }
 
-  int numThreads = 16;
+  int numThreads = std::max(1, std::min(mNumThreads, numTimesteps));
 
   // This has one col each for start COM positions, start COM velocities,
   // It outputs the change in physically consistent X, Y, Z coordinates of COM
@@ -3116,22 +3214,7 @@ ResidualForceHelper::getLinearTrajectoryLinearSystemParallel(
 
   // Make sure there are enough copies of skeletons, and residuals helpers, to
   // fill out all the parallel threads we need.
-  for (int threadIdx = mThreadSkels.size(); threadIdx < numThreads; threadIdx++)
-  {
-    mThreadSkels.push_back(mSkel->cloneSkeleton());
-  }
-  for (int threadIdx = mThreadHelpers.size(); threadIdx < numThreads;
-       threadIdx++)
-  {
-    mThreadHelpers.emplace_back(mThreadSkels[threadIdx], mForceBodies);
-  }
-  for (int threadIdx = 0; threadIdx < numThreads; threadIdx++)
-  {
-    mThreadSkels[threadIdx]->setGroupScales(mSkel->getGroupScales());
-    mThreadSkels[threadIdx]->setGroupCOMs(mSkel->getGroupCOMs());
-    mThreadSkels[threadIdx]->setGroupMasses(mSkel->getGroupMasses());
-    mThreadSkels[threadIdx]->setGroupInertias(mSkel->getGroupInertias());
-  }
+  ensureThreadSkels(numThreads);
 
   std::vector<std::future<void>> futures;
   for (int threadIdx = 0; threadIdx < numThreads; threadIdx++)
@@ -3837,30 +3920,34 @@ ResidualForceHelper::getMultiMassLinearSystem(
     coms.push_back(mSkel->getCOM());
   }
 
+  // Compute the offset from the difference between a finite-difference's
+  // COM acceleration and an analytical one, for all timesteps at once
+  std::vector<Eigen::MatrixXs> comOffsetJac;
   std::vector<Eigen::MatrixXs> accOffsetJac;
+  int numThreads = std::max(1, std::min(mNumThreads, numTimesteps));
+  ensureThreadSkels(numThreads);
+  std::vector<std::shared_ptr<dynamics::Skeleton>> threadSkels(
+      mThreadSkels.begin(), mThreadSkels.begin() + numThreads);
+  mSkel->getLinearizedMassesJacobiansOverTrajectory(
+      qs, dqs, ddqs, comOffsetJac, accOffsetJac, threadSkels);
+  // We only use the acceleration offsets on the interior timesteps
+  if (accOffsetJac.size() >= 2)
+  {
+    accOffsetJac.pop_back();
+    accOffsetJac.erase(accOffsetJac.begin());
+  }
+  else
+  {
+    accOffsetJac.clear();
+  }
 
   std::vector<Eigen::Vector3s> comOffset;
-  std::vector<Eigen::MatrixXs> comOffsetJac;
   for (int t = 0; t < qs.cols(); t++)
   {
-    // Compute the offset from the difference between a finite-difference's
-    // COM acceleration and an analytical one
-    mSkel->setPositions(qs.col(t));
-    mSkel->setVelocities(dqs.col(t));
-    mSkel->setAccelerations(ddqs.col(t));
-
     comOffset.push_back(
         qs.col(t).segment<3>(3)); // Unnormalized COMs start at 0, so the
                                   // offset at 0 is just the original root pos
-    comOffsetJac.push_back(
-        -mSkel->getUnnormalizedCOMJacobianWrtLinearizedMasses());
-
-    if (t > 0 && t < qs.cols() - 1)
-    {
-      accOffsetJac.push_back(
-          mSkel
-              ->getUnnormalizedCOMAccelerationOffsetJacobianWrtLinearizedMasses());
-    }
+    comOffsetJac[t] = -comOffsetJac[t];
   }
 
   // This has one col each for start COM positions, start COM velocities,
@@ -4577,6 +4664,7 @@ DynamicsFitProblem::DynamicsFitProblem(
     DynamicsFitProblemConfig config)
   : mInit(init),
     mBlocks(createBlocks(init, config)),
+    mLastParallelWallTime(0.0),
     mSkeleton(skeleton),
     mConfig(config),
     mBestObjectiveValue(std::numeric_limits<s_t>::infinity()),
@@ -4729,6 +4817,15 @@ DynamicsFitProblem::DynamicsFitProblem(
         std::make_shared<SpatialNewtonHelper>(skelClone));
   }
 
+  // 3. Until we've timed them, assume blocks cost time proportional to their
+  // length
+  for (auto& block : mBlocks)
+  {
+    mBlockCosts.push_back(block.len);
+  }
+  mThreadBusyTimes = std::vector<double>(mConfig.mNumThreads, 0.0);
+  sortBlocksByCost();
+
   mInitX = flatten();
   if (mInitX.size() != getProblemSize())
   {
@@ -4743,6 +4840,10 @@ DynamicsFitProblem::DynamicsFitProblem(
   std::cout << "Getting initial loss:" << std::endl;
   s_t initialLoss = computeLossParallel(mInitX, true);
   std::cout << "Got initial loss:" << initialLoss << std::endl;
+  // The initial loss timed every block, so we can now hand out the blocks by
+  // how expensive they actually are. This matters because block cost varies a
+  // lot with contact state and missing GRF frames.
+  sortBlocksByCost();
   mBestObjectiveValueState = mInitX;
   mBestObjectiveValue = initialLoss;
   mBestObjectiveValueIteration = -1;
@@ -4836,6 +4937,47 @@ std::vector<struct DynamicsFitProblemBlock> DynamicsFitProblem::createBlocks(
   return blocks;
 }
 
+//==============================================================================
+// This sorts the blocks so that threads claim the most expensive blocks first,
+// which keeps one long block from being picked up last and holding up the
+// whole evaluation. The cost of a block is how long it took to evaluate last
+// time, or its length if it has not been evaluated yet.
+void DynamicsFitProblem::sortBlocksByCost()
+{
+  mBlockOrder.clear();
+  for (int blockIdx = 0; blockIdx < mBlocks.size(); blockIdx++)
+  {
+    mBlockOrder.push_back(blockIdx);
+  }
+  std::stable_sort(mBlockOrder.begin(), mBlockOrder.end(), [&](int a, int b) {
+    return mBlockCosts[a] > mBlockCosts[b];
+  });
+}
+
+//==============================================================================
+// This prints how much of the last parallel evaluation each thread spent
+// busy, as a fraction of the wall time of the whole evaluation.
+void DynamicsFitProblem::logThreadUtilization()
+{
+  if (mLastParallelWallTime <= 0)
+  {
+    return;
+  }
+  std::cout << "Thread utilization over " << mLastParallelWallTime * 1000
+            << "ms: [";
+  for (int threadIdx = 0; threadIdx < mThreadBusyTimes.size(); threadIdx++)
+  {
+    if (threadIdx > 0)
+    {
+      std::cout << ",";
+    }
+    std::cout << (int)std::round(
+        100 * mThreadBusyTimes[threadIdx] / mLastParallelWallTime)
+              << "%";
+  }
+  std::cout << "]" << std::endl;
+}
+
 //==============================================================================
 // This returns the dimension of the decision variables (the length of the
 // flatten() vector), which depends on which variables we choose to include in
@@ -5092,7 +5234,7 @@ Eigen::VectorXs DynamicsFitProblem::flattenLowerBound()
 
 //==============================================================================
 // This reads the problem state out of a flat vector, and into the init object
-void DynamicsFitProblem::unflatten(Eigen::VectorXs x)
+void DynamicsFitProblem::unflatten(const Eigen::Ref<const Eigen::VectorXs>& x)
 {
   if (x.size() == mLastX.size() && x == mLastX)
   {
@@ -5164,29 +5306,25 @@ void DynamicsFitProblem::unflatten(Eigen::VectorXs x)
 
     for (auto& block : mBlocks)
     {
-      Eigen::VectorXs pos = x.segment(cursor, dims);
+      // These are views onto the rows of the block we're optimizing, so we can
+      // integrate directly into them without any temporaries
+      auto pos = block.pos.block(start, 0, dims, block.len);
+      auto vel = block.vel.block(start, 0, dims, block.len);
+      auto acc = block.acc.block(start, 0, dims, block.len);
+
+      pos.col(0) = x.segment(cursor, dims);
       cursor += dims;
-      Eigen::VectorXs vel = x.segment(cursor, dims);
+      vel.col(0) = x.segment(cursor, dims);
       cursor += dims;
+      acc = Eigen::Map<const Eigen::MatrixXs>(
+          x.data() + cursor, dims, block.len);
+      cursor += dims * block.len;
 
-      block.pos.block(start, 0, dims, block.pos.cols()).setZero();
-      block.vel.block(start, 0, dims, block.pos.cols()).setZero();
-      block.acc.block(start, 0, dims, block.pos.cols()).setZero();
-
-      for (int i = 0; i < block.len; i++)
+      // Integrate time forward through the block
+      for (int i = 0; i < block.len - 1; i++)
       {
-        // Write out our current state
-        block.pos.col(i).segment(start, dims) = pos;
-        block.vel.col(i).segment(start, dims) = vel;
-
-        // Read acc at this timestep
-        Eigen::VectorXs acc = x.segment(cursor, dims);
-        cursor += dims;
-        block.acc.col(i).segment(start, dims) = acc;
-
-        // Integrate time to the next timestep
-        vel += acc * block.dt;
-        pos += vel * block.dt;
+        vel.col(i + 1) = vel.col(i) + acc.col(i) * block.dt;
+        pos.col(i + 1) = pos.col(i) + vel.col(i + 1) * block.dt;
       }
     }
   }
@@ -5198,7 +5336,8 @@ void DynamicsFitProblem::unflatten(Eigen::VectorXs x)
 // This gets the value of the loss function, as a weighted sum of the
 // discrepancy between measured and expected GRF data and other regularization
 // terms.
-s_t DynamicsFitProblem::computeLoss(Eigen::VectorXs x, bool logExplanation)
+s_t DynamicsFitProblem::computeLoss(
+    const Eigen::Ref<const Eigen::VectorXs>& x, bool logExplanation)
 {
   unflatten(x);
 
@@ -5485,7 +5624,7 @@ struct LossExplanation
 // discrepancy between measured and expected GRF data and other regularization
 // terms.
 s_t DynamicsFitProblem::computeLossParallel(
-    Eigen::VectorXs x, bool logExplanation)
+    const Eigen::Ref<const Eigen::VectorXs>& x, bool logExplanation)
 {
   unflatten(x);
 
@@ -5709,41 +5848,39 @@ s_t DynamicsFitProblem::computeLossParallel(
   }
 
   int numThreads = std::min((int)mBlocks.size(), mConfig.mNumThreads);
-
-  std::vector<struct LossExplanation> threadLossExplanations;
-  for (int threadIdx = 0; threadIdx < numThreads; threadIdx++)
+  std::fill(mThreadBusyTimes.begin(), mThreadBusyTimes.end(), 0.0);
+  auto parallelStartTime = std::chrono::high_resolution_clock::now();
+
+  // Each block gets its own partial sums, which we add up in block order once
+  // all the threads are done. Threads claim blocks dynamically, so which
+  // thread evaluates which block changes from run to run, but the order of
+  // the floating point sums (and so the loss) does not.
+  std::vector<struct LossExplanation> blockLossExplanations;
+  for (int blockIdx = 0; blockIdx < mBlocks.size(); blockIdx++)
   {
-    threadLossExplanations.emplace_back();
-    struct LossExplanation& threadLoss = threadLossExplanations.at(threadIdx);
-    threadLoss.linearNewtonError = 0.0;
-    threadLoss.residualRMS = 0.0;
-    threadLoss.markerRMS = 0.0;
-    threadLoss.poseRegularization = 0.0;
-    threadLoss.accRegularization = 0.0;
-    threadLoss.jointAccRegularization = 0.0;
-    threadLoss.jointRMS = 0.0;
-    threadLoss.axisRMS = 0.0;
-    threadLoss.markerCount = 0;
+    blockLossExplanations.emplace_back();
+    struct LossExplanation& blockLoss = blockLossExplanations.at(blockIdx);
+    blockLoss.linearNewtonError = 0.0;
+    blockLoss.residualRMS = 0.0;
+    blockLoss.markerRMS = 0.0;
+    blockLoss.poseRegularization = 0.0;
+    blockLoss.accRegularization = 0.0;
+    blockLoss.jointAccRegularization = 0.0;
+    blockLoss.jointRMS = 0.0;
+    blockLoss.axisRMS = 0.0;
+    blockLoss.markerCount = 0;
   }
 
+  std::atomic<int> nextBlock(0);
   std::vector<std::future<void>> futures;
   for (int threadIdx = 0; threadIdx < numThreads; threadIdx++)
   {
-    futures.push_back(std::async([&threadLossExplanations,
+    futures.push_back(std::async([&blockLossExplanations,
+                                  &nextBlock,
                                   this,
                                   threadIdx,
                                   totalAccTimesteps,
                                   totalTimesteps] {
-      if (threadLossExplanations.size() <= threadIdx)
-      {
-        std::cout << "INTERNAL ERROR" << std::endl;
-        std::cout << "threadLossExplanations.size() = "
-                  << threadLossExplanations.size() << std::endl;
-        std::cout << "threadIdx = " << threadIdx << std::endl;
-        throw std::runtime_error("threadLossExplanations.size() <= threadIdx");
-      }
-      struct LossExplanation& threadLoss = threadLossExplanations.at(threadIdx);
-
       if (mThreadSkeletons.size() <= threadIdx)
       {
         std::cout << "INTERNAL ERROR" << std::endl;
@@ -5754,14 +5891,13 @@ s_t DynamicsFitProblem::computeLossParallel(
       }
       mThreadSkeletons.at(threadIdx)->clearExternalForces();
 
-      for (int blockIdx = 0; blockIdx < mBlocks.size(); blockIdx++)
+      for (int orderIdx = nextBlock++; orderIdx < mBlockOrder.size();
+           orderIdx = nextBlock++)
       {
-        if ((blockIdx + threadIdx) % mConfig.mNumThreads != 0)
-        {
-          continue;
-        }
-
+        int blockIdx = mBlockOrder.at(orderIdx);
         auto& block = mBlocks[blockIdx];
+        struct LossExplanation& blockLoss = blockLossExplanations.at(blockIdx);
+        auto blockStartTime = std::chrono::high_resolution_clock::now();
 
         if (block.trial >= mInit->trialTimesteps.size())
         {
@@ -6094,8 +6230,8 @@ s_t DynamicsFitProblem::computeLossParallel(
                                      block.acc.col(t),
                                      block.grf.col(t),
                                      mConfig.mLinearNewtonUseL1);
-                threadLoss.linearNewtonError += cost;
-                assert(!isnan(threadLoss.linearNewtonError));
+                blockLoss.linearNewtonError += cost;
+                assert(!isnan(blockLoss.linearNewtonError));
               }
               if (mConfig.mResidualWeight > 0)
               {
@@ -6108,8 +6244,8 @@ s_t DynamicsFitProblem::computeLossParallel(
                                      block.grf.col(t),
                                      mConfig.mResidualTorqueMultiple,
                                      mConfig.mResidualUseL1);
-                threadLoss.residualRMS += cost;
-                assert(!isnan(threadLoss.residualRMS));
+                blockLoss.residualRMS += cost;
+                assert(!isnan(blockLoss.residualRMS));
               }
               if (mConfig.mRegularizeAcc > 0)
               {
@@ -6121,15 +6257,15 @@ s_t DynamicsFitProblem::computeLossParallel(
                                      block.acc.col(t),
                                      mConfig.mRegularizeAccBodyWeights,
                                      mConfig.mRegularizeAccUseL1);
-                threadLoss.accRegularization += cost;
-                assert(!isnan(threadLoss.accRegularization));
+                blockLoss.accRegularization += cost;
+                assert(!isnan(blockLoss.accRegularization));
               }
               if (mConfig.mRegularizeJointAcc > 0)
               {
-                threadLoss.jointAccRegularization
+                blockLoss.jointAccRegularization
                     += mConfig.mRegularizeJointAcc * (1.0 / totalAccTimesteps)
                        * block.acc.col(t).squaredNorm();
-                assert(!isnan(threadLoss.jointAccRegularization));
+                assert(!isnan(blockLoss.jointAccRegularization));
               }
             }
 
@@ -6155,9 +6291,9 @@ s_t DynamicsFitProblem::computeLossParallel(
                 {
                   thisMarkerCost = diff.squaredNorm();
                 }
-                threadLoss.markerRMS += thisMarkerCost;
-                threadLoss.markerCount++;
-                assert(!isnan(threadLoss.markerRMS));
+                blockLoss.markerRMS += thisMarkerCost;
+                blockLoss.markerCount++;
+                assert(!isnan(blockLoss.markerRMS));
               }
             }
 
@@ -6171,10 +6307,10 @@ s_t DynamicsFitProblem::computeLossParallel(
             Eigen::VectorXs jointDiff = jointPoses - jointCenters;
             for (int i = 0; i < mInit->jointWeights.at(block.trial).size(); i++)
             {
-              threadLoss.jointRMS += (jointPoses.segment<3>(i * 3)
-                                      - jointCenters.segment<3>(i * 3))
-                                         .squaredNorm()
-                                     * mInit->jointWeights.at(block.trial)(i);
+              blockLoss.jointRMS += (jointPoses.segment<3>(i * 3)
+                                     - jointCenters.segment<3>(i * 3))
+                                        .squaredNorm()
+                                    * mInit->jointWeights.at(block.trial)(i);
             }
             Eigen::VectorXs jointAxis
                 = mInit->jointAxis.at(block.trial).col(realT);
@@ -6187,20 +6323,26 @@ s_t DynamicsFitProblem::computeLossParallel(
               // Subtract out any component parallel to the axis
               Eigen::Vector3s jointDiff = actualJointPos - axisCenter;
               jointDiff -= jointDiff.dot(axisDir) * axisDir;
-              threadLoss.axisRMS += jointDiff.squaredNorm()
-                                    * mInit->axisWeights.at(block.trial)(i);
+              blockLoss.axisRMS += jointDiff.squaredNorm()
+                                   * mInit->axisWeights.at(block.trial)(i);
             }
             // }
 
             // Add regularization
-            threadLoss.poseRegularization
+            blockLoss.poseRegularization
                 += mConfig.mRegularizePoses * (1.0 / totalTimesteps)
                    * (block.pos.col(t)
                       - mInit->regularizePosesTo.at(block.trial).col(realT))
                          .squaredNorm();
-            assert(!isnan(threadLoss.poseRegularization));
+            assert(!isnan(blockLoss.poseRegularization));
           }
         }
+
+        mBlockCosts[blockIdx] = std::chrono::duration<double>(
+                                    std::chrono::high_resolution_clock::now()
+                                    - blockStartTime)
+                                    .count();
+        mThreadBusyTimes[threadIdx] += mBlockCosts[blockIdx];
       }
     }));
   }
@@ -6209,6 +6351,10 @@ s_t DynamicsFitProblem::computeLossParallel(
   {
     (void)futures.at(threadIdx).get();
   }
+  mLastParallelWallTime = std::chrono::duration<double>(
+                              std::chrono::high_resolution_clock::now()
+                              - parallelStartTime)
+                              .count();
 
   s_t linearNewtonError = 0.0;
   s_t residualRMS = 0.0;
@@ -6219,32 +6365,17 @@ s_t DynamicsFitProblem::computeLossParallel(
   s_t jointRMS = 0.0;
   s_t axisRMS = 0.0;
   int markerCount = 0;
-  for (int threadIdx = 0; threadIdx < numThreads; threadIdx++)
+  for (struct LossExplanation& blockLoss : blockLossExplanations)
   {
-    if (threadIdx < threadLossExplanations.size())
-    {
-      linearNewtonError
-          += threadLossExplanations.at(threadIdx).linearNewtonError;
-      residualRMS += threadLossExplanations.at(threadIdx).residualRMS;
-      markerRMS += threadLossExplanations.at(threadIdx).markerRMS;
-      poseRegularization
-          += threadLossExplanations.at(threadIdx).poseRegularization;
-      accRegularization
-          += threadLossExplanations.at(threadIdx).accRegularization;
-      jointAccRegularization
-          += threadLossExplanations.at(threadIdx).jointAccRegularization;
-      jointRMS += threadLossExplanations.at(threadIdx).jointRMS;
-      axisRMS += threadLossExplanations.at(threadIdx).axisRMS;
-      markerCount += threadLossExplanations.at(threadIdx).markerCount;
-    }
-    else
-    {
-      std::cout << "INTERNAL ERROR" << std::endl;
-      std::cout << "threadIdx = " << threadIdx << std::endl;
-      std::cout << "threadLossExplanations.size() = "
-                << threadLossExplanations.size() << std::endl;
-      throw std::runtime_error("threadIdx >= threadLossExplanations.size()");
-    }
+    linearNewtonError += blockLoss.linearNewtonError;
+    residualRMS += blockLoss.residualRMS;
+    markerRMS += blockLoss.markerRMS;
+    poseRegularization += blockLoss.poseRegularization;
+    accRegularization += blockLoss.accRegularization;
+    jointAccRegularization += blockLoss.jointAccRegularization;
+    jointRMS += blockLoss.jointRMS;
+    axisRMS += blockLoss.axisRMS;
+    markerCount += blockLoss.markerCount;
   }
 
   sum += linearNewtonError;
@@ -6276,6 +6407,7 @@ s_t DynamicsFitProblem::computeLossParallel(
               << ",axisRMS=" << axisRMS << ",qR=" << poseRegularization
               << ",fRMS=" << residualRMS << ",linF=" << linearNewtonError
               << ",mkRMS=" << markerRMS << "]" << std::endl;
+    logThreadUtilization();
   }
 
   //   // Check against linear:
@@ -6288,7 +6420,8 @@ s_t DynamicsFitProblem::computeLossParallel(
 
 //==============================================================================
 // This gets the gradient of the loss function
-Eigen::VectorXs DynamicsFitProblem::computeGradient(Eigen::VectorXs x)
+Eigen::VectorXs DynamicsFitProblem::computeGradient(
+    const Eigen::Ref<const Eigen::VectorXs>& x)
 {
   unflatten(x);
 
@@ -6726,7 +6859,7 @@ Eigen::VectorXs DynamicsFitProblem::computeGradient(Eigen::VectorXs x)
           // Record joint gradients
           grad.segment(cursor, dim)
               += mSkeleton
-                     ->getJointWorldPositionsJacobianWrtGroupScales(
+                     ->getJointWorldPositionsSparseJacobianWrtGroupScales(
                          mInit->joints.at(block.trial))
                      .transpose()
                  * jointGrad;
@@ -6910,7 +7043,7 @@ Eigen::VectorXs DynamicsFitProblem::computeGradient(Eigen::VectorXs x)
           // Record joint gradients
           grad.segment(cursor, dim)
               += mSkeleton
-                     ->getJointWorldPositionsJacobianWrtGroupScales(
+                     ->getJointWorldPositionsSparseJacobianWrtGroupScales(
                          mInit->joints.at(block.trial))
                      .transpose()
                  * jointGrad;
@@ -6966,7 +7099,8 @@ Eigen::VectorXs DynamicsFitProblem::computeGradient(Eigen::VectorXs x)
 
 //==============================================================================
 // This gets the gradient of the loss function
-Eigen::VectorXs DynamicsFitProblem::computeGradientParallel(Eigen::VectorXs x)
+Eigen::VectorXs DynamicsFitProblem::computeGradientParallel(
+    const Eigen::Ref<const Eigen::VectorXs>& x)
 {
   unflatten(x);
 
@@ -7142,11 +7276,30 @@ Eigen::VectorXs DynamicsFitProblem::computeGradientParallel(Eigen::VectorXs x)
   }
 
   int initialPosesCursor = posesCursor;
+  std::vector<int> blockStarts;
+  for (auto& block : mBlocks)
+  {
+    blockStarts.push_back(posesCursor);
+    posesCursor += (2 + block.len) * dims;
+  }
+  // Every block adds into the shared variables before the poses, so each block
+  // gets its own copy of that part of the gradient, which we add up in block
+  // order once all the threads are done. Threads claim blocks dynamically, so
+  // which thread evaluates which block changes from run to run, but the order
+  // of the floating point sums (and so the gradient) does not. The rest of the
+  // gradient is only ever written by the block that owns it.
+  std::vector<Eigen::VectorXs> blockSharedGrads(mBlocks.size());
+  std::atomic<int> nextBlock(0);
   std::vector<std::future<Eigen::VectorXs>> futures;
   int gradSize = grad.size();
+  std::fill(mThreadBusyTimes.begin(), mThreadBusyTimes.end(), 0.0);
+  auto parallelStartTime = std::chrono::high_resolution_clock::now();
   for (int threadIdx = 0; threadIdx < mConfig.mNumThreads; threadIdx++)
   {
     futures.push_back(std::async([initialPosesCursor,
+                                  &blockStarts,
+                                  &blockSharedGrads,
+                                  &nextBlock,
                                   this,
                                   threadIdx,
                                   dofs,
@@ -7156,19 +7309,15 @@ Eigen::VectorXs DynamicsFitProblem::computeGradientParallel(Eigen::VectorXs x)
                                   markerCount,
                                   totalAccTimesteps,
                                   totalTimesteps] {
-      int posesCursor = initialPosesCursor;
       Eigen::VectorXs threadGrad = Eigen::VectorXs::Zero(gradSize);
-      for (int blockIdx = 0; blockIdx < mBlocks.size(); blockIdx++)
+      for (int orderIdx = nextBlock++; orderIdx < mBlockOrder.size();
+           orderIdx = nextBlock++)
       {
+        int blockIdx = mBlockOrder.at(orderIdx);
         auto& block = mBlocks[blockIdx];
         s_t dt = block.dt;
-        const int blockStart = posesCursor;
-
-        if ((blockIdx + threadIdx) % mConfig.mNumThreads != 0)
-        {
-          posesCursor += (2 + block.len) * dims;
-          continue;
-        }
+        const int blockStart = blockStarts.at(blockIdx);
+        auto blockStartTime = std::chrono::high_resolution_clock::now();
 
         for (int t = 0; t < block.len; t++)
         {
@@ -7438,7 +7587,7 @@ Eigen::VectorXs DynamicsFitProblem::computeGradientParallel(Eigen::VectorXs x)
               // Record joint gradients
               threadGrad.segment(cursor, dim)
                   += mThreadSkeletons.at(threadIdx)
-                         ->getJointWorldPositionsJacobianWrtGroupScales(
+                         ->getJointWorldPositionsSparseJacobianWrtGroupScales(
                              mThreadJoints.at(threadIdx).at(block.trial))
                          .transpose()
                      * jointGrad;
@@ -7638,7 +7787,7 @@ Eigen::VectorXs DynamicsFitProblem::computeGradientParallel(Eigen::VectorXs x)
               // Record joint gradients
               threadGrad.segment(cursor, dim)
                   += mThreadSkeletons.at(threadIdx)
-                         ->getJointWorldPositionsJacobianWrtGroupScales(
+                         ->getJointWorldPositionsSparseJacobianWrtGroupScales(
                              mThreadJoints.at(threadIdx).at(block.trial))
                          .transpose()
                      * jointGrad;
@@ -7690,16 +7839,30 @@ Eigen::VectorXs DynamicsFitProblem::computeGradientParallel(Eigen::VectorXs x)
           }
         }
 
-        posesCursor += (2 + block.len) * dims;
+        mBlockCosts[blockIdx] = std::chrono::duration<double>(
+                                    std::chrono::high_resolution_clock::now()
+                                    - blockStartTime)
+                                    .count();
+        mThreadBusyTimes[threadIdx] += mBlockCosts[blockIdx];
+        blockSharedGrads.at(blockIdx) = threadGrad.head(initialPosesCursor);
+        threadGrad.head(initialPosesCursor).setZero();
       }
-      assert(posesCursor == gradSize);
       return threadGrad;
     }));
   }
+  assert(posesCursor == gradSize);
   for (int threadIdx = 0; threadIdx < mConfig.mNumThreads; threadIdx++)
   {
     grad += futures[threadIdx].get();
   }
+  for (int blockIdx = 0; blockIdx < mBlocks.size(); blockIdx++)
+  {
+    grad.head(initialPosesCursor) += blockSharedGrads.at(blockIdx);
+  }
+  mLastParallelWallTime = std::chrono::duration<double>(
+                              std::chrono::high_resolution_clock::now()
+                              - parallelStartTime)
+                              .count();
 
   // // Check against single-threaded
   // Eigen::VectorXs gradSingleThreaded = computeGradient(x);
@@ -7779,7 +7942,8 @@ int DynamicsFitProblem::getConstraintSize()
 // active when we're including positions in the decision variables, and they
 // just enforce that finite differencing is valid to relate velocity,
 // acceleration, and position.
-Eigen::VectorXs DynamicsFitProblem::computeConstraints(Eigen::VectorXs x)
+Eigen::VectorXs DynamicsFitProblem::computeConstraints(
+    const Eigen::Ref<const Eigen::VectorXs>& x)
 {
   if (mConfig.mIncludePoses || mConfig.mConstrainResidualsZero)
   {
@@ -8528,7 +8692,9 @@ DynamicsFitProblemConfig::DynamicsFitProblemConfig(
     mMaxNumTrials(-1),
     mOnlyOneTrial(-1),
     mMaxNumBlocksPerTrial(-1),
-    mNumThreads(16)
+    mNumThreads(16),
+    mDerivativeCheckDirections(0),
+    mDerivativeCheckTolerance(1e-4)
 // mResidualWeight(0.1),
 // mLinearNewtonWeight(0.1),
 // mMarkerWeight(1.0),
@@ -8904,6 +9070,15 @@ DynamicsFitProblemConfig& DynamicsFitProblemConfig::setNumThreads(int value)
   return *(this);
 }
 
+//==============================================================================
+DynamicsFitProblemConfig& DynamicsFitProblemConfig::setRandomDerivativeCheck(
+    int numDirections, s_t tolerance)
+{
+  mDerivativeCheckDirections = numDirections;
+  mDerivativeCheckTolerance = tolerance;
+  return *(this);
+}
+
 //------------------------- Ipopt::TNLP --------------------------------------
 
 //==============================================================================
@@ -9073,6 +9248,26 @@ bool DynamicsFitProblem::eval_grad_f(
 
   grad = computeGradientParallel(x.cast<s_t>()).cast<double>();
 
+  if (mConfig.mDerivativeCheckDirections > 0 && _n > 0)
+  {
+    const Eigen::VectorXs x_s = x.cast<s_t>();
+    s_t error = math::checkGradientAlongRandomDirections(
+        [&](const Eigen::VectorXs& point) {
+          return computeLossParallel(point);
+        },
+        grad.cast<s_t>(),
+        x_s,
+        mConfig.mDerivativeCheckDirections);
+    unflatten(x_s);
+    if (error > mConfig.mDerivativeCheckTolerance)
+    {
+      std::cout << "WARNING: DynamicsFitProblem::eval_grad_f() failed the "
+                   "random derivative check, with error "
+                << error << " > tolerance " << mConfig.mDerivativeCheckTolerance
+                << std::endl;
+    }
+  }
+
   return true;
 }
 
@@ -9325,7 +9520,8 @@ DynamicsFitter::DynamicsFitter(
     mCheckDerivatives(false),
     mPrintFrequency(1),
     mSilenceOutput(false),
-    mDisableLinesearch(false)
+    mDisableLinesearch(false),
+    mNumThreads(16)
 {
   mSkeleton->setGroupMasses(mSkeleton->getGroupMasses());
   mSkeleton->setGroupCOMs(mSkeleton->getGroupCOMs());
@@ -10101,148 +10297,138 @@ void DynamicsFitter::estimateFootGroundContactsWithStillness(
 {
   guessTrialsOnTreadmill(init);
 
-  for (int trial = 0; trial < init->poseTrials.size(); trial++)
-  {
-    recomputeGRFs(init, mSkeleton, trial);
-
-    if (init->probablyMissingGRF.size() < trial)
-    {
-      std::cout << "Error: probablyMissingGRF is missing trial " << trial
-                << std::endl;
-      throw std::runtime_error("probablyMissingGRF is missing frames");
-    }
-    if (init->probablyMissingGRF.at(trial).size()
-        < init->poseTrials[trial].cols())
-    {
-      std::cout << "Error: probablyMissingGRF manual initialization is missing "
-                   "frames for trial "
-                << trial << "! Got frames "
-                << init->probablyMissingGRF.at(trial).size()
-                << ", expected frames " << init->poseTrials[trial].cols()
-                << std::endl;
-      throw std::runtime_error("probablyMissingGRF is missing frames");
-    }
-    if (init->missingGRFReason.size() < trial)
-    {
-      std::cout << "Error: missingGRFReason is missing trial " << trial
-                << std::endl;
-      throw std::runtime_error("missingGRFReason is missing frames");
-    }
-    if (init->missingGRFReason.at(trial).size()
-        < init->poseTrials[trial].cols())
-    {
-      std::cout << "Error: missingGRFReason manual initialization is missing "
-                   "frames for trial "
-                << trial << "! Got frames "
-                << init->missingGRFReason.at(trial).size()
-                << ", expected frames " << init->poseTrials[trial].cols()
-                << std::endl;
-      throw std::runtime_error("missingGRFReason is missing frames");
-    }
-
-    // Otherwise, we can estimate ground contact by looking at the velocity of
-    // the feet
-    Eigen::VectorXs originalPose = mSkeleton->getPositions();
-
-    // Collect the positions of the feet over time
-    std::vector<std::vector<Eigen::Vector3s>> footPositions;
-    for (int i = 0; i < init->grfBodyNodes.size(); i++)
-    {
-      footPositions.emplace_back();
-    }
-    for (int t = 0; t < init->poseTrials[trial].cols(); t++)
-    {
-      for (int i = 0; i < init->grfBodyNodes.size(); i++)
-      {
-        mSkeleton->setPositions(init->poseTrials[trial].col(t));
-        Eigen::Vector3s worldPos
-            = init->grfBodyNodes[i]->getWorldTransform().translation();
-        footPositions[i].push_back(worldPos);
-      }
-    }
-
-    // Do a manual clustering for "at rest detection"
-    // If the feet are within `radius` of each other for more than `minTime`
-    // seconds, we call that at rest.
-
-    // We need to extend in this window in both directions, so we need to divide
-    // the window frames we would naively get by an additional factor of 2
-    int minTimestepsWindow = (int)(minTime / (2 * init->trialTimesteps[trial]));
+  // Every trial is independent, so we recompute the GRFs and classify the
+  // contacts for all the trials at once. Each trial only writes to its own
+  // slots, and the contact flags get appended to `init` in order at the end.
+  const int numTrials = init->poseTrials.size();
+  const int numBodies = init->grfBodyNodes.size();
+  std::vector<Eigen::MatrixXb> trialForceActives(numTrials);
+  std::vector<Eigen::MatrixXb> trialSphereInContacts(numTrials);
+  computeTrialsInParallel(
+      numTrials, [&](std::shared_ptr<dynamics::Skeleton> skel, int trial) {
+        recomputeGRFs(init, skel, trial);
+
+        if (init->probablyMissingGRF.size() < trial)
+        {
+          std::cout << "Error: probablyMissingGRF is missing trial " << trial
+                    << std::endl;
+          throw std::runtime_error("probablyMissingGRF is missing frames");
+        }
+        if (init->probablyMissingGRF.at(trial).size()
+            < init->poseTrials[trial].cols())
+        {
+          std::cout
+              << "Error: probablyMissingGRF manual initialization is missing "
+                 "frames for trial "
+              << trial << "! Got frames "
+              << init->probablyMissingGRF.at(trial).size()
+              << ", expected frames " << init->poseTrials[trial].cols()
+              << std::endl;
+          throw std::runtime_error("probablyMissingGRF is missing frames");
+        }
+        if (init->missingGRFReason.size() < trial)
+        {
+          std::cout << "Error: missingGRFReason is missing trial " << trial
+                    << std::endl;
+          throw std::runtime_error("missingGRFReason is missing frames");
+        }
+        if (init->missingGRFReason.at(trial).size()
+            < init->poseTrials[trial].cols())
+        {
+          std::cout
+              << "Error: missingGRFReason manual initialization is missing "
+                 "frames for trial "
+              << trial << "! Got frames "
+              << init->missingGRFReason.at(trial).size()
+              << ", expected frames " << init->poseTrials[trial].cols()
+              << std::endl;
+          throw std::runtime_error("missingGRFReason is missing frames");
+        }
 
-    std::vector<std::vector<bool>> footAtRests;
-    for (int i = 0; i < footPositions.size(); i++)
-    {
-      std::vector<bool> footAtRest;
-      for (int t = 0; t < init->poseTrials[trial].cols(); t++)
-      {
-        bool foundOutOfBounds = false;
-        for (int scanT = std::max(0, t - minTimestepsWindow);
-             scanT
-             < std::min((int)footPositions[i].size(), t + minTimestepsWindow);
-             scanT++)
+        // Otherwise, we can estimate ground contact by looking at the
+        // velocity of the feet
+        const int numTimesteps = init->poseTrials[trial].cols();
+        Eigen::MatrixXs footPositions = computeBodyWorldPositions(
+            init->poseTrials[trial], init->grfBodyNodes, skel);
+
+        // Do a manual clustering for "at rest detection"
+        // If the feet are within `radius` of each other for more than
+        // `minTime` seconds, we call that at rest.
+
+        // We need to extend in this window in both directions, so we need to
+        // divide the window frames we would naively get by an additional
+        // factor of 2
+        int minTimestepsWindow
+            = (int)(minTime / (2 * init->trialTimesteps[trial]));
+
+        Eigen::MatrixXb footAtRest = Eigen::MatrixXb::Zero(
+            numBodies, numTimesteps);
+        for (int i = 0; i < numBodies; i++)
         {
-          if ((footPositions[i][scanT] - footPositions[i][t]).squaredNorm()
-              > radius)
+          for (int t = 0; t < numTimesteps; t++)
           {
-            foundOutOfBounds = true;
-            break;
+            bool foundOutOfBounds = false;
+            for (int scanT = std::max(0, t - minTimestepsWindow);
+                 scanT < std::min(numTimesteps, t + minTimestepsWindow);
+                 scanT++)
+            {
+              if ((footPositions.block<3, 1>(i * 3, scanT)
+                   - footPositions.block<3, 1>(i * 3, t))
+                      .squaredNorm()
+                  > radius)
+              {
+                foundOutOfBounds = true;
+                break;
+              }
+            }
+            footAtRest(i, t) = !foundOutOfBounds;
           }
         }
-        footAtRest.push_back(!foundOutOfBounds);
-      }
-      footAtRests.push_back(footAtRest);
-    }
-
-    std::vector<std::vector<bool>> trialForceActive;
-    std::vector<std::vector<bool>> trialSphereInContact;
-    std::vector<std::vector<bool>> trialOffForcePlate;
-    std::vector<bool> trialAnyOffForcePlate;
-
-    // Now we know when the feet were judged to be at rest, we can check if
-    // there was force coming through the feet at those times. If not, we can
-    // mark them.
-    for (int t = 0; t < init->poseTrials[trial].cols(); t++)
-    {
-      trialForceActive.emplace_back();
-      trialSphereInContact.emplace_back();
-      trialOffForcePlate.emplace_back();
-
-      bool anyOffForcePlate = false;
-      for (int i = 0; i < footAtRests.size(); i++)
-      {
-        // Check the GRF to see if we are measured as being in contact
-        bool footActive
-            = (init->grfTrials[trial].col(t).segment<6>(i * 6).squaredNorm()
-               > 1e-3);
-        trialForceActive[t].push_back(footActive);
-        trialSphereInContact[t].push_back(footAtRests[i][t]);
-        trialOffForcePlate[t].push_back(false);
 
-        if (footAtRests[i][t] && !footActive && !init->trialsOnTreadmill[trial])
+        // Now we know when the feet were judged to be at rest, we can check
+        // if there was force coming through the feet at those times. If not,
+        // we can mark them.
+        Eigen::MatrixXb forceActive
+            = Eigen::MatrixXb::Zero(numBodies, numTimesteps);
+        for (int t = 0; t < numTimesteps; t++)
         {
-          anyOffForcePlate = true;
-        }
-      }
-      trialAnyOffForcePlate.push_back(anyOffForcePlate);
-    }
-    init->grfBodyForceActive.push_back(trialForceActive);
-    init->grfBodySphereInContact.push_back(trialSphereInContact);
-    init->grfBodyOffForcePlate.push_back(trialOffForcePlate);
+          bool anyOffForcePlate = false;
+          for (int i = 0; i < numBodies; i++)
+          {
+            // Check the GRF to see if we are measured as being in contact
+            bool footActive
+                = (init->grfTrials[trial].col(t).segment<6>(i * 6).squaredNorm()
+                   > 1e-3);
+            forceActive(i, t) = footActive;
+
+            if (footAtRest(i, t) && !footActive
+                && !init->trialsOnTreadmill[trial])
+            {
+              anyOffForcePlate = true;
+            }
+          }
 
-    for (int t = 0; t < init->probablyMissingGRF.at(trial).size(); t++)
-    {
-      if (init->probablyMissingGRF.at(trial).at(t) == MissingGRFStatus::unknown)
-      {
-        if (trialAnyOffForcePlate.at(t))
-        {
-          init->probablyMissingGRF.at(trial).at(t) = MissingGRFStatus::yes;
-          init->missingGRFReason.at(trial).at(t)
-              = MissingGRFReason::footContactDetectedButNoForce;
+          if (t < init->probablyMissingGRF.at(trial).size()
+              && init->probablyMissingGRF.at(trial).at(t)
+                     == MissingGRFStatus::unknown
+              && anyOffForcePlate)
+          {
+            init->probablyMissingGRF.at(trial).at(t) = MissingGRFStatus::yes;
+            init->missingGRFReason.at(trial).at(t)
+                = MissingGRFReason::footContactDetectedButNoForce;
+          }
         }
-      }
-    }
 
-    mSkeleton->setPositions(originalPose);
+        trialForceActives[trial] = forceActive;
+        trialSphereInContacts[trial] = footAtRest;
+      });
+
+  for (int trial = 0; trial < numTrials; trial++)
+  {
+    init->grfBodyForceActive.push_back(trialForceActives[trial]);
+    init->grfBodySphereInContact.push_back(trialSphereInContacts[trial]);
+    init->grfBodyOffForcePlate.push_back(Eigen::MatrixXb::Zero(
+        numBodies, trialForceActives[trial].cols()));
   }
   fillInMissingGRFBlips(init);
 }
@@ -10255,8 +10441,6 @@ void DynamicsFitter::estimateFootGroundContactsWithHeightHeuristic(
     std::shared_ptr<DynamicsInitialization> init,
     bool ignoreFootNotOverForcePlate)
 {
-  Eigen::VectorXs originalPose = mSkeleton->getPositions();
-
   const s_t offForcePlateHeightSafetyMargin = 0.05;
 
   // 0. Expand the set of grf bodies to include any childen that are not
@@ -10292,383 +10476,423 @@ void DynamicsFitter::estimateFootGroundContactsWithHeightHeuristic(
     init->contactBodies.push_back(extendedContactBodies);
   }
 
-  for (int trial = 0; trial < init->forcePlateTrials.size(); trial++)
+  // 0.1. We collect the world positions of all the contact bodies over time
+  // into one matrix per trial. Contact body `c` of GRF body `b` is at block
+  // row `contactBodyOffsets[b] + c` of that matrix.
+  std::vector<dynamics::BodyNode*> allContactBodies;
+  std::vector<int> contactBodyOffsets;
+  for (int b = 0; b < init->grfBodyNodes.size(); b++)
   {
-    bool noGroundCorners = true;
+    contactBodyOffsets.push_back(allContactBodies.size());
+    for (dynamics::BodyNode* body : init->contactBodies[b])
+    {
+      allContactBodies.push_back(body);
+    }
+  }
 
-    // 1.1. First check for the ground level from the force plates
+  // Every trial is independent, so we classify the contacts for all the
+  // trials at once. Each trial only writes to its own slots, and the results
+  // (and trialLog messages) are appended to `init` in order at the end.
+  const int numTrials = init->forcePlateTrials.size();
+  std::vector<std::vector<std::vector<s_t>>> trialContactSphereRadii(
+      numTrials);
+  std::vector<std::vector<Eigen::Vector3s>> trialDefaultCorners(numTrials);
+  std::vector<Eigen::MatrixXb> trialForceActives(numTrials);
+  std::vector<Eigen::MatrixXb> trialSphereInContacts(numTrials);
+  std::vector<Eigen::MatrixXb> trialOffForcePlates(numTrials);
+  std::vector<std::stringstream> trialLogs(numTrials);
+  computeTrialsInParallel(
+      numTrials, [&](std::shared_ptr<dynamics::Skeleton> skel, int trial) {
+        std::stringstream& trialLog = trialLogs[trial];
+        Eigen::MatrixXs contactPositions = computeBodyWorldPositions(
+            init->poseTrials[trial], allContactBodies, skel);
 
-    s_t groundHeight = std::numeric_limits<s_t>::infinity();
-    for (ForcePlate& forcePlate : init->forcePlateTrials[trial])
-    {
-      for (Eigen::Vector3s corner : forcePlate.corners)
-      {
-        if (noGroundCorners)
-        {
-          groundHeight = corner(1);
-          noGroundCorners = false;
-        }
-      }
-    }
+        bool noGroundCorners = true;
 
-    // 1.2. Check the ground level from the GRF data, if we don't have force
-    // plate data
+        // 1.1. First check for the ground level from the force plates
 
-    if (noGroundCorners)
-    {
-      for (int t = 0; t < init->poseTrials[trial].cols(); t++)
-      {
+        s_t groundHeight = std::numeric_limits<s_t>::infinity();
         for (ForcePlate& forcePlate : init->forcePlateTrials[trial])
         {
-          s_t height = forcePlate.centersOfPressure[t](1);
-          if (noGroundCorners)
+          for (Eigen::Vector3s corner : forcePlate.corners)
           {
-            groundHeight = height;
-            noGroundCorners = false;
+            if (noGroundCorners)
+            {
+              groundHeight = corner(1);
+              noGroundCorners = false;
+            }
           }
-          else if (height < groundHeight)
+        }
+
+        // 1.2. Check the ground level from the GRF data, if we don't have force
+        // plate data
+
+        if (noGroundCorners)
+        {
+          for (int t = 0; t < init->poseTrials[trial].cols(); t++)
           {
-            groundHeight = height;
+            for (ForcePlate& forcePlate : init->forcePlateTrials[trial])
+            {
+              s_t height = forcePlate.centersOfPressure[t](1);
+              if (noGroundCorners)
+              {
+                groundHeight = height;
+                noGroundCorners = false;
+              }
+              else if (height < groundHeight)
+              {
+                groundHeight = height;
+              }
+            }
           }
         }
-      }
-    }
 
-    std::cout << "Detected ground height: " << groundHeight << std::endl;
+        trialLog << "Detected ground height: " << groundHeight << std::endl;
 
-    assert(!isnan(groundHeight));
+        assert(!isnan(groundHeight));
 
-    // 2.0. Check for the size of the contact spheres to check for contact
-    // Since each grf body actually gets a (potentially) extended set of
-    // contact bodies attached to it, each grf body gets an array of contact
-    // sphere radii, one for each contact sphere.
+        // 2.0. Check for the size of the contact spheres to check for contact
+        // Since each grf body actually gets a (potentially) extended set of
+        // contact bodies attached to it, each grf body gets an array of contact
+        // sphere radii, one for each contact sphere.
 
-    std::vector<std::vector<s_t>> grfContactSphereSizes;
-    for (int b = 0; b < init->contactBodies.size(); b++)
-    {
-      grfContactSphereSizes.emplace_back();
-      for (int c = 0; c < init->contactBodies[b].size(); c++)
-      {
-        grfContactSphereSizes[grfContactSphereSizes.size() - 1].push_back(0.0);
-      }
-    }
-
-    for (int t = 0; t < init->poseTrials[trial].cols(); t++)
-    {
-      mSkeleton->setPositions(init->poseTrials[trial].col(t));
-
-      for (int b = 0; b < init->grfBodyNodes.size(); b++)
-      {
-        bool footActive
-            = (init->grfTrials[trial].col(t).segment<6>(b * 6).squaredNorm()
-               > 1e-3);
-
-        // If this foot is active on this timestep, then we have to resize our
-        // contact spheres to ensure that they show contact on this frame. We
-        // do this by ensuring that the closest sphere is at least large
-        // enough to hit contact.
-        if (footActive)
+        std::vector<std::vector<s_t>> grfContactSphereSizes;
+        for (int b = 0; b < init->contactBodies.size(); b++)
         {
-          // Check which of the contact bodies is closest to the ground
-          s_t minDist = std::numeric_limits<s_t>::infinity();
-          int closestBody = -1;
+          grfContactSphereSizes.emplace_back();
           for (int c = 0; c < init->contactBodies[b].size(); c++)
           {
-            auto* body = init->contactBodies[b][c];
-            Eigen::Vector3s worldPos = body->getWorldTransform().translation();
-            s_t dist = worldPos(1) - groundHeight;
-            if (dist < minDist)
+            grfContactSphereSizes[grfContactSphereSizes.size() - 1].push_back(
+                0.0);
+          }
+        }
+
+        for (int t = 0; t < init->poseTrials[trial].cols(); t++)
+        {
+          for (int b = 0; b < init->grfBodyNodes.size(); b++)
+          {
+            bool footActive
+                = (init->grfTrials[trial].col(t).segment<6>(b * 6).squaredNorm()
+                   > 1e-3);
+
+            // If this foot is active on this timestep, then we have to resize
+            // our contact spheres to ensure that they show contact on this
+            // frame. We do this by ensuring that the closest sphere is at least
+            // large enough to hit contact.
+            if (footActive)
             {
-              minDist = dist;
-              closestBody = c;
+              // Check which of the contact bodies is closest to the ground
+              s_t minDist = std::numeric_limits<s_t>::infinity();
+              int closestBody = -1;
+              for (int c = 0; c < init->contactBodies[b].size(); c++)
+              {
+                Eigen::Vector3s worldPos
+                    = contactPositions.block<3, 1>(
+                        (contactBodyOffsets[b] + c) * 3, t);
+                s_t dist = worldPos(1) - groundHeight;
+                if (dist < minDist)
+                {
+                  minDist = dist;
+                  closestBody = c;
+                }
+              }
+
+              // If our closest sphere needs to expand to hit the ground, then
+              // expand it
+              if (minDist > grfContactSphereSizes[b][closestBody])
+              {
+                grfContactSphereSizes[b][closestBody] = minDist;
+              }
             }
           }
+        }
 
-          // If our closest sphere needs to expand to hit the ground, then
-          // expand it
-          if (minDist > grfContactSphereSizes[b][closestBody])
+        for (int b = 0; b < init->contactBodies.size(); b++)
+        {
+          trialLog << "Contact body " << b << " radii: [";
+          for (s_t r : grfContactSphereSizes[b])
           {
-            grfContactSphereSizes[b][closestBody] = minDist;
+            trialLog << r << ",";
           }
+          trialLog << std::endl;
         }
-      }
-    }
-
-    for (int b = 0; b < init->contactBodies.size(); b++)
-    {
-      std::cout << "Contact body " << b << " radii: [";
-      for (s_t r : grfContactSphereSizes[b])
-      {
-        std::cout << r << ",";
-      }
-      std::cout << std::endl;
-    }
 
-    init->grfBodyContactSphereRadius.push_back(grfContactSphereSizes);
+        trialContactSphereRadii[trial] = grfContactSphereSizes;
 
-    // 3. Create the default force plate size, if needed.
+        // 3. Create the default force plate size, if needed.
 
-    // 3.1. We only need a default force plate if any of the force plates in
-    // the trials lack the corners array
-    bool needDefaultForcePlate = false;
-    for (ForcePlate& forcePlate : init->forcePlateTrials[trial])
-    {
-      if (forcePlate.corners.size() == 0)
-      {
-        needDefaultForcePlate = true;
-        break;
-      }
-    }
-    // 3.2. If we need the default force plate, now we want to go create a
-    // rectangle to hold all the GRF data.
-    std::vector<Eigen::Vector3s> defaultCorners;
-    if (needDefaultForcePlate)
-    {
-      s_t minX = std::numeric_limits<s_t>::infinity();
-      s_t maxX = -std::numeric_limits<s_t>::infinity();
-      s_t minZ = std::numeric_limits<s_t>::infinity();
-      s_t maxZ = -std::numeric_limits<s_t>::infinity();
-      for (int t = 0; t < init->poseTrials[trial].cols(); t++)
-      {
+        // 3.1. We only need a default force plate if any of the force plates in
+        // the trials lack the corners array
+        bool needDefaultForcePlate = false;
         for (ForcePlate& forcePlate : init->forcePlateTrials[trial])
         {
-          if (forcePlate.centersOfPressure[t](0) < minX)
-          {
-            minX = forcePlate.centersOfPressure[t](0);
-          }
-          if (forcePlate.centersOfPressure[t](0) > maxX)
+          if (forcePlate.corners.size() == 0)
           {
-            maxX = forcePlate.centersOfPressure[t](0);
+            needDefaultForcePlate = true;
+            break;
           }
-          if (forcePlate.centersOfPressure[t](2) < minZ)
+        }
+        // 3.2. If we need the default force plate, now we want to go create a
+        // rectangle to hold all the GRF data.
+        std::vector<Eigen::Vector3s> defaultCorners;
+        if (needDefaultForcePlate)
+        {
+          s_t minX = std::numeric_limits<s_t>::infinity();
+          s_t maxX = -std::numeric_limits<s_t>::infinity();
+          s_t minZ = std::numeric_limits<s_t>::infinity();
+          s_t maxZ = -std::numeric_limits<s_t>::infinity();
+          for (int t = 0; t < init->poseTrials[trial].cols(); t++)
           {
-            minZ = forcePlate.centersOfPressure[t](2);
+            for (ForcePlate& forcePlate : init->forcePlateTrials[trial])
+            {
+              if (forcePlate.centersOfPressure[t](0) < minX)
+              {
+                minX = forcePlate.centersOfPressure[t](0);
+              }
+              if (forcePlate.centersOfPressure[t](0) > maxX)
+              {
+                maxX = forcePlate.centersOfPressure[t](0);
+              }
+              if (forcePlate.centersOfPressure[t](2) < minZ)
+              {
+                minZ = forcePlate.centersOfPressure[t](2);
+              }
+              if (forcePlate.centersOfPressure[t](2) > maxZ)
+              {
+                maxZ = forcePlate.centersOfPressure[t](2);
+              }
+            }
           }
-          if (forcePlate.centersOfPressure[t](2) > maxZ)
+
+          // Add 20cm to each side, to be very conservative
+          s_t padding = 0.20;
+          minX -= padding;
+          maxX += padding;
+          minZ -= padding;
+          maxZ += padding;
+
+          defaultCorners.push_back(Eigen::Vector3s(minX, groundHeight, minZ));
+          defaultCorners.push_back(Eigen::Vector3s(minX, groundHeight, maxZ));
+          defaultCorners.push_back(Eigen::Vector3s(maxX, groundHeight, maxZ));
+          defaultCorners.push_back(Eigen::Vector3s(maxX, groundHeight, minZ));
+        }
+
+        // 4. Determine foot-ground contact at each trial, and figure out which
+        // timesteps we think we're receiving force that isn't measured by a
+        // force plate.
+
+        std::vector<std::vector<Eigen::Vector3s>> sortedForcePlateCorners;
+        for (ForcePlate& plate : init->forcePlateTrials[trial])
+        {
+          if (plate.corners.size() > 0)
           {
-            maxZ = forcePlate.centersOfPressure[t](2);
+            sortedForcePlateCorners.push_back(plate.corners);
+            math::prepareConvex2DShape(
+                sortedForcePlateCorners[sortedForcePlateCorners.size() - 1],
+                plate.corners[0],
+                Eigen::Vector3s::UnitX(),
+                Eigen::Vector3s::UnitZ());
           }
         }
-      }
-
-      // Add 20cm to each side, to be very conservative
-      s_t padding = 0.20;
-      minX -= padding;
-      maxX += padding;
-      minZ -= padding;
-      maxZ += padding;
+        if (defaultCorners.size() > 0)
+        {
+          math::prepareConvex2DShape(
+              defaultCorners,
+              defaultCorners[0],
+              Eigen::Vector3s::UnitX(),
+              Eigen::Vector3s::UnitZ());
+        }
 
-      defaultCorners.push_back(Eigen::Vector3s(minX, groundHeight, minZ));
-      defaultCorners.push_back(Eigen::Vector3s(minX, groundHeight, maxZ));
-      defaultCorners.push_back(Eigen::Vector3s(maxX, groundHeight, maxZ));
-      defaultCorners.push_back(Eigen::Vector3s(maxX, groundHeight, minZ));
-    }
-    init->defaultForcePlateCorners.push_back(defaultCorners);
+        const int numTimesteps = init->poseTrials[trial].cols();
+        const int numBodies = init->grfBodyNodes.size();
+        Eigen::MatrixXb forceActive
+            = Eigen::MatrixXb::Zero(numBodies, numTimesteps);
+        Eigen::MatrixXb sphereInContact
+            = Eigen::MatrixXb::Zero(numBodies, numTimesteps);
+        Eigen::MatrixXb offForcePlate
+            = Eigen::MatrixXb::Zero(numBodies, numTimesteps);
+        std::vector<bool> trialAnyOffForcePlate;
+        std::vector<MissingGRFReason> trialMissingGRFReason;
+        for (int t = 0; t < numTimesteps; t++)
+        {
+          bool anyContactIsSus = false;
+          MissingGRFReason reason = MissingGRFReason::notMissingGRF;
+          for (int b = 0; b < init->grfBodyNodes.size(); b++)
+          {
+            // 4.1. Check the GRF to see if we are measured as being in contact
+            bool footActive
+                = (init->grfTrials[trial].col(t).segment<6>(b * 6).squaredNorm()
+                   > 1e-3);
+            forceActive(b, t) = footActive;
+
+            // 4.2. Check all the contact bodies assigned to this GRF node to
+            // guess if we think we might be in contact here
+            bool inContact = false;
+            bool anyInPlate = false;
+            for (int c = 0; c < init->contactBodies[b].size(); c++)
+            {
+              Eigen::Vector3s worldPos = contactPositions.block<3, 1>(
+                  (contactBodyOffsets[b] + c) * 3, t);
 
-    // 4. Determine foot-ground contact at each trial, and figure out which
-    // timesteps we think we're receiving force that isn't measured by a force
-    // plate.
+              // Check if this body is over a force plate
+              bool overPlate = false;
+              for (ForcePlate& plate : init->forcePlateTrials[trial])
+              {
+                if (plate.corners.size() > 0)
+                {
+                  if (math::convex2DShapeContains(
+                          worldPos,
+                          plate.corners,
+                          plate.worldOrigin,
+                          Eigen::Vector3s::UnitX(),
+                          Eigen::Vector3s::UnitZ()))
+                  {
+                    overPlate = true;
+                    break;
+                  }
+                }
+              }
+              if (defaultCorners.size() > 0)
+              {
+                if (math::convex2DShapeContains(
+                        worldPos,
+                        defaultCorners,
+                        defaultCorners[0],
+                        Eigen::Vector3s::UnitX(),
+                        Eigen::Vector3s::UnitZ()))
+                {
+                  overPlate = true;
+                }
+              }
 
-    std::vector<std::vector<Eigen::Vector3s>> sortedForcePlateCorners;
-    for (ForcePlate& plate : init->forcePlateTrials[trial])
-    {
-      if (plate.corners.size() > 0)
-      {
-        sortedForcePlateCorners.push_back(plate.corners);
-        math::prepareConvex2DShape(
-            sortedForcePlateCorners[sortedForcePlateCorners.size() - 1],
-            plate.corners[0],
-            Eigen::Vector3s::UnitX(),
-            Eigen::Vector3s::UnitZ());
-      }
-    }
-    if (init->defaultForcePlateCorners[trial].size() > 0)
-    {
-      math::prepareConvex2DShape(
-          init->defaultForcePlateCorners[trial],
-          init->defaultForcePlateCorners[trial][0],
-          Eigen::Vector3s::UnitX(),
-          Eigen::Vector3s::UnitZ());
-    }
+              if (overPlate)
+              {
+                anyInPlate = true;
+              }
 
-    std::vector<std::vector<bool>> trialForceActive;
-    std::vector<std::vector<bool>> trialSphereInContact;
-    std::vector<std::vector<bool>> trialOffForcePlate;
-    std::vector<bool> trialAnyOffForcePlate;
-    std::vector<MissingGRFReason> trialMissingGRFReason;
-    for (int t = 0; t < init->poseTrials[trial].cols(); t++)
-    {
-      mSkeleton->setPositions(init->poseTrials[trial].col(t));
-
-      std::vector<bool> forceActive;
-      std::vector<bool> sphereInContact;
-      std::vector<bool> offForcePlate;
-      bool anyContactIsSus = false;
-      MissingGRFReason reason = MissingGRFReason::notMissingGRF;
-      for (int b = 0; b < init->grfBodyNodes.size(); b++)
-      {
-        // 4.1. Check the GRF to see if we are measured as being in contact
-        bool footActive
-            = (init->grfTrials[trial].col(t).segment<6>(b * 6).squaredNorm()
-               > 1e-3);
-        forceActive.push_back(footActive);
-
-        // 4.2. Check all the contact bodies assigned to this GRF node to
-        // guess if we think we might be in contact here
-        bool inContact = false;
-        bool anyInPlate = false;
-        for (int c = 0; c < init->contactBodies[b].size(); c++)
-        {
-          auto* body = init->contactBodies[b][c];
-          Eigen::Vector3s worldPos = body->getWorldTransform().translation();
+              s_t dist = worldPos(1) - groundHeight;
+              if (!overPlate)
+              {
+                // If we're not over a force plate, use a more generous margin
+                // to detect foot-ground contact, since we almost certainly are
+                // missing data here, and we want to prioritize recall on those
+                // timesteps.
+                dist -= offForcePlateHeightSafetyMargin;
+              }
 
-          // Check if this body is over a force plate
-          bool overPlate = false;
-          for (ForcePlate& plate : init->forcePlateTrials[trial])
-          {
-            if (plate.corners.size() > 0)
-            {
-              if (math::convex2DShapeContains(
-                      worldPos,
-                      plate.corners,
-                      plate.worldOrigin,
-                      Eigen::Vector3s::UnitX(),
-                      Eigen::Vector3s::UnitZ()))
+              if (dist < grfContactSphereSizes[b][c])
               {
-                overPlate = true;
-                break;
+                inContact = true;
               }
             }
-          }
-          if (init->defaultForcePlateCorners[trial].size() > 0)
-          {
-            if (math::convex2DShapeContains(
-                    worldPos,
-                    init->defaultForcePlateCorners[trial],
-                    init->defaultForcePlateCorners[trial][0],
-                    Eigen::Vector3s::UnitX(),
-                    Eigen::Vector3s::UnitZ()))
+            sphereInContact(b, t) = inContact;
+
+            // 4.3. If we think from the collider heuristic that we might be in
+            // contact, but then we don't actually have any GRF, we need to be
+            // suspicious that this might be a contact outside a force plate,
+            // which would mean that our inverse dynamics should ignore these
+            // frames.
+            bool contactIsSus = false;
+            if (inContact && !footActive)
             {
-              overPlate = true;
+              // 4.3.2. If we're NOT over a plate, then register this frame as
+              // suspicious
+              if (!anyInPlate && !ignoreFootNotOverForcePlate)
+              {
+                contactIsSus = true;
+                anyContactIsSus = true;
+                reason = MissingGRFReason::notOverForcePlate;
+              }
             }
-          }
 
-          if (overPlate)
-          {
-            anyInPlate = true;
+            offForcePlate(b, t) = contactIsSus;
           }
-
-          s_t dist = worldPos(1) - groundHeight;
-          if (!overPlate)
+          if (anyContactIsSus)
           {
-            // If we're not over a force plate, use a more generous margin to
-            // detect foot-ground contact, since we almost certainly are
-            // missing data here, and we want to prioritize recall on those
-            // timesteps.
-            dist -= offForcePlateHeightSafetyMargin;
+            trialLog << "Marking trial " << trial << ", timestep " << t
+                << " as probably missing GRF, due to contact heuristic"
+                << std::endl;
           }
 
-          if (dist < grfContactSphereSizes[b][c])
-          {
-            inContact = true;
-          }
-        }
-        sphereInContact.push_back(inContact);
-
-        // 4.3. If we think from the collider heuristic that we might be in
-        // contact, but then we don't actually have any GRF, we need to be
-        // suspicious that this might be a contact outside a force plate,
-        // which would mean that our inverse dynamics should ignore these
-        // frames.
-        bool contactIsSus = false;
-        if (inContact && !footActive)
-        {
-          // 4.3.2. If we're NOT over a plate, then register this frame as
-          // suspicious
-          if (!anyInPlate && !ignoreFootNotOverForcePlate)
-          {
-            contactIsSus = true;
-            anyContactIsSus = true;
-            reason = MissingGRFReason::notOverForcePlate;
-          }
+          trialAnyOffForcePlate.push_back(anyContactIsSus);
+          trialMissingGRFReason.push_back(reason);
         }
 
-        offForcePlate.push_back(contactIsSus);
-      }
-      if (anyContactIsSus)
-      {
-        std::cout << "Marking trial " << trial << ", timestep " << t
-                  << " as probably missing GRF, due to contact heuristic"
-                  << std::endl;
-      }
-
-      trialForceActive.push_back(forceActive);
-      trialSphereInContact.push_back(sphereInContact);
-      trialOffForcePlate.push_back(offForcePlate);
-      trialAnyOffForcePlate.push_back(anyContactIsSus);
-      trialMissingGRFReason.push_back(reason);
-    }
-
-    init->grfBodyForceActive.push_back(trialForceActive);
-    init->grfBodySphereInContact.push_back(trialSphereInContact);
-    init->grfBodyOffForcePlate.push_back(trialOffForcePlate);
+        trialForceActives[trial] = forceActive;
+        trialSphereInContacts[trial] = sphereInContact;
+        trialOffForcePlates[trial] = offForcePlate;
+        trialDefaultCorners[trial] = defaultCorners;
 
-    if (init->probablyMissingGRF.size() < trial)
-    {
-      std::cout << "Error: probablyMissingGRF is missing trial " << trial
-                << std::endl;
-      throw std::runtime_error("probablyMissingGRF is missing frames");
-    }
-    if (init->probablyMissingGRF.at(trial).size()
-        < init->poseTrials[trial].cols())
-    {
-      std::cout << "Error: probablyMissingGRF manual initialization is missing "
-                   "frames for trial "
-                << trial << "! Got frames "
-                << init->probablyMissingGRF.at(trial).size()
-                << ", expected frames " << init->poseTrials[trial].cols()
-                << std::endl;
-      throw std::runtime_error("probablyMissingGRF is missing frames");
-    }
-    if (init->missingGRFReason.size() < trial)
-    {
-      std::cout << "Error: missingGRFReason is missing trial " << trial
-                << std::endl;
-      throw std::runtime_error("missingGRFReason is missing frames");
-    }
-    if (init->missingGRFReason.at(trial).size()
-        < init->poseTrials[trial].cols())
-    {
-      std::cout << "Error: missingGRFReason manual initialization is missing "
-                   "frames for trial "
-                << trial << "! Got frames "
-                << init->missingGRFReason.at(trial).size()
-                << ", expected frames " << init->poseTrials[trial].cols()
-                << std::endl;
-      throw std::runtime_error("missingGRFReason is missing frames");
-    }
-    for (int t = 0; t < init->probablyMissingGRF.at(trial).size(); t++)
-    {
-      if (init->probablyMissingGRF.at(trial).at(t) == MissingGRFStatus::unknown)
-      {
-        if (trialAnyOffForcePlate.at(t))
+        if (init->probablyMissingGRF.size() < trial)
         {
-          init->probablyMissingGRF.at(trial).at(t) = MissingGRFStatus::yes;
-          if (trialMissingGRFReason.at(t) != MissingGRFReason::notMissingGRF)
-          {
-            init->missingGRFReason.at(trial).at(t)
-                = trialMissingGRFReason.at(t);
-          }
-          else
+          std::cout << "Error: probablyMissingGRF is missing trial " << trial
+                    << std::endl;
+          throw std::runtime_error("probablyMissingGRF is missing frames");
+        }
+        if (init->probablyMissingGRF.at(trial).size()
+            < init->poseTrials[trial].cols())
+        {
+          std::cout
+              << "Error: probablyMissingGRF manual initialization is missing "
+                 "frames for trial "
+              << trial << "! Got frames "
+              << init->probablyMissingGRF.at(trial).size()
+              << ", expected frames " << init->poseTrials[trial].cols()
+              << std::endl;
+          throw std::runtime_error("probablyMissingGRF is missing frames");
+        }
+        if (init->missingGRFReason.size() < trial)
+        {
+          std::cout << "Error: missingGRFReason is missing trial " << trial
+                    << std::endl;
+          throw std::runtime_error("missingGRFReason is missing frames");
+        }
+        if (init->missingGRFReason.at(trial).size()
+            < init->poseTrials[trial].cols())
+        {
+          std::cout
+              << "Error: missingGRFReason manual initialization is missing "
+                 "frames for trial "
+              << trial << "! Got frames "
+              << init->missingGRFReason.at(trial).size()
+              << ", expected frames " << init->poseTrials[trial].cols()
+              << std::endl;
+          throw std::runtime_error("missingGRFReason is missing frames");
+        }
+        for (int t = 0; t < init->probablyMissingGRF.at(trial).size(); t++)
+        {
+          if (init->probablyMissingGRF.at(trial).at(t)
+              == MissingGRFStatus::unknown)
           {
-            // Ensure we do not mark a frame's reason for missing GRF as
-            // notMissingGRF if we are setting the missing status to yes
-            init->missingGRFReason.at(trial).at(t)
-                = MissingGRFReason::footContactDetectedButNoForce;
+            if (trialAnyOffForcePlate.at(t))
+            {
+              init->probablyMissingGRF.at(trial).at(t) = MissingGRFStatus::yes;
+              if (trialMissingGRFReason.at(t)
+                  != MissingGRFReason::notMissingGRF)
+              {
+                init->missingGRFReason.at(trial).at(t)
+                    = trialMissingGRFReason.at(t);
+              }
+              else
+              {
+                // Ensure we do not mark a frame's reason for missing GRF as
+                // notMissingGRF if we are setting the missing status to yes
+                init->missingGRFReason.at(trial).at(t)
+                    = MissingGRFReason::footContactDetectedButNoForce;
+              }
+            }
           }
         }
-      }
-    }
+      });
+
+  for (int trial = 0; trial < numTrials; trial++)
+  {
+    std::cout << trialLogs[trial].str();
+    init->grfBodyContactSphereRadius.push_back(trialContactSphereRadii[trial]);
+    init->defaultForcePlateCorners.push_back(trialDefaultCorners[trial]);
+    init->grfBodyForceActive.push_back(trialForceActives[trial]);
+    init->grfBodySphereInContact.push_back(trialSphereInContacts[trial]);
+    init->grfBodyOffForcePlate.push_back(trialOffForcePlates[trial]);
   }
 
   fillInMissingGRFBlips(init);
@@ -10687,8 +10911,8 @@ void DynamicsFitter::markMissingImpacts(
     bool alsoMarkLiftoff)
 {
   s_t eps = 1e-4;
-  for (int trial = 0; trial < init->poseTrials.size(); trial++)
-  {
+  // Each trial only touches its own frames, so we can do them all at once
+  forEachTrialInParallel(init->poseTrials.size(), [&](int trial) {
     bool lastInContact = true;
     for (int t = 0; t < init->poseTrials[trial].cols(); t++)
     {
@@ -10725,7 +10949,7 @@ void DynamicsFitter::markMissingImpacts(
       }
       lastInContact = inContact;
     }
-  }
+  });
 }
 
 //==============================================================================
@@ -10734,8 +10958,11 @@ void DynamicsFitter::markMissingImpacts(
 void DynamicsFitter::fillInMissingGRFBlips(
     std::shared_ptr<DynamicsInitialization> init, int blipFilterLen)
 {
-  for (int trial = 0; trial < init->forcePlateTrials.size(); trial++)
-  {
+  // Each trial only touches its own frames, so we can do them all at once,
+  // and print the log messages in order afterwards
+  const int numTrials = init->forcePlateTrials.size();
+  std::vector<std::stringstream> trialLogs(numTrials);
+  forEachTrialInParallel(numTrials, [&](int trial) {
     int firstMissing = -1;
     int lastMissing = -1;
     for (int t = 0; t < init->probablyMissingGRF.at(trial).size(); t++)
@@ -10819,7 +11046,7 @@ void DynamicsFitter::fillInMissingGRFBlips(
               if (init->probablyMissingGRF.at(trial).at(scanT)
                   == MissingGRFStatus::unknown)
               {
-                std::cout << "Filling in GRF blip on trial " << trial
+                trialLogs[trial] << "Filling in GRF blip on trial " << trial
                           << ", timestep " << scanT << std::endl;
                 init->probablyMissingGRF.at(trial).at(scanT)
                     = MissingGRFStatus::yes;
@@ -10831,6 +11058,10 @@ void DynamicsFitter::fillInMissingGRFBlips(
         }
       }
     }
+  });
+  for (int trial = 0; trial < numTrials; trial++)
+  {
+    std::cout << trialLogs[trial].str();
   }
   excludeTrialsWithTooManyMissingGRFs(init);
 }
@@ -12271,6 +12502,7 @@ void DynamicsFitter::multimassZeroLinearResidualsOnCOMTrajectory(
     s_t boundPush)
 {
   ResidualForceHelper helper(mSkeleton, init->grfBodyIndices);
+  helper.setNumThreads(mNumThreads);
 
   const s_t regularizeResiduals = 0.001;
   const s_t regularizeInverseMass = 10.0;
@@ -13701,6 +13933,7 @@ bool DynamicsFitter::optimizeSpatialResidualsOnCOMTrajectory(
 {
 
   ResidualForceHelper helper(mSkeleton, init->grfBodyIndices);
+  helper.setNumThreads(mNumThreads);
 
   mSkeleton->setTimeStep(init->trialTimesteps[trial]);
   mSkeleton->setGravity(Eigen::Vector3s(0, -9.81, 0));
@@ -14705,6 +14938,34 @@ void DynamicsFitter::recomputeGRFs(
   }
 }
 
+//==============================================================================
+// This returns the world positions of `bodies` at every frame of `poses`, as a
+// (3 * bodies.size()) x poses.cols() matrix
+Eigen::MatrixXs DynamicsFitter::computeBodyWorldPositions(
+    const Eigen::MatrixXs& poses,
+    const std::vector<dynamics::BodyNode*>& bodies,
+    std::shared_ptr<dynamics::Skeleton> skel)
+{
+  std::vector<dynamics::BodyNode*> skelBodies;
+  for (dynamics::BodyNode* body : bodies)
+  {
+    skelBodies.push_back(skel->getBodyNode(body->getName()));
+  }
+
+  Eigen::MatrixXs positions
+      = Eigen::MatrixXs::Zero(skelBodies.size() * 3, poses.cols());
+  for (int t = 0; t < poses.cols(); t++)
+  {
+    skel->setPositions(poses.col(t));
+    for (int i = 0; i < skelBodies.size(); i++)
+    {
+      positions.block<3, 1>(i * 3, t)
+          = skelBodies[i]->getWorldTransform().translation();
+    }
+  }
+  return positions;
+}
+
 //==============================================================================
 // 1. Shift the COM trajectory by a 3vec offset to minimize the amount of
 // remaining residual
@@ -14926,8 +15187,10 @@ void DynamicsFitter::optimizeRootTrajectory(
   problem.unflatten(problem.flatten());
   problem.mConfig.setIncludePoses(config.mIncludePoses);
 
+  // The trials (and blocks within them) are independent here, so we evaluate
+  // them in parallel across the problem's thread-local skeletons
   Eigen::VectorXs x = problem.flatten();
-  s_t lastLoss = problem.computeLoss(x);
+  s_t lastLoss = problem.computeLossParallel(x);
 
   Eigen::VectorXs lowerBounds = problem.flattenLowerBound();
   Eigen::VectorXs upperBounds = problem.flattenUpperBound();
@@ -14940,7 +15203,7 @@ void DynamicsFitter::optimizeRootTrajectory(
   for (int i = 0; i < iterationLimit; i++)
   {
     std::cout << "Step " << i << ": " << lastLoss << std::endl;
-    Eigen::VectorXs grad = problem.computeGradient(x);
+    Eigen::VectorXs grad = problem.computeGradientParallel(x);
 
     // Go through and zero out any gradient NOT related to the first 6 dofs
     int cursor = 0;
@@ -14966,7 +15229,7 @@ void DynamicsFitter::optimizeRootTrajectory(
           testX(i) = lowerBounds(i);
         }
       }
-      s_t testLoss = problem.computeLoss(testX, true);
+      s_t testLoss = problem.computeLossParallel(testX, true);
       if (testLoss < lastLoss)
       {
         x = testX;
@@ -15024,199 +15287,224 @@ void DynamicsFitter::optimizeRootTrajectory(
 void DynamicsFitter::zeroSpatialResidualsUsingForwardSim(
     std::shared_ptr<DynamicsInitialization> init, int resetEveryNSteps)
 {
-  const int dimsToLetFree = 6;
-
-  ResidualForceHelper helper(mSkeleton, init->grfBodyIndices);
+  // Each trial is its own independent forward simulation, so we can run them
+  // all at once on separate copies of the skeleton
+  std::vector<s_t> averageChanges(init->poseTrials.size(), 0.0);
+  computeTrialsInParallel(
+      init->poseTrials.size(),
+      [&](std::shared_ptr<dynamics::Skeleton> skel, int trial) {
+        averageChanges[trial] = zeroSpatialResidualsUsingForwardSimOnTrial(
+            init, skel, trial, resetEveryNSteps);
+      });
 
   for (int trial = 0; trial < init->poseTrials.size(); trial++)
   {
-    s_t dt = init->trialTimesteps[trial];
-    s_t totalChange = 0.0;
-    int numTimestepsChanged = 0;
+    std::cout << "Trial " << trial << " rotated root by an average of "
+              << averageChanges[trial]
+              << "radians to achieve rotational physical consistency."
+              << std::endl;
+  }
+}
 
-    /*
-  #ifndef NDEBUG
-    // In debug mode, check that we produced a reduced net moment
-    std::vector<Eigen::Vector3s> newCOMs = comPositions(init, trial);
-    Eigen::Vector3s newSumForceCrossR = Eigen::Vector3s::Zero();
-    for (int i = 0; i < forcePlates.size(); i++)
+//==============================================================================
+// This runs zeroSpatialResidualsUsingForwardSim() on a single trial, doing all
+// the dynamics on `skel`, and returns the average change in the root position
+// per timestep.
+s_t DynamicsFitter::zeroSpatialResidualsUsingForwardSimOnTrial(
+    std::shared_ptr<DynamicsInitialization> init,
+    std::shared_ptr<dynamics::Skeleton> skel,
+    int trial,
+    int resetEveryNSteps)
+{
+  const int dimsToLetFree = 6;
+
+  ResidualForceHelper helper(skel, init->grfBodyIndices);
+
+  s_t dt = init->trialTimesteps[trial];
+  s_t totalChange = 0.0;
+  int numTimestepsChanged = 0;
+
+  /*
+#ifndef NDEBUG
+  // In debug mode, check that we produced a reduced net moment
+  std::vector<Eigen::Vector3s> newCOMs = comPositions(init, trial);
+  Eigen::Vector3s newSumForceCrossR = Eigen::Vector3s::Zero();
+  for (int i = 0; i < forcePlates.size(); i++)
+  {
+    for (int t = 0; t < forcePlates[i].forces.size(); t++)
     {
-      for (int t = 0; t < forcePlates[i].forces.size(); t++)
-      {
-        Eigen::Vector3s f = forcePlates[i].forces[t];
-        Eigen::Vector3s p = forcePlates[i].centersOfPressure[t];
-        Eigen::Vector3s m = forcePlates[i].moments[t];
-        Eigen::Vector3s r = newCOMs[t] - p;
-        newSumForceCrossR += f.cross(r) + m;
-      }
+      Eigen::Vector3s f = forcePlates[i].forces[t];
+      Eigen::Vector3s p = forcePlates[i].centersOfPressure[t];
+      Eigen::Vector3s m = forcePlates[i].moments[t];
+      Eigen::Vector3s r = newCOMs[t] - p;
+      newSumForceCrossR += f.cross(r) + m;
     }
+  }
 
-    Eigen::MatrixXs compare(3, 2);
-    compare.col(0) = sumForceCrossR;
-    compare.col(1) = newSumForceCrossR;
-    std::cout << "Original f x r - Adjusted f x r" << std::endl
-              << compare << std::endl;
-    // We need to guarantee that it didn't get any worse
-    assert(newSumForceCrossR.norm() <= sumForceCrossR.norm());
-  #endif
-    */
+  Eigen::MatrixXs compare(3, 2);
+  compare.col(0) = sumForceCrossR;
+  compare.col(1) = newSumForceCrossR;
+  std::cout << "Original f x r - Adjusted f x r" << std::endl
+            << compare << std::endl;
+  // We need to guarantee that it didn't get any worse
+  assert(newSumForceCrossR.norm() <= sumForceCrossR.norm());
+#endif
+  */
 
-    Eigen::MatrixXs originalPoses = init->poseTrials[trial];
+  Eigen::MatrixXs originalPoses = init->poseTrials[trial];
 
-    // 2. For each timestep, go through and "re-simulate" the angular root.
-    for (int t = 1; t < init->poseTrials[trial].cols() - 1; t++)
+  // 2. For each timestep, go through and "re-simulate" the angular root.
+  for (int t = 1; t < init->poseTrials[trial].cols() - 1; t++)
+  {
+    if (resetEveryNSteps > 0
+        && (t % resetEveryNSteps == 0 || (t - 1) % resetEveryNSteps == 0))
     {
-      if (resetEveryNSteps > 0
-          && (t % resetEveryNSteps == 0 || (t - 1) % resetEveryNSteps == 0))
-      {
-        continue;
-      }
-      // 2.1. First, finite difference out current q,dq,ddq:
-      Eigen::VectorXs q = init->poseTrials[trial].col(t);
-      Eigen::VectorXs dq = (init->poseTrials[trial].col(t)
-                            - init->poseTrials[trial].col(t - 1))
-                           / dt;
-      Eigen::VectorXs ddq = (init->poseTrials[trial].col(t + 1)
-                             - 2 * init->poseTrials[trial].col(t)
-                             + init->poseTrials[trial].col(t - 1))
-                            / (dt * dt);
-
-      if (init->probablyMissingGRF.size() > trial
-          && init->probablyMissingGRF[trial][t] == yes)
-      {
-        // 2.2. If we're missing GRF data, skip this timestep
-        // TODO: maybe cap the allowable root forces anyways, to preserve
-        // smoothness?
-      }
-      else
-      {
-        // 2.2. Calculate inverse dynamics to get necessary torques
-        mSkeleton->setPositions(q);
-        mSkeleton->setVelocities(dq);
-        mSkeleton->setAccelerations(ddq);
+      continue;
+    }
+    // 2.1. First, finite difference out current q,dq,ddq:
+    Eigen::VectorXs q = init->poseTrials[trial].col(t);
+    Eigen::VectorXs dq = (init->poseTrials[trial].col(t)
+                          - init->poseTrials[trial].col(t - 1))
+                         / dt;
+    Eigen::VectorXs ddq = (init->poseTrials[trial].col(t + 1)
+                           - 2 * init->poseTrials[trial].col(t)
+                           + init->poseTrials[trial].col(t - 1))
+                          / (dt * dt);
 
+    if (init->probablyMissingGRF.size() > trial
+        && init->probablyMissingGRF[trial][t] == yes)
+    {
+      // 2.2. If we're missing GRF data, skip this timestep
+      // TODO: maybe cap the allowable root forces anyways, to preserve
+      // smoothness?
+    }
+    else
+    {
+      // 2.2. Calculate inverse dynamics to get necessary torques
 #ifndef NDEBUG
-        Eigen::VectorXs originalTau = helper.calculateInverseDynamics(
-            q, dq, ddq, init->grfTrials[trial].col(t));
+      Eigen::VectorXs originalTau = helper.calculateInverseDynamics(
+          q, dq, ddq, init->grfTrials[trial].col(t));
 #endif
 
-        Eigen::Vector6s solve = helper.calculateResidualFreeRootAcceleration(
-            q, dq, ddq, init->grfTrials[trial].col(t));
+      Eigen::Vector6s solve
+          = helper.calculateResidualFreeRootAccelerationWithoutMassMatrix(
+              q, dq, ddq, init->grfTrials[trial].col(t));
 
 #ifndef NDEBUG
-        Eigen::MatrixXs M = mSkeleton->getMassMatrix();
-        Eigen::VectorXs tailDdq = ddq;
-        tailDdq.head(dimsToLetFree).setZero();
-        Eigen::VectorXs tailTauContribution = M * tailDdq;
-        Eigen::VectorXs C = mSkeleton->getCoriolisAndGravityForces();
-        Eigen::VectorXs Fs = helper.calculateContactForceTaus(
-            q, init->grfTrials[trial].col(t));
-        Eigen::VectorXs solve2
-            = -M.block(0, 0, dimsToLetFree, dimsToLetFree)
-                   .completeOrthogonalDecomposition()
-                   .solve(
-                       tailTauContribution.head(dimsToLetFree)
-                       + C.head(dimsToLetFree) - Fs.head(dimsToLetFree));
-        Eigen::Vector6s diff = solve - solve2;
-        if (diff.norm() > 1e-12)
-        {
-          std::cout << "Diff: " << std::endl << diff << std::endl;
-          assert(diff.norm() < 1e-12);
-        }
+      skel->setPositions(q);
+      skel->setVelocities(dq);
+      skel->setAccelerations(ddq);
+      Eigen::MatrixXs M = skel->getMassMatrix();
+      Eigen::VectorXs tailDdq = ddq;
+      tailDdq.head(dimsToLetFree).setZero();
+      Eigen::VectorXs tailTauContribution = M * tailDdq;
+      Eigen::VectorXs C = skel->getCoriolisAndGravityForces();
+      Eigen::VectorXs Fs = helper.calculateContactForceTaus(
+          q, init->grfTrials[trial].col(t));
+      Eigen::VectorXs solve2
+          = -M.block(0, 0, dimsToLetFree, dimsToLetFree)
+                 .completeOrthogonalDecomposition()
+                 .solve(
+                     tailTauContribution.head(dimsToLetFree)
+                     + C.head(dimsToLetFree) - Fs.head(dimsToLetFree));
+      Eigen::Vector6s diff = solve - solve2;
+      // `solve` never forms the full mass matrix, so it only agrees with
+      // `solve2` up to round-off
+      if (diff.norm() > 1e-8 * (1.0 + solve2.norm()))
+      {
+        std::cout << "Diff: " << std::endl << diff << std::endl;
+        assert(diff.norm() < 1e-8 * (1.0 + solve2.norm()));
+      }
 #endif
 
 #ifndef NDEBUG
-        Eigen::VectorXs originalDdq = ddq;
+      Eigen::VectorXs originalDdq = ddq;
 #endif
-        // 2.5. We only want to change the acceleration at this timestep, so
-        // we overwrite the next timestep's position, and nothing else.
-        ddq.head(dimsToLetFree) = solve;
-        Eigen::VectorXs nextDq = dq + dt * ddq;
-        Eigen::VectorXs nextQ = q + dt * nextDq;
+      // 2.5. We only want to change the acceleration at this timestep, so
+      // we overwrite the next timestep's position, and nothing else.
+      ddq.head(dimsToLetFree) = solve;
+      Eigen::VectorXs nextDq = dq + dt * ddq;
+      Eigen::VectorXs nextQ = q + dt * nextDq;
 
-        Eigen::VectorXs change
-            = (nextQ.head(dimsToLetFree)
-               - init->poseTrials[trial].col(t + 1).head(dimsToLetFree));
-        totalChange += change.norm();
-        numTimestepsChanged++;
+      Eigen::VectorXs change
+          = (nextQ.head(dimsToLetFree)
+             - init->poseTrials[trial].col(t + 1).head(dimsToLetFree));
+      totalChange += change.norm();
+      numTimestepsChanged++;
 
-        init->poseTrials[trial].col(t + 1).head(dimsToLetFree)
-            = nextQ.head(dimsToLetFree);
+      init->poseTrials[trial].col(t + 1).head(dimsToLetFree)
+          = nextQ.head(dimsToLetFree);
 
 #ifndef NDEBUG
-        // 3. As an idiot check, and only in debug mode, we'll recompute
-        // inverse dynamics to check that the rotational residuals are in fact
-        // gone.
-        Eigen::VectorXs updatedDq = (init->poseTrials[trial].col(t)
-                                     - init->poseTrials[trial].col(t - 1))
-                                    / dt;
-        assert(updatedDq == dq);
-        Eigen::VectorXs updatedDdq = (init->poseTrials[trial].col(t + 1)
-                                      - 2 * init->poseTrials[trial].col(t)
-                                      + init->poseTrials[trial].col(t - 1))
-                                     / (dt * dt);
-        if ((updatedDdq - ddq).norm() > 1e-8)
-        {
-          std::cout << "Did not get the acceleration we expected from our "
-                       "position change."
-                    << std::endl;
-          Eigen::MatrixXs compare(ddq.size(), 4);
-          compare.col(0) = ddq;
-          compare.col(1) = updatedDdq;
-          compare.col(2) = ddq - updatedDdq;
-          compare.col(3) = originalDdq;
-          std::cout << "Desired - Achieved - Diff - Original" << std::endl
-                    << compare << std::endl;
-          assert(false);
-        }
+      // 3. As an idiot check, and only in debug mode, we'll recompute
+      // inverse dynamics to check that the rotational residuals are in fact
+      // gone.
+      Eigen::VectorXs updatedDq = (init->poseTrials[trial].col(t)
+                                   - init->poseTrials[trial].col(t - 1))
+                                  / dt;
+      assert(updatedDq == dq);
+      Eigen::VectorXs updatedDdq = (init->poseTrials[trial].col(t + 1)
+                                    - 2 * init->poseTrials[trial].col(t)
+                                    + init->poseTrials[trial].col(t - 1))
+                                   / (dt * dt);
+      if ((updatedDdq - ddq).norm() > 1e-8)
+      {
+        std::cout << "Did not get the acceleration we expected from our "
+                     "position change."
+                  << std::endl;
+        Eigen::MatrixXs compare(ddq.size(), 4);
+        compare.col(0) = ddq;
+        compare.col(1) = updatedDdq;
+        compare.col(2) = ddq - updatedDdq;
+        compare.col(3) = originalDdq;
+        std::cout << "Desired - Achieved - Diff - Original" << std::endl
+                  << compare << std::endl;
+        assert(false);
+      }
 
-        Eigen::VectorXs newTau = helper.calculateInverseDynamics(
-            q, updatedDq, updatedDdq, init->grfTrials[trial].col(t));
-        if (newTau.head(dimsToLetFree).norm() > 1e-8)
-        {
-          std::cout
-              << "Timestep " << t
-              << " rotational procedure did not zero out rotational torques!"
-              << std::endl;
-          Eigen::MatrixXs compareAcc(dimsToLetFree, 2);
-          compareAcc.col(0) = originalDdq.head(dimsToLetFree);
-          compareAcc.col(1) = updatedDdq.head(dimsToLetFree);
-          std::cout << "Original acc - New acc:" << std::endl
-                    << compareAcc << std::endl;
-          Eigen::MatrixXs compareTau(dimsToLetFree, 2);
-          compareTau.col(0) = originalTau.head(dimsToLetFree);
-          compareTau.col(1) = newTau.head(dimsToLetFree);
-          std::cout << "Original tau - New tau" << std::endl
-                    << compareTau << std::endl;
-          assert(false);
-        }
-#endif
+      Eigen::VectorXs newTau = helper.calculateInverseDynamics(
+          q, updatedDq, updatedDdq, init->grfTrials[trial].col(t));
+      if (newTau.head(dimsToLetFree).norm() > 1e-8)
+      {
+        std::cout
+            << "Timestep " << t
+            << " rotational procedure did not zero out rotational torques!"
+            << std::endl;
+        Eigen::MatrixXs compareAcc(dimsToLetFree, 2);
+        compareAcc.col(0) = originalDdq.head(dimsToLetFree);
+        compareAcc.col(1) = updatedDdq.head(dimsToLetFree);
+        std::cout << "Original acc - New acc:" << std::endl
+                  << compareAcc << std::endl;
+        Eigen::MatrixXs compareTau(dimsToLetFree, 2);
+        compareTau.col(0) = originalTau.head(dimsToLetFree);
+        compareTau.col(1) = newTau.head(dimsToLetFree);
+        std::cout << "Original tau - New tau" << std::endl
+                  << compareTau << std::endl;
+        assert(false);
       }
+#endif
     }
+  }
 
-    std::cout << "Trial " << trial << " rotated root by an average of "
-              << (totalChange / numTimestepsChanged)
-              << "radians to achieve rotational physical consistency."
-              << std::endl;
+  // s_t avgChange = totalChange / numTimestepsChanged;
+  // if (capChangeNorm > 0 && avgChange > capChangeNorm)
+  // {
+  //   s_t scaleChange = capChangeNorm / avgChange;
+  //   std::cout << "Scaling angular changes by " << scaleChange * 100
+  //             << "%, to keep average change within the cap of "
+  //             << capChangeNorm << "." << std::endl;
+  //   for (int t = 0; t < init->poseTrials[trial].cols(); t++)
+  //   {
+  //     Eigen::VectorXs change
+  //         = init->poseTrials[trial].col(t).head(dimsToLetFree)
+  //           - originalPoses.col(t).head(dimsToLetFree);
+  //     init->poseTrials[trial].col(t).head(dimsToLetFree)
+  //         = originalPoses.col(t).head(dimsToLetFree) + change *
+  //         scaleChange;
+  //   }
+  // }
 
-    // s_t avgChange = totalChange / numTimestepsChanged;
-    // if (capChangeNorm > 0 && avgChange > capChangeNorm)
-    // {
-    //   s_t scaleChange = capChangeNorm / avgChange;
-    //   std::cout << "Scaling angular changes by " << scaleChange * 100
-    //             << "%, to keep average change within the cap of "
-    //             << capChangeNorm << "." << std::endl;
-    //   for (int t = 0; t < init->poseTrials[trial].cols(); t++)
-    //   {
-    //     Eigen::VectorXs change
-    //         = init->poseTrials[trial].col(t).head(dimsToLetFree)
-    //           - originalPoses.col(t).head(dimsToLetFree);
-    //     init->poseTrials[trial].col(t).head(dimsToLetFree)
-    //         = originalPoses.col(t).head(dimsToLetFree) + change *
-    //         scaleChange;
-    //   }
-    // }
-  }
+  return totalChange / numTimestepsChanged;
 }
 
 //==============================================================================
@@ -16451,9 +16739,9 @@ void DynamicsFitter::computePerfectGRFs(
 
       int activeFootIndex = -1;
       bool onlyOneActive = false;
-      for (int i = 0; i < init->grfBodyForceActive[trial][t].size(); i++)
+      for (int i = 0; i < init->grfBodyForceActive[trial].rows(); i++)
       {
-        bool active = init->grfBodyForceActive[trial][t][i];
+        bool active = init->grfBodyForceActive[trial](i, t);
         if (active)
         {
           if (activeFootIndex == -1)
@@ -16953,8 +17241,8 @@ void DynamicsFitter::writeCSVData(
     csvFile << "," << init->missingGRFReason[trial][t];
     for (int i = 0; i < mFootNodes.size(); i++)
     {
-      csvFile << "," << init->grfBodyForceActive[trial][t][i]
-          || init->grfBodySphereInContact[trial][t][i];
+      csvFile << "," << init->grfBodyForceActive[trial](i, t)
+          || init->grfBodySphereInContact[trial](i, t);
     }
     writeVectorToCSV(csvFile, footContactData);
 
@@ -17997,7 +18285,7 @@ void DynamicsFitter::saveDynamicsToGUI(
           "contact_sphere_" + std::to_string(i) + "_" + std::to_string(j),
           init->grfBodyContactSphereRadius[trialIndex][i][j],
           Eigen::Vector3s::Zero(),
-          init->grfBodyOffForcePlate[trialIndex][0][i]
+          init->grfBodyOffForcePlate[trialIndex](i, 0)
               ? groundContactActiveColor
               : groundContactLayerColor,
           groundContactLayerName);
@@ -18470,7 +18758,7 @@ void DynamicsFitter::saveDynamicsToGUI(
             init->contactBodies[i][j]->getWorldTransform().translation());
         if (init->probablyMissingGRF[trialIndex][timestep] == yes)
         {
-          if (init->grfBodyOffForcePlate[trialIndex][timestep][i])
+          if (init->grfBodyOffForcePlate[trialIndex](i, timestep))
           {
             server.setObjectColor(
                 "contact_sphere_" + std::to_string(i) + "_" + std::to_string(j),
@@ -18485,7 +18773,7 @@ void DynamicsFitter::saveDynamicsToGUI(
         }
         else
         {
-          if (init->grfBodyOffForcePlate[trialIndex][timestep][i])
+          if (init->grfBodyOffForcePlate[trialIndex](i, timestep))
           {
             server.setObjectColor(
                 "contact_sphere_" + std::to_string(i) + "_" + std::to_string(j),
@@ -18848,5 +19136,95 @@ void DynamicsFitter::setDisableLinesearch(bool disable)
   mDisableLinesearch = disable;
 }
 
+//==============================================================================
+void DynamicsFitter::setNumThreads(int numThreads)
+{
+  mNumThreads = numThreads;
+}
+
+//==============================================================================
+// This calls `computeTrial(skel, trial)` once for every trial, splitting the
+// trials across mNumThreads threads.
+void DynamicsFitter::computeTrialsInParallel(
+    int numTrials,
+    std::function<void(std::shared_ptr<dynamics::Skeleton>, int)> computeTrial)
+{
+  int numThreads = std::max(1, std::min(mNumThreads, numTrials));
+
+  // Only clone as many skeletons as we have threads, and keep them around for
+  // the next call. Earlier stages may have changed the scales and masses on
+  // mSkeleton, so bring the clones up to date.
+  while (mTrialThreadSkeletons.size() < numThreads)
+  {
+    mTrialThreadSkeletons.push_back(mSkeleton->cloneSkeleton());
+  }
+  const Eigen::VectorXs bodyScales = mSkeleton->getBodyScales();
+  const Eigen::VectorXs linkMasses = mSkeleton->getLinkMasses();
+  const Eigen::VectorXs linkCOMs = mSkeleton->getLinkCOMs();
+  const Eigen::VectorXs linkMOIs = mSkeleton->getLinkMOIs();
+  for (int threadIdx = 0; threadIdx < numThreads; threadIdx++)
+  {
+    std::shared_ptr<dynamics::Skeleton> skel = mTrialThreadSkeletons[threadIdx];
+    skel->setBodyScales(bodyScales);
+    skel->setLinkMasses(linkMasses);
+    skel->setLinkCOMs(linkCOMs);
+    skel->setLinkMOIs(linkMOIs);
+    skel->setGravity(mSkeleton->getGravity());
+    skel->setTimeStep(mSkeleton->getTimeStep());
+  }
+
+  std::vector<std::future<void>> futures;
+  for (int threadIdx = 0; threadIdx < numThreads; threadIdx++)
+  {
+    std::shared_ptr<dynamics::Skeleton> skel = mTrialThreadSkeletons[threadIdx];
+    futures.push_back(std::async(
+        std::launch::async,
+        [skel, threadIdx, numThreads, numTrials, &computeTrial] {
+          for (int trial = threadIdx; trial < numTrials; trial += numThreads)
+          {
+            computeTrial(skel, trial);
+          }
+        }));
+  }
+  for (auto& future : futures)
+  {
+    future.get();
+  }
+}
+
+//==============================================================================
+// This calls `computeTrial(trial)` once for every trial, splitting the trials
+// across mNumThreads threads.
+void DynamicsFitter::forEachTrialInParallel(
+    int numTrials, std::function<void(int)> computeTrial)
+{
+  int numThreads = std::max(1, std::min(mNumThreads, numTrials));
+  if (numThreads == 1)
+  {
+    for (int trial = 0; trial < numTrials; trial++)
+    {
+      computeTrial(trial);
+    }
+    return;
+  }
+
+  std::vector<std::future<void>> futures;
+  for (int threadIdx = 0; threadIdx < numThreads; threadIdx++)
+  {
+    futures.push_back(std::async(
+        std::launch::async,
+        [threadIdx, numThreads, numTrials, &computeTrial] {
+          for (int trial = threadIdx; trial < numTrials; trial += numThreads)
+          {
+            computeTrial(trial);
+          }
+        }));
+  }
+  for (auto& future : futures)
+  {
+    future.get();
+  }
+}
+
 } // namespace biomechanics
 } // namespace dart
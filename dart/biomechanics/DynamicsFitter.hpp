@@ -1,6 +1,7 @@
 #ifndef DART_BIOMECH_DYNAMICS_FITTER_HPP_
 #define DART_BIOMECH_DYNAMICS_FITTER_HPP_
 
+#include <functional>
 #include <memory>
 #include <tuple>
 #include <vector>
@@ -263,6 +264,16 @@ public:
       Eigen::VectorXs ddq,
       Eigen::VectorXs forcesConcat);
 
+  ////////////////////////////////////////////
+  // This computes the same thing as calculateResidualFreeRootAcceleration(),
+  // but without forming the full mass matrix, which makes it much cheaper for
+  // skeletons with many DOFs.
+  Eigen::Vector6s calculateResidualFreeRootAccelerationWithoutMassMatrix(
+      Eigen::VectorXs q,
+      Eigen::VectorXs dq,
+      Eigen::VectorXs ddq,
+      Eigen::VectorXs forcesConcat);
+
   ////////////////////////////////////////////
   // This computes the angular acceleration we would need at the root in order
   // to keep everything else the same, and end up with zero residuals at the
@@ -681,10 +692,23 @@ public:
 
   int getExpectedForcesDim();
 
+  ////////////////////////////////////////////
+  // This sets how many threads the trajectory-level linear systems split
+  // their timesteps across. The skeleton clones for those threads are kept
+  // around and reused between calls.
+  void setNumThreads(int numThreads);
+
 protected:
+  ////////////////////////////////////////////
+  // This makes sure there are at least `numThreads` clones of the skeleton
+  // (and helpers built on them), with the same body scales and masses as
+  // mSkel.
+  void ensureThreadSkels(int numThreads);
+
   std::shared_ptr<dynamics::Skeleton> mSkel;
   std::vector<int> mForceBodies;
   std::vector<neural::DifferentiableExternalForce> mForces;
+  int mNumThreads;
 
   std::vector<std::shared_ptr<dynamics::Skeleton>> mThreadSkels;
   std::vector<ResidualForceHelper> mThreadHelpers;
@@ -818,10 +842,12 @@ struct DynamicsInitialization
   // Foot ground contact, and rendering
   std::vector<std::vector<dynamics::BodyNode*>> contactBodies;
   std::vector<std::vector<std::vector<s_t>>> grfBodyContactSphereRadius;
-  std::vector<std::vector<std::vector<bool>>> grfBodyForceActive;
-  std::vector<std::vector<std::vector<bool>>> grfBodySphereInContact;
+  // These contact flags have one row per GRF body and one column per
+  // timestep, like `grfTrials`
+  std::vector<Eigen::MatrixXb> grfBodyForceActive;
+  std::vector<Eigen::MatrixXb> grfBodySphereInContact;
   std::vector<std::vector<Eigen::Vector3s>> defaultForcePlateCorners;
-  std::vector<std::vector<std::vector<bool>>> grfBodyOffForcePlate;
+  std::vector<Eigen::MatrixXb> grfBodyOffForcePlate;
   // This is the critical value, telling us if we think we're receiving support
   // from off a force plate on this frame
   std::vector<std::vector<MissingGRFStatus>> probablyMissingGRF;
@@ -938,6 +964,12 @@ public:
 
   DynamicsFitProblemConfig& setNumThreads(int value);
 
+  // This checks every gradient evaluation along `numDirections` random
+  // directions with math::checkGradientAlongRandomDirections(), and logs any
+  // error above `tolerance`. Pass 0 to turn it off.
+  DynamicsFitProblemConfig& setRandomDerivativeCheck(
+      int numDirections, s_t tolerance = 1e-4);
+
 public:
   friend class DynamicsFitProblem;
   friend class DynamicsFitter;
@@ -990,6 +1022,9 @@ public:
   int mMaxNumBlocksPerTrial;
 
   int mNumThreads;
+
+  int mDerivativeCheckDirections;
+  s_t mDerivativeCheckTolerance;
 };
 
 /**
@@ -1034,6 +1069,16 @@ public:
       std::shared_ptr<DynamicsInitialization> init,
       DynamicsFitProblemConfig config);
 
+  // This sorts the blocks so that threads claim the most expensive blocks
+  // first, which keeps one long block from being picked up last and holding up
+  // the whole evaluation. The cost of a block is how long it took to evaluate
+  // last time, or its length if it has not been evaluated yet.
+  void sortBlocksByCost();
+
+  // This prints how much of the last parallel evaluation each thread spent
+  // busy, as a fraction of the wall time of the whole evaluation.
+  void logThreadUtilization();
+
   // This returns the dimension of the decision variables (the length of the
   // flatten() vector), which depends on which variables we choose to include in
   // the optimization problem.
@@ -1049,23 +1094,26 @@ public:
   Eigen::VectorXs flattenLowerBound();
 
   // This reads the problem state out of a flat vector, and into the init object
-  void unflatten(Eigen::VectorXs x);
+  void unflatten(const Eigen::Ref<const Eigen::VectorXs>& x);
 
   // This gets the value of the loss function, as a weighted sum of the
   // discrepancy between measured and expected GRF data and other regularization
   // terms.
-  s_t computeLoss(Eigen::VectorXs x, bool logExplanation = false);
+  s_t computeLoss(
+      const Eigen::Ref<const Eigen::VectorXs>& x, bool logExplanation = false);
 
   // This gets the value of the loss function, as a weighted sum of the
   // discrepancy between measured and expected GRF data and other regularization
   // terms.
-  s_t computeLossParallel(Eigen::VectorXs x, bool logExplanation = false);
+  s_t computeLossParallel(
+      const Eigen::Ref<const Eigen::VectorXs>& x, bool logExplanation = false);
 
   // This gets the gradient of the loss function
-  Eigen::VectorXs computeGradient(Eigen::VectorXs x);
+  Eigen::VectorXs computeGradient(const Eigen::Ref<const Eigen::VectorXs>& x);
 
   // This gets the gradient of the loss function
-  Eigen::VectorXs computeGradientParallel(Eigen::VectorXs x);
+  Eigen::VectorXs computeGradientParallel(
+      const Eigen::Ref<const Eigen::VectorXs>& x);
 
   // This gets the gradient of the loss function
   Eigen::VectorXs finiteDifferenceGradient(
@@ -1078,7 +1126,8 @@ public:
   // active when we're including positions in the decision variables, and they
   // just enforce that finite differencing is valid to relate velocity,
   // acceleration, and position.
-  Eigen::VectorXs computeConstraints(Eigen::VectorXs x);
+  Eigen::VectorXs computeConstraints(
+      const Eigen::Ref<const Eigen::VectorXs>& x);
 
   // Gets a vector of upper bounds for the constraints. To have a constrant be
   // equal to 0, just set both upper and lower bounds to 0.
@@ -1225,6 +1274,14 @@ public:
   DynamicsFitProblemConfig mConfig;
 
   std::vector<struct DynamicsFitProblemBlock> mBlocks;
+  // This is the order threads claim blocks in, and the time (in seconds) it
+  // took to evaluate each block in the last parallel loss or gradient
+  std::vector<int> mBlockOrder;
+  std::vector<double> mBlockCosts;
+  // This is how long each thread was busy in the last parallel evaluation, and
+  // how long that evaluation took overall
+  std::vector<double> mThreadBusyTimes;
+  double mLastParallelWallTime;
 
   std::vector<std::string> mMarkerNames;
   std::vector<bool> mMarkerIsTracking;
@@ -1558,6 +1615,14 @@ public:
       std::shared_ptr<dynamics::Skeleton> skel,
       s_t forcePlateZeroThresholdNewtons = 3.0);
 
+  // This returns the world positions of `bodies` at every frame of `poses`, as
+  // a (3 * bodies.size()) x poses.cols() matrix. The bodies are looked up by
+  // name on `skel`, so they can belong to a different copy of the skeleton.
+  static Eigen::MatrixXs computeBodyWorldPositions(
+      const Eigen::MatrixXs& poses,
+      const std::vector<dynamics::BodyNode*>& bodies,
+      std::shared_ptr<dynamics::Skeleton> skel);
+
   // 1. Shift the COM trajectory by a 3vec offset to minimize the amount of
   // remaining residual
   void centerAngularResiduals(std::shared_ptr<DynamicsInitialization> init);
@@ -1572,6 +1637,15 @@ public:
   void zeroSpatialResidualsUsingForwardSim(
       std::shared_ptr<DynamicsInitialization> init, int resetEveryNSteps = -1);
 
+  // This runs zeroSpatialResidualsUsingForwardSim() on a single trial, doing
+  // all the dynamics on `skel`, and returns the average change in the root
+  // position per timestep.
+  s_t zeroSpatialResidualsUsingForwardSimOnTrial(
+      std::shared_ptr<DynamicsInitialization> init,
+      std::shared_ptr<dynamics::Skeleton> skel,
+      int trial,
+      int resetEveryNSteps = -1);
+
   bool verifyLinearForceConsistency(
       std::shared_ptr<DynamicsInitialization> init);
 
@@ -1763,8 +1837,24 @@ public:
   void setPrintFrequency(int freq);
   void setSilenceOutput(bool silent);
   void setDisableLinesearch(bool disable);
+  void setNumThreads(int numThreads);
 
 protected:
+  // This calls `computeTrial(skel, trial)` once for every trial, splitting the
+  // trials across mNumThreads threads. Each thread gets its own clone of
+  // mSkeleton, so mSkeleton itself is not modified. The clones are kept
+  // between calls, and synced to the current scales and masses of mSkeleton
+  // before each call.
+  void computeTrialsInParallel(
+      int numTrials,
+      std::function<void(std::shared_ptr<dynamics::Skeleton>, int)>
+          computeTrial);
+
+  // This is the same as computeTrialsInParallel(), for work that doesn't need
+  // a skeleton. `computeTrial` must only touch data for its own trial.
+  void forEachTrialInParallel(
+      int numTrials, std::function<void(int)> computeTrial);
+
   std::shared_ptr<dynamics::Skeleton> mSkeleton;
   std::vector<dynamics::BodyNode*> mFootNodes;
   std::vector<std::string> mTrackingMarkers;
@@ -1780,6 +1870,10 @@ protected:
   int mPrintFrequency;
   bool mSilenceOutput;
   bool mDisableLinesearch;
+  int mNumThreads;
+  // These are the clones of mSkeleton that computeTrialsInParallel() hands
+  // out, one per thread
+  std::vector<std::shared_ptr<dynamics::Skeleton>> mTrialThreadSkeletons;
 };
 
 }; // namespace biomechanics
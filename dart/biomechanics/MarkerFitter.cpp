@@ -1,5 +1,6 @@
 #include "dart/biomechanics/MarkerFitter.hpp"
 
+#include <algorithm>
 #include <fstream>
 #include <future>
 #include <iostream>
@@ -7,7 +8,9 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <random>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -19,6 +22,7 @@
 #include "dart/biomechanics/MarkerFixer.hpp"
 #include "dart/biomechanics/OpenSimParser.hpp"
 #include "dart/biomechanics/macros.hpp"
+#include "dart/common/Console.hpp"
 #include "dart/dynamics/BodyNode.hpp"
 #include "dart/dynamics/DegreeOfFreedom.hpp"
 #include "dart/dynamics/Joint.hpp"
@@ -108,14 +112,10 @@ MarkerFitterState::MarkerFitterState(
 
   // Read marker offsets
 
-  markerOffsets
-      = Eigen::Matrix<s_t, 3, Eigen::Dynamic>::Zero(3, markerOrder.size());
+  markerOffsets = Eigen::Map<const Eigen::Matrix<s_t, 3, Eigen::Dynamic>>(
+      flat.data() + groupScaleDim, 3, markerOrder.size());
   markerOffsetsGrad
       = Eigen::Matrix<s_t, 3, Eigen::Dynamic>::Zero(3, markerOrder.size());
-  for (int i = 0; i < markerOrder.size(); i++)
-  {
-    markerOffsets.col(i) = flat.segment<3>(groupScaleDim + i * 3);
-  }
 
   // Read poses and marker errors
 
@@ -134,8 +134,12 @@ MarkerFitterState::MarkerFitterState(
     markerMap[fitter->mMarkerNames[i]] = markers[i];
   }
 
-  posesAtTimesteps = Eigen::MatrixXs::Zero(
-      skeleton->getNumDofs(), markerObservations.size());
+  // The poses are laid out in the flat vector exactly like a column-major
+  // (dofs x timesteps) matrix, so we can copy them in one go
+  posesAtTimesteps = Eigen::Map<const Eigen::MatrixXs>(
+      flat.data() + groupScaleDim + markerOffsetDim,
+      skeleton->getNumDofs(),
+      markerObservations.size());
   posesAtTimestepsGrad = Eigen::MatrixXs::Zero(
       skeleton->getNumDofs(), markerObservations.size());
 
@@ -156,14 +160,9 @@ MarkerFitterState::MarkerFitterState(
 
   for (int i = 0; i < markerObservations.size(); i++)
   {
-    Eigen::VectorXs pos = flat.segment(
-        groupScaleDim + markerOffsetDim + (skeleton->getNumDofs() * i),
-        skeleton->getNumDofs());
-    posesAtTimesteps.col(i) = pos;
-
     // Compute marker errors at each timestep
 
-    skeleton->setPositions(pos);
+    skeleton->setPositions(posesAtTimesteps.col(i));
     std::map<std::string, Eigen::Vector3s> currentMarkerPoses
         = skeleton->getMarkerMapWorldPositions(markerMap);
     std::map<std::string, Eigen::Vector3s> desiredMarkerPoses
@@ -228,8 +227,9 @@ MarkerFitterState::MarkerFitterState(
 }
 
 //==============================================================================
-/// This returns a single flat vector representing this whole problem state
-Eigen::VectorXs MarkerFitterState::flattenState()
+/// This is the length of the flat vectors written by flattenState() and
+/// flattenGradient()
+int MarkerFitterState::getFlatSize()
 {
   // group scale
   int groupScaleDim = skeleton->getGroupScaleDim();
@@ -240,8 +240,29 @@ Eigen::VectorXs MarkerFitterState::flattenState()
   // the root position for the static calibration pose
   int staticRootDim = 6;
 
-  Eigen::VectorXs flat = Eigen::VectorXs::Zero(
-      groupScaleDim + markerOffsetDim + posesDim + staticRootDim);
+  return groupScaleDim + markerOffsetDim + posesDim + staticRootDim;
+}
+
+//==============================================================================
+/// This returns a single flat vector representing this whole problem state
+Eigen::VectorXs MarkerFitterState::flattenState()
+{
+  Eigen::VectorXs flat(getFlatSize());
+  flattenState(flat);
+  return flat;
+}
+
+//==============================================================================
+/// This writes the whole problem state into `flat`, which must already be the
+/// right size
+void MarkerFitterState::flattenState(Eigen::Ref<Eigen::VectorXs> flat)
+{
+  assert(flat.size() == getFlatSize());
+
+  // group scale
+  int groupScaleDim = skeleton->getGroupScaleDim();
+  // marker offsets
+  int markerOffsetDim = markerOrder.size() * 3;
 
   // Collapse body scales into group scales
 
@@ -255,20 +276,17 @@ Eigen::VectorXs MarkerFitterState::flattenState()
 
   // Write marker offsets
 
-  for (int i = 0; i < markerOrder.size(); i++)
-  {
-    flat.segment<3>(groupScaleDim + i * 3) = markerOffsets.col(i);
-  }
+  Eigen::Map<Eigen::Matrix<s_t, 3, Eigen::Dynamic>>(
+      flat.data() + groupScaleDim, 3, markerOrder.size())
+      = markerOffsets;
 
   // Write poses
 
-  for (int i = 0; i < posesAtTimesteps.cols(); i++)
-  {
-    flat.segment(
-        groupScaleDim + markerOffsetDim + (skeleton->getNumDofs() * i),
-        skeleton->getNumDofs())
-        = posesAtTimesteps.col(i);
-  }
+  Eigen::Map<Eigen::MatrixXs>(
+      flat.data() + groupScaleDim + markerOffsetDim,
+      skeleton->getNumDofs(),
+      posesAtTimesteps.cols())
+      = posesAtTimesteps;
 
   // Write the static calibration pose root position
 
@@ -276,8 +294,6 @@ Eigen::VectorXs MarkerFitterState::flattenState()
       groupScaleDim + markerOffsetDim
       + (skeleton->getNumDofs() * posesAtTimesteps.cols()))
       = staticPoseRoot;
-
-  return flat;
 }
 
 //==============================================================================
@@ -285,20 +301,25 @@ Eigen::VectorXs MarkerFitterState::flattenState()
 /// problem state
 Eigen::VectorXs MarkerFitterState::flattenGradient()
 {
+  Eigen::VectorXs grad(getFlatSize());
+  flattenGradient(grad);
+  return grad;
+}
+
+//==============================================================================
+/// This writes the gradient of the whole problem state into `grad`, which must
+/// already be the right size
+void MarkerFitterState::flattenGradient(Eigen::Ref<Eigen::VectorXs> grad)
+{
+  assert(grad.size() == getFlatSize());
+
   // group scale
   int groupScaleDim = skeleton->getGroupScaleDim();
   // marker offsets
   int markerOffsetDim = markerOrder.size() * 3;
-  // poses
-  int posesDim = skeleton->getNumDofs() * posesAtTimesteps.cols();
-  // the root position for the static calibration pose
-  int staticRootDim = 6;
 
   // 1. Write scale grad
 
-  Eigen::VectorXs grad = Eigen::VectorXs::Zero(
-      groupScaleDim + markerOffsetDim + posesDim + staticRootDim);
-
   std::map<std::string, Eigen::Vector3s> bodyScalesGradMap;
   for (int i = 0; i < skeleton->getNumBodyNodes(); i++)
   {
@@ -310,20 +331,17 @@ Eigen::VectorXs MarkerFitterState::flattenGradient()
 
   // 2. Write marker offsets grad
 
-  for (int i = 0; i < markerOrder.size(); i++)
-  {
-    grad.segment<3>(groupScaleDim + (i * 3)) = markerOffsetsGrad.col(i);
-  }
+  Eigen::Map<Eigen::Matrix<s_t, 3, Eigen::Dynamic>>(
+      grad.data() + groupScaleDim, 3, markerOrder.size())
+      = markerOffsetsGrad;
 
   // 3. Write poses grad
 
-  for (int i = 0; i < posesAtTimesteps.cols(); i++)
-  {
-    grad.segment(
-        groupScaleDim + markerOffsetDim + (skeleton->getNumDofs() * i),
-        skeleton->getNumDofs())
-        = posesAtTimestepsGrad.col(i);
-  }
+  Eigen::Map<Eigen::MatrixXs>(
+      grad.data() + groupScaleDim + markerOffsetDim,
+      skeleton->getNumDofs(),
+      posesAtTimesteps.cols())
+      = posesAtTimestepsGrad;
 
   // 4. Incorporate marker and joint error grads
 
@@ -337,12 +355,8 @@ Eigen::VectorXs MarkerFitterState::flattenGradient()
     skeleton->getBodyNode(i)->setScale(bodyScales.col(i));
   }
   Eigen::VectorXs groupScales = skeleton->getGroupScales();
-  Eigen::VectorXs markerOffsetsFlat
-      = Eigen::VectorXs::Zero(markerOrder.size() * 3);
-  for (int i = 0; i < markerOrder.size(); i++)
-  {
-    markerOffsetsFlat.segment<3>(i * 3) = markerOffsets.col(i);
-  }
+  Eigen::VectorXs markerOffsetsFlat = Eigen::Map<const Eigen::VectorXs>(
+      markerOffsets.data(), markerOffsets.size());
   Eigen::VectorXs firstPose = posesAtTimesteps.col(0);
 
   std::vector<std::pair<dynamics::BodyNode*, Eigen::Vector3s>> markers
@@ -354,8 +368,7 @@ Eigen::VectorXs MarkerFitterState::flattenGradient()
   for (int i = 0; i < markerObservations.size(); i++)
   {
     int offset = groupScaleDim + markerOffsetDim + (i * skeleton->getNumDofs());
-    Eigen::VectorXs pose = posesAtTimesteps.col(i);
-    skeleton->setPositions(pose);
+    skeleton->setPositions(posesAtTimesteps.col(i));
 
     Eigen::VectorXs markerErrorGrad
         = Eigen::VectorXs::Zero(markerOrder.size() * 3);
@@ -382,7 +395,7 @@ Eigen::VectorXs MarkerFitterState::flattenGradient()
         += fitter->getMarkerLossGradientWrtGroupScales(
             skeleton, markers, markerErrorGrad);
     grad.segment(0, groupScaleDim)
-        += skeleton->getJointWorldPositionsJacobianWrtGroupScales(joints)
+        += skeleton->getJointWorldPositionsSparseJacobianWrtGroupScales(joints)
                .transpose()
            * combinedJointGrad;
 
@@ -402,8 +415,6 @@ Eigen::VectorXs MarkerFitterState::flattenGradient()
       groupScaleDim + markerOffsetDim
       + (skeleton->getNumDofs() * posesAtTimesteps.cols()))
       = staticPoseRootGrad;
-
-  return grad;
 }
 
 //==============================================================================
@@ -630,7 +641,16 @@ MarkerFitter::MarkerFitter(
     mJointSphereFitSGDIterations(5000),
     mJointAxisFitSGDIterations(10000),
     mCheckDerivatives(false),
+    mDerivativeCheckDirections(0),
+    mDerivativeCheckTolerance(1e-4),
     mUseParallelIKWarps(false),
+    mUseWarmStartIK(false),
+    mWarmStartIKRestartLoss(0.01),
+    mWarmStartIKMaxRestarts(3),
+    mWarmStartIKNumChunks(16),
+    mUseSlidingWindowIK(false),
+    mSlidingWindowIKSize(1000),
+    mSlidingWindowIKOverlap(100),
     mPrintFrequency(1),
     mSilenceOutput(false),
     mDisableLinesearch(false),
@@ -965,7 +985,7 @@ MarkerFitter::MarkerFitter(
       // 7.4.1. Body scales
       Eigen::VectorXs bodyScalesGradVector
           = this->mSkeleton
-                ->getMarkerWorldPositionsJacobianWrtBodyScales(
+                ->getMarkerWorldPositionsSparseJacobianWrtBodyScales(
                     staticTrialMarkers)
                 .transpose()
             * staticMarkerErrorGrad;
@@ -1294,81 +1314,118 @@ bool MarkerFitter::checkForFlippedMarkers(
   // half of Scott Uhlrich's OpenCap trials the foot markers are on one side of
   // the foot, and in the other half of the trials the foot markers are flipped.
 
-  Eigen::VectorXs originalPose = mSkeleton->getPositions();
-  Eigen::VectorXs originalScales = mSkeleton->getGroupScales();
-  std::map<std::string, std::map<std::string, s_t>> totalDistances;
-  std::map<std::string, std::map<std::string, int>> totalObservations;
-  for (std::string& marker : observedMarkers)
-  {
-    totalDistances[marker] = std::map<std::string, s_t>();
-    totalObservations[marker] = std::map<std::string, int>();
-    for (std::string& innerMarker : observedMarkers)
-    {
-      if (!totalDistances.count(marker))
+  const int numMarkers = observedMarkers.size();
+  std::map<std::string, int> observedMarkerIndex;
+  for (int k = 0; k < numMarkers; k++)
+  {
+    observedMarkerIndex[observedMarkers[k]] = k;
+  }
+
+  if (init.poses.cols() != markerObservations.size())
+  {
+    dtwarn << "MarkerFitter::checkForFlippedMarkers() got "
+           << init.poses.cols() << " poses but " << markerObservations.size()
+           << " frames of marker observations. Only the first "
+           << std::min((int)init.poses.cols(), (int)markerObservations.size())
+           << " frames will be checked.\n";
+  }
+  const int numFrames
+      = std::min((int)init.poses.cols(), (int)markerObservations.size());
+
+  // Sum up the distance from every predicted marker to every observed marker
+  // over the whole clip. The frames are split into contiguous blocks that run
+  // in parallel, each on its own skeleton clone, and each block keeps dense
+  // sums indexed by position in `observedMarkers`.
+  const int minFramesPerThread = 50;
+  const int numThreads = std::max(
+      1,
+      std::min(
+          (int)std::thread::hardware_concurrency(),
+          numFrames / minFramesPerThread));
+  const int blockSize = (numFrames + numThreads - 1) / numThreads;
+  std::vector<Eigen::MatrixXs> blockDistances(
+      numThreads, Eigen::MatrixXs::Zero(numMarkers, numMarkers));
+  std::vector<Eigen::MatrixXi> blockObservations(
+      numThreads, Eigen::MatrixXi::Zero(numMarkers, numMarkers));
+  std::vector<std::future<void>> blockFutures;
+  for (int block = 0; block < numThreads; block++)
+  {
+    const int start = block * blockSize;
+    const int end = std::min(numFrames, start + blockSize);
+    std::shared_ptr<dynamics::Skeleton> threadSkel = mSkeleton->cloneSkeleton();
+    blockFutures.push_back(std::async([&, block, start, end, threadSkel]() {
+      threadSkel->setGroupScales(init.groupScales);
+
+      // Only the markers we observe somewhere in the clip get counted
+      std::vector<std::pair<dynamics::BodyNode*, Eigen::Vector3s>>
+          predictedMarkers;
+      std::vector<int> predictedIndices;
+      for (auto& pair :
+           threadSkel->convertMarkerMap(init.updatedMarkerMap, false))
       {
-        std::cout << "init: totalDistances doesn'contain " << marker
-                  << std::endl;
+        if (observedMarkerIndex.count(pair.first))
+        {
+          predictedMarkers.push_back(pair.second);
+          predictedIndices.push_back(observedMarkerIndex.at(pair.first));
+        }
       }
-      totalDistances.at(marker)[innerMarker] = 0.0;
-      totalObservations.at(marker)[innerMarker] = 0;
-    }
-  }
 
-  mSkeleton->setGroupScales(init.groupScales);
-  for (int i = 0; i < init.poses.cols(); i++)
-  {
-    mSkeleton->setPositions(init.poses.col(i));
-    std::map<std::string, Eigen::Vector3s> markerPos
-        = mSkeleton->getMarkerMapWorldPositions(init.updatedMarkerMap);
-    if (markerObservations.size() > i)
-    {
-      for (auto& pair : markerPos)
+      Eigen::Matrix<s_t, 3, Eigen::Dynamic> observed(3, numMarkers);
+      std::vector<int> observedIndices;
+      for (int i = start; i < end; i++)
       {
-        if (std::find(
-                observedMarkers.begin(), observedMarkers.end(), pair.first)
-            == observedMarkers.end())
+        threadSkel->setPositions(init.poses.col(i));
+        Eigen::VectorXs predicted
+            = threadSkel->getMarkerWorldPositions(predictedMarkers);
+
+        observedIndices.clear();
+        for (auto& pair : markerObservations.at(i))
         {
-          // Skip any markers that are not in the `observedMarkers` list
-          continue;
+          observed.col(observedIndices.size()) = pair.second;
+          observedIndices.push_back(observedMarkerIndex.at(pair.first));
         }
-        for (auto& innerPair : markerObservations.at(i))
-        {
-          if (!totalDistances.count(pair.first))
-          {
-            std::cout << "counting: totalDistances doesn't contain "
-                      << pair.first << std::endl;
-          }
-          else if (!totalDistances.at(pair.first).count(innerPair.first))
-          {
-            std::cout << "counting: totalDistances[" << pair.first
-                      << "] doesn'contain " << innerPair.first << std::endl;
-          }
-          totalDistances.at(pair.first).at(innerPair.first)
-              += (pair.second - innerPair.second).norm();
+        const int numObserved = observedIndices.size();
 
-          if (!totalObservations.count(pair.first))
-          {
-            std::cout << "counting: totalObservations doesn'contain "
-                      << pair.first << std::endl;
-          }
-          else if (!totalObservations.at(pair.first).count(innerPair.first))
+        for (int k = 0; k < predictedMarkers.size(); k++)
+        {
+          Eigen::Matrix<s_t, 1, Eigen::Dynamic> dists
+              = (observed.leftCols(numObserved).colwise()
+                 - predicted.segment<3>(k * 3))
+                    .colwise()
+                    .norm();
+          for (int o = 0; o < numObserved; o++)
           {
-            std::cout << "counting: totalObservations[" << pair.first
-                      << "] doesn'contain " << innerPair.first << std::endl;
+            blockDistances[block](predictedIndices[k], observedIndices[o])
+                += dists(o);
+            blockObservations[block](predictedIndices[k], observedIndices[o])++;
           }
-          totalObservations.at(pair.first).at(innerPair.first)++;
         }
       }
-    }
-    else
+    }));
+  }
+
+  Eigen::MatrixXs distanceSums = Eigen::MatrixXs::Zero(numMarkers, numMarkers);
+  Eigen::MatrixXi observationCounts
+      = Eigen::MatrixXi::Zero(numMarkers, numMarkers);
+  for (int block = 0; block < numThreads; block++)
+  {
+    blockFutures[block].get();
+    distanceSums += blockDistances[block];
+    observationCounts += blockObservations[block];
+  }
+
+  std::map<std::string, std::map<std::string, s_t>> totalDistances;
+  std::map<std::string, std::map<std::string, int>> totalObservations;
+  for (int k = 0; k < numMarkers; k++)
+  {
+    for (int o = 0; o < numMarkers; o++)
     {
-      std::cout << "i = " << i
-                << ", markerObservations.size() = " << markerObservations.size()
-                << std::endl;
+      totalDistances[observedMarkers[k]][observedMarkers[o]]
+          = distanceSums(k, o);
+      totalObservations[observedMarkers[k]][observedMarkers[o]]
+          = observationCounts(k, o);
     }
   }
-  mSkeleton->setPositions(originalPose);
-  mSkeleton->setGroupScales(originalScales);
 
   std::map<std::string, std::string> closestMarkers;
   for (std::string& marker : observedMarkers)
@@ -2944,12 +3001,6 @@ void MarkerFitter::autorotateC3D(C3D* c3d)
               << std::endl;
     return;
   }
-  std::vector<bool> newClip;
-  for (int i = 0; i < c3d->markerTimesteps.size(); i++)
-  {
-    newClip.push_back(false);
-  }
-
   std::vector<Eigen::Matrix3s> rotationsToTry;
   rotationsToTry.push_back(Eigen::Matrix3s::Identity());
   // People generally just can't agree on which axis means "up", Y or Z
@@ -2958,13 +3009,11 @@ void MarkerFitter::autorotateC3D(C3D* c3d)
   rotationsToTry.push_back(
       math::eulerXYZToMatrix(Eigen::Vector3s(M_PI / 2, 0, 0)));
 
-  s_t smallestMag = std::numeric_limits<double>::infinity();
-  Eigen::Matrix3s smallestMagR = Eigen::Matrix3s::Identity();
-
-  for (Eigen::Matrix3s& R : rotationsToTry)
-  {
+  // This runs IK on every `stride` frames of the rotated data, and returns the
+  // average magnitude of the root rotation.
+  auto scoreRotation = [&](const Eigen::Matrix3s& R, int stride) {
     std::vector<std::map<std::string, Eigen::Vector3s>> markerTimesteps;
-    for (int i = 0; i < c3d->markerTimesteps.size(); i++)
+    for (int i = 0; i < c3d->markerTimesteps.size(); i += stride)
     {
       std::map<std::string, Eigen::Vector3s> rotatedMarkers;
       for (auto& pair : c3d->markerTimesteps[i])
@@ -2973,6 +3022,7 @@ void MarkerFitter::autorotateC3D(C3D* c3d)
       }
       markerTimesteps.push_back(rotatedMarkers);
     }
+    std::vector<bool> newClip(markerTimesteps.size(), false);
 
     MarkerInitialization init = getInitialization(
         markerTimesteps,
@@ -2991,11 +3041,60 @@ void MarkerFitter::autorotateC3D(C3D* c3d)
     }
     avgMag /= init.poses.cols();
     mSkeleton->setPositions(originalPose);
+    return avgMag;
+  };
+
+  // Each candidate already runs its IK across threads inside
+  // getInitialization(), which isn't safe to run concurrently on one fitter,
+  // so the candidates are scored one at a time. To keep that cheap on long
+  // trials, we first score every candidate on a subsample of the frames. If
+  // one candidate beats the rest by a clear margin we stop there, and
+  // otherwise we rescore only the candidates that are still in contention on
+  // every frame.
+  const int coarseFrames = 200;
+  const s_t dominanceMargin = 0.5;
+  const int coarseStride
+      = std::max(1, (int)c3d->markerTimesteps.size() / coarseFrames);
+
+  std::vector<s_t> scores;
+  for (Eigen::Matrix3s& R : rotationsToTry)
+  {
+    scores.push_back(scoreRotation(R, coarseStride));
+  }
+  s_t bestScore = *std::min_element(scores.begin(), scores.end());
 
-    if (avgMag < smallestMag)
+  if (coarseStride > 1)
+  {
+    std::vector<int> contenders;
+    for (int r = 0; r < rotationsToTry.size(); r++)
+    {
+      if (scores[r] < bestScore + dominanceMargin)
+      {
+        contenders.push_back(r);
+      }
+    }
+    if (contenders.size() > 1)
+    {
+      for (int r = 0; r < rotationsToTry.size(); r++)
+      {
+        scores[r] = std::numeric_limits<s_t>::infinity();
+      }
+      for (int r : contenders)
+      {
+        scores[r] = scoreRotation(rotationsToTry[r], 1);
+      }
+    }
+  }
+
+  // Ties go to the earliest candidate, which puts the identity first
+  s_t smallestMag = std::numeric_limits<s_t>::infinity();
+  Eigen::Matrix3s smallestMagR = Eigen::Matrix3s::Identity();
+  for (int r = 0; r < rotationsToTry.size(); r++)
+  {
+    if (scores[r] < smallestMag)
     {
-      smallestMag = avgMag;
-      smallestMagR = R;
+      smallestMag = scores[r];
+      smallestMagR = rotationsToTry[r];
     }
   }
 
@@ -3584,6 +3683,131 @@ MarkerInitialization MarkerFitter::fineTuneIK(
     anatomicalMarkerNames.push_back(mMarkerNames[j]);
   }
 
+  if (mUseSlidingWindowIK)
+  {
+    assert(initialization.groupScales.size() > 0);
+    result.groupScales = initialization.groupScales;
+    result.poses = Eigen::MatrixXs::Zero(
+        mSkeleton->getNumDofs(), markerObservations.size());
+    result.poseScores = Eigen::VectorXs::Zero(markerObservations.size());
+
+    std::vector<std::pair<int, int>> windows = getSlidingWindows(
+        markerObservations.size(),
+        mSlidingWindowIKSize,
+        mSlidingWindowIKOverlap);
+    // Only keep a bounded number of windows in flight, so that the copies of
+    // the observations and the results for each window don't scale with the
+    // length of the trial.
+    const int maxInFlight
+        = std::max(1, (int)std::thread::hardware_concurrency());
+
+    for (int batchStart = 0; batchStart < windows.size();
+         batchStart += maxInFlight)
+    {
+      const int batchEnd
+          = std::min((int)windows.size(), batchStart + maxInFlight);
+      std::vector<Eigen::MatrixXs> windowPoses;
+      std::vector<Eigen::VectorXs> windowScores;
+      for (int w = batchStart; w < batchEnd; w++)
+      {
+        windowPoses.push_back(
+            Eigen::MatrixXs::Zero(mSkeleton->getNumDofs(), windows[w].second));
+        windowScores.push_back(Eigen::VectorXs::Zero(windows[w].second));
+      }
+
+      std::vector<std::future<void>> windowFitFutures;
+      for (int w = batchStart; w < batchEnd; w++)
+      {
+        const int start = windows[w].first;
+        const int size = windows[w].second;
+
+        std::vector<std::map<std::string, Eigen::Vector3s>> windowObservations;
+        std::vector<Eigen::VectorXs> windowJointCenters;
+        std::vector<Eigen::VectorXs> windowJointAxis;
+        for (int i = start; i < start + size; i++)
+        {
+          windowObservations.emplace_back();
+          for (std::string& marker : anatomicalMarkerNames)
+          {
+            if (markerObservations[i].count(marker) > 0)
+            {
+              windowObservations.back().emplace(
+                  marker, markerObservations[i].at(marker));
+            }
+          }
+          if (initialization.jointCenters.cols() > i)
+          {
+            windowJointCenters.emplace_back(initialization.jointCenters.col(i));
+          }
+          else
+          {
+            windowJointCenters.emplace_back(Eigen::VectorXs::Zero(0));
+          }
+          if (initialization.jointAxis.cols() > i)
+          {
+            windowJointAxis.emplace_back(initialization.jointAxis.col(i));
+          }
+          else
+          {
+            windowJointAxis.emplace_back(Eigen::VectorXs::Zero(0));
+          }
+        }
+
+        // Each window starts from the initialization, rather than from the
+        // end of the window before it, so that the windows are independent.
+        Eigen::VectorXs firstGuessPose = start < initialization.poses.cols()
+                                             ? initialization.poses.col(start)
+                                             : mSkeleton->getPositions();
+
+        std::cout << "Starting fit for window " << w << "/" << windows.size()
+                  << std::endl;
+
+        windowFitFutures.push_back(std::async(
+            &MarkerFitter::fitTrajectory,
+            this,
+            result.groupScales,
+            firstGuessPose,
+            windowObservations,
+            markerWeights,
+            initialization.markerOffsets,
+            initialization.joints,
+            windowJointCenters,
+            initialization.jointWeights,
+            windowJointAxis,
+            initialization.axisWeights,
+            result.observedJoints,
+            windowPoses[w - batchStart].block(
+                0, 0, mSkeleton->getNumDofs(), size),
+            windowScores[w - batchStart].segment(0, size),
+            false));
+      }
+
+      for (int w = batchStart; w < batchEnd; w++)
+      {
+        windowFitFutures[w - batchStart].get();
+        const int start = windows[w].first;
+        const int overlap
+            = w == 0 ? 0
+                     : windows[w - 1].first + windows[w - 1].second - start;
+        blendSlidingWindow(
+            result.poses,
+            windowPoses[w - batchStart],
+            start,
+            overlap,
+            mSkeleton);
+        blendSlidingWindow(
+            result.poseScores.transpose(),
+            windowScores[w - batchStart].transpose(),
+            start,
+            overlap);
+        std::cout << "Finished fit for window " << w << "/" << windows.size()
+                  << std::endl;
+      }
+    }
+
+    return result;
+  }
+
   // 1. Divide the marker observations into N sequential blocks.
   std::vector<std::vector<std::map<std::string, Eigen::Vector3s>>> blocks;
   std::vector<Eigen::VectorXs> firstGuessPoses;
@@ -3866,9 +4090,54 @@ MarkerInitialization MarkerFitter::smoothOutIK(
               << trialStarts.size() << std::endl;
     int start = trialStarts[i];
     int size = trialSizes[i];
-    AccelerationSmoother smoother(size, 1.0, 0.001);
-    smoother.smooth(
-        smoothed.poses.block(0, start, smoothed.poses.rows(), size));
+    if (mUseSlidingWindowIK)
+    {
+      // Smooth overlapping windows in parallel, a bounded number at a time, so
+      // that we never factor a problem the length of the whole trial.
+      std::vector<std::pair<int, int>> windows = getSlidingWindows(
+          size, mSlidingWindowIKSize, mSlidingWindowIKOverlap);
+      const int maxInFlight
+          = std::max(1, (int)std::thread::hardware_concurrency());
+      // Later batches blend into columns that earlier batches already wrote,
+      // so every window reads from the unsmoothed poses instead.
+      const Eigen::MatrixXs unsmoothed
+          = smoothed.poses.block(0, start, smoothed.poses.rows(), size);
+      for (int batchStart = 0; batchStart < windows.size();
+           batchStart += maxInFlight)
+      {
+        const int batchEnd
+            = std::min((int)windows.size(), batchStart + maxInFlight);
+        std::vector<std::future<Eigen::MatrixXs>> smoothFutures;
+        for (int w = batchStart; w < batchEnd; w++)
+        {
+          Eigen::MatrixXs window = unsmoothed.block(
+              0, windows[w].first, unsmoothed.rows(), windows[w].second);
+          smoothFutures.push_back(std::async([window]() {
+            AccelerationSmoother smoother(window.cols(), 1.0, 0.001);
+            return smoother.smooth(window);
+          }));
+        }
+        for (int w = batchStart; w < batchEnd; w++)
+        {
+          const int overlap = w == 0 ? 0
+                                     : windows[w - 1].first
+                                           + windows[w - 1].second
+                                           - windows[w].first;
+          blendSlidingWindow(
+              smoothed.poses.block(0, start, smoothed.poses.rows(), size),
+              smoothFutures[w - batchStart].get(),
+              windows[w].first,
+              overlap,
+              mSkeleton);
+        }
+      }
+    }
+    else
+    {
+      AccelerationSmoother smoother(size, 1.0, 0.001);
+      smoother.smooth(
+          smoothed.poses.block(0, start, smoothed.poses.rows(), size));
+    }
   }
 
   return smoothed;
@@ -6329,7 +6598,145 @@ void MarkerFitter::fitTrajectory(
     assert(result.rows() == skeleton->getNumDofs());
     assert(result.cols() == markerObservations.size());
 
-    if (fitter->mUseParallelIKWarps)
+    if (fitter->mUseWarmStartIK)
+    {
+      // 2. Split the trajectory into contiguous chunks, and run through each
+      // chunk in sequence on its own thread. Each timestep starts from the
+      // previous solution, extrapolated at constant velocity. Chunks after
+      // the first don't have a previous solution, so they start with a cold
+      // solve.
+      const int numTimesteps = markerObservations.size();
+      // Chunks shorter than this spend more time on their cold solve than
+      // they save by running in parallel
+      const int minChunkLen = 20;
+      const int numChunks = std::max(
+          1,
+          std::min(fitter->mWarmStartIKNumChunks, numTimesteps / minChunkLen));
+
+      // Make copies of the skeletons for each chunk, since each chunk will be
+      // re-posing them in parallel with the others
+      std::vector<std::shared_ptr<dynamics::Skeleton>> threadSkeleton;
+      std::vector<std::shared_ptr<dynamics::Skeleton>> threadSkeletonBallJoints;
+      for (int chunk = 0; chunk < numChunks; chunk++)
+      {
+        threadSkeleton.push_back(skeleton->cloneSkeleton());
+        threadSkeletonBallJoints.push_back(skeletonBallJoints->cloneSkeleton());
+      }
+
+      std::vector<std::future<void>> chunkFutures;
+      for (int chunk = 0; chunk < numChunks; chunk++)
+      {
+        const int chunkStart = (chunk * numTimesteps) / numChunks;
+        const int chunkEnd = ((chunk + 1) * numTimesteps) / numChunks;
+        chunkFutures.push_back(std::async([chunk,
+                                           chunkStart,
+                                           chunkEnd,
+                                           numTimesteps,
+                                           backwards,
+                                           fitter,
+                                           &threadSkeleton,
+                                           &threadSkeletonBallJoints,
+                                           &observedJoints,
+                                           &joints,
+                                           &markerObservations,
+                                           &markerWeights,
+                                           &markerOffsets,
+                                           &jointCenters,
+                                           &jointWeights,
+                                           &jointAxis,
+                                           &axisWeights,
+                                           &initialGuess,
+                                           &result,
+                                           &resultScores] {
+          // 2.0. Grab the skeleton copies for this chunk
+          std::shared_ptr<dynamics::Skeleton> skeleton = threadSkeleton[chunk];
+          std::shared_ptr<dynamics::Skeleton> skeletonBallJoints
+              = threadSkeletonBallJoints[chunk];
+          std::vector<dynamics::Joint*> chunkObservedJoints;
+          for (auto joint : observedJoints)
+          {
+            chunkObservedJoints.push_back(
+                skeleton->getJoint(joint->getName()));
+          }
+          std::vector<dynamics::Joint*> jointsForSkeletonBallJoints;
+          for (auto joint : joints)
+          {
+            jointsForSkeletonBallJoints.push_back(
+                skeletonBallJoints->getJoint(joint->getName()));
+          }
+
+          // Each chunk draws its random restarts from its own generator, so
+          // that the results don't depend on how the threads get scheduled
+          std::mt19937 restartGenerator(chunk);
+
+          Eigen::VectorXs lastPos = Eigen::VectorXs::Zero(0);
+          Eigen::VectorXs lastLastPos = Eigen::VectorXs::Zero(0);
+          for (int j = chunkStart; j < chunkEnd; j++)
+          {
+            int i = j;
+            if (backwards)
+            {
+              i = numTimesteps - 1 - j;
+            }
+
+            Eigen::VectorXs guess = initialGuess;
+            Eigen::VectorXs fallbackGuess = Eigen::VectorXs::Zero(0);
+            int maxRestarts = fitter->mInitialIKMaxRestarts;
+            s_t restartLoss = fitter->mInitialIKSatisfactoryLoss;
+            if (lastPos.size() > 0)
+            {
+              guess = lastPos;
+              if (lastLastPos.size() > 0)
+              {
+                guess += lastPos - lastLastPos;
+                fallbackGuess = lastPos;
+              }
+              maxRestarts = fitter->mWarmStartIKMaxRestarts;
+              restartLoss = fitter->mWarmStartIKRestartLoss;
+            }
+            else if (chunk == 0)
+            {
+              // The first chunk starts at firstPoseGuess, just like the
+              // sequential fit, so there's no need for a cold solve
+              maxRestarts = 1;
+            }
+
+            s_t finalLoss = fitTrajectoryTimestep(
+                fitter,
+                skeleton,
+                skeletonBallJoints,
+                chunkObservedJoints,
+                joints,
+                jointsForSkeletonBallJoints,
+                markerObservations[i],
+                markerWeights,
+                markerOffsets,
+                jointCenters[i],
+                jointWeights,
+                jointAxis[i],
+                axisWeights,
+                guess,
+                fallbackGuess,
+                maxRestarts,
+                restartLoss,
+                &restartGenerator);
+
+            // 2.1. Record this outcome
+            result.col(i) = skeleton->getPositions();
+            resultScores(i) = finalLoss;
+
+            // 2.2. Set up for the next timestep
+            lastLastPos = lastPos;
+            lastPos = skeletonBallJoints->getPositions();
+          }
+        }));
+      }
+      for (auto& chunkFuture : chunkFutures)
+      {
+        chunkFuture.get();
+      }
+    }
+    else if (fitter->mUseParallelIKWarps)
     {
       int numThreads = 32;
       int numWarps = ceil((s_t)markerObservations.size() / numThreads);
@@ -6615,184 +7022,24 @@ void MarkerFitter::fitTrajectory(
                   << std::endl;
         */
 
-        // 2.1. Linearize the marker names and marker observations. This needs
-        // to be done at each step, because the observed markers can be
-        // different at different steps.
-        Eigen::VectorXs markerPoses
-            = Eigen::VectorXs::Zero(markerObservations[i].size() * 3);
-        Eigen::VectorXs markerWeightsVector
-            = Eigen::VectorXs::Ones(markerObservations[i].size());
-        Eigen::VectorXs centerPoses = jointCenters[i];
-        Eigen::VectorXs axisPoses = jointAxis[i];
-        std::vector<std::pair<dynamics::BodyNode*, Eigen::Vector3s>>
-            markerVector;
-        std::vector<std::string> outputNames;
-        for (std::pair<std::string, Eigen::Vector3s> pair :
-             markerObservations[i])
-        {
-          markerPoses.segment<3>(markerVector.size() * 3) = pair.second;
-          if (markerWeights.count(pair.first))
-          {
-            assert(markerWeights.count(pair.first));
-            markerWeightsVector(markerVector.size())
-                = markerWeights.at(pair.first);
-          }
-          else
-          {
-            markerWeightsVector(markerVector.size())
-                = fitter->mMarkerIsTracking.at(
-                      fitter->mMarkerIndices.at(pair.first))
-                      ? fitter->mTrackingMarkerDefaultWeight
-                      : fitter->mAnatomicalMarkerDefaultWeight;
-          }
-          assert(fitter->mMarkerMap.count(pair.first));
-          const std::pair<dynamics::BodyNode*, Eigen::Vector3s>& originalMarker
-              = fitter->mMarkerMap.at(pair.first);
-          Eigen::Vector3s offset = Eigen::Vector3s::Zero();
-          if (markerOffsets.count(pair.first))
-          {
-            assert(markerOffsets.count(pair.first));
-            offset = markerOffsets.at(pair.first);
-          }
-          markerVector.emplace_back(
-              skeletonBallJoints->getBodyNode(originalMarker.first->getName()),
-              originalMarker.second + offset);
-          Eigen::Vector3s markerPos = originalMarker.second + offset;
-          std::string markerPrefix
-              = "marker " + originalMarker.first->getName() + " ("
-                + std::to_string((double)markerPos(0)) + ","
-                + std::to_string((double)markerPos(1)) + ","
-                + std::to_string((double)markerPos(2)) + ")";
-          outputNames.push_back(markerPrefix + " X");
-          outputNames.push_back(markerPrefix + " Y");
-          outputNames.push_back(markerPrefix + " Z");
-        }
-        for (int i = 0; i < joints.size(); i++)
-        {
-          std::string jointPrefix = "joint " + joints[i]->getName();
-          outputNames.push_back(jointPrefix + " X");
-          outputNames.push_back(jointPrefix + " Y");
-          outputNames.push_back(jointPrefix + " Z");
-        }
-        std::vector<std::string> inputNames;
-        for (int i = 0; i < skeletonBallJoints->getNumDofs(); i++)
-        {
-          inputNames.push_back(
-              "dof " + skeletonBallJoints->getDof(i)->getName());
-        }
-
-        assert(markerPoses.size() == markerVector.size() * 3);
-        assert(centerPoses.size() == joints.size() * 3);
-
-        // 2.2. Actually run the IK solver
-        // Initialize at the old config
-
-        const bool ignoreJointLimits = fitter->mIgnoreJointLimits;
-        s_t finalLoss = math::solveIK(
+        s_t finalLoss = fitTrajectoryTimestep(
+            fitter,
+            skeleton,
+            skeletonBallJoints,
+            observedJoints,
+            joints,
+            jointsForSkeletonBallJoints,
+            markerObservations[i],
+            markerWeights,
+            markerOffsets,
+            jointCenters[i],
+            jointWeights,
+            jointAxis[i],
+            axisWeights,
             initialGuess,
-            skeletonBallJoints->getPositionUpperLimits(),
-            skeletonBallJoints->getPositionLowerLimits(),
-            (markerVector.size() * 3) + (joints.size() * 3),
-            // Set positions
-            [skeletonBallJoints, skeleton, ignoreJointLimits](
-                /* in*/ const Eigen::VectorXs pos, bool clamp) {
-              skeletonBallJoints->setPositions(pos);
-              if (clamp)
-              {
-                // 1. Map the position back into eulerian space
-                skeleton->setPositions(
-                    skeleton->convertPositionsFromBallSpace(pos));
-                if (!ignoreJointLimits)
-                {
-                  // 2. Clamp the position to limits
-                  skeleton->clampPositionsToLimits();
-                  // 3. Map the position back into SO3 space
-                  skeletonBallJoints->setPositions(
-                      skeleton->convertPositionsToBallSpace(
-                          skeleton->getPositions()));
-                }
-              }
-
-              // Return the clamped position
-              return skeletonBallJoints->getPositions();
-            },
-            [skeletonBallJoints,
-             markerPoses,
-             markerVector,
-             markerWeightsVector,
-             jointsForSkeletonBallJoints,
-             centerPoses,
-             jointWeights,
-             axisPoses,
-             axisWeights](
-                /*out*/ Eigen::Ref<Eigen::VectorXs> diff,
-                /*out*/ Eigen::Ref<Eigen::MatrixXs> jac) {
-              assert(diff.size() == markerPoses.size() + centerPoses.size());
-
-              diff.segment(0, markerPoses.size())
-                  = skeletonBallJoints->getMarkerWorldPositions(markerVector)
-                    - markerPoses;
-              Eigen::VectorXs jointPoses
-                  = skeletonBallJoints->getJointWorldPositions(
-                      jointsForSkeletonBallJoints);
-              computeJointIKDiff(
-                  diff.segment(markerPoses.size(), centerPoses.size()),
-                  jointPoses,
-                  centerPoses,
-                  jointWeights,
-                  axisPoses,
-                  axisWeights);
-
-              assert(jac.cols() == skeletonBallJoints->getNumDofs());
-              assert(
-                  jac.rows()
-                  == (markerVector.size() * 3)
-                         + (jointsForSkeletonBallJoints.size() * 3));
-              jac.block(
-                  0,
-                  0,
-                  markerVector.size() * 3,
-                  skeletonBallJoints->getNumDofs())
-                  = skeletonBallJoints
-                        ->getMarkerWorldPositionsJacobianWrtJointPositions(
-                            markerVector);
-              jac.block(
-                  markerVector.size() * 3,
-                  0,
-                  jointsForSkeletonBallJoints.size() * 3,
-                  skeletonBallJoints->getNumDofs())
-                  = skeletonBallJoints
-                        ->getJointWorldPositionsJacobianWrtJointPositions(
-                            jointsForSkeletonBallJoints);
-              for (int i = 0; i < markerWeightsVector.size(); i++)
-              {
-                diff.segment<3>(i * 3) *= markerWeightsVector(i);
-                jac.block(i * 3, 0, 3, jac.cols()) *= markerWeightsVector(i);
-              }
-              rescaleIKJacobianForWeightsAndAxis(
-                  jac.block(
-                      markerVector.size() * 3,
-                      0,
-                      jointsForSkeletonBallJoints.size() * 3,
-                      skeletonBallJoints->getNumDofs()),
-                  jointWeights,
-                  axisPoses,
-                  axisWeights);
-            },
-            [initialGuess](Eigen::Ref<Eigen::VectorXs> val) {
-              assert(false);
-              val = initialGuess;
-            },
-            math::IKConfig()
-                .setMaxStepCount(500)
-                .setConvergenceThreshold(1e-6)
-                .setDontExitTranspose(true)
-                .setLossLowerBound(1e-8)
-                .setMaxRestarts(1)
-                .setStartClamped(true)
-                .setLogOutput(false)
-                .setInputNames(inputNames)
-                .setOutputNames(outputNames));
+            Eigen::VectorXs::Zero(0),
+            1,
+            1e-8);
 
         // 2.3. Record this outcome
         result.col(i) = skeleton->getPositions();
@@ -6968,6 +7215,318 @@ void MarkerFitter::fitTrajectory(
   }
 }
 
+//==============================================================================
+/// This runs IK for a single timestep of fitTrajectory(), in ball joint space,
+/// starting at `initialGuess`. If `maxRestarts` > 1, then restarts only fire
+/// when the loss from `initialGuess` is above `restartLoss`. The first restart
+/// tries `fallbackGuess` (if it's not empty), and the rest are random poses
+/// near the marker cloud. This leaves both skeletons at the solution, and
+/// returns the loss.
+s_t MarkerFitter::fitTrajectoryTimestep(
+    const MarkerFitter* fitter,
+    std::shared_ptr<dynamics::Skeleton> skeleton,
+    std::shared_ptr<dynamics::Skeleton> skeletonBallJoints,
+    const std::vector<dynamics::Joint*>& observedJoints,
+    const std::vector<dynamics::Joint*>& joints,
+    const std::vector<dynamics::Joint*>& jointsForSkeletonBallJoints,
+    const std::map<std::string, Eigen::Vector3s>& markerObservations,
+    const std::map<std::string, s_t>& markerWeights,
+    const std::map<std::string, Eigen::Vector3s>& markerOffsets,
+    const Eigen::VectorXs& jointCenters,
+    const Eigen::VectorXs& jointWeights,
+    const Eigen::VectorXs& jointAxis,
+    const Eigen::VectorXs& axisWeights,
+    const Eigen::VectorXs& initialGuess,
+    const Eigen::VectorXs& fallbackGuess,
+    int maxRestarts,
+    s_t restartLoss,
+    std::mt19937* restartGenerator)
+{
+  // 1. Linearize the marker names and marker observations. This needs to be
+  // done at each step, because the observed markers can be different at
+  // different steps.
+  Eigen::VectorXs markerPoses
+      = Eigen::VectorXs::Zero(markerObservations.size() * 3);
+  Eigen::VectorXs markerWeightsVector
+      = Eigen::VectorXs::Ones(markerObservations.size());
+  Eigen::VectorXs centerPoses = jointCenters;
+  Eigen::VectorXs axisPoses = jointAxis;
+  std::vector<std::pair<dynamics::BodyNode*, Eigen::Vector3s>> markerVector;
+  std::vector<std::string> outputNames;
+  for (std::pair<std::string, Eigen::Vector3s> pair : markerObservations)
+  {
+    markerPoses.segment<3>(markerVector.size() * 3) = pair.second;
+    if (markerWeights.count(pair.first))
+    {
+      assert(markerWeights.count(pair.first));
+      markerWeightsVector(markerVector.size()) = markerWeights.at(pair.first);
+    }
+    else
+    {
+      markerWeightsVector(markerVector.size())
+          = fitter->mMarkerIsTracking.at(fitter->mMarkerIndices.at(pair.first))
+                ? fitter->mTrackingMarkerDefaultWeight
+                : fitter->mAnatomicalMarkerDefaultWeight;
+    }
+    assert(fitter->mMarkerMap.count(pair.first));
+    const std::pair<dynamics::BodyNode*, Eigen::Vector3s>& originalMarker
+        = fitter->mMarkerMap.at(pair.first);
+    Eigen::Vector3s offset = Eigen::Vector3s::Zero();
+    if (markerOffsets.count(pair.first))
+    {
+      assert(markerOffsets.count(pair.first));
+      offset = markerOffsets.at(pair.first);
+    }
+    markerVector.emplace_back(
+        skeletonBallJoints->getBodyNode(originalMarker.first->getName()),
+        originalMarker.second + offset);
+    Eigen::Vector3s markerPos = originalMarker.second + offset;
+    std::string markerPrefix
+        = "marker " + originalMarker.first->getName() + " ("
+          + std::to_string((double)markerPos(0)) + ","
+          + std::to_string((double)markerPos(1)) + ","
+          + std::to_string((double)markerPos(2)) + ")";
+    outputNames.push_back(markerPrefix + " X");
+    outputNames.push_back(markerPrefix + " Y");
+    outputNames.push_back(markerPrefix + " Z");
+  }
+  for (int i = 0; i < joints.size(); i++)
+  {
+    std::string jointPrefix = "joint " + joints[i]->getName();
+    outputNames.push_back(jointPrefix + " X");
+    outputNames.push_back(jointPrefix + " Y");
+    outputNames.push_back(jointPrefix + " Z");
+  }
+  std::vector<std::string> inputNames;
+  for (int i = 0; i < skeletonBallJoints->getNumDofs(); i++)
+  {
+    inputNames.push_back("dof " + skeletonBallJoints->getDof(i)->getName());
+  }
+
+  assert(markerPoses.size() == markerVector.size() * 3);
+  assert(centerPoses.size() == joints.size() * 3);
+
+  // 2. Actually run the IK solver
+
+  const bool ignoreJointLimits = fitter->mIgnoreJointLimits;
+  int numRestarts = 0;
+  s_t finalLoss = math::solveIK(
+      initialGuess,
+      skeletonBallJoints->getPositionUpperLimits(),
+      skeletonBallJoints->getPositionLowerLimits(),
+      (markerVector.size() * 3) + (joints.size() * 3),
+      // Set positions
+      [skeletonBallJoints, skeleton, ignoreJointLimits](
+          /* in*/ const Eigen::VectorXs pos, bool clamp) {
+        skeletonBallJoints->setPositions(pos);
+        if (clamp)
+        {
+          // 1. Map the position back into eulerian space
+          skeleton->setPositions(skeleton->convertPositionsFromBallSpace(pos));
+          if (!ignoreJointLimits)
+          {
+            // 2. Clamp the position to limits
+            skeleton->clampPositionsToLimits();
+            // 3. Map the position back into SO3 space
+            skeletonBallJoints->setPositions(
+                skeleton->convertPositionsToBallSpace(
+                    skeleton->getPositions()));
+          }
+        }
+
+        // Return the clamped position
+        return skeletonBallJoints->getPositions();
+      },
+      [skeletonBallJoints,
+       markerPoses,
+       markerVector,
+       markerWeightsVector,
+       jointsForSkeletonBallJoints,
+       centerPoses,
+       jointWeights,
+       axisPoses,
+       axisWeights](
+          /*out*/ Eigen::Ref<Eigen::VectorXs> diff,
+          /*out*/ Eigen::Ref<Eigen::MatrixXs> jac) {
+        assert(diff.size() == markerPoses.size() + centerPoses.size());
+
+        diff.segment(0, markerPoses.size())
+            = skeletonBallJoints->getMarkerWorldPositions(markerVector)
+              - markerPoses;
+        Eigen::VectorXs jointPoses
+            = skeletonBallJoints->getJointWorldPositions(
+                jointsForSkeletonBallJoints);
+        computeJointIKDiff(
+            diff.segment(markerPoses.size(), centerPoses.size()),
+            jointPoses,
+            centerPoses,
+            jointWeights,
+            axisPoses,
+            axisWeights);
+
+        assert(jac.cols() == skeletonBallJoints->getNumDofs());
+        assert(
+            jac.rows()
+            == (markerVector.size() * 3)
+                   + (jointsForSkeletonBallJoints.size() * 3));
+        jac.block(
+            0,
+            0,
+            markerVector.size() * 3,
+            skeletonBallJoints->getNumDofs())
+            = skeletonBallJoints
+                  ->getMarkerWorldPositionsJacobianWrtJointPositions(
+                      markerVector);
+        jac.block(
+            markerVector.size() * 3,
+            0,
+            jointsForSkeletonBallJoints.size() * 3,
+            skeletonBallJoints->getNumDofs())
+            = skeletonBallJoints
+                  ->getJointWorldPositionsJacobianWrtJointPositions(
+                      jointsForSkeletonBallJoints);
+        for (int i = 0; i < markerWeightsVector.size(); i++)
+        {
+          diff.segment<3>(i * 3) *= markerWeightsVector(i);
+          jac.block(i * 3, 0, 3, jac.cols()) *= markerWeightsVector(i);
+        }
+        rescaleIKJacobianForWeightsAndAxis(
+            jac.block(
+                markerVector.size() * 3,
+                0,
+                jointsForSkeletonBallJoints.size() * 3,
+                skeletonBallJoints->getNumDofs()),
+            jointWeights,
+            axisPoses,
+            axisWeights);
+      },
+      // Generate a restart position, trying the fallback guess first
+      [&skeleton,
+       &observedJoints,
+       &markerPoses,
+       &fallbackGuess,
+       &numRestarts,
+       restartGenerator](Eigen::Ref<Eigen::VectorXs> val) {
+        numRestarts++;
+        if (numRestarts == 1 && fallbackGuess.size() > 0)
+        {
+          val = fallbackGuess;
+          return;
+        }
+        val = skeleton->convertPositionsToBallSpace(
+            restartGenerator != nullptr
+                ? skeleton->getRandomPoseForJoints(
+                    observedJoints, *restartGenerator)
+                : skeleton->getRandomPoseForJoints(observedJoints));
+
+        // Set the root translation to within a fairly narrow range of the
+        // average marker cloud
+        Eigen::Vector3s avgMarkerPos = Eigen::Vector3s::Zero();
+        for (int i = 0; i < markerPoses.size() / 3; i++)
+        {
+          avgMarkerPos += markerPoses.segment<3>(i * 3);
+        }
+        avgMarkerPos /= (s_t)(markerPoses.size() / 3);
+        Eigen::Vector3s noise;
+        if (restartGenerator != nullptr)
+        {
+          std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+          for (int i = 0; i < 3; i++)
+          {
+            noise(i) = distribution(*restartGenerator);
+          }
+        }
+        else
+        {
+          noise = Eigen::Vector3s::Random();
+        }
+        val.segment<3>(3) = avgMarkerPos + (noise * 0.2);
+      },
+      math::IKConfig()
+          .setMaxStepCount(500)
+          .setConvergenceThreshold(1e-6)
+          .setDontExitTranspose(true)
+          .setLossLowerBound(restartLoss)
+          .setMaxRestarts(maxRestarts)
+          .setStartClamped(true)
+          .setLogOutput(false)
+          .setInputNames(inputNames)
+          .setOutputNames(outputNames));
+
+  return finalLoss;
+}
+
+//==============================================================================
+/// This splits `numTimesteps` into consecutive windows of at most
+/// `windowSize` timesteps, where each window shares `overlap` timesteps with
+/// the one before it. This returns (start, size) for each window.
+std::vector<std::pair<int, int>> MarkerFitter::getSlidingWindows(
+    int numTimesteps, int windowSize, int overlap)
+{
+  windowSize = std::max(1, windowSize);
+  overlap = std::max(0, std::min(overlap, windowSize - 1));
+  int stride = windowSize - overlap;
+
+  std::vector<std::pair<int, int>> windows;
+  int start = 0;
+  while (start < numTimesteps)
+  {
+    // Because the last window always runs to the end of the trial, every
+    // window after the first has more than `overlap` timesteps.
+    if (start + windowSize >= numTimesteps)
+    {
+      windows.emplace_back(start, numTimesteps - start);
+      break;
+    }
+    windows.emplace_back(start, windowSize);
+    start += stride;
+  }
+  return windows;
+}
+
+//==============================================================================
+/// This writes `window` into `series` starting at column `start`. The first
+/// `overlap` columns are linearly blended with what's already in `series`,
+/// ramping from the old values to the new ones. If `skel` is passed, the
+/// columns are poses for it, and the window gets unwrapped onto `series`
+/// first, so that Euler angles that differ by 2*pi don't get averaged.
+void MarkerFitter::blendSlidingWindow(
+    Eigen::Ref<Eigen::MatrixXs> series,
+    Eigen::MatrixXs window,
+    int start,
+    int overlap,
+    std::shared_ptr<dynamics::Skeleton> skel)
+{
+  assert(series.rows() == window.rows());
+  assert(start + window.cols() <= series.cols());
+  if (skel != nullptr && start > 0 && window.cols() > 0)
+  {
+    // Line the first column up with the pose it overlaps (or follows), and
+    // then every column after it with the one before, so the window stays
+    // continuous with the poses already in `series`.
+    window.col(0) = skel->unwrapPositionToNearest(
+        window.col(0), series.col(overlap > 0 ? start : start - 1));
+    for (int i = 1; i < window.cols(); i++)
+    {
+      window.col(i)
+          = skel->unwrapPositionToNearest(window.col(i), window.col(i - 1));
+    }
+  }
+  for (int i = 0; i < window.cols(); i++)
+  {
+    if (i < overlap)
+    {
+      s_t alpha = (s_t)(i + 1) / (overlap + 1);
+      series.col(start + i)
+          = (1.0 - alpha) * series.col(start + i) + alpha * window.col(i);
+    }
+    else
+    {
+      series.col(start + i) = window.col(i);
+    }
+  }
+}
+
 //==============================================================================
 /// This solves a bunch of optimization problems, one per joint, to find and
 /// track the joint centers over time. It puts the results back into
@@ -8129,7 +8688,7 @@ Eigen::VectorXs MarkerFitter::getMarkerLossGradientWrtGroupScales(
     const std::vector<std::pair<dynamics::BodyNode*, Eigen::Vector3s>>& markers,
     Eigen::VectorXs lossGradWrtMarkerError)
 {
-  return skeleton->getMarkerWorldPositionsJacobianWrtGroupScales(markers)
+  return skeleton->getMarkerWorldPositionsSparseJacobianWrtGroupScales(markers)
              .transpose()
          * lossGradWrtMarkerError;
 }
@@ -8681,12 +9240,61 @@ void MarkerFitter::setCheckDerivatives(bool checkDerivatives)
   mCheckDerivatives = checkDerivatives;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////
+void MarkerFitter::setRandomDerivativeCheck(int numDirections, s_t tolerance)
+{
+  mDerivativeCheckDirections = numDirections;
+  mDerivativeCheckTolerance = tolerance;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////
 void MarkerFitter::setParallelIKWarps(bool parallelWarps)
 {
   mUseParallelIKWarps = parallelWarps;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////
+void MarkerFitter::setWarmStartIK(bool warmStart)
+{
+  mUseWarmStartIK = warmStart;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////
+void MarkerFitter::setWarmStartIKRestartLoss(s_t loss)
+{
+  mWarmStartIKRestartLoss = loss;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////
+void MarkerFitter::setWarmStartIKMaxRestarts(int maxRestarts)
+{
+  mWarmStartIKMaxRestarts = maxRestarts;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////
+void MarkerFitter::setWarmStartIKNumChunks(int numChunks)
+{
+  mWarmStartIKNumChunks = numChunks;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////
+void MarkerFitter::setSlidingWindowIK(bool slidingWindow)
+{
+  mUseSlidingWindowIK = slidingWindow;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////
+void MarkerFitter::setSlidingWindowIKSize(int windowSize)
+{
+  mSlidingWindowIKSize = windowSize;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////
+void MarkerFitter::setSlidingWindowIKOverlap(int overlap)
+{
+  mSlidingWindowIKOverlap = overlap;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////
 // The SphereFitJointCenterProblem, which maps the sphere-fitting joint-center
 // problem onto a differentiable format.
@@ -10055,10 +10663,12 @@ Eigen::MatrixXs BilevelFitProblem::getConstraintsJacobian(Eigen::VectorXs x)
         jac.rows() + mFitter->mZeroConstraints.size(), jac.cols());
     concatenatedJac.block(0, 0, jac.rows(), jac.cols()) = jac;
     int cursor = jac.rows();
+    Eigen::VectorXs constraintGrad(state.getFlatSize());
     for (auto pair : mFitter->mZeroConstraints)
     {
       pair.second(&state);
-      concatenatedJac.row(cursor) = state.flattenGradient();
+      state.flattenGradient(constraintGrad);
+      concatenatedJac.row(cursor) = constraintGrad;
       cursor++;
     }
     return concatenatedJac;
@@ -10306,6 +10916,25 @@ bool BilevelFitProblem::eval_grad_f(
 
   grad = getGradient(x.cast<s_t>()).cast<double>();
 
+  if (mFitter->mDerivativeCheckDirections > 0 && _n > 0)
+  {
+    const Eigen::VectorXs x_s = x.cast<s_t>();
+    s_t error = math::checkGradientAlongRandomDirections(
+        [&](const Eigen::VectorXs& point) { return getLoss(point); },
+        grad.cast<s_t>(),
+        x_s,
+        mFitter->mDerivativeCheckDirections);
+    // getLoss() overwrites mLastX, which we use to recover the best state
+    mLastX = x_s;
+    if (error > mFitter->mDerivativeCheckTolerance)
+    {
+      std::cout << "WARNING: BilevelFitProblem::eval_grad_f() failed the "
+                   "random derivative check, with error "
+                << error << " > tolerance "
+                << mFitter->mDerivativeCheckTolerance << std::endl;
+    }
+  }
+
   return true;
 }
 
@@ -11405,6 +12034,27 @@ bool IMUFineTuneProblem::eval_grad_f(
   }
   Eigen::Map<Eigen::VectorXd> grad(_grad_f, n);
   grad = getGrad().cast<s_t>();
+
+  if (mFitter->mDerivativeCheckDirections > 0 && n > 0)
+  {
+    const Eigen::VectorXs x = flatten();
+    s_t error = math::checkGradientAlongRandomDirections(
+        [&](const Eigen::VectorXs& point) {
+          unflatten(point);
+          return getLoss();
+        },
+        grad.cast<s_t>(),
+        x,
+        mFitter->mDerivativeCheckDirections);
+    unflatten(x);
+    if (error > mFitter->mDerivativeCheckTolerance)
+    {
+      std::cout << "WARNING: IMUFineTuneProblem::eval_grad_f() failed the "
+                   "random derivative check, with error "
+                << error << " > tolerance "
+                << mFitter->mDerivativeCheckTolerance << std::endl;
+    }
+  }
   return true;
 }
 
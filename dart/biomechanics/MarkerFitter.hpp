@@ -5,6 +5,7 @@
 // #include <unordered_map>
 #include <map>
 #include <mutex>
+#include <random>
 #include <vector>
 
 #include <Eigen/Dense>
@@ -98,10 +99,22 @@ struct MarkerFitterState
   /// This returns a single flat vector representing this whole problem state
   Eigen::VectorXs flattenState();
 
+  /// This writes the whole problem state into `flat`, which must already be
+  /// the right size
+  void flattenState(Eigen::Ref<Eigen::VectorXs> flat);
+
   /// This returns a single flat vector representing the gradient of this whole
   /// problem state
   Eigen::VectorXs flattenGradient();
 
+  /// This writes the gradient of the whole problem state into `grad`, which
+  /// must already be the right size
+  void flattenGradient(Eigen::Ref<Eigen::VectorXs> grad);
+
+  /// This is the length of the flat vectors written by flattenState() and
+  /// flattenGradient()
+  int getFlatSize();
+
 protected:
   std::vector<std::map<std::string, Eigen::Vector3s>> markerObservations;
   std::shared_ptr<dynamics::Skeleton> skeleton;
@@ -791,6 +804,51 @@ public:
       Eigen::Ref<Eigen::VectorXs> resultScores,
       bool backwards = false);
 
+  /// This splits `numTimesteps` into consecutive windows of at most
+  /// `windowSize` timesteps, where each window shares `overlap` timesteps with
+  /// the one before it. This returns (start, size) for each window.
+  static std::vector<std::pair<int, int>> getSlidingWindows(
+      int numTimesteps, int windowSize, int overlap);
+
+  /// This writes `window` into `series` starting at column `start`. The first
+  /// `overlap` columns are linearly blended with what's already in `series`,
+  /// ramping from the old values to the new ones. If `skel` is passed, the
+  /// columns are poses for it, and the window gets unwrapped onto `series`
+  /// first, so that Euler angles that differ by 2*pi don't get averaged.
+  static void blendSlidingWindow(
+      Eigen::Ref<Eigen::MatrixXs> series,
+      Eigen::MatrixXs window,
+      int start,
+      int overlap,
+      std::shared_ptr<dynamics::Skeleton> skel = nullptr);
+
+  /// This runs IK for a single timestep of fitTrajectory(), in ball joint
+  /// space, starting at `initialGuess`. If `maxRestarts` > 1, then restarts
+  /// only fire when the loss from `initialGuess` is above `restartLoss`. The
+  /// first restart tries `fallbackGuess` (if it's not empty), and the rest are
+  /// random poses near the marker cloud. Those are drawn from
+  /// `restartGenerator` if it's passed, and from std::rand() otherwise. This
+  /// leaves both skeletons at the solution, and returns the loss.
+  static s_t fitTrajectoryTimestep(
+      const MarkerFitter* fitter,
+      std::shared_ptr<dynamics::Skeleton> skeleton,
+      std::shared_ptr<dynamics::Skeleton> skeletonBallJoints,
+      const std::vector<dynamics::Joint*>& observedJoints,
+      const std::vector<dynamics::Joint*>& joints,
+      const std::vector<dynamics::Joint*>& jointsForSkeletonBallJoints,
+      const std::map<std::string, Eigen::Vector3s>& markerObservations,
+      const std::map<std::string, s_t>& markerWeights,
+      const std::map<std::string, Eigen::Vector3s>& markerOffsets,
+      const Eigen::VectorXs& jointCenters,
+      const Eigen::VectorXs& jointWeights,
+      const Eigen::VectorXs& jointAxis,
+      const Eigen::VectorXs& axisWeights,
+      const Eigen::VectorXs& initialGuess,
+      const Eigen::VectorXs& fallbackGuess,
+      int maxRestarts,
+      s_t restartLoss,
+      std::mt19937* restartGenerator = nullptr);
+
   ///////////////////////////////////////////////////////////////////////////
   // Pipeline step 2: Find joint centers
   ///////////////////////////////////////////////////////////////////////////
@@ -1129,6 +1187,45 @@ public:
   /// initialization for the whole warp. Defaults to false.
   void setParallelIKWarps(bool parallelWarps);
 
+  /// If true, fitTrajectory() splits the trajectory into contiguous chunks
+  /// that run in parallel. Each chunk starts with a cold IK solve (with the
+  /// same restarts as the initial IK) at its first timestep. After that, each
+  /// timestep starts from the previous solution extrapolated at constant
+  /// velocity, and only restarts if the loss from there is above
+  /// setWarmStartIKRestartLoss(). This takes precedence over
+  /// setParallelIKWarps(). Defaults to false.
+  void setWarmStartIK(bool warmStart);
+
+  /// When warm starting IK, timesteps with a loss above this from the warm
+  /// start fall back to the previous solution, and then to random restarts.
+  void setWarmStartIKRestartLoss(s_t loss);
+
+  /// When warm starting IK, this is the most solves (counting the one from the
+  /// warm start) that a timestep after the first in its chunk gets. This is
+  /// deliberately much smaller than setInitialIKMaxRestarts(), since a warm
+  /// start that's off is usually fixed by the previous solution. The random
+  /// restarts come from a generator seeded by chunk, so the results don't
+  /// depend on thread scheduling. Defaults to 3.
+  void setWarmStartIKMaxRestarts(int maxRestarts);
+
+  /// When warm starting IK, this is the maximum number of chunks (and threads)
+  /// that fitTrajectory() splits the trajectory into.
+  void setWarmStartIKNumChunks(int numChunks);
+
+  /// If true, fineTuneIK() and smoothOutIK() solve fixed-length overlapping
+  /// windows of each trial in parallel, instead of one problem per block (or
+  /// per trial). The overlapping timesteps are blended linearly between
+  /// neighboring windows, after unwrapping any Euler angles. Only a bounded
+  /// number of windows are in flight at once, so peak memory doesn't grow with
+  /// the length of the trial. Defaults to false.
+  void setSlidingWindowIK(bool slidingWindow);
+
+  /// This sets the number of timesteps in each sliding window.
+  void setSlidingWindowIKSize(int windowSize);
+
+  /// This sets the number of timesteps that neighboring sliding windows share.
+  void setSlidingWindowIKOverlap(int overlap);
+
   /// This gives us a configuration option to ignore the joint limits in the
   /// uploaded model, and then set them after the fit.
   void setIgnoreJointLimits(bool ignore);
@@ -1379,6 +1476,12 @@ public:
   void setLBFGSHistory(int hist);
   void setCheckDerivatives(bool checkDerivatives);
 
+  /// Unlike setCheckDerivatives(), which has IPOPT finite difference the whole
+  /// gradient, this checks every gradient evaluation along `numDirections`
+  /// random directions with math::checkGradientAlongRandomDirections().
+  /// Failures are logged. Pass 0 to turn it off.
+  void setRandomDerivativeCheck(int numDirections, s_t tolerance = 1e-4);
+
   friend class BilevelFitProblem;
   friend class SphereFitJointCenterProblem;
   friend class CylinderFitJointAxisProblem;
@@ -1434,6 +1537,13 @@ protected:
   bool mIgnoreJointLimits;
   s_t mMaxMarkerOffset;
   bool mUseParallelIKWarps;
+  bool mUseWarmStartIK;
+  s_t mWarmStartIKRestartLoss;
+  int mWarmStartIKMaxRestarts;
+  int mWarmStartIKNumChunks;
+  bool mUseSlidingWindowIK;
+  int mSlidingWindowIKSize;
+  int mSlidingWindowIKOverlap;
 
   // Parameters for joint weighting
   s_t mMinVarianceCutoff;
@@ -1464,6 +1574,8 @@ protected:
   int mIterationLimit;
   int mLBFGSHistoryLength;
   bool mCheckDerivatives;
+  int mDerivativeCheckDirections;
+  s_t mDerivativeCheckTolerance;
   int mPrintFrequency;
   bool mSilenceOutput;
   bool mDisableLinesearch;
@@ -1,7 +1,9 @@
 #include "dart/biomechanics/MarkerLabeller.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <limits>
+#include <stdexcept>
 #include <string>
 #include <utility>
 
@@ -1006,7 +1008,22 @@ void MarkerLabeller::evaluate(
 NeuralMarkerLabeller::NeuralMarkerLabeller(
     std::function<std::vector<std::map<std::string, Eigen::Vector3s>>(
         const std::vector<std::vector<Eigen::Vector3s>>&)> jointCenterPredictor)
-  : mJointCenterPredictor(jointCenterPredictor)
+  : mJointCenterPredictor(jointCenterPredictor), mBatchSize(0), mMaxPoints(0)
+{
+}
+
+//==============================================================================
+NeuralMarkerLabeller::NeuralMarkerLabeller(
+    std::function<Eigen::MatrixXs(
+        const Eigen::MatrixXs& points, const Eigen::VectorXi& numPoints)>
+        batchedJointCenterPredictor,
+    std::vector<std::string> jointNames,
+    int batchSize,
+    int maxPoints)
+  : mBatchedJointCenterPredictor(batchedJointCenterPredictor),
+    mJointNames(jointNames),
+    mBatchSize(std::max(1, batchSize)),
+    mMaxPoints(maxPoints)
 {
 }
 
@@ -1020,7 +1037,65 @@ std::vector<std::map<std::string, Eigen::Vector3s>>
 NeuralMarkerLabeller::guessJointLocations(
     const std::vector<std::vector<Eigen::Vector3s>>& pointClouds)
 {
-  return mJointCenterPredictor(pointClouds);
+  if (!mBatchedJointCenterPredictor)
+  {
+    return mJointCenterPredictor(pointClouds);
+  }
+
+  // Every batch has the same shape, so the predictor never has to re-trace or
+  // re-allocate for a new input size
+  int width = mMaxPoints;
+  for (const auto& cloud : pointClouds)
+  {
+    width = std::max(width, (int)cloud.size());
+  }
+
+  std::vector<std::map<std::string, Eigen::Vector3s>> result;
+  result.reserve(pointClouds.size());
+  Eigen::MatrixXs points = Eigen::MatrixXs::Zero(3, mBatchSize * width);
+  Eigen::VectorXi numPoints = Eigen::VectorXi::Zero(mBatchSize);
+  for (int batchStart = 0; batchStart < pointClouds.size();
+       batchStart += mBatchSize)
+  {
+    // 1. Pack the batch, padding any frames past the end with empty clouds
+    points.setZero();
+    numPoints.setZero();
+    for (int b = 0; b < mBatchSize && batchStart + b < pointClouds.size(); b++)
+    {
+      const auto& cloud = pointClouds[batchStart + b];
+      numPoints(b) = cloud.size();
+      for (int i = 0; i < cloud.size(); i++)
+      {
+        points.col(b * width + i) = cloud[i];
+      }
+    }
+
+    // 2. Run the predictor once for the whole batch
+    Eigen::MatrixXs jointCenters
+        = mBatchedJointCenterPredictor(points, numPoints);
+    if (jointCenters.rows() != mJointNames.size() * 3
+        || jointCenters.cols() != mBatchSize)
+    {
+      std::cout << "ERROR: NeuralMarkerLabeller batched predictor returned a "
+                << jointCenters.rows() << "x" << jointCenters.cols()
+                << " matrix, but expected " << mJointNames.size() * 3 << "x"
+                << mBatchSize << std::endl;
+      throw std::runtime_error(
+          "NeuralMarkerLabeller batched predictor returned the wrong shape");
+    }
+
+    // 3. Scatter the results back out to each frame
+    for (int b = 0; b < mBatchSize && batchStart + b < pointClouds.size(); b++)
+    {
+      std::map<std::string, Eigen::Vector3s> frameJoints;
+      for (int j = 0; j < mJointNames.size(); j++)
+      {
+        frameJoints[mJointNames[j]] = jointCenters.block<3, 1>(j * 3, b);
+      }
+      result.push_back(frameJoints);
+    }
+  }
+  return result;
 }
 
 //==============================================================================
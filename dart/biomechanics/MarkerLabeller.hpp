@@ -149,6 +149,23 @@ public:
           const std::vector<std::vector<Eigen::Vector3s>>&)>
           jointCenterPredictor);
 
+  /// This creates a labeller that packs the point clouds into fixed-shape
+  /// contiguous batches before handing them to `batchedJointCenterPredictor`,
+  /// which is much cheaper to cross into Python than nested vectors. Each call
+  /// gets a 3 x (batchSize * width) matrix of points, where frame `b` of the
+  /// batch fills columns [b * width, b * width + numPoints(b)) and the rest is
+  /// zero padding. `width` is `maxPoints`, or the size of the largest point
+  /// cloud if that is bigger. The predictor must return a
+  /// (3 * jointNames.size()) x batchSize matrix of joint centers, in the order
+  /// of `jointNames`.
+  NeuralMarkerLabeller(
+      std::function<Eigen::MatrixXs(
+          const Eigen::MatrixXs& points, const Eigen::VectorXi& numPoints)>
+          batchedJointCenterPredictor,
+      std::vector<std::string> jointNames,
+      int batchSize,
+      int maxPoints);
+
   virtual ~NeuralMarkerLabeller();
 
   virtual std::vector<std::map<std::string, Eigen::Vector3s>>
@@ -159,6 +176,13 @@ protected:
   std::function<std::vector<std::map<std::string, Eigen::Vector3s>>(
       const std::vector<std::vector<Eigen::Vector3s>>&)>
       mJointCenterPredictor;
+
+  std::function<Eigen::MatrixXs(
+      const Eigen::MatrixXs& points, const Eigen::VectorXi& numPoints)>
+      mBatchedJointCenterPredictor;
+  std::vector<std::string> mJointNames;
+  int mBatchSize;
+  int mMaxPoints;
 };
 
 class MarkerLabellerMock : public MarkerLabeller
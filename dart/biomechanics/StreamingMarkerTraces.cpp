@@ -7,6 +7,7 @@
 #include <limits>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -190,7 +191,11 @@ StreamingMarkerTraces::StreamingMarkerTraces(int numClasses, int numBodies)
     mNumClasses(numClasses),
     mTraceMaxJoinDistance(0.15),
     mTraceTimeoutMillis(300),
-    mFeatureMaxStrideToleranceMillis(10)
+    mFeatureMaxStrideToleranceMillis(10),
+    mBatchSize(1),
+    mBatchMaxPoints(0),
+    mBatchMaxLatencyMillis(0),
+    mOldestQueuedFeaturesTime(0)
 {
 }
 
@@ -432,17 +437,141 @@ void StreamingMarkerTraces::observeTraceLogits(
   const std::lock_guard<std::mutex> lock(
       *(const_cast<std::mutex*>(&mGlobalLock)));
   const s_t blendFactor = 0.999;
+  // Index the traces once, rather than searching them for every point
+  std::unordered_map<int, int> traceIndices;
+  for (int j = 0; j < mTraces.size(); j++)
+  {
+    traceIndices.emplace(mTraces[j].uuid, j);
+  }
   for (int i = 0; i < traceIDs.size(); i++)
   {
-    int traceID = traceIDs(i);
-    for (int j = 0; j < mTraces.size(); j++)
+    auto it = traceIndices.find(traceIDs(i));
+    if (it != traceIndices.end())
     {
-      if (mTraces[j].uuid == traceID)
+      Trace& trace = mTraces[it->second];
+      trace.logits = (logits.col(i) * (1.0 - blendFactor))
+                     + (trace.logits * blendFactor);
+    }
+  }
+}
+
+//==============================================================================
+/// This sets a batched classifier for the traces. Rather than handing the
+/// features from every update to the classifier (often in Python) one at a
+/// time, queueTraceFeatures() collects them, and we call `classifier` once
+/// per batch of frames.
+void StreamingMarkerTraces::setBatchedTraceClassifier(
+    std::function<Eigen::MatrixXs(
+        const Eigen::MatrixXs& features, const Eigen::VectorXi& numPoints)>
+        classifier,
+    int batchSize,
+    int maxPoints,
+    long maxLatencyMillis)
+{
+  const std::lock_guard<std::mutex> lock(mBatchLock);
+  mBatchedClassifier = classifier;
+  mBatchSize = std::max(1, batchSize);
+  mBatchMaxPoints = maxPoints;
+  mBatchMaxLatencyMillis = maxLatencyMillis;
+}
+
+//==============================================================================
+/// This computes the current trace features (see getTraceFeatures()) and
+/// queues them for the batched classifier. Once `batchSize` frames are
+/// queued, or the oldest queued frame is at least `maxLatencyMillis` older
+/// than `now`, the whole batch is classified and the logits are applied to
+/// the traces. This returns true if it classified a batch.
+bool StreamingMarkerTraces::queueTraceFeatures(
+    int numWindows, long windowDuration, long now, bool center)
+{
+  std::pair<Eigen::MatrixXs, Eigen::VectorXi> features
+      = getTraceFeatures(numWindows, windowDuration, center);
+
+  bool shouldFlush = false;
+  {
+    const std::lock_guard<std::mutex> lock(mBatchLock);
+    if (features.second.size() > 0)
+    {
+      if (mQueuedFeatures.size() == 0)
       {
-        mTraces[j].logits = (logits.col(i) * (1.0 - blendFactor))
-                            + (mTraces[j].logits * blendFactor);
-        break;
+        mOldestQueuedFeaturesTime = now;
       }
+      mQueuedFeatures.push_back(features);
+    }
+    shouldFlush = mQueuedFeatures.size() >= mBatchSize
+                  || (mQueuedFeatures.size() > 0
+                      && now - mOldestQueuedFeaturesTime
+                             >= mBatchMaxLatencyMillis);
+  }
+
+  if (shouldFlush)
+  {
+    flushTraceFeatures();
+  }
+  return shouldFlush;
+}
+
+//==============================================================================
+/// This classifies whatever trace features are currently queued, even if we
+/// don't have a full batch yet.
+void StreamingMarkerTraces::flushTraceFeatures()
+{
+  std::vector<std::pair<Eigen::MatrixXs, Eigen::VectorXi>> queued;
+  std::function<Eigen::MatrixXs(
+      const Eigen::MatrixXs& features, const Eigen::VectorXi& numPoints)>
+      classifier;
+  int batchSize;
+  int maxPoints;
+  {
+    const std::lock_guard<std::mutex> lock(mBatchLock);
+    queued.swap(mQueuedFeatures);
+    classifier = mBatchedClassifier;
+    batchSize = mBatchSize;
+    maxPoints = mBatchMaxPoints;
+  }
+  if (queued.size() == 0 || !classifier)
+  {
+    return;
+  }
+
+  for (int batchStart = 0; batchStart < queued.size(); batchStart += batchSize)
+  {
+    // 1. Pack the frames into one fixed-shape, zero padded matrix
+    Eigen::MatrixXs features = Eigen::MatrixXs::Zero(4, batchSize * maxPoints);
+    Eigen::VectorXi numPoints = Eigen::VectorXi::Zero(batchSize);
+    for (int b = 0; b < batchSize && batchStart + b < queued.size(); b++)
+    {
+      const Eigen::MatrixXs& frameFeatures = queued[batchStart + b].first;
+      numPoints(b) = std::min((int)frameFeatures.cols(), maxPoints);
+      if (frameFeatures.cols() > maxPoints)
+      {
+        std::cout << "WARNING: StreamingMarkerTraces batched classifier got "
+                  << frameFeatures.cols() << " points in one frame, but only "
+                  << "has room for " << maxPoints << ". Dropping the last "
+                  << frameFeatures.cols() - maxPoints
+                  << " points from this frame." << std::endl;
+      }
+      features.block(0, b * maxPoints, 4, numPoints(b))
+          = frameFeatures.leftCols(numPoints(b));
+    }
+
+    // 2. Classify the whole batch at once
+    Eigen::MatrixXs logits = classifier(features, numPoints);
+    if (logits.rows() != mNumClasses || logits.cols() != features.cols())
+    {
+      std::cout << "ERROR: StreamingMarkerTraces batched classifier returned a "
+                << logits.rows() << "x" << logits.cols()
+                << " matrix, but expected " << mNumClasses << "x"
+                << features.cols() << ". Dropping this batch." << std::endl;
+      continue;
+    }
+
+    // 3. Scatter the logits back to the traces they came from
+    for (int b = 0; b < batchSize && batchStart + b < queued.size(); b++)
+    {
+      observeTraceLogits(
+          logits.block(0, b * maxPoints, mNumClasses, numPoints(b)),
+          queued[batchStart + b].second.head(numPoints(b)));
     }
   }
 }
@@ -1,6 +1,7 @@
 #ifndef DART_BIOMECH_STREAMING_TRACE
 #define DART_BIOMECH_STREAMING_TRACE
 
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
@@ -86,6 +87,35 @@ public:
   void observeTraceLogits(
       const Eigen::MatrixXs& logits, const Eigen::VectorXi& traceIDs);
 
+  /// This sets a batched classifier for the traces. Rather than handing the
+  /// features from every update to the classifier (often in Python) one at a
+  /// time, queueTraceFeatures() collects them, and we call `classifier` once
+  /// per batch of frames. Each call gets a 4 x (batchSize * maxPoints) matrix
+  /// of features, where frame `b` of the batch fills columns
+  /// [b * maxPoints, b * maxPoints + numPoints(b)) and the rest is zero
+  /// padding. It must return a numClasses x (batchSize * maxPoints) matrix of
+  /// logits in the same layout. Points past `maxPoints` in a frame are left
+  /// out of that frame (with a warning), so those traces keep their old logits.
+  void setBatchedTraceClassifier(
+      std::function<Eigen::MatrixXs(
+          const Eigen::MatrixXs& features, const Eigen::VectorXi& numPoints)>
+          classifier,
+      int batchSize,
+      int maxPoints,
+      long maxLatencyMillis);
+
+  /// This computes the current trace features (see getTraceFeatures()) and
+  /// queues them for the batched classifier. Once `batchSize` frames are
+  /// queued, or the oldest queued frame is at least `maxLatencyMillis` older
+  /// than `now`, the whole batch is classified and the logits are applied to
+  /// the traces. This returns true if it classified a batch.
+  bool queueTraceFeatures(
+      int numWindows, long windowDuration, long now, bool center = true);
+
+  /// This classifies whatever trace features are currently queued, even if we
+  /// don't have a full batch yet.
+  void flushTraceFeatures();
+
   /// This method sets the maximum distance that can exist between the last head
   /// of a trace, and a new marker position. Markers that are within this
   /// distance from a trace are not guaranteed to be merged (they must be the
@@ -125,6 +155,19 @@ protected:
   long mTraceTimeoutMillis;
   s_t mTraceMaxJoinDistance;
   int mFeatureMaxStrideToleranceMillis;
+
+  // This is the state for batching up trace features for the classifier. It
+  // has its own lock, so that we never hold mGlobalLock while the classifier
+  // runs.
+  std::mutex mBatchLock;
+  std::function<Eigen::MatrixXs(
+      const Eigen::MatrixXs& features, const Eigen::VectorXi& numPoints)>
+      mBatchedClassifier;
+  int mBatchSize;
+  int mBatchMaxPoints;
+  long mBatchMaxLatencyMillis;
+  std::vector<std::pair<Eigen::MatrixXs, Eigen::VectorXi>> mQueuedFeatures;
+  long mOldestQueuedFeaturesTime;
 };
 
 } // namespace biomechanics
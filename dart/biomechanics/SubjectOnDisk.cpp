@@ -1,11 +1,16 @@
 #include "dart/biomechanics/SubjectOnDisk.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <exception>
+#include <functional>
+#include <future>
 #include <iostream>
 #include <memory>
+#include <set>
 #include <vector>
 
 #include <stdio.h>
@@ -43,6 +48,26 @@ struct FileHeader
 };
 }
 
+// `long` is only 32 bits on Windows, so seeking past 2GB (which a shard can
+// easily be) needs the explicitly 64 bit versions of fseek() and ftell().
+static int fseek64(FILE* file, int64_t offset, int origin)
+{
+#ifdef _WIN32
+  return _fseeki64(file, offset, origin);
+#else
+  return fseeko(file, (off_t)offset, origin);
+#endif
+}
+
+static int64_t ftell64(FILE* file)
+{
+#ifdef _WIN32
+  return _ftelli64(file);
+#else
+  return (int64_t)ftello(file);
+#endif
+}
+
 proto::ProcessingPassType passTypeToProto(ProcessingPassType type)
 {
   switch (type)
@@ -293,7 +318,7 @@ proto::DetectedTrialFeature detectedTrialFeatureToProto(
   return proto::DetectedTrialFeature::walking;
 }
 
-SubjectOnDisk::SubjectOnDisk(const std::string& path)
+SubjectOnDisk::SubjectOnDisk(const std::string& path, int64_t fileOffset)
   : mPath(path), mLoadedAllFrames(false)
 {
   // 1. Open the file
@@ -304,6 +329,14 @@ SubjectOnDisk::SubjectOnDisk(const std::string& path)
               << path << std::endl;
     throw new std::exception();
   }
+  if (fileOffset != 0 && fseek64(file, fileOffset, SEEK_SET) != 0)
+  {
+    std::cout << "SubjectOnDisk attempting to read a B3D at offset "
+              << fileOffset << " of " << path
+              << ", but was unable to seek there." << std::endl;
+    fclose(file);
+    throw new std::exception();
+  }
   // 2. Read the length of the message from the integer header
   int64_t headerSize = -1;
   int64_t elementsRead = fread(&headerSize, sizeof(int64_t), 1, file);
@@ -362,7 +395,9 @@ SubjectOnDisk::SubjectOnDisk(const std::string& path)
   mHeader->read(header);
   mSensorFrameSize = header.raw_sensor_frame_size();
   mProcessingPassFrameSize = header.processing_pass_frame_size();
-  mDataSectionStart = sizeof(int64_t) + headerSize;
+  // All the frame offsets are relative to this, so frames read straight out
+  // of a shard without any other changes
+  mDataSectionStart = fileOffset + sizeof(int64_t) + headerSize;
 
   fclose(file);
 }
@@ -987,13 +1022,13 @@ std::vector<std::shared_ptr<Frame>> SubjectOnDisk::readFrames(
   for (int i = 0; i < numFramesToRead; i++)
   {
     // 2. Seek to the right place in the file to read this frame
-    long offsetBytes
+    int64_t offsetBytes
         = mDataSectionStart + (linearFrameStart + (i * stride * frameSize));
 
     std::shared_ptr<Frame> frame = std::make_shared<Frame>();
     if (includeSensorData)
     {
-      fseek(file, offsetBytes, SEEK_SET);
+      fseek64(file, offsetBytes, SEEK_SET);
 
       // 3. Allocate a buffer to hold the serialized data
       std::vector<char> serializedFrame(mSensorFrameSize);
@@ -1035,7 +1070,7 @@ std::vector<std::shared_ptr<Frame>> SubjectOnDisk::readFrames(
     }
     if (includeProcessingPasses)
     {
-      fseek(file, offsetBytes + mSensorFrameSize, SEEK_SET);
+      fseek64(file, offsetBytes + mSensorFrameSize, SEEK_SET);
 
       // 3. Allocate a buffer to hold the serialized data
       std::vector<char> serializedPassFrame(mProcessingPassFrameSize);
@@ -1951,6 +1986,333 @@ std::string SubjectOnDisk::getNotes()
   return mHeader->mNotes;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This is the SubjectOnDiskShard object
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static const char SHARD_MAGIC[8] = {'B', '3', 'D', 'S', 'H', 'A', 'R', 'D'};
+
+SubjectOnDiskShard::SubjectOnDiskShard(const std::string& path)
+  : mPath(path), mPayloadStart(0)
+{
+  // 1. Open the file
+  FILE* file = fopen(path.c_str(), "r");
+  if (file == nullptr)
+  {
+    std::cout << "SubjectOnDiskShard attempting to open file that does not "
+                 "exist: "
+              << path << std::endl;
+    throw std::exception();
+  }
+
+  // 2. Check that this is actually a shard, and not a B3D
+  char magic[8];
+  if (fread(magic, sizeof(char), 8, file) != 8
+      || memcmp(magic, SHARD_MAGIC, 8) != 0)
+  {
+    std::cout << "SubjectOnDiskShard attempting to read a file that isn't a "
+                 "shard at "
+              << path << std::endl;
+    fclose(file);
+    throw std::exception();
+  }
+
+  // 3. Read and parse the index
+  int64_t indexSize = -1;
+  if (fread(&indexSize, sizeof(int64_t), 1, file) != 1 || indexSize < 0)
+  {
+    std::cout << "SubjectOnDiskShard attempting to read a corrupted shard at "
+              << path << ": was unable to read index size" << std::endl;
+    fclose(file);
+    throw std::exception();
+  }
+  std::vector<char> serializedIndex(indexSize);
+  int64_t bytesRead
+      = fread(serializedIndex.data(), sizeof(char), indexSize, file);
+  fclose(file);
+  if (bytesRead != indexSize
+      || !mIndex.ParseFromArray(serializedIndex.data(), indexSize))
+  {
+    std::cout << "SubjectOnDiskShard attempting to read a corrupted shard at "
+              << path << ": got an error reading the index" << std::endl;
+    throw std::exception();
+  }
+  mPayloadStart = 8 + sizeof(int64_t) + indexSize;
+}
+
+/// This packs the B3D files at `b3dPaths` into a single shard at `shardPath`,
+/// and returns false (leaving `shardPath` untouched) if anything goes wrong
+bool SubjectOnDiskShard::packB3Ds(
+    const std::vector<std::string>& b3dPaths, const std::string& shardPath)
+{
+  // 1. Build the index. Offsets are relative to the end of the index, so we
+  // only need each file's length to know where it will go.
+  proto::SubjectOnDiskShardIndex index;
+  std::vector<int64_t> lengths;
+  std::set<std::string> names;
+  int64_t cursor = 0;
+  for (const std::string& b3dPath : b3dPaths)
+  {
+    // Subjects unpack to their file name, so two files with the same name
+    // (from different folders) would overwrite each other
+    std::string name = b3dPath.substr(b3dPath.find_last_of("/\\") + 1);
+    if (!names.insert(name).second)
+    {
+      std::cout << "SubjectOnDiskShard::packB3Ds() got more than one B3D "
+                   "named "
+                << name << ", which would collide when unpacked. Rename one "
+                << "of them before packing." << std::endl;
+      return false;
+    }
+
+    FILE* b3d = fopen(b3dPath.c_str(), "r");
+    if (b3d == nullptr)
+    {
+      std::cout << "SubjectOnDiskShard::packB3Ds() failed to open input file "
+                << b3dPath << std::endl;
+      return false;
+    }
+    fseek64(b3d, 0, SEEK_END);
+    int64_t length = ftell64(b3d);
+    fclose(b3d);
+    if (length < 0)
+    {
+      std::cout << "SubjectOnDiskShard::packB3Ds() failed to get the length "
+                   "of input file "
+                << b3dPath << std::endl;
+      return false;
+    }
+
+    // This only parses the header, to get the trial lengths for the index
+    SubjectOnDisk subject(b3dPath);
+
+    proto::SubjectOnDiskShardEntry* entry = index.add_subjects();
+    entry->set_name(name);
+    entry->set_offset(cursor);
+    entry->set_length(length);
+    for (int trial = 0; trial < subject.getNumTrials(); trial++)
+    {
+      entry->add_trial_lengths(subject.getTrialLength(trial));
+    }
+    lengths.push_back(length);
+    cursor += length;
+  }
+  std::string indexSerialized = "";
+  if (!index.SerializeToString(&indexSerialized))
+  {
+    std::cout << "SubjectOnDiskShard::packB3Ds() failed to serialize the "
+                 "shard index."
+              << std::endl;
+    return false;
+  }
+
+  // 2. Write the magic and the index. Everything goes to a temporary file
+  // that only replaces `shardPath` once it's complete, so a failure part way
+  // through never leaves a truncated shard behind.
+  std::string tmpPath = shardPath + ".tmp";
+  FILE* file = fopen(tmpPath.c_str(), "wb");
+  if (file == nullptr)
+  {
+    std::cout << "SubjectOnDiskShard::packB3Ds() failed to open output file "
+                 "at "
+              << tmpPath << ". Do you have permissions to write that file?"
+              << std::endl;
+    return false;
+  }
+  int64_t indexSize = indexSerialized.size();
+  bool ok = fwrite(SHARD_MAGIC, sizeof(char), 8, file) == 8
+            && fwrite(&indexSize, sizeof(int64_t), 1, file) == 1
+            && fwrite(indexSerialized.c_str(), sizeof(char), indexSize, file)
+                   == indexSize;
+
+  // 3. Copy each B3D in, in index order. The files have to be exactly as long
+  // as they were when we built the index, or the offsets would be wrong.
+  std::vector<char> buffer(1 << 20);
+  for (int i = 0; ok && i < b3dPaths.size(); i++)
+  {
+    FILE* b3d = fopen(b3dPaths[i].c_str(), "r");
+    if (b3d == nullptr)
+    {
+      std::cout << "SubjectOnDiskShard::packB3Ds() failed to reopen input "
+                   "file "
+                << b3dPaths[i] << std::endl;
+      ok = false;
+      break;
+    }
+    int64_t copied = 0;
+    size_t bytesRead;
+    while ((bytesRead = fread(buffer.data(), sizeof(char), buffer.size(), b3d))
+           > 0)
+    {
+      if (fwrite(buffer.data(), sizeof(char), bytesRead, file) != bytesRead)
+      {
+        std::cout << "SubjectOnDiskShard::packB3Ds() failed writing to "
+                  << tmpPath << std::endl;
+        ok = false;
+        break;
+      }
+      copied += bytesRead;
+    }
+    fclose(b3d);
+    if (ok && copied != lengths[i])
+    {
+      std::cout << "SubjectOnDiskShard::packB3Ds() expected " << lengths[i]
+                << " bytes from " << b3dPaths[i] << " but read " << copied
+                << ". Did the file change while we were packing it?"
+                << std::endl;
+      ok = false;
+    }
+  }
+  if (fclose(file) != 0)
+  {
+    ok = false;
+  }
+
+  // 4. Move the finished shard into place
+  if (!ok)
+  {
+    std::remove(tmpPath.c_str());
+    return false;
+  }
+#ifdef _WIN32
+  // rename() won't overwrite an existing file on Windows
+  std::remove(shardPath.c_str());
+#endif
+  if (std::rename(tmpPath.c_str(), shardPath.c_str()) != 0)
+  {
+    std::cout << "SubjectOnDiskShard::packB3Ds() failed to move " << tmpPath
+              << " to " << shardPath << std::endl;
+    std::remove(tmpPath.c_str());
+    return false;
+  }
+  return true;
+}
+
+/// This writes every subject in the shard back out as its own B3D file
+std::vector<std::string> SubjectOnDiskShard::unpackB3Ds(
+    const std::string& shardPath, const std::string& outputFolder)
+{
+  SubjectOnDiskShard shard(shardPath);
+  std::vector<std::string> paths;
+
+  FILE* file = fopen(shardPath.c_str(), "r");
+  if (file == nullptr)
+  {
+    std::cout << "SubjectOnDiskShard::unpackB3Ds() failed to open "
+              << shardPath << std::endl;
+    return paths;
+  }
+  std::vector<char> buffer(1 << 20);
+  for (int i = 0; i < shard.mIndex.subjects_size(); i++)
+  {
+    const proto::SubjectOnDiskShardEntry& entry = shard.mIndex.subjects(i);
+    std::string path = outputFolder;
+    if (!path.empty() && path.back() != '/')
+    {
+      path += "/";
+    }
+    path += entry.name();
+
+    FILE* b3d = fopen(path.c_str(), "wb");
+    if (b3d == nullptr)
+    {
+      std::cout << "SubjectOnDiskShard::unpackB3Ds() failed to open output "
+                   "file at "
+                << path << ". Do you have permissions to write that file?"
+                << std::endl;
+      continue;
+    }
+    if (fseek64(file, shard.mPayloadStart + entry.offset(), SEEK_SET) != 0)
+    {
+      std::cout << "SubjectOnDiskShard::unpackB3Ds() failed to seek to "
+                << entry.name() << " in " << shardPath << std::endl;
+      fclose(b3d);
+      std::remove(path.c_str());
+      continue;
+    }
+    int64_t remaining = entry.length();
+    while (remaining > 0)
+    {
+      size_t toRead = std::min<int64_t>(remaining, buffer.size());
+      size_t bytesRead = fread(buffer.data(), sizeof(char), toRead, file);
+      if (bytesRead == 0)
+      {
+        std::cout << "SubjectOnDiskShard::unpackB3Ds() hit the end of "
+                  << shardPath << " early, while unpacking " << entry.name()
+                  << std::endl;
+        break;
+      }
+      fwrite(buffer.data(), sizeof(char), bytesRead, b3d);
+      remaining -= bytesRead;
+    }
+    fclose(b3d);
+    paths.push_back(path);
+  }
+  fclose(file);
+  return paths;
+}
+
+/// This returns the number of subjects packed in this shard
+int SubjectOnDiskShard::getNumSubjects()
+{
+  return mIndex.subjects_size();
+}
+
+/// This returns the name (the original B3D file name) of a subject
+std::string SubjectOnDiskShard::getSubjectName(int subject)
+{
+  if (subject < 0 || subject >= mIndex.subjects_size())
+  {
+    std::cout << "SubjectOnDiskShard::getSubjectName() called with invalid "
+                 "subject number: "
+              << subject << std::endl;
+    return "";
+  }
+  return mIndex.subjects(subject).name();
+}
+
+/// This returns the number of trials on a subject, from the index alone
+int SubjectOnDiskShard::getSubjectNumTrials(int subject)
+{
+  if (subject < 0 || subject >= mIndex.subjects_size())
+  {
+    std::cout << "SubjectOnDiskShard::getSubjectNumTrials() called with "
+                 "invalid subject number: "
+              << subject << std::endl;
+    return 0;
+  }
+  return mIndex.subjects(subject).trial_lengths_size();
+}
+
+/// This returns the length of a trial on a subject, from the index alone
+int SubjectOnDiskShard::getSubjectTrialLength(int subject, int trial)
+{
+  if (subject < 0 || subject >= mIndex.subjects_size() || trial < 0
+      || trial >= mIndex.subjects(subject).trial_lengths_size())
+  {
+    std::cout << "SubjectOnDiskShard::getSubjectTrialLength() called with "
+                 "invalid subject/trial number: "
+              << subject << "/" << trial << std::endl;
+    return 0;
+  }
+  return mIndex.subjects(subject).trial_lengths(trial);
+}
+
+/// This reads the header for a subject out of the shard, and returns a
+/// SubjectOnDisk that lazily reads its frames from the shard.
+std::shared_ptr<SubjectOnDisk> SubjectOnDiskShard::getSubject(int subject)
+{
+  if (subject < 0 || subject >= mIndex.subjects_size())
+  {
+    std::cout << "SubjectOnDiskShard::getSubject() called with invalid "
+                 "subject number: "
+              << subject << std::endl;
+    return nullptr;
+  }
+  return std::make_shared<SubjectOnDisk>(
+      mPath, mPayloadStart + mIndex.subjects(subject).offset());
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Builders, to create a SubjectOnDisk from scratch
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -2487,6 +2849,49 @@ void SubjectOnDiskTrialPass::setDofAccelerationFiniteDifferenced(
   mDofAccelerationFiniteDifferenced = dofAccelerationFiniteDifference;
 }
 
+namespace {
+
+// This splits the frames [0, numFrames) into contiguous blocks across
+// `numThreads` threads, and calls `computeBlock(skel, start, end)` once per
+// block. Every block but the last runs on its own clone of `skel`. The last
+// block runs on `skel` itself, so that `skel` is left in the same state as a
+// serial pass would leave it. Each frame sets the full skeleton state it
+// reads, so the results don't depend on how the frames are split.
+void computeFrameBlocksInParallel(
+    std::shared_ptr<dynamics::Skeleton> skel,
+    int numFrames,
+    int numThreads,
+    std::function<void(std::shared_ptr<dynamics::Skeleton>, int, int)>
+        computeBlock)
+{
+  numThreads = std::max(1, std::min(numThreads, numFrames));
+  if (numThreads <= 1)
+  {
+    computeBlock(skel, 0, numFrames);
+    return;
+  }
+
+  int blockSize = (numFrames + numThreads - 1) / numThreads;
+  std::vector<std::future<void>> futures;
+  for (int start = 0; start < numFrames; start += blockSize)
+  {
+    int end = std::min(numFrames, start + blockSize);
+    // Clones are all made before the last block starts mutating `skel`
+    std::shared_ptr<dynamics::Skeleton> threadSkel
+        = end == numFrames ? skel : skel->cloneSkeleton();
+    futures.push_back(std::async(
+        std::launch::async, [threadSkel, start, end, &computeBlock] {
+          computeBlock(threadSkel, start, end);
+        }));
+  }
+  for (auto& future : futures)
+  {
+    future.get();
+  }
+}
+
+} // namespace
+
 // This is for allowing the user to set all the values of a pass at once,
 // without having to manually compute them in Python, which turns out to be
 // slow and difficult to test.
@@ -2499,7 +2904,8 @@ void SubjectOnDiskTrialPass::computeValues(
     Eigen::MatrixXs moments,
     Eigen::MatrixXs cops,
     int rootHistoryLen,
-    int rootHistoryStride)
+    int rootHistoryStride,
+    int numThreads)
 {
   std::vector<ForcePlate> forcePlates;
   int numForcePlates = forces.rows() / 3;
@@ -2524,7 +2930,11 @@ void SubjectOnDiskTrialPass::computeValues(
       footBodyNames,
       forcePlates,
       rootHistoryLen,
-      rootHistoryStride);
+      rootHistoryStride,
+      Eigen::MatrixXs::Zero(0, 0),
+      Eigen::MatrixXs::Zero(0, 0),
+      3.0,
+      numThreads);
 }
 
 // This is for allowing the user to set all the kinematic values of a pass at
@@ -2536,7 +2946,8 @@ void SubjectOnDiskTrialPass::computeKinematicValues(
     int rootHistoryLen,
     int rootHistoryStride,
     Eigen::MatrixXs explicitVels,
-    Eigen::MatrixXs explicitAccs)
+    Eigen::MatrixXs explicitAccs,
+    int numThreads)
 {
   // 1. Assume there are two foot bodies in case that passing matrices that are
   // empty or with mismatching dimensions causes downstream issues.
@@ -2549,9 +2960,9 @@ void SubjectOnDiskTrialPass::computeKinematicValues(
       = Eigen::MatrixXs::Zero(9 * numFootBodies, poses.cols());
 
   // 2. We need to actually run through all the frames and compute the aggregate
-  // values
-  std::vector<s_t> linearResiduals;
-  std::vector<s_t> angularResiduals;
+  // values. There are no dynamics here, so the residuals are all zero.
+  std::vector<s_t> linearResiduals(poses.cols(), 0.0);
+  std::vector<s_t> angularResiduals(poses.cols(), 0.0);
   Eigen::MatrixXs vels
       = Eigen::MatrixXs::Zero(skel->getNumDofs(), poses.cols());
   if (explicitVels.cols() == poses.cols()
@@ -2590,46 +3001,47 @@ void SubjectOnDiskTrialPass::computeKinematicValues(
       = Eigen::MatrixXs::Zero(3 * rootHistoryLen, poses.cols());
 
   s_t dt = timestep;
-  std::vector<Eigen::Isometry3s> rootTransforms;
-  for (int t = 0; t < poses.cols(); t++)
-  {
+  bool hasExplicitVels = explicitVels.cols() == poses.cols()
+                         && explicitVels.rows() == poses.rows();
+  bool hasExplicitAccs = explicitAccs.cols() == poses.cols()
+                         && explicitAccs.rows() == poses.rows();
+  std::vector<Eigen::Isometry3s> rootTransforms(poses.cols());
+  // Frames are independent, so every output here is written straight into
+  // its own column of the preallocated matrices
+  auto computeFrame = [&](dynamics::Skeleton* threadSkel, int t) {
     Eigen::VectorXs q = poses.col(t);
-    skel->setPositions(q);
-    comPoses.col(t) = skel->getCOM();
-    Eigen::Isometry3s T_wr = skel->getRootBodyNode()->getWorldTransform();
-    rootTransforms.push_back(T_wr);
+    threadSkel->setPositions(q);
+    comPoses.col(t) = threadSkel->getCOM();
+    Eigen::Isometry3s T_wr
+        = threadSkel->getRootBodyNode()->getWorldTransform();
+    rootTransforms[t] = T_wr;
 
     Eigen::VectorXs worldCenters
-        = skel->getJointWorldPositions(skel->getJoints());
+        = threadSkel->getJointWorldPositions(threadSkel->getJoints());
     jointCenters.col(t) = worldCenters;
-    for (int j = 0; j < skel->getNumJoints(); j++)
+    for (int j = 0; j < threadSkel->getNumJoints(); j++)
     {
       jointCentersInRootFrame.block<3, 1>(j * 3, t)
           = T_wr.inverse() * worldCenters.segment<3>(j * 3);
     }
 
-    s_t linearResidual = 0.0;
-    s_t angularResidual = 0.0;
     if (t > 0)
     {
-      if (explicitVels.cols() == poses.cols()
-          && explicitVels.rows() == poses.rows())
-      {
-        // Do nothing
-      }
-      else
+      if (!hasExplicitVels)
       {
-        vels.col(t)
-            = skel->getPositionDifferences(poses.col(t), poses.col(t - 1)) / dt;
+        vels.col(t) = threadSkel->getPositionDifferences(
+                          poses.col(t), poses.col(t - 1))
+                      / dt;
       }
       Eigen::VectorXs dq = vels.col(t);
-      skel->setVelocities(dq);
-      comVels.col(t) = skel->getCOMLinearVelocity();
-      if (skel->getRootJoint() != nullptr
-          && skel->getRootJoint()->getNumDofs() == 6)
+      threadSkel->setVelocities(dq);
+      comVels.col(t) = threadSkel->getCOMLinearVelocity();
+      if (threadSkel->getRootJoint() != nullptr
+          && threadSkel->getRootJoint()->getNumDofs() == 6)
       {
         const Eigen::Vector6s rootSpatialVel
-            = skel->getRootJoint()->getRelativeJacobian() * dq.head<6>();
+            = threadSkel->getRootJoint()->getRelativeJacobian()
+              * dq.head<6>();
         const Eigen::Vector3s rootAngVel = rootSpatialVel.head<3>();
         rootSpatialVelInRootFrame.col(t).head<3>() = rootAngVel;
         const Eigen::Vector3s rootLinVel = rootSpatialVel.tail<3>();
@@ -2639,46 +3051,52 @@ void SubjectOnDiskTrialPass::computeKinematicValues(
       if (t < poses.cols() - 1)
       {
         Eigen::VectorXs ddq;
-        if (explicitAccs.cols() == poses.cols()
-            && explicitAccs.rows() == poses.rows())
+        if (hasExplicitAccs)
         {
           ddq = explicitAccs.col(t);
         }
         else
         {
-          ddq = (skel->getPositionDifferences(poses.col(t + 1), poses.col(t))
-                 - skel->getPositionDifferences(poses.col(t), poses.col(t - 1)))
+          ddq = (threadSkel->getPositionDifferences(
+                     poses.col(t + 1), poses.col(t))
+                 - threadSkel->getPositionDifferences(
+                     poses.col(t), poses.col(t - 1)))
                 / (dt * dt);
         }
 
-        Eigen::Vector6s residual = Eigen::Vector6s::Zero();
-        angularResidual = residual.head<3>().norm();
-        linearResidual = residual.tail<3>().norm();
-
         accs.col(t) = ddq;
-        taus.col(t) = Eigen::VectorXs::Zero(skel->getNumDofs());
+        taus.col(t) = Eigen::VectorXs::Zero(threadSkel->getNumDofs());
 
-        skel->setAccelerations(ddq);
-        comAccs.col(t) = skel->getCOMLinearAcceleration() - skel->getGravity();
+        threadSkel->setAccelerations(ddq);
+        comAccs.col(t)
+            = threadSkel->getCOMLinearAcceleration() - threadSkel->getGravity();
         comAccsInRootFrame.col(t) = T_wr.linear().transpose() * comAccs.col(t);
 
-        if (skel->getRootJoint()->getNumDofs() == 6)
+        if (threadSkel->getRootJoint()->getNumDofs() == 6)
         {
           const Eigen::MatrixXs rootJac
-              = skel->getRootJoint()->getRelativeJacobian();
+              = threadSkel->getRootJoint()->getRelativeJacobian();
           const Eigen::Vector6s rootSpatialAcc = rootJac * ddq.head<6>();
           const Eigen::Vector3s rootAngAcc = rootSpatialAcc.head<3>();
           rootSpatialAccInRootFrame.col(t).head<3>() = rootAngAcc;
           const Eigen::Vector3s rootLinAcc
               = rootSpatialAcc.tail<3>()
-                - (T_wr.linear().transpose() * skel->getGravity());
+                - (T_wr.linear().transpose() * threadSkel->getGravity());
           rootSpatialAccInRootFrame.col(t).tail<3>() = rootLinAcc;
         }
       }
     }
-    linearResiduals.push_back(linearResidual);
-    angularResiduals.push_back(angularResidual);
-  }
+  };
+  computeFrameBlocksInParallel(
+      skel,
+      poses.cols(),
+      numThreads,
+      [&](std::shared_ptr<dynamics::Skeleton> threadSkel, int start, int end) {
+        for (int t = start; t < end; t++)
+        {
+          computeFrame(threadSkel.get(), t);
+        }
+      });
 
   assert(poses.cols() == rootTransforms.size());
   for (int t = 0; t < rootTransforms.size(); t++)
@@ -2737,7 +3155,8 @@ void SubjectOnDiskTrialPass::computeValuesFromForcePlates(
     int rootHistoryStride,
     Eigen::MatrixXs explicitVels,
     Eigen::MatrixXs explicitAccs,
-    s_t forcePlateZeroThresholdNewtons)
+    s_t forcePlateZeroThresholdNewtons,
+    int numThreads)
 {
   // 0. Compute kinematic values
   computeKinematicValues(
@@ -2747,7 +3166,8 @@ void SubjectOnDiskTrialPass::computeValuesFromForcePlates(
       rootHistoryLen,
       rootHistoryStride,
       explicitVels,
-      explicitAccs);
+      explicitAccs,
+      numThreads);
   const auto& vels = getVels();
   const auto& accs = getAccs();
 
@@ -2801,8 +3221,8 @@ void SubjectOnDiskTrialPass::computeValuesFromForcePlates(
 
   // 2. We need to actually run through all the frames and compute the aggregate
   // values
-  std::vector<s_t> linearResiduals;
-  std::vector<s_t> angularResiduals;
+  std::vector<s_t> linearResiduals(poses.cols(), 0.0);
+  std::vector<s_t> angularResiduals(poses.cols(), 0.0);
   Eigen::MatrixXs taus
       = Eigen::MatrixXs::Zero(skel->getNumDofs(), poses.cols());
   Eigen::MatrixXs residualWrenchInRootFrame
@@ -2810,21 +3230,19 @@ void SubjectOnDiskTrialPass::computeValuesFromForcePlates(
   Eigen::MatrixXs groundBodyWrenchesInRootFrame
       = Eigen::MatrixXs::Zero(6 * footBodyNames.size(), poses.cols());
 
-  ResidualForceHelper helper(skel, footIndices);
-  std::vector<Eigen::Isometry3s> rootTransforms;
-  for (int t = 0; t < poses.cols(); t++)
-  {
+  // Frames are independent, so every output here is written straight into
+  // its own column of the preallocated matrices
+  auto computeFrame = [&](dynamics::Skeleton* threadSkel,
+                          ResidualForceHelper& helper, int t) {
     const Eigen::VectorXs& q = poses.col(t);
-    skel->setPositions(q);
-    Eigen::Isometry3s T_wr = skel->getRootBodyNode()->getWorldTransform();
-    rootTransforms.push_back(T_wr);
+    threadSkel->setPositions(q);
+    Eigen::Isometry3s T_wr
+        = threadSkel->getRootBodyNode()->getWorldTransform();
 
-    s_t linearResidual = 0.0;
-    s_t angularResidual = 0.0;
     if (t > 0)
     {
       const Eigen::VectorXs& dq = vels.col(t);
-      skel->setVelocities(dq);
+      threadSkel->setVelocities(dq);
 
       if (t < poses.cols() - 1)
       {
@@ -2832,16 +3250,16 @@ void SubjectOnDiskTrialPass::computeValuesFromForcePlates(
         Eigen::VectorXs tau
             = helper.calculateInverseDynamics(q, dq, ddq, grfTrial.col(t));
         Eigen::Vector6s residual = tau.head<6>();
-        angularResidual = residual.head<3>().norm();
-        linearResidual = residual.tail<3>().norm();
+        angularResiduals[t] = residual.head<3>().norm();
+        linearResiduals[t] = residual.tail<3>().norm();
 
         taus.col(t) = tau;
 
-        skel->setAccelerations(ddq);
-        if (skel->getRootJoint()->getNumDofs() == 6)
+        threadSkel->setAccelerations(ddq);
+        if (threadSkel->getRootJoint()->getNumDofs() == 6)
         {
           Eigen::Matrix6s rootJacobianTransposeInverse
-              = skel->getRootJoint()
+              = threadSkel->getRootJoint()
                     ->getRelativeJacobian()
                     .transpose()
                     .completeOrthogonalDecomposition()
@@ -2906,16 +3324,19 @@ void SubjectOnDiskTrialPass::computeValuesFromForcePlates(
         // joint torques
 
         std::vector<Eigen::Vector6s> rootFrameContactWrenches;
-        for (int b = 0; b < footBodies.size(); b++)
+        std::vector<dynamics::BodyNode*> threadFootBodies;
+        for (int b = 0; b < footIndices.size(); b++)
         {
           rootFrameContactWrenches.push_back(
               groundBodyWrenchesInRootFrame.block<6, 1>(b * 6, t));
+          threadFootBodies.push_back(threadSkel->getBodyNode(footIndices[b]));
         }
-        Eigen::VectorXs recoveredTau = skel->getInverseDynamicsFromPredictions(
-            ddq,
-            footBodies,
-            rootFrameContactWrenches,
-            residualWrenchInRootFrame.col(t));
+        Eigen::VectorXs recoveredTau
+            = threadSkel->getInverseDynamicsFromPredictions(
+                ddq,
+                threadFootBodies,
+                rootFrameContactWrenches,
+                residualWrenchInRootFrame.col(t));
         tau.head<6>().setZero();
         if ((recoveredTau - tau).norm() > 1e-8)
         {
@@ -2930,9 +3351,18 @@ void SubjectOnDiskTrialPass::computeValuesFromForcePlates(
 #endif
       }
     }
-    linearResiduals.push_back(linearResidual);
-    angularResiduals.push_back(angularResidual);
-  }
+  };
+  computeFrameBlocksInParallel(
+      skel,
+      poses.cols(),
+      numThreads,
+      [&](std::shared_ptr<dynamics::Skeleton> threadSkel, int start, int end) {
+        ResidualForceHelper helper(threadSkel, footIndices);
+        for (int t = start; t < end; t++)
+        {
+          computeFrame(threadSkel.get(), helper, t);
+        }
+      });
 
   setLinearResidual(linearResiduals);
   setAngularResidual(angularResiduals);
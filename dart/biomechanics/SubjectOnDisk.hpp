@@ -1,6 +1,7 @@
 #ifndef BIOMECH_SUBJECT_ON_DISK
 #define BIOMECH_SUBJECT_ON_DISK
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -175,7 +176,9 @@ public:
       Eigen::MatrixXs cops,
       // How much history to use for the root position and orientation
       int rootHistoryLen = 5,
-      int rootHistoryStride = 1);
+      int rootHistoryStride = 1,
+      // How many threads to split the frames across
+      int numThreads = 1);
 
   // This is for allowing the user to set all the kinematic values of a pass at
   // once. All dynamics values are set to zero.
@@ -187,7 +190,9 @@ public:
       int rootHistoryLen = 5,
       int rootHistoryStride = 1,
       Eigen::MatrixXs explicitVels = Eigen::MatrixXs::Zero(0, 0),
-      Eigen::MatrixXs explicitAccs = Eigen::MatrixXs::Zero(0, 0));
+      Eigen::MatrixXs explicitAccs = Eigen::MatrixXs::Zero(0, 0),
+      // How many threads to split the frames across
+      int numThreads = 1);
 
   // This is for allowing the user to set all the values of a pass at once,
   // without having to manually compute them in Python, which turns out to be
@@ -203,7 +208,9 @@ public:
       int rootHistoryStride = 1,
       Eigen::MatrixXs explicitVels = Eigen::MatrixXs::Zero(0, 0),
       Eigen::MatrixXs explicitAccs = Eigen::MatrixXs::Zero(0, 0),
-      s_t forcePlateZeroThresholdNewtons = 3.0);
+      s_t forcePlateZeroThresholdNewtons = 3.0,
+      // How many threads to split the frames across
+      int numThreads = 1);
 
   // Manual setters (and getters) that compete with computeValues()
   void setLinearResidual(std::vector<s_t> linearResidual);
@@ -546,7 +553,10 @@ protected:
 class SubjectOnDisk
 {
 public:
-  SubjectOnDisk(const std::string& path);
+  /// This opens the B3D at `path`. If `fileOffset` is non-zero, the B3D starts
+  /// that many bytes into the file, which is how subjects are read out of a
+  /// SubjectOnDiskShard.
+  SubjectOnDisk(const std::string& path, int64_t fileOffset = 0);
 
   SubjectOnDisk(std::shared_ptr<SubjectOnDiskHeader> header);
 
@@ -711,7 +721,7 @@ protected:
   std::string mPath;
   // We cache some very basic data about the accessible bounds of on-disk data,
   // so we don't have to look that up every time.
-  long mDataSectionStart;
+  int64_t mDataSectionStart;
   long mSensorFrameSize;
   long mProcessingPassFrameSize;
   bool mLoadedAllFrames;
@@ -719,6 +729,59 @@ protected:
   std::shared_ptr<SubjectOnDiskHeader> mHeader;
 };
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This is the SubjectOnDiskShard object
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * This packs many B3D files into one large file, with an index of the
+ * subjects, their trials, and where each subject's bytes live. Opening a shard
+ * only reads the index, and each subject is then read through the usual
+ * SubjectOnDisk API, so a corpus of many small subjects can be enumerated
+ * without opening and parsing every file.
+ */
+class SubjectOnDiskShard
+{
+public:
+  SubjectOnDiskShard(const std::string& path);
+
+  /// This packs the B3D files at `b3dPaths` into a single shard at
+  /// `shardPath`, copying each file byte-for-byte. Subjects are named after
+  /// the file name of their B3D, so two B3Ds with the same file name are
+  /// rejected. The shard is written to a temporary file and only moved to
+  /// `shardPath` once complete, so this returns false (and leaves any
+  /// existing file at `shardPath` alone) if anything goes wrong.
+  static bool packB3Ds(
+      const std::vector<std::string>& b3dPaths, const std::string& shardPath);
+
+  /// This writes every subject in the shard at `shardPath` back out as its own
+  /// B3D file in `outputFolder`, and returns the paths it wrote.
+  static std::vector<std::string> unpackB3Ds(
+      const std::string& shardPath, const std::string& outputFolder);
+
+  /// This returns the number of subjects packed in this shard
+  int getNumSubjects();
+
+  /// This returns the name (the original B3D file name) of a subject
+  std::string getSubjectName(int subject);
+
+  /// This returns the number of trials on a subject, from the index alone
+  int getSubjectNumTrials(int subject);
+
+  /// This returns the length of a trial on a subject, from the index alone
+  int getSubjectTrialLength(int subject, int trial);
+
+  /// This reads the header for a subject out of the shard, and returns a
+  /// SubjectOnDisk that lazily reads its frames from the shard.
+  std::shared_ptr<SubjectOnDisk> getSubject(int subject);
+
+protected:
+  std::string mPath;
+  // Subject offsets in the index are relative to this
+  int64_t mPayloadStart;
+  proto::SubjectOnDiskShardIndex mIndex;
+};
+
 } // namespace biomechanics
 } // namespace dart
 
@@ -32,7 +32,12 @@
 
 #include "dart/collision/dart/DARTCollide.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <thread>
 
 #include "dart/collision/CollisionObject.hpp"
@@ -2020,6 +2025,38 @@ void ccdSupportCapsule(
   _out->v[2] = static_cast<ccd_real_t>(out(2));
 }
 
+/// libccd support function for a multi-sphere convex hull
+void ccdSupportMultiSphere(
+    const void* _obj, const ccd_vec3_t* _dir, ccd_vec3_t* _out)
+{
+  ccdMultiSphere* hull = (ccdMultiSphere*)_obj;
+
+  Eigen::Vector3s dir;
+  dir(0) = static_cast<s_t>(_dir->v[0]);
+  dir(1) = static_cast<s_t>(_dir->v[1]);
+  dir(2) = static_cast<s_t>(_dir->v[2]);
+  dir.normalize();
+
+  // The hull's support point is the support point of whichever sphere reaches
+  // furthest along dir
+  Eigen::Vector3s out = Eigen::Vector3s::Zero();
+  s_t maxDot = -std::numeric_limits<s_t>::infinity();
+  for (const auto& sphere : *(hull->spheres))
+  {
+    const Eigen::Vector3s point
+        = *(hull->transform) * sphere.second + dir * sphere.first;
+    const s_t dot = point.dot(dir);
+    if (dot > maxDot)
+    {
+      maxDot = dot;
+      out = point;
+    }
+  }
+  _out->v[0] = static_cast<ccd_real_t>(out(0));
+  _out->v[1] = static_cast<ccd_real_t>(out(1));
+  _out->v[2] = static_cast<ccd_real_t>(out(2));
+}
+
 /// libccd support function for a box
 void ccdCenterBox(const void* _obj, ccd_vec3_t* _center)
 {
@@ -2056,6 +2093,21 @@ void ccdCenterCapsule(const void* _obj, ccd_vec3_t* _center)
   _center->v[2] = static_cast<ccd_real_t>(capsule->transform->translation()(2));
 }
 
+/// libccd support function for a multi-sphere convex hull
+void ccdCenterMultiSphere(const void* _obj, ccd_vec3_t* _center)
+{
+  ccdMultiSphere* hull = (ccdMultiSphere*)_obj;
+  Eigen::Vector3s center = Eigen::Vector3s::Zero();
+  for (const auto& sphere : *(hull->spheres))
+    center += sphere.second;
+  if (!hull->spheres->empty())
+    center /= static_cast<s_t>(hull->spheres->size());
+  center = *(hull->transform) * center;
+  _center->v[0] = static_cast<ccd_real_t>(center(0));
+  _center->v[1] = static_cast<ccd_real_t>(center(1));
+  _center->v[2] = static_cast<ccd_real_t>(center(2));
+}
+
 /// Find all the vertices within epsilon of lying on the witness plane
 std::vector<Eigen::Vector3s> ccdPointsAtWitnessBox(
     ccdBox* box, ccd_vec3_t* _dir, bool neg)
@@ -3710,6 +3762,7 @@ void clearCcdCache()
   const std::thread::id tid = std::this_thread::get_id();
   _ccdDirCache[tid].clear();
   _ccdPosCache[tid].clear();
+  clearGJKCache();
   // _ccdDirCache.clear();
   // _ccdPosCache.clear();
 }
@@ -3886,6 +3939,46 @@ ccd_vec3_t& getCachedCcdDir(CollisionObject* o1, CollisionObject* o2)
   return dir;
 }
 
+namespace {
+
+// The GJK warm starts are keyed by pair only, and shared between threads, so
+// that short-lived worker threads don't each leave a cache behind. Entries are
+// copied in and out under the lock rather than handed out by reference. Pairs
+// of objects that no longer exist are never looked up again, so once the map
+// gets this big it is simply cleared.
+const std::size_t MAX_GJK_CACHE_SIZE = 1 << 16;
+std::mutex gjkCacheMutex;
+std::unordered_map<long, GJKCache> gjkCache;
+
+} // namespace
+
+// Get a copy of the warm-start simplex for GJK for this pair of objects
+GJKCache loadGJKCache(CollisionObject* o1, CollisionObject* o2)
+{
+  long key = (long)o1 ^ (long)o2;
+  std::lock_guard<std::mutex> lock(gjkCacheMutex);
+  auto it = gjkCache.find(key);
+  return it == gjkCache.end() ? GJKCache() : it->second;
+}
+
+// Save the warm-start simplex for GJK for this pair of objects
+void storeGJKCache(
+    CollisionObject* o1, CollisionObject* o2, const GJKCache& cache)
+{
+  long key = (long)o1 ^ (long)o2;
+  std::lock_guard<std::mutex> lock(gjkCacheMutex);
+  if (gjkCache.size() >= MAX_GJK_CACHE_SIZE && gjkCache.count(key) == 0)
+    gjkCache.clear();
+  gjkCache[key] = cache;
+}
+
+// Forget every saved GJK warm start
+void clearGJKCache()
+{
+  std::lock_guard<std::mutex> lock(gjkCacheMutex);
+  gjkCache.clear();
+}
+
 int collideBoxBoxAsMesh(
     CollisionObject* o1,
     CollisionObject* o2,
@@ -5027,23 +5120,1883 @@ int collideCylinderPlane(
 }
 
 //==============================================================================
-int collide(
+namespace {
+
+/// The terrain features a heightmap contact can be made against, ordered by
+/// dimension.
+enum HeightmapFeatureDim
+{
+  HEIGHTMAP_VERTEX = 0,
+  HEIGHTMAP_EDGE = 1,
+  HEIGHTMAP_FACE = 2
+};
+
+/// A candidate contact between one heightmap triangle and either a sphere or
+/// the side of a pipe. Everything is in the heightmap's local frame.
+struct HeightmapFeature
+{
+  /// The closest point on the terrain
+  Eigen::Vector3s terrainPoint;
+  /// The sphere center, or the closest point on the pipe axis
+  Eigen::Vector3s queryPoint;
+  /// Distance from queryPoint to the terrain. For faces this is signed, and
+  /// negative once queryPoint sinks below the face.
+  s_t distance;
+  /// Radius of the sphere or pipe
+  s_t radius;
+  /// Only filled for pipes, the ends of the pipe axis
+  Eigen::Vector3s pipeA;
+  Eigen::Vector3s pipeB;
+  HeightmapFeatureDim dim;
+  /// True if this is against the side of a pipe, rather than a sphere
+  bool onPipe;
+  /// Sorted grid vertex ids of the feature, only the first (dim + 1) are used
+  int featureIds[3];
+  /// Grid vertex ids of the triangle that found this feature
+  int triangleIds[3];
+  /// Upwards normal of that triangle
+  Eigen::Vector3s faceNormal;
+  /// Only filled for edges
+  Eigen::Vector3s edgeFixedPoint;
+  Eigen::Vector3s edgeDir;
+};
+
+/// A read-only view of the vertex grid of a HeightmapShape, in the
+/// heightmap's local frame. Vertex (i, j) is column i and row j of the height
+/// field. Columns run along +X, rows run along -Y, and the grid is centered
+/// on the origin. Cell (i, j) spans vertices (i, j) to (i + 1, j + 1), and is
+/// split into two triangles along its (i, j) - (i + 1, j + 1) diagonal.
+template <typename S>
+class HeightmapGrid
+{
+public:
+  explicit HeightmapGrid(const dynamics::HeightmapShape<S>& heightmap)
+    : mHeights(heightmap.getHeightField()),
+      mScale(heightmap.getScale().template cast<s_t>()),
+      mWidth(static_cast<int>(heightmap.getWidth())),
+      mDepth(static_cast<int>(heightmap.getDepth()))
+  {
+    mOriginX = -0.5 * (mWidth - 1) * mScale(0);
+    mOriginY = 0.5 * (mDepth - 1) * mScale(1);
+    mMaxHeight = static_cast<s_t>(heightmap.getMaxHeight()) * mScale(2);
+  }
+
+  /// The number of vertices along X
+  int getWidth() const
+  {
+    return mWidth;
+  }
+
+  /// The number of vertices along Y
+  int getDepth() const
+  {
+    return mDepth;
+  }
+
+  int getVertexId(int i, int j) const
+  {
+    return j * mWidth + i;
+  }
+
+  Eigen::Vector3s getVertex(int id) const
+  {
+    const int i = id % mWidth;
+    const int j = id / mWidth;
+    return Eigen::Vector3s(
+        mOriginX + i * mScale(0),
+        mOriginY - j * mScale(1),
+        static_cast<s_t>(mHeights(j, i)) * mScale(2));
+  }
+
+  /// Returns true if the heights of cell (i, j) overlap [minZ, maxZ].
+  bool cellOverlapsHeights(int i, int j, s_t minZ, s_t maxZ) const
+  {
+    const S a = mHeights(j, i);
+    const S b = mHeights(j, i + 1);
+    const S c = mHeights(j + 1, i);
+    const S d = mHeights(j + 1, i + 1);
+    const s_t cellMin
+        = static_cast<s_t>(std::min(std::min(a, b), std::min(c, d)));
+    const s_t cellMax
+        = static_cast<s_t>(std::max(std::max(a, b), std::max(c, d)));
+    return cellMax * mScale(2) >= minZ && cellMin * mScale(2) <= maxZ;
+  }
+
+  /// Finds the (inclusive) range of cells under the XY footprint of the box
+  /// [min, max]. Returns false if there are none, or if the box is entirely
+  /// above the highest point of the heightmap.
+  bool getCellRange(
+      const Eigen::Vector3s& min,
+      const Eigen::Vector3s& max,
+      int& iMin,
+      int& iMax,
+      int& jMin,
+      int& jMax) const
+  {
+    if (mWidth < 2 || mDepth < 2 || min(2) > mMaxHeight)
+      return false;
+    if (max(0) < mOriginX || min(0) > mOriginX + (mWidth - 1) * mScale(0)
+        || min(1) > mOriginY || max(1) < mOriginY - (mDepth - 1) * mScale(1))
+      return false;
+
+    iMin = std::max(
+        0, static_cast<int>(floor((min(0) - mOriginX) / mScale(0))));
+    iMax = std::min(
+        mWidth - 2, static_cast<int>(floor((max(0) - mOriginX) / mScale(0))));
+    jMin = std::max(
+        0, static_cast<int>(floor((mOriginY - max(1)) / mScale(1))));
+    jMax = std::min(
+        mDepth - 2, static_cast<int>(floor((mOriginY - min(1)) / mScale(1))));
+    return iMin <= iMax && jMin <= jMax;
+  }
+
+  /// Gets the vertex ids of triangle `t` (0 or 1) of cell (i, j), wound so
+  /// that the face normal points up.
+  void getCellTriangle(int i, int j, int t, int ids[3]) const
+  {
+    ids[0] = getVertexId(i, j);
+    ids[1] = t == 0 ? getVertexId(i, j + 1) : getVertexId(i + 1, j + 1);
+    ids[2] = t == 0 ? getVertexId(i + 1, j + 1) : getVertexId(i + 1, j);
+  }
+
+  /// Finds the terrain triangle under the local point (x, y), and the height
+  /// of the terrain at that point. Returns false if (x, y) is off the grid.
+  bool getSurface(s_t x, s_t y, s_t& height, Eigen::Vector3s& normal) const
+  {
+    const s_t u = (x - mOriginX) / mScale(0);
+    const s_t v = (mOriginY - y) / mScale(1);
+    if (mWidth < 2 || mDepth < 2 || u < 0 || v < 0 || u > mWidth - 1
+        || v > mDepth - 1)
+      return false;
+
+    const int i = std::min(mWidth - 2, static_cast<int>(floor(u)));
+    const int j = std::min(mDepth - 2, static_cast<int>(floor(v)));
+    int ids[3];
+    getCellTriangle(i, j, (v - j) >= (u - i) ? 0 : 1, ids);
+
+    const Eigen::Vector3s a = getVertex(ids[0]);
+    normal = (getVertex(ids[1]) - a).cross(getVertex(ids[2]) - a).normalized();
+    height
+        = a(2) - (normal(0) * (x - a(0)) + normal(1) * (y - a(1))) / normal(2);
+    return true;
+  }
+
+protected:
+  const typename dynamics::HeightmapShape<S>::HeightField& mHeights;
+  Eigen::Vector3s mScale;
+  int mWidth;
+  int mDepth;
+  s_t mOriginX;
+  s_t mOriginY;
+  s_t mMaxHeight;
+};
+
+/// Finds the closest point to `p` on the triangle (a, b, c). This also
+/// reports which feature of the triangle that point is on, as a dimension and
+/// the indices (into a, b, c) of the feature's vertices.
+Eigen::Vector3s closestPointOnHeightmapTriangle(
+    const Eigen::Vector3s& p,
+    const Eigen::Vector3s& a,
+    const Eigen::Vector3s& b,
+    const Eigen::Vector3s& c,
+    HeightmapFeatureDim& dim,
+    int feature[2])
+{
+  const Eigen::Vector3s ab = b - a;
+  const Eigen::Vector3s ac = c - a;
+  const Eigen::Vector3s ap = p - a;
+  const s_t d1 = ab.dot(ap);
+  const s_t d2 = ac.dot(ap);
+  if (d1 <= 0 && d2 <= 0)
+  {
+    dim = HEIGHTMAP_VERTEX;
+    feature[0] = 0;
+    return a;
+  }
+
+  const Eigen::Vector3s bp = p - b;
+  const s_t d3 = ab.dot(bp);
+  const s_t d4 = ac.dot(bp);
+  if (d3 >= 0 && d4 <= d3)
+  {
+    dim = HEIGHTMAP_VERTEX;
+    feature[0] = 1;
+    return b;
+  }
+
+  const s_t vc = d1 * d4 - d3 * d2;
+  if (vc <= 0 && d1 >= 0 && d3 <= 0)
+  {
+    dim = HEIGHTMAP_EDGE;
+    feature[0] = 0;
+    feature[1] = 1;
+    return a + ab * (d1 / (d1 - d3));
+  }
+
+  const Eigen::Vector3s cp = p - c;
+  const s_t d5 = ab.dot(cp);
+  const s_t d6 = ac.dot(cp);
+  if (d6 >= 0 && d5 <= d6)
+  {
+    dim = HEIGHTMAP_VERTEX;
+    feature[0] = 2;
+    return c;
+  }
+
+  const s_t vb = d5 * d2 - d1 * d6;
+  if (vb <= 0 && d2 >= 0 && d6 <= 0)
+  {
+    dim = HEIGHTMAP_EDGE;
+    feature[0] = 0;
+    feature[1] = 2;
+    return a + ac * (d2 / (d2 - d6));
+  }
+
+  const s_t va = d3 * d6 - d5 * d4;
+  if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+  {
+    dim = HEIGHTMAP_EDGE;
+    feature[0] = 1;
+    feature[1] = 2;
+    return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+  }
+
+  dim = HEIGHTMAP_FACE;
+  const s_t denom = 1.0 / (va + vb + vc);
+  return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+/// Fills in the bookkeeping that every HeightmapFeature needs.
+void initHeightmapFeature(
+    HeightmapFeature& feature,
+    HeightmapFeatureDim dim,
+    bool onPipe,
+    const int triangleIds[3],
+    const int* localIds,
+    const Eigen::Vector3s* triangle,
+    const Eigen::Vector3s& faceNormal)
+{
+  feature.dim = dim;
+  feature.onPipe = onPipe;
+  feature.faceNormal = faceNormal;
+  for (int k = 0; k < 3; k++)
+  {
+    feature.triangleIds[k] = triangleIds[k];
+    feature.featureIds[k]
+        = dim == HEIGHTMAP_FACE ? triangleIds[k] : triangleIds[localIds[0]];
+  }
+  if (dim == HEIGHTMAP_EDGE)
+  {
+    feature.featureIds[1] = triangleIds[localIds[1]];
+    feature.edgeFixedPoint = triangle[localIds[0]];
+    feature.edgeDir
+        = (triangle[localIds[1]] - triangle[localIds[0]]).normalized();
+  }
+  std::sort(feature.featureIds, feature.featureIds + dim + 1);
+}
+
+/// Records the closest feature of a terrain triangle to a sphere, if it's
+/// within the sphere's radius.
+void findHeightmapSphereFeature(
+    const Eigen::Vector3s& center,
+    s_t radius,
+    const int triangleIds[3],
+    const Eigen::Vector3s* triangle,
+    const Eigen::Vector3s& faceNormal,
+    std::vector<HeightmapFeature>& features)
+{
+  HeightmapFeatureDim dim;
+  int localIds[2];
+  const Eigen::Vector3s closest = closestPointOnHeightmapTriangle(
+      center, triangle[0], triangle[1], triangle[2], dim, localIds);
+
+  s_t distance;
+  if (dim == HEIGHTMAP_FACE)
+  {
+    distance = faceNormal.dot(center - triangle[0]);
+    if (distance >= radius)
+      return;
+  }
+  else
+  {
+    // Edges and vertices only count from above the terrain. From below, the
+    // face of this triangle or a neighbor is the real contact.
+    const Eigen::Vector3s diff = center - closest;
+    distance = diff.norm();
+    if (distance >= radius || diff.dot(faceNormal) <= 0)
+      return;
+  }
+
+  HeightmapFeature feature;
+  initHeightmapFeature(
+      feature, dim, false, triangleIds, localIds, triangle, faceNormal);
+  feature.terrainPoint = closest;
+  feature.queryPoint = center;
+  feature.distance = distance;
+  feature.radius = radius;
+  features.push_back(feature);
+}
+
+/// Records the edges and vertices of a terrain triangle that are within
+/// `radius` of the interior of the pipe from `a` to `b`. Contacts at the ends
+/// of the pipe are left to findHeightmapSphereFeature().
+void findHeightmapPipeFeatures(
+    const Eigen::Vector3s& a,
+    const Eigen::Vector3s& b,
+    s_t radius,
+    const int triangleIds[3],
+    const Eigen::Vector3s* triangle,
+    const Eigen::Vector3s& faceNormal,
+    std::vector<HeightmapFeature>& features)
+{
+  const s_t INTERIOR_THRESHOLD = 1e-8;
+
+  for (int e = 0; e < 3; e++)
+  {
+    const int localIds[2] = {e, (e + 1) % 3};
+    const Eigen::Vector3s& e0 = triangle[localIds[0]];
+    const Eigen::Vector3s& e1 = triangle[localIds[1]];
+    s_t alpha, beta;
+    dSegmentsClosestApproach(a, e0, b, e1, &alpha, &beta);
+    if (alpha < INTERIOR_THRESHOLD || alpha > 1 - INTERIOR_THRESHOLD
+        || beta < INTERIOR_THRESHOLD || beta > 1 - INTERIOR_THRESHOLD)
+      continue;
+
+    const Eigen::Vector3s pipePoint = a + (b - a) * alpha;
+    const Eigen::Vector3s edgePoint = e0 + (e1 - e0) * beta;
+    const Eigen::Vector3s diff = pipePoint - edgePoint;
+    const s_t distance = diff.norm();
+    if (distance >= radius || diff.dot(faceNormal) <= 0)
+      continue;
+
+    HeightmapFeature feature;
+    initHeightmapFeature(
+        feature,
+        HEIGHTMAP_EDGE,
+        true,
+        triangleIds,
+        localIds,
+        triangle,
+        faceNormal);
+    feature.terrainPoint = edgePoint;
+    feature.queryPoint = pipePoint;
+    feature.distance = distance;
+    feature.radius = radius;
+    feature.pipeA = a;
+    feature.pipeB = b;
+    features.push_back(feature);
+  }
+
+  for (int v = 0; v < 3; v++)
+  {
+    s_t alpha;
+    const s_t distance = dDistPointToSegment(triangle[v], a, b, &alpha);
+    if (alpha < INTERIOR_THRESHOLD || alpha > 1 - INTERIOR_THRESHOLD
+        || distance >= radius)
+      continue;
+
+    const Eigen::Vector3s pipePoint = a + (b - a) * alpha;
+    if ((pipePoint - triangle[v]).dot(faceNormal) <= 0)
+      continue;
+
+    HeightmapFeature feature;
+    initHeightmapFeature(
+        feature,
+        HEIGHTMAP_VERTEX,
+        true,
+        triangleIds,
+        &v,
+        triangle,
+        faceNormal);
+    feature.terrainPoint = triangle[v];
+    feature.queryPoint = pipePoint;
+    feature.distance = distance;
+    feature.radius = radius;
+    feature.pipeA = a;
+    feature.pipeB = b;
+    features.push_back(feature);
+  }
+}
+
+/// Collects the terrain features within `radius` of the segment from `a` to
+/// `b`, which are in the heightmap's local frame. If `a == b` this is just a
+/// sphere. If `withEndSpheres` is false, only the side of the pipe is tested.
+/// Only the cells under the segment's bounding box are visited, and cells
+/// whose height range doesn't overlap that box are skipped without building
+/// their triangles.
+template <typename S>
+void findHeightmapFeatures(
+    const HeightmapGrid<S>& grid,
+    const Eigen::Vector3s& a,
+    const Eigen::Vector3s& b,
+    s_t radius,
+    std::vector<HeightmapFeature>& features,
+    bool withEndSpheres = true)
+{
+  const Eigen::Vector3s padding = Eigen::Vector3s::Constant(radius);
+  const Eigen::Vector3s min = a.cwiseMin(b) - padding;
+  const Eigen::Vector3s max = a.cwiseMax(b) + padding;
+  int iMin, iMax, jMin, jMax;
+  if (!grid.getCellRange(min, max, iMin, iMax, jMin, jMax))
+    return;
+
+  const bool isPipe = a != b;
+  for (int j = jMin; j <= jMax; j++)
+  {
+    for (int i = iMin; i <= iMax; i++)
+    {
+      if (!grid.cellOverlapsHeights(i, j, min(2), max(2)))
+        continue;
+
+      for (int t = 0; t < 2; t++)
+      {
+        int ids[3];
+        grid.getCellTriangle(i, j, t, ids);
+        const Eigen::Vector3s triangle[3] = {grid.getVertex(ids[0]),
+                                             grid.getVertex(ids[1]),
+                                             grid.getVertex(ids[2])};
+        const Eigen::Vector3s faceNormal = (triangle[1] - triangle[0])
+                                               .cross(triangle[2] - triangle[0])
+                                               .normalized();
+
+        if (withEndSpheres)
+          findHeightmapSphereFeature(
+              a, radius, ids, triangle, faceNormal, features);
+        if (isPipe)
+        {
+          if (withEndSpheres)
+            findHeightmapSphereFeature(
+                b, radius, ids, triangle, faceNormal, features);
+          findHeightmapPipeFeatures(
+              a, b, radius, ids, triangle, faceNormal, features);
+        }
+      }
+    }
+  }
+}
+
+/// Returns true if `triangleIds` includes every vertex of `feature`.
+bool heightmapTriangleContains(
+    const int triangleIds[3], const HeightmapFeature& feature)
+{
+  for (int k = 0; k <= feature.dim; k++)
+  {
+    if (triangleIds[0] != feature.featureIds[k]
+        && triangleIds[1] != feature.featureIds[k]
+        && triangleIds[2] != feature.featureIds[k])
+      return false;
+  }
+  return true;
+}
+
+/// Shared edges and vertices get found once by every triangle that touches
+/// them, so this removes the duplicates. It also removes edge and vertex
+/// features that aren't locally deepest: if any triangle touching the
+/// feature has a deeper point, then that triangle owns the contact instead.
+void filterHeightmapFeatures(std::vector<HeightmapFeature>& features)
+{
+  const s_t EPS = 1e-9;
+
+  std::vector<HeightmapFeature> kept;
+  kept.reserve(features.size());
+  for (std::size_t k = 0; k < features.size(); k++)
+  {
+    const HeightmapFeature& feature = features[k];
+    bool keep = true;
+    for (std::size_t m = 0; m < features.size() && keep; m++)
+    {
+      if (m == k)
+        continue;
+      const HeightmapFeature& other = features[m];
+
+      const bool sameFeature
+          = other.dim == feature.dim && other.onPipe == feature.onPipe
+            && std::equal(
+                feature.featureIds,
+                feature.featureIds + feature.dim + 1,
+                other.featureIds)
+            && (other.queryPoint - feature.queryPoint).squaredNorm() < EPS;
+      if (sameFeature)
+      {
+        keep = m > k;
+        continue;
+      }
+
+      if (feature.dim != HEIGHTMAP_FACE
+          && heightmapTriangleContains(other.triangleIds, feature))
+      {
+        // Compare penetration rather than distance, since features of a
+        // sphere hull can come from spheres of different radii
+        const s_t depth = feature.radius - feature.distance;
+        const s_t otherDepth = other.radius - other.distance;
+        const bool deeper = otherDepth > depth + EPS;
+        const bool tiedButBigger
+            = abs(otherDepth - depth) <= EPS && other.dim > feature.dim;
+        keep = !deeper && !tiedButBigger;
+      }
+    }
+    if (keep)
+      kept.push_back(feature);
+  }
+  features.swap(kept);
+}
+
+/// Turns a heightmap feature into a contact, in world coordinates. `T` is the
+/// heightmap's transform.
+int createHeightmapContact(
     CollisionObject* o1,
     CollisionObject* o2,
+    const HeightmapFeature& feature,
+    const Eigen::Isometry3s& T,
+    bool heightmapIsObject1,
     const CollisionOption& option,
     CollisionResult& result)
 {
-  // TODO(JS): We could make the contact point computation as optional for
-  // the case that we want only binary check.
+  const s_t radius = feature.radius;
+  const s_t penetrationDepth = radius - feature.distance;
+  if (penetrationDepth > option.contactClippingDepth)
+    return 0;
 
-  const auto& shape1 = o1->getShape();
-  const auto& shape2 = o2->getShape();
+  const Eigen::Vector3s terrainPoint = T * feature.terrainPoint;
+  const Eigen::Vector3s queryPoint = T * feature.queryPoint;
+  // This points out of the terrain, towards the other shape
+  const Eigen::Vector3s normal
+      = feature.dim == HEIGHTMAP_FACE
+            ? (T.linear() * feature.faceNormal).eval()
+            : (queryPoint - terrainPoint).normalized();
 
-  const auto& shapeType1 = shape1->getType();
-  const auto& shapeType2 = shape2->getType();
+  Contact contact;
+  contact.collisionObject1 = o1;
+  contact.collisionObject2 = o2;
+  contact.normal = heightmapIsObject1 ? -normal : normal;
+  contact.penetrationDepth = penetrationDepth;
+  if (feature.dim == HEIGHTMAP_EDGE)
+  {
+    contact.edgeAClosestPoint = terrainPoint;
+    contact.edgeAFixedPoint = T * feature.edgeFixedPoint;
+    contact.edgeADir = T.linear() * feature.edgeDir;
+  }
+  else if (feature.dim == HEIGHTMAP_VERTEX)
+  {
+    contact.vertexPoint = terrainPoint;
+  }
 
-  const Eigen::Isometry3s& T1 = o1->getTransform();
-  const Eigen::Isometry3s& T2 = o2->getTransform();
+  if (feature.onPipe)
+  {
+    contact.point = terrainPoint;
+    contact.pipeClosestPoint = queryPoint;
+    contact.pipeFixedPoint = T * feature.pipeA;
+    contact.pipeDir
+        = (T.linear() * (feature.pipeB - feature.pipeA)).normalized();
+    contact.pipeRadius = radius;
+    if (feature.dim == HEIGHTMAP_EDGE)
+      contact.type = heightmapIsObject1 ? EDGE_PIPE : PIPE_EDGE;
+    else
+      contact.type = heightmapIsObject1 ? VERTEX_PIPE : PIPE_VERTEX;
+  }
+  else
+  {
+    contact.sphereCenter = queryPoint;
+    contact.sphereRadius = radius;
+    if (feature.dim == HEIGHTMAP_FACE)
+    {
+      contact.point = queryPoint - normal * radius;
+      contact.type = heightmapIsObject1 ? FACE_SPHERE : SPHERE_FACE;
+    }
+    else if (feature.dim == HEIGHTMAP_EDGE)
+    {
+      contact.point = terrainPoint;
+      contact.type = heightmapIsObject1 ? EDGE_SPHERE : SPHERE_EDGE;
+    }
+    else
+    {
+      contact.point = terrainPoint;
+      contact.type = heightmapIsObject1 ? VERTEX_SPHERE : SPHERE_VERTEX;
+    }
+  }
+
+  result.addContact(contact);
+  return 1;
+}
+
+/// Filters `features` and turns the survivors into contacts.
+int createHeightmapContacts(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    std::vector<HeightmapFeature>& features,
+    const Eigen::Isometry3s& T,
+    bool heightmapIsObject1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  filterHeightmapFeatures(features);
+
+  int numContacts = 0;
+  for (const HeightmapFeature& feature : features)
+  {
+    numContacts += createHeightmapContact(
+        o1, o2, feature, T, heightmapIsObject1, option, result);
+  }
+  return numContacts;
+}
+
+/// Collides a heightmap with the swept sphere from `a` to `b` (in world
+/// coordinates), which covers spheres (a == b) and capsules.
+template <typename S>
+int collideHeightmapSweptSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const HeightmapGrid<S>& grid,
+    const Eigen::Isometry3s& T,
+    const Eigen::Vector3s& a,
+    const Eigen::Vector3s& b,
+    s_t radius,
+    bool heightmapIsObject1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  const Eigen::Isometry3s worldToHeightmap = T.inverse();
+  std::vector<HeightmapFeature> features;
+  findHeightmapFeatures(
+      grid, worldToHeightmap * a, worldToHeightmap * b, radius, features);
+  return createHeightmapContacts(
+      o1, o2, features, T, heightmapIsObject1, option, result);
+}
+
+/// Collides a heightmap with the convex hull of a set of spheres, whose
+/// centers are in world coordinates. Each sphere is tested on its own, and
+/// the hull's surface between every pair of spheres is covered by the side of
+/// the pipe joining them, using the smaller of the two radii. That is exact
+/// for equal radii, and conservative otherwise. Regions of the hull spanned
+/// by three or more spheres are only reached through their edges.
+template <typename S>
+int collideHeightmapSphereHull(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const HeightmapGrid<S>& grid,
+    const Eigen::Isometry3s& T,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres,
+    const Eigen::Isometry3s& spheresT,
+    bool heightmapIsObject1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  const Eigen::Isometry3s spheresToHeightmap = T.inverse() * spheresT;
+  std::vector<Eigen::Vector3s> centers;
+  centers.reserve(spheres.size());
+  for (const auto& sphere : spheres)
+    centers.push_back(spheresToHeightmap * sphere.second);
+
+  std::vector<HeightmapFeature> features;
+  for (std::size_t k = 0; k < spheres.size(); k++)
+  {
+    findHeightmapFeatures(
+        grid, centers[k], centers[k], spheres[k].first, features);
+    for (std::size_t m = k + 1; m < spheres.size(); m++)
+    {
+      if (centers[k] == centers[m])
+        continue;
+      findHeightmapFeatures(
+          grid,
+          centers[k],
+          centers[m],
+          std::min(spheres[k].first, spheres[m].first),
+          features,
+          false);
+    }
+  }
+  return createHeightmapContacts(
+      o1, o2, features, T, heightmapIsObject1, option, result);
+}
+
+/// A terrain edge, as sorted grid vertex ids, with the upwards normals and the
+/// far vertices of the one or two triangles it borders.
+struct HeightmapEdge
+{
+  int ids[2];
+  Eigen::Vector3s faceNormals[2];
+  int farIds[2];
+  int numFaces;
+};
+
+/// Collects the convex terrain edges of the cells in [iMin, iMax] x
+/// [jMin, jMax] whose heights overlap [minZ, maxZ]. An edge is convex if it is
+/// on the border of the grid, or if the far vertex of one of its triangles is
+/// below the plane of the other. Edges between coplanar triangles, or in a
+/// valley, are left out: the box corners and terrain vertices cover those.
+template <typename S>
+void findConvexHeightmapEdges(
+    const HeightmapGrid<S>& grid,
+    int iMin,
+    int iMax,
+    int jMin,
+    int jMax,
+    s_t minZ,
+    s_t maxZ,
+    std::vector<HeightmapEdge>& edges)
+{
+  const s_t EPS = 1e-9;
+
+  // The triangles on the far side of an edge can come from a cell just
+  // outside the range, so the neighboring cells are visited too
+  std::map<std::pair<int, int>, HeightmapEdge> allEdges;
+  std::set<std::pair<int, int>> candidates;
+  const int jEnd = std::min(grid.getDepth() - 2, jMax + 1);
+  const int iEnd = std::min(grid.getWidth() - 2, iMax + 1);
+  for (int j = std::max(0, jMin - 1); j <= jEnd; j++)
+  {
+    for (int i = std::max(0, iMin - 1); i <= iEnd; i++)
+    {
+      const bool inRange = i >= iMin && i <= iMax && j >= jMin && j <= jMax
+                           && grid.cellOverlapsHeights(i, j, minZ, maxZ);
+      for (int t = 0; t < 2; t++)
+      {
+        int ids[3];
+        grid.getCellTriangle(i, j, t, ids);
+        const Eigen::Vector3s a = grid.getVertex(ids[0]);
+        const Eigen::Vector3s faceNormal
+            = (grid.getVertex(ids[1]) - a)
+                  .cross(grid.getVertex(ids[2]) - a)
+                  .normalized();
+        for (int e = 0; e < 3; e++)
+        {
+          const std::pair<int, int> key(
+              std::min(ids[e], ids[(e + 1) % 3]),
+              std::max(ids[e], ids[(e + 1) % 3]));
+          HeightmapEdge& edge = allEdges[key];
+          if (edge.numFaces == 0)
+          {
+            edge.ids[0] = key.first;
+            edge.ids[1] = key.second;
+          }
+          if (edge.numFaces < 2)
+          {
+            edge.faceNormals[edge.numFaces] = faceNormal;
+            edge.farIds[edge.numFaces] = ids[(e + 2) % 3];
+            edge.numFaces++;
+          }
+          if (inRange)
+            candidates.insert(key);
+        }
+      }
+    }
+  }
+
+  for (const std::pair<int, int>& key : candidates)
+  {
+    const HeightmapEdge& edge = allEdges[key];
+    if (edge.numFaces == 2
+        && edge.faceNormals[0].dot(
+               grid.getVertex(edge.farIds[1]) - grid.getVertex(edge.ids[0]))
+               > -EPS)
+      continue;
+    edges.push_back(edge);
+  }
+}
+
+/// Collides a heightmap with a box. This checks the box corners against the
+/// terrain surface, the terrain vertices against the inside of the box, and
+/// the box edges against convex terrain edges, which is what holds up a box
+/// resting across a ridge.
+template <typename S>
+int collideHeightmapBoxFeatures(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const HeightmapGrid<S>& grid,
+    const Eigen::Isometry3s& T,
+    const Eigen::Vector3s& size,
+    const Eigen::Isometry3s& boxT,
+    bool heightmapIsObject1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  const Eigen::Isometry3s boxToHeightmap = T.inverse() * boxT;
+  const Eigen::Vector3s halfSize = size / 2;
+
+  Eigen::Vector3s corners[8];
+  Eigen::Vector3s min = Eigen::Vector3s::Constant(
+      std::numeric_limits<s_t>::infinity());
+  Eigen::Vector3s max = -min;
+  for (int k = 0; k < 8; k++)
+  {
+    corners[k] = boxToHeightmap
+                 * Eigen::Vector3s(
+                     (k & 1) ? halfSize(0) : -halfSize(0),
+                     (k & 2) ? halfSize(1) : -halfSize(1),
+                     (k & 4) ? halfSize(2) : -halfSize(2));
+    min = min.cwiseMin(corners[k]);
+    max = max.cwiseMax(corners[k]);
+  }
+
+  int iMin, iMax, jMin, jMax;
+  if (!grid.getCellRange(min, max, iMin, iMax, jMin, jMax))
+    return 0;
+
+  int numContacts = 0;
+
+  // Box vertices below the terrain surface
+  for (int k = 0; k < 8; k++)
+  {
+    s_t height;
+    Eigen::Vector3s faceNormal;
+    if (!grid.getSurface(corners[k](0), corners[k](1), height, faceNormal)
+        || corners[k](2) >= height)
+      continue;
+
+    const s_t penetrationDepth = (height - corners[k](2)) * faceNormal(2);
+    if (penetrationDepth > option.contactClippingDepth)
+      continue;
+
+    const Eigen::Vector3s normal = T.linear() * faceNormal;
+    Contact contact;
+    contact.collisionObject1 = o1;
+    contact.collisionObject2 = o2;
+    contact.point = T * corners[k];
+    contact.normal = heightmapIsObject1 ? -normal : normal;
+    contact.penetrationDepth = penetrationDepth;
+    contact.type = heightmapIsObject1 ? FACE_VERTEX : VERTEX_FACE;
+    result.addContact(contact);
+    numContacts++;
+  }
+
+  // Terrain vertices inside the box
+  const Eigen::Isometry3s heightmapToBox = boxToHeightmap.inverse();
+  for (int j = jMin; j <= jMax + 1; j++)
+  {
+    for (int i = iMin; i <= iMax + 1; i++)
+    {
+      const Eigen::Vector3s vertex = grid.getVertex(grid.getVertexId(i, j));
+      if (vertex(2) < min(2) || vertex(2) > max(2))
+        continue;
+
+      const Eigen::Vector3s inBox = heightmapToBox * vertex;
+      const Eigen::Vector3s slack = halfSize - inBox.cwiseAbs();
+      int axis;
+      const s_t penetrationDepth = slack.minCoeff(&axis);
+      if (penetrationDepth <= 0
+          || penetrationDepth > option.contactClippingDepth)
+        continue;
+
+      // The box face this vertex is pushed out through
+      const Eigen::Vector3s faceNormal
+          = boxT.linear().col(axis) * (inBox(axis) > 0 ? 1.0 : -1.0);
+      Contact contact;
+      contact.collisionObject1 = o1;
+      contact.collisionObject2 = o2;
+      contact.point = T * vertex;
+      contact.normal = heightmapIsObject1 ? faceNormal : -faceNormal;
+      contact.penetrationDepth = penetrationDepth;
+      contact.type = heightmapIsObject1 ? VERTEX_FACE : FACE_VERTEX;
+      result.addContact(contact);
+      numContacts++;
+    }
+  }
+
+  // Box edges crossing convex terrain edges
+  const s_t INTERIOR_THRESHOLD = 1e-8;
+  const s_t EPS = 1e-9;
+  std::vector<HeightmapEdge> edges;
+  findConvexHeightmapEdges(grid, iMin, iMax, jMin, jMax, min(2), max(2), edges);
+  for (const HeightmapEdge& edge : edges)
+  {
+    const Eigen::Vector3s t0 = grid.getVertex(edge.ids[0]);
+    const Eigen::Vector3s t1 = grid.getVertex(edge.ids[1]);
+    for (int axis = 0; axis < 3; axis++)
+    {
+      for (int k = 0; k < 8; k++)
+      {
+        if (k & (1 << axis))
+          continue;
+        const Eigen::Vector3s& b0 = corners[k];
+        const Eigen::Vector3s& b1 = corners[k | (1 << axis)];
+        s_t alpha, beta;
+        dSegmentsClosestApproach(b0, t0, b1, t1, &alpha, &beta);
+        if (alpha < INTERIOR_THRESHOLD || alpha > 1 - INTERIOR_THRESHOLD
+            || beta < INTERIOR_THRESHOLD || beta > 1 - INTERIOR_THRESHOLD)
+          continue;
+
+        const Eigen::Vector3s boxPoint = b0 + (b1 - b0) * alpha;
+        const Eigen::Vector3s terrainPoint = t0 + (t1 - t0) * beta;
+        // The terrain point sits on the faces next to the box edge, so this
+        // only has to reject points outside the box
+        const Eigen::Vector3s inBox = heightmapToBox * terrainPoint;
+        if ((halfSize - inBox.cwiseAbs()).minCoeff() < -EPS)
+          continue;
+
+        // This points out of the terrain, and has to lie between the normals
+        // of the faces on both sides of each edge to be a real edge contact
+        Eigen::Vector3s normal = (b1 - b0).cross(t1 - t0);
+        if (normal.norm() < EPS)
+          continue;
+        normal.normalize();
+        Eigen::Vector3s terrainNormal = edge.faceNormals[0];
+        if (edge.numFaces == 2)
+          terrainNormal += edge.faceNormals[1];
+        if (normal.dot(terrainNormal) < 0)
+          normal = -normal;
+        bool inNormalCones = true;
+        for (int f = 0; f < edge.numFaces; f++)
+          inNormalCones &= normal.dot(edge.faceNormals[f]) >= -EPS;
+        for (int side = 0; side < 3; side++)
+        {
+          if (side == axis)
+            continue;
+          const Eigen::Vector3s boxFaceNormal
+              = boxToHeightmap.linear().col(side)
+                * ((k & (1 << side)) ? 1.0 : -1.0);
+          inNormalCones &= normal.dot(boxFaceNormal) <= EPS;
+        }
+        if (!inNormalCones)
+          continue;
+
+        const s_t penetrationDepth = (terrainPoint - boxPoint).dot(normal);
+        if (penetrationDepth <= 0
+            || penetrationDepth > option.contactClippingDepth)
+          continue;
+
+        const Eigen::Vector3s worldNormal = T.linear() * normal;
+        const Eigen::Vector3s terrainDir = T.linear() * (t1 - t0).normalized();
+        const Eigen::Vector3s boxDir = T.linear() * (b1 - b0).normalized();
+        Contact contact;
+        contact.collisionObject1 = o1;
+        contact.collisionObject2 = o2;
+        contact.type = EDGE_EDGE;
+        contact.point = T * ((terrainPoint + boxPoint) / 2);
+        contact.normal = heightmapIsObject1 ? -worldNormal : worldNormal;
+        contact.penetrationDepth = penetrationDepth;
+        contact.edgeAClosestPoint
+            = T * (heightmapIsObject1 ? terrainPoint : boxPoint);
+        contact.edgeAFixedPoint = T * (heightmapIsObject1 ? t0 : b0);
+        contact.edgeADir = heightmapIsObject1 ? terrainDir : boxDir;
+        contact.edgeBClosestPoint
+            = T * (heightmapIsObject1 ? boxPoint : terrainPoint);
+        contact.edgeBFixedPoint = T * (heightmapIsObject1 ? b0 : t0);
+        contact.edgeBDir = heightmapIsObject1 ? boxDir : terrainDir;
+        result.addContact(contact);
+        numContacts++;
+      }
+    }
+  }
+
+  return numContacts;
+}
+
+//==============================================================================
+/// Dispatches a heightmap against whatever shape the other object has.
+/// Returns -1 if that shape isn't supported.
+template <typename S>
+int collideHeightmapWithShape(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    bool heightmapIsObject1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  CollisionObject* heightmapObject = heightmapIsObject1 ? o1 : o2;
+  CollisionObject* otherObject = heightmapIsObject1 ? o2 : o1;
+  const auto& heightmap = static_cast<const dynamics::HeightmapShape<S>&>(
+      *heightmapObject->getShape());
+  const auto& other = otherObject->getShape();
+  const auto& otherType = other->getType();
+  const Eigen::Isometry3s& T = heightmapObject->getTransform();
+  const Eigen::Isometry3s& otherT = otherObject->getTransform();
+
+  if (dynamics::SphereShape::getStaticType() == otherType
+      || dynamics::EllipsoidShape::getStaticType() == otherType)
+  {
+    const s_t radius
+        = dynamics::SphereShape::getStaticType() == otherType
+              ? static_cast<const dynamics::SphereShape*>(other.get())
+                    ->getRadius()
+              : static_cast<const dynamics::EllipsoidShape*>(other.get())
+                    ->getRadii()[0];
+    return heightmapIsObject1
+               ? collideHeightmapSphere(
+                   o1, o2, heightmap, T, radius, otherT, option, result)
+               : collideSphereHeightmap(
+                   o1, o2, radius, otherT, heightmap, T, option, result);
+  }
+  else if (dynamics::CapsuleShape::getStaticType() == otherType)
+  {
+    const auto* capsule
+        = static_cast<const dynamics::CapsuleShape*>(other.get());
+    const s_t height = capsule->getHeight();
+    const s_t radius = capsule->getRadius();
+    return heightmapIsObject1
+               ? collideHeightmapCapsule(
+                   o1, o2, heightmap, T, height, radius, otherT, option, result)
+               : collideCapsuleHeightmap(
+                   o1,
+                   o2,
+                   height,
+                   radius,
+                   otherT,
+                   heightmap,
+                   T,
+                   option,
+                   result);
+  }
+  else if (dynamics::BoxShape::getStaticType() == otherType)
+  {
+    const auto* box = static_cast<const dynamics::BoxShape*>(other.get());
+    const Eigen::Vector3s& size = box->getSize();
+    return heightmapIsObject1
+               ? collideHeightmapBox(
+                   o1, o2, heightmap, T, size, otherT, option, result)
+               : collideBoxHeightmap(
+                   o1, o2, size, otherT, heightmap, T, option, result);
+  }
+  else if (dynamics::MultiSphereConvexHullShape::getStaticType() == otherType)
+  {
+    const auto& spheres
+        = static_cast<const dynamics::MultiSphereConvexHullShape*>(other.get())
+              ->getSpheres();
+    return heightmapIsObject1
+               ? collideHeightmapMultiSphere(
+                   o1, o2, heightmap, T, spheres, otherT, option, result)
+               : collideMultiSphereHeightmap(
+                   o1, o2, spheres, otherT, heightmap, T, option, result);
+  }
+
+  return -1;
+}
+
+} // namespace
+
+//==============================================================================
+template <typename S>
+int collideHeightmapSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::HeightmapShape<S>& heightmap0,
+    const Eigen::Isometry3s& T0,
+    s_t radius1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  return collideHeightmapSweptSphere(
+      o1,
+      o2,
+      HeightmapGrid<S>(heightmap0),
+      T0,
+      T1.translation(),
+      T1.translation(),
+      radius1,
+      true,
+      option,
+      result);
+}
+
+//==============================================================================
+template <typename S>
+int collideSphereHeightmap(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    s_t radius0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::HeightmapShape<S>& heightmap1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  return collideHeightmapSweptSphere(
+      o1,
+      o2,
+      HeightmapGrid<S>(heightmap1),
+      T1,
+      T0.translation(),
+      T0.translation(),
+      radius0,
+      false,
+      option,
+      result);
+}
+
+//==============================================================================
+template <typename S>
+int collideHeightmapCapsule(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::HeightmapShape<S>& heightmap0,
+    const Eigen::Isometry3s& T0,
+    s_t height1,
+    s_t radius1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  return collideHeightmapSweptSphere(
+      o1,
+      o2,
+      HeightmapGrid<S>(heightmap0),
+      T0,
+      T1 * (Eigen::Vector3s::UnitZ() * -(height1 / 2)),
+      T1 * (Eigen::Vector3s::UnitZ() * (height1 / 2)),
+      radius1,
+      true,
+      option,
+      result);
+}
+
+//==============================================================================
+template <typename S>
+int collideCapsuleHeightmap(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    s_t height0,
+    s_t radius0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::HeightmapShape<S>& heightmap1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  return collideHeightmapSweptSphere(
+      o1,
+      o2,
+      HeightmapGrid<S>(heightmap1),
+      T1,
+      T0 * (Eigen::Vector3s::UnitZ() * -(height0 / 2)),
+      T0 * (Eigen::Vector3s::UnitZ() * (height0 / 2)),
+      radius0,
+      false,
+      option,
+      result);
+}
+
+//==============================================================================
+template <typename S>
+int collideHeightmapBox(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::HeightmapShape<S>& heightmap0,
+    const Eigen::Isometry3s& T0,
+    const Eigen::Vector3s& size1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  return collideHeightmapBoxFeatures(
+      o1,
+      o2,
+      HeightmapGrid<S>(heightmap0),
+      T0,
+      size1,
+      T1,
+      true,
+      option,
+      result);
+}
+
+//==============================================================================
+template <typename S>
+int collideBoxHeightmap(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& size0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::HeightmapShape<S>& heightmap1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  return collideHeightmapBoxFeatures(
+      o1,
+      o2,
+      HeightmapGrid<S>(heightmap1),
+      T1,
+      size0,
+      T0,
+      false,
+      option,
+      result);
+}
+
+//==============================================================================
+template <typename S>
+int collideHeightmapMultiSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::HeightmapShape<S>& heightmap0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  return collideHeightmapSphereHull(
+      o1,
+      o2,
+      HeightmapGrid<S>(heightmap0),
+      T0,
+      spheres1,
+      T1,
+      true,
+      option,
+      result);
+}
+
+//==============================================================================
+template <typename S>
+int collideMultiSphereHeightmap(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::HeightmapShape<S>& heightmap1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  return collideHeightmapSphereHull(
+      o1,
+      o2,
+      HeightmapGrid<S>(heightmap1),
+      T1,
+      spheres0,
+      T0,
+      false,
+      option,
+      result);
+}
+
+#define DART_INSTANTIATE_HEIGHTMAP_COLLIDE(S)                                  \
+  template int collideHeightmapSphere<S>(                                      \
+      CollisionObject*,                                                        \
+      CollisionObject*,                                                        \
+      const dynamics::HeightmapShape<S>&,                                      \
+      const Eigen::Isometry3s&,                                                \
+      s_t,                                                                     \
+      const Eigen::Isometry3s&,                                                \
+      const CollisionOption&,                                                  \
+      CollisionResult&);                                                       \
+  template int collideSphereHeightmap<S>(                                      \
+      CollisionObject*,                                                        \
+      CollisionObject*,                                                        \
+      s_t,                                                                     \
+      const Eigen::Isometry3s&,                                                \
+      const dynamics::HeightmapShape<S>&,                                      \
+      const Eigen::Isometry3s&,                                                \
+      const CollisionOption&,                                                  \
+      CollisionResult&);                                                       \
+  template int collideHeightmapCapsule<S>(                                     \
+      CollisionObject*,                                                        \
+      CollisionObject*,                                                        \
+      const dynamics::HeightmapShape<S>&,                                      \
+      const Eigen::Isometry3s&,                                                \
+      s_t,                                                                     \
+      s_t,                                                                     \
+      const Eigen::Isometry3s&,                                                \
+      const CollisionOption&,                                                  \
+      CollisionResult&);                                                       \
+  template int collideCapsuleHeightmap<S>(                                     \
+      CollisionObject*,                                                        \
+      CollisionObject*,                                                        \
+      s_t,                                                                     \
+      s_t,                                                                     \
+      const Eigen::Isometry3s&,                                                \
+      const dynamics::HeightmapShape<S>&,                                      \
+      const Eigen::Isometry3s&,                                                \
+      const CollisionOption&,                                                  \
+      CollisionResult&);                                                       \
+  template int collideHeightmapBox<S>(                                         \
+      CollisionObject*,                                                        \
+      CollisionObject*,                                                        \
+      const dynamics::HeightmapShape<S>&,                                      \
+      const Eigen::Isometry3s&,                                                \
+      const Eigen::Vector3s&,                                                  \
+      const Eigen::Isometry3s&,                                                \
+      const CollisionOption&,                                                  \
+      CollisionResult&);                                                       \
+  template int collideBoxHeightmap<S>(                                         \
+      CollisionObject*,                                                        \
+      CollisionObject*,                                                        \
+      const Eigen::Vector3s&,                                                  \
+      const Eigen::Isometry3s&,                                                \
+      const dynamics::HeightmapShape<S>&,                                      \
+      const Eigen::Isometry3s&,                                                \
+      const CollisionOption&,                                                  \
+      CollisionResult&);                                                       \
+  template int collideHeightmapMultiSphere<S>(                                 \
+      CollisionObject*,                                                        \
+      CollisionObject*,                                                        \
+      const dynamics::HeightmapShape<S>&,                                      \
+      const Eigen::Isometry3s&,                                                \
+      const dynamics::MultiSphereConvexHullShape::Spheres&,                    \
+      const Eigen::Isometry3s&,                                                \
+      const CollisionOption&,                                                  \
+      CollisionResult&);                                                       \
+  template int collideMultiSphereHeightmap<S>(                                 \
+      CollisionObject*,                                                        \
+      CollisionObject*,                                                        \
+      const dynamics::MultiSphereConvexHullShape::Spheres&,                    \
+      const Eigen::Isometry3s&,                                                \
+      const dynamics::HeightmapShape<S>&,                                      \
+      const Eigen::Isometry3s&,                                                \
+      const CollisionOption&,                                                  \
+      CollisionResult&);
+
+DART_INSTANTIATE_HEIGHTMAP_COLLIDE(float)
+DART_INSTANTIATE_HEIGHTMAP_COLLIDE(s_t)
+
+#undef DART_INSTANTIATE_HEIGHTMAP_COLLIDE
+
+namespace {
+
+//==============================================================================
+/// Returns the indices of the spheres in a multi-sphere hull that reach within
+/// DART_COLLISION_WITNESS_PLANE_DEPTH of the hull's support plane along `dir`.
+std::vector<int> getMultiSphereWitnesses(
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres,
+    const Eigen::Isometry3s& T,
+    const Eigen::Vector3s& dir)
+{
+  std::vector<s_t> reach;
+  reach.reserve(spheres.size());
+  s_t maxReach = -std::numeric_limits<s_t>::infinity();
+  for (const auto& sphere : spheres)
+  {
+    reach.push_back((T * sphere.second).dot(dir) + sphere.first);
+    if (reach.back() > maxReach)
+      maxReach = reach.back();
+  }
+
+  std::vector<int> witnesses;
+  for (int i = 0; i < static_cast<int>(spheres.size()); i++)
+  {
+    if (reach[i] >= maxReach - DART_COLLISION_WITNESS_PLANE_DEPTH)
+      witnesses.push_back(i);
+  }
+  return witnesses;
+}
+
+//==============================================================================
+Eigen::Isometry3s getMultiSphereTransform(
+    const dynamics::MultiSphereConvexHullShape::Sphere& sphere,
+    const Eigen::Isometry3s& T)
+{
+  Eigen::Isometry3s sphereT = Eigen::Isometry3s::Identity();
+  sphereT.translation() = T * sphere.second;
+  return sphereT;
+}
+
+//==============================================================================
+/// When GJK/EPA says the shapes overlap but none of the witness spheres do,
+/// it's the skin of the hull between the spheres that's touching. This
+/// records the EPA result as a vertex-face contact, with the point moving
+/// with the hull and the normal turning with the other shape, which is how
+/// the gradients treat VERTEX_FACE and FACE_VERTEX contacts. For two hulls,
+/// o1 is taken as the vertex side.
+int createGJKContact(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const GJKResult& gjk,
+    bool hullIsObject1,
+    CollisionResult& result)
+{
+  Contact contact;
+  contact.collisionObject1 = o1;
+  contact.collisionObject2 = o2;
+  contact.type = hullIsObject1 ? VERTEX_FACE : FACE_VERTEX;
+  contact.normal = gjk.normal;
+  contact.point = (gjk.pointA + gjk.pointB) / 2;
+  contact.penetrationDepth = gjk.depth;
+  result.addContact(contact);
+  return 1;
+}
+
+//==============================================================================
+/// Runs GJK/EPA between a multi-sphere hull and another convex shape, warm
+/// started from the last time we saw this pair. If they overlap, each witness
+/// sphere of the hull is passed to `collideSphere(radius, transform)`, which
+/// collides it against the other shape with o1 and o2 in the right order.
+template <typename SphereCollider>
+int collideMultiSphereWithConvex(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres,
+    const Eigen::Isometry3s& T,
+    const GJKShape& other,
+    bool multiSphereIsObject1,
+    const CollisionOption& option,
+    CollisionResult& result,
+    SphereCollider collideSphere)
+{
+  if (spheres.empty())
+    return 0;
+
+  ccdMultiSphere hull;
+  hull.spheres = &spheres;
+  hull.transform = &T;
+  const GJKShape hullShape{&hull, ccdSupportMultiSphere, ccdCenterMultiSphere};
+
+  GJKCache cache = loadGJKCache(o1, o2);
+  const GJKResult gjk = multiSphereIsObject1
+                            ? gjkPenetration(hullShape, other, &cache)
+                            : gjkPenetration(other, hullShape, &cache);
+  storeGJKCache(o1, o2, cache);
+  if (!gjk.intersecting || gjk.depth > option.contactClippingDepth)
+    return 0;
+
+  // gjk.normal points from o2 to o1, and we want it pointing out of the hull
+  const Eigen::Vector3s towardsOther
+      = multiSphereIsObject1 ? (-gjk.normal).eval() : gjk.normal;
+  int numContacts = 0;
+  for (int i : getMultiSphereWitnesses(spheres, T, towardsOther))
+  {
+    numContacts += collideSphere(
+        spheres[i].first, getMultiSphereTransform(spheres[i], T));
+  }
+  if (numContacts == 0)
+    numContacts
+        = createGJKContact(o1, o2, gjk, multiSphereIsObject1, result);
+  return numContacts;
+}
+
+//==============================================================================
+/// Dispatches a multi-sphere hull against whatever shape the other object
+/// has. Returns -1 if that shape isn't supported.
+int collideMultiSphereWithShape(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    bool multiSphereIsObject1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  CollisionObject* hullObject = multiSphereIsObject1 ? o1 : o2;
+  CollisionObject* otherObject = multiSphereIsObject1 ? o2 : o1;
+  const auto& spheres
+      = static_cast<const dynamics::MultiSphereConvexHullShape*>(
+            hullObject->getShape().get())
+            ->getSpheres();
+  const auto& other = otherObject->getShape();
+  const auto& otherType = other->getType();
+  const Eigen::Isometry3s& T = hullObject->getTransform();
+  const Eigen::Isometry3s& otherT = otherObject->getTransform();
+
+  if (dynamics::SphereShape::getStaticType() == otherType
+      || dynamics::EllipsoidShape::getStaticType() == otherType)
+  {
+    const s_t radius
+        = dynamics::SphereShape::getStaticType() == otherType
+              ? static_cast<const dynamics::SphereShape*>(other.get())
+                    ->getRadius()
+              : static_cast<const dynamics::EllipsoidShape*>(other.get())
+                    ->getRadii()[0];
+    return multiSphereIsObject1
+               ? collideMultiSphereSphere(
+                   o1, o2, spheres, T, radius, otherT, option, result)
+               : collideSphereMultiSphere(
+                   o1, o2, radius, otherT, spheres, T, option, result);
+  }
+  else if (dynamics::BoxShape::getStaticType() == otherType)
+  {
+    const auto* box = static_cast<const dynamics::BoxShape*>(other.get());
+    const Eigen::Vector3s& size = box->getSize();
+    return multiSphereIsObject1
+               ? collideMultiSphereBox(
+                   o1, o2, spheres, T, size, otherT, option, result)
+               : collideBoxMultiSphere(
+                   o1, o2, size, otherT, spheres, T, option, result);
+  }
+  else if (dynamics::CapsuleShape::getStaticType() == otherType)
+  {
+    const auto* capsule
+        = static_cast<const dynamics::CapsuleShape*>(other.get());
+    const s_t height = capsule->getHeight();
+    const s_t radius = capsule->getRadius();
+    return multiSphereIsObject1
+               ? collideMultiSphereCapsule(
+                   o1, o2, spheres, T, height, radius, otherT, option, result)
+               : collideCapsuleMultiSphere(
+                   o1, o2, height, radius, otherT, spheres, T, option, result);
+  }
+  else if (dynamics::MeshShape::getStaticType() == otherType)
+  {
+    const auto* mesh = static_cast<const dynamics::MeshShape*>(other.get());
+    const aiScene* scene = mesh->getMesh();
+    const Eigen::Vector3s& scale = mesh->getScale();
+    return multiSphereIsObject1
+               ? collideMultiSphereMesh(
+                   o1, o2, spheres, T, scene, scale, otherT, option, result)
+               : collideMeshMultiSphere(
+                   o1, o2, scene, scale, otherT, spheres, T, option, result);
+  }
+  else if (dynamics::MultiSphereConvexHullShape::getStaticType() == otherType)
+  {
+    const auto& otherSpheres
+        = static_cast<const dynamics::MultiSphereConvexHullShape*>(other.get())
+              ->getSpheres();
+    return multiSphereIsObject1
+               ? collideMultiSphereMultiSphere(
+                   o1, o2, spheres, T, otherSpheres, otherT, option, result)
+               : collideMultiSphereMultiSphere(
+                   o1, o2, otherSpheres, otherT, spheres, T, option, result);
+  }
+
+  return -1;
+}
+
+} // namespace
+
+//==============================================================================
+int collideMultiSphereSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres0,
+    const Eigen::Isometry3s& T0,
+    const s_t& r1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  ccdSphere sphere;
+  sphere.radius = r1;
+  sphere.transform = &T1;
+  const GJKShape other{&sphere, ccdSupportSphere, ccdCenterSphere};
+
+  return collideMultiSphereWithConvex(
+      o1,
+      o2,
+      spheres0,
+      T0,
+      other,
+      true,
+      option,
+      result,
+      [&](s_t radius, const Eigen::Isometry3s& sphereT) {
+        return collideSphereSphere(
+            o1, o2, radius, sphereT, r1, T1, option, result);
+      });
+}
+
+//==============================================================================
+int collideSphereMultiSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const s_t& r0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  ccdSphere sphere;
+  sphere.radius = r0;
+  sphere.transform = &T0;
+  const GJKShape other{&sphere, ccdSupportSphere, ccdCenterSphere};
+
+  return collideMultiSphereWithConvex(
+      o1,
+      o2,
+      spheres1,
+      T1,
+      other,
+      false,
+      option,
+      result,
+      [&](s_t radius, const Eigen::Isometry3s& sphereT) {
+        return collideSphereSphere(
+            o1, o2, r0, T0, radius, sphereT, option, result);
+      });
+}
+
+//==============================================================================
+int collideMultiSphereBox(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres0,
+    const Eigen::Isometry3s& T0,
+    const Eigen::Vector3s& size1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  ccdBox box;
+  box.size = &size1;
+  box.transform = &T1;
+  const GJKShape other{&box, ccdSupportBox, ccdCenterBox};
+
+  return collideMultiSphereWithConvex(
+      o1,
+      o2,
+      spheres0,
+      T0,
+      other,
+      true,
+      option,
+      result,
+      [&](s_t radius, const Eigen::Isometry3s& sphereT) {
+        return collideSphereBox(
+            o1, o2, radius, sphereT, size1, T1, option, result);
+      });
+}
+
+//==============================================================================
+int collideBoxMultiSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& size0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  ccdBox box;
+  box.size = &size0;
+  box.transform = &T0;
+  const GJKShape other{&box, ccdSupportBox, ccdCenterBox};
+
+  return collideMultiSphereWithConvex(
+      o1,
+      o2,
+      spheres1,
+      T1,
+      other,
+      false,
+      option,
+      result,
+      [&](s_t radius, const Eigen::Isometry3s& sphereT) {
+        return collideBoxSphere(
+            o1, o2, size0, T0, radius, sphereT, option, result);
+      });
+}
+
+//==============================================================================
+int collideMultiSphereCapsule(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres0,
+    const Eigen::Isometry3s& T0,
+    s_t height1,
+    s_t radius1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  ccdCapsule capsule;
+  capsule.radius = radius1;
+  capsule.height = height1;
+  capsule.transform = &T1;
+  const GJKShape other{&capsule, ccdSupportCapsule, ccdCenterCapsule};
+
+  return collideMultiSphereWithConvex(
+      o1,
+      o2,
+      spheres0,
+      T0,
+      other,
+      true,
+      option,
+      result,
+      [&](s_t radius, const Eigen::Isometry3s& sphereT) {
+        return collideSphereCapsule(
+            o1, o2, radius, sphereT, height1, radius1, T1, option, result);
+      });
+}
+
+//==============================================================================
+int collideCapsuleMultiSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    s_t height0,
+    s_t radius0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  ccdCapsule capsule;
+  capsule.radius = radius0;
+  capsule.height = height0;
+  capsule.transform = &T0;
+  const GJKShape other{&capsule, ccdSupportCapsule, ccdCenterCapsule};
+
+  return collideMultiSphereWithConvex(
+      o1,
+      o2,
+      spheres1,
+      T1,
+      other,
+      false,
+      option,
+      result,
+      [&](s_t radius, const Eigen::Isometry3s& sphereT) {
+        return collideCapsuleSphere(
+            o1, o2, height0, radius0, T0, radius, sphereT, option, result);
+      });
+}
+
+//==============================================================================
+int collideMultiSphereMesh(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres0,
+    const Eigen::Isometry3s& T0,
+    const aiScene* mesh1,
+    const Eigen::Vector3s& size1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  ccdMesh mesh;
+  mesh.mesh = mesh1;
+  mesh.transform = &T1;
+  mesh.scale = &size1;
+  const GJKShape other{&mesh, ccdSupportMesh, ccdCenterMesh};
+
+  return collideMultiSphereWithConvex(
+      o1,
+      o2,
+      spheres0,
+      T0,
+      other,
+      true,
+      option,
+      result,
+      [&](s_t radius, const Eigen::Isometry3s& sphereT) {
+        return collideSphereMesh(
+            o1, o2, radius, sphereT, mesh1, size1, T1, option, result);
+      });
+}
+
+//==============================================================================
+int collideMeshMultiSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const aiScene* mesh0,
+    const Eigen::Vector3s& size0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  ccdMesh mesh;
+  mesh.mesh = mesh0;
+  mesh.transform = &T0;
+  mesh.scale = &size0;
+  const GJKShape other{&mesh, ccdSupportMesh, ccdCenterMesh};
+
+  return collideMultiSphereWithConvex(
+      o1,
+      o2,
+      spheres1,
+      T1,
+      other,
+      false,
+      option,
+      result,
+      [&](s_t radius, const Eigen::Isometry3s& sphereT) {
+        return collideMeshSphere(
+            o1, o2, mesh0, size0, T0, radius, sphereT, option, result);
+      });
+}
+
+//==============================================================================
+int collideMultiSphereMultiSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  if (spheres0.empty() || spheres1.empty())
+    return 0;
+
+  ccdMultiSphere hull0;
+  hull0.spheres = &spheres0;
+  hull0.transform = &T0;
+  ccdMultiSphere hull1;
+  hull1.spheres = &spheres1;
+  hull1.transform = &T1;
+  const GJKShape shape0{&hull0, ccdSupportMultiSphere, ccdCenterMultiSphere};
+  const GJKShape shape1{&hull1, ccdSupportMultiSphere, ccdCenterMultiSphere};
+
+  GJKCache cache = loadGJKCache(o1, o2);
+  const GJKResult gjk = gjkPenetration(shape0, shape1, &cache);
+  storeGJKCache(o1, o2, cache);
+  if (!gjk.intersecting || gjk.depth > option.contactClippingDepth)
+    return 0;
+
+  const std::vector<int> witnesses0
+      = getMultiSphereWitnesses(spheres0, T0, -gjk.normal);
+  const std::vector<int> witnesses1
+      = getMultiSphereWitnesses(spheres1, T1, gjk.normal);
+  int numContacts = 0;
+  for (int i : witnesses0)
+  {
+    const Eigen::Isometry3s sphereT0 = getMultiSphereTransform(spheres0[i], T0);
+    for (int j : witnesses1)
+    {
+      numContacts += collideSphereSphere(
+          o1,
+          o2,
+          spheres0[i].first,
+          sphereT0,
+          spheres1[j].first,
+          getMultiSphereTransform(spheres1[j], T1),
+          option,
+          result);
+    }
+  }
+  if (numContacts == 0)
+    numContacts = createGJKContact(o1, o2, gjk, true, result);
+  return numContacts;
+}
+
+//==============================================================================
+int collide(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  // TODO(JS): We could make the contact point computation as optional for
+  // the case that we want only binary check.
+
+  const auto& shape1 = o1->getShape();
+  const auto& shape2 = o2->getShape();
+
+  const auto& shapeType1 = shape1->getType();
+  const auto& shapeType2 = shape2->getType();
+
+  const Eigen::Isometry3s& T1 = o1->getTransform();
+  const Eigen::Isometry3s& T2 = o2->getTransform();
+
+  // Heightmaps come in two scalar types, so they're dispatched separately
+  int heightmapContacts = -1;
+  if (dynamics::HeightmapShapef::getStaticType() == shapeType1)
+    heightmapContacts
+        = collideHeightmapWithShape<float>(o1, o2, true, option, result);
+  else if (dynamics::HeightmapShaped::getStaticType() == shapeType1)
+    heightmapContacts
+        = collideHeightmapWithShape<s_t>(o1, o2, true, option, result);
+  else if (dynamics::HeightmapShapef::getStaticType() == shapeType2)
+    heightmapContacts
+        = collideHeightmapWithShape<float>(o1, o2, false, option, result);
+  else if (dynamics::HeightmapShaped::getStaticType() == shapeType2)
+    heightmapContacts
+        = collideHeightmapWithShape<s_t>(o1, o2, false, option, result);
+  if (heightmapContacts >= 0)
+    return heightmapContacts;
+
+  // Multi-sphere hulls go through GJK/EPA against any convex shape
+  int multiSphereContacts = -1;
+  if (dynamics::MultiSphereConvexHullShape::getStaticType() == shapeType1)
+    multiSphereContacts
+        = collideMultiSphereWithShape(o1, o2, true, option, result);
+  else if (dynamics::MultiSphereConvexHullShape::getStaticType() == shapeType2)
+    multiSphereContacts
+        = collideMultiSphereWithShape(o1, o2, false, option, result);
+  if (multiSphereContacts >= 0)
+    return multiSphereContacts;
 
   if (dynamics::SphereShape::getStaticType() == shapeType1)
   {
@@ -43,6 +43,9 @@
 #include <ccd/vec3.h>
 
 #include "dart/collision/CollisionDetector.hpp"
+#include "dart/collision/dart/DARTGJK.hpp"
+#include "dart/dynamics/HeightmapShape.hpp"
+#include "dart/dynamics/MultiSphereConvexHullShape.hpp"
 
 namespace dart {
 namespace collision {
@@ -291,6 +294,208 @@ int collideCylinderPlane(
     const CollisionOption& option,
     CollisionResult& result);
 
+/// Heightmap narrowphase. These only visit the grid cells under the other
+/// shape's footprint, and skip any cell whose range of heights doesn't
+/// overlap the shape's vertical extent. Each cell is split into two
+/// triangles, and the contacts are annotated the same way as the equivalent
+/// mesh contacts, so they can be differentiated. Only S = float and S = s_t
+/// are instantiated.
+template <typename S>
+int collideHeightmapSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::HeightmapShape<S>& heightmap0,
+    const Eigen::Isometry3s& T0,
+    s_t radius1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+template <typename S>
+int collideSphereHeightmap(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    s_t radius0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::HeightmapShape<S>& heightmap1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+template <typename S>
+int collideHeightmapCapsule(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::HeightmapShape<S>& heightmap0,
+    const Eigen::Isometry3s& T0,
+    s_t height1,
+    s_t radius1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+template <typename S>
+int collideCapsuleHeightmap(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    s_t height0,
+    s_t radius0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::HeightmapShape<S>& heightmap1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+/// Box corners are tested against the terrain surface, terrain vertices
+/// against the inside of the box, and box edges against convex terrain edges
+/// (ridges), which produce EDGE_EDGE contacts.
+template <typename S>
+int collideHeightmapBox(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::HeightmapShape<S>& heightmap0,
+    const Eigen::Isometry3s& T0,
+    const Eigen::Vector3s& size1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+template <typename S>
+int collideBoxHeightmap(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& size0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::HeightmapShape<S>& heightmap1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+/// Each sphere of the hull is tested on its own, and the surface between every
+/// pair of spheres is tested as the side of the pipe joining them, using the
+/// smaller radius of the pair. Parts of the hull spanned by three or more
+/// spheres are only reached through those pipes.
+template <typename S>
+int collideHeightmapMultiSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::HeightmapShape<S>& heightmap0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+template <typename S>
+int collideMultiSphereHeightmap(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::HeightmapShape<S>& heightmap1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+/// Multi-sphere hulls are collided with GJK/EPA on the whole hull, which tells
+/// us whether (and along which normal) the hull touches the other shape. The
+/// contacts themselves come from colliding the hull's spheres that lie on the
+/// witness plane against the other shape, so they carry the same gradient
+/// metadata as ordinary sphere contacts.
+int collideMultiSphereSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres0,
+    const Eigen::Isometry3s& T0,
+    const s_t& r1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+int collideSphereMultiSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const s_t& r0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+int collideMultiSphereBox(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres0,
+    const Eigen::Isometry3s& T0,
+    const Eigen::Vector3s& size1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+int collideBoxMultiSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& size0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+int collideMultiSphereCapsule(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres0,
+    const Eigen::Isometry3s& T0,
+    s_t height1,
+    s_t radius1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+int collideCapsuleMultiSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    s_t height0,
+    s_t radius0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+int collideMultiSphereMesh(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres0,
+    const Eigen::Isometry3s& T0,
+    const aiScene* mesh1,
+    const Eigen::Vector3s& size1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+int collideMeshMultiSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const aiScene* mesh0,
+    const Eigen::Vector3s& size0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+int collideMultiSphereMultiSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres0,
+    const Eigen::Isometry3s& T0,
+    const dynamics::MultiSphereConvexHullShape::Spheres& spheres1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
 /////////////////////////////////////////////////////////////////////
 // Interface with libccd:
 /////////////////////////////////////////////////////////////////////
@@ -301,6 +506,16 @@ ccd_vec3_t& getCachedCcdPos(CollisionObject* o1, CollisionObject* o2);
 // Get the `dir` vec for CCD for this pair of objects
 ccd_vec3_t& getCachedCcdDir(CollisionObject* o1, CollisionObject* o2);
 
+// Get a copy of the warm-start simplex for GJK for this pair of objects
+GJKCache loadGJKCache(CollisionObject* o1, CollisionObject* o2);
+
+// Save the warm-start simplex for GJK for this pair of objects
+void storeGJKCache(
+    CollisionObject* o1, CollisionObject* o2, const GJKCache& cache);
+
+// Forget every saved GJK warm start
+void clearGJKCache();
+
 // We need to define structs for each object type that we pass to libccd, with
 // all relevant info about the object.
 struct ccdBox
@@ -329,6 +544,12 @@ struct ccdCapsule
   const Eigen::Isometry3s* transform;
 };
 
+struct ccdMultiSphere
+{
+  const dynamics::MultiSphereConvexHullShape::Spheres* spheres;
+  const Eigen::Isometry3s* transform;
+};
+
 // We also need to define "support" functions that will find the furthest point
 // in the object along the direction "_dir", and return it in "_vec" for each
 // type of object.
@@ -339,6 +560,8 @@ void ccdSupportSphere(
 void ccdSupportMesh(const void* _obj, const ccd_vec3_t* _dir, ccd_vec3_t* _out);
 void ccdSupportCapsule(
     const void* _obj, const ccd_vec3_t* _dir, ccd_vec3_t* _out);
+void ccdSupportMultiSphere(
+    const void* _obj, const ccd_vec3_t* _dir, ccd_vec3_t* _out);
 
 // Finally, we need to define the "center" function for objects. This returns
 // the approximate center of each object.
@@ -347,6 +570,7 @@ void ccdCenterBox(const void* _obj, ccd_vec3_t* _center);
 void ccdCenterSphere(const void* _obj, ccd_vec3_t* _center);
 void ccdCenterMesh(const void* _obj, ccd_vec3_t* _center);
 void ccdCenterCapsule(const void* _obj, ccd_vec3_t* _center);
+void ccdCenterMultiSphere(const void* _obj, ccd_vec3_t* _center);
 
 // In order to differentiate between different types of contact, we need to be
 // able to get all the vertices that are within some small epsilon of being on
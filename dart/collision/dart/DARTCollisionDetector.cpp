@@ -40,7 +40,9 @@
 #include "dart/dynamics/BoxShape.hpp"
 #include "dart/dynamics/CapsuleShape.hpp"
 #include "dart/dynamics/EllipsoidShape.hpp"
+#include "dart/dynamics/HeightmapShape.hpp"
 #include "dart/dynamics/MeshShape.hpp"
+#include "dart/dynamics/MultiSphereConvexHullShape.hpp"
 #include "dart/dynamics/ShapeFrame.hpp"
 #include "dart/dynamics/SphereShape.hpp"
 
@@ -292,6 +294,13 @@ void warnUnsupportedShapeType(const dynamics::ShapeFrame* shapeFrame)
   if (shapeType == dynamics::CapsuleShape::getStaticType())
     return;
 
+  if (shapeType == dynamics::HeightmapShapef::getStaticType()
+      || shapeType == dynamics::HeightmapShaped::getStaticType())
+    return;
+
+  if (shapeType == dynamics::MultiSphereConvexHullShape::getStaticType())
+    return;
+
   if (shapeType == dynamics::EllipsoidShape::getStaticType())
   {
     const auto& ellipsoid
@@ -305,7 +314,8 @@ void warnUnsupportedShapeType(const dynamics::ShapeFrame* shapeFrame)
         << shapeType << "] that is not supported "
         << "by DARTCollisionDetector. Currently, only BoxShape and "
         << "EllipsoidShape (only when all the radii are equal) and SphereShape "
-           "and MeshShape and CapsuleShape are "
+           "and MeshShape and CapsuleShape and HeightmapShape and "
+           "MultiSphereConvexHullShape are "
         << "supported. This shape will always get penetrated by other "
         << "objects.\n";
 }
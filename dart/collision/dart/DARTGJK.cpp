@@ -0,0 +1,632 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/collision/dart/DARTGJK.hpp"
+
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace dart {
+namespace collision {
+
+namespace {
+
+/// One vertex of the Minkowski difference A - B, along with the points on A
+/// and B that produced it, and the direction they were queried in.
+struct GJKVertex
+{
+  Eigen::Vector3s w;
+  Eigen::Vector3s a;
+  Eigen::Vector3s b;
+  Eigen::Vector3s dir;
+};
+
+/// A face of the EPA polytope, with its outward unit normal and its distance
+/// from the origin.
+struct EPAFace
+{
+  int v[3];
+  Eigen::Vector3s normal;
+  s_t distance;
+  bool alive;
+};
+
+//==============================================================================
+Eigen::Vector3s fromCcd(const ccd_vec3_t& vec)
+{
+  return Eigen::Vector3s(
+      static_cast<s_t>(vec.v[0]),
+      static_cast<s_t>(vec.v[1]),
+      static_cast<s_t>(vec.v[2]));
+}
+
+//==============================================================================
+ccd_vec3_t toCcd(const Eigen::Vector3s& vec)
+{
+  ccd_vec3_t out;
+  out.v[0] = static_cast<ccd_real_t>(vec(0));
+  out.v[1] = static_cast<ccd_real_t>(vec(1));
+  out.v[2] = static_cast<ccd_real_t>(vec(2));
+  return out;
+}
+
+//==============================================================================
+Eigen::Vector3s getCenter(const GJKShape& shape)
+{
+  ccd_vec3_t center;
+  shape.center(shape.obj, &center);
+  return fromCcd(center);
+}
+
+//==============================================================================
+/// Queries the support point of A - B along `dir`
+GJKVertex getSupport(
+    const GJKShape& a,
+    const GJKShape& b,
+    const Eigen::Vector3s& dir,
+    GJKResult& result)
+{
+  GJKVertex vertex;
+  vertex.dir = dir;
+
+  ccd_vec3_t ccdDir = toCcd(dir);
+  ccd_vec3_t out;
+  a.support(a.obj, &ccdDir, &out);
+  vertex.a = fromCcd(out);
+
+  ccdDir = toCcd(-dir);
+  b.support(b.obj, &ccdDir, &out);
+  vertex.b = fromCcd(out);
+
+  vertex.w = vertex.a - vertex.b;
+  result.numSupportCalls++;
+  return vertex;
+}
+
+//==============================================================================
+bool isInSimplex(
+    const GJKVertex* simplex, int n, const Eigen::Vector3s& w, s_t tolerance)
+{
+  for (int i = 0; i < n; i++)
+  {
+    if ((simplex[i].w - w).squaredNorm() <= tolerance * tolerance)
+      return true;
+  }
+  return false;
+}
+
+//==============================================================================
+/// Shrinks a segment simplex to the feature closest to the origin, and
+/// writes the barycentric weights of the closest point into `lambda`.
+void reduceSegment(GJKVertex* simplex, int& n, s_t* lambda)
+{
+  const Eigen::Vector3s ab = simplex[1].w - simplex[0].w;
+  const s_t denom = ab.squaredNorm();
+  const s_t t = denom > 0 ? -simplex[0].w.dot(ab) / denom : 0.0;
+  if (t <= 0)
+  {
+    n = 1;
+    lambda[0] = 1.0;
+  }
+  else if (t >= 1)
+  {
+    simplex[0] = simplex[1];
+    n = 1;
+    lambda[0] = 1.0;
+  }
+  else
+  {
+    n = 2;
+    lambda[0] = 1.0 - t;
+    lambda[1] = t;
+  }
+}
+
+//==============================================================================
+/// Shrinks a triangle simplex to the feature closest to the origin. This is
+/// the closest-point-on-triangle test from Ericson's "Real-Time Collision
+/// Detection" (5.1.5), with the query point at the origin.
+void reduceTriangle(GJKVertex* simplex, int& n, s_t* lambda)
+{
+  const Eigen::Vector3s a = simplex[0].w;
+  const Eigen::Vector3s b = simplex[1].w;
+  const Eigen::Vector3s c = simplex[2].w;
+  const Eigen::Vector3s ab = b - a;
+  const Eigen::Vector3s ac = c - a;
+
+  const s_t d1 = -ab.dot(a);
+  const s_t d2 = -ac.dot(a);
+  if (d1 <= 0 && d2 <= 0)
+  {
+    n = 1;
+    lambda[0] = 1.0;
+    return;
+  }
+
+  const s_t d3 = -ab.dot(b);
+  const s_t d4 = -ac.dot(b);
+  if (d3 >= 0 && d4 <= d3)
+  {
+    simplex[0] = simplex[1];
+    n = 1;
+    lambda[0] = 1.0;
+    return;
+  }
+
+  const s_t vc = d1 * d4 - d3 * d2;
+  if (vc <= 0 && d1 >= 0 && d3 <= 0)
+  {
+    const s_t t = d1 / (d1 - d3);
+    n = 2;
+    lambda[0] = 1.0 - t;
+    lambda[1] = t;
+    return;
+  }
+
+  const s_t d5 = -ab.dot(c);
+  const s_t d6 = -ac.dot(c);
+  if (d6 >= 0 && d5 <= d6)
+  {
+    simplex[0] = simplex[2];
+    n = 1;
+    lambda[0] = 1.0;
+    return;
+  }
+
+  const s_t vb = d5 * d2 - d1 * d6;
+  if (vb <= 0 && d2 >= 0 && d6 <= 0)
+  {
+    const s_t t = d2 / (d2 - d6);
+    simplex[1] = simplex[2];
+    n = 2;
+    lambda[0] = 1.0 - t;
+    lambda[1] = t;
+    return;
+  }
+
+  const s_t va = d3 * d6 - d5 * d4;
+  if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+  {
+    const s_t t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+    simplex[0] = simplex[1];
+    simplex[1] = simplex[2];
+    n = 2;
+    lambda[0] = 1.0 - t;
+    lambda[1] = t;
+    return;
+  }
+
+  const s_t denom = 1.0 / (va + vb + vc);
+  lambda[1] = vb * denom;
+  lambda[2] = vc * denom;
+  lambda[0] = 1.0 - lambda[1] - lambda[2];
+  n = 3;
+}
+
+//==============================================================================
+/// Shrinks a tetrahedron simplex to the face feature closest to the origin.
+/// If the origin is inside the tetrahedron, the simplex is left alone.
+void reduceTetrahedron(GJKVertex* simplex, int& n, s_t* lambda)
+{
+  // The three vertices of each face, followed by the vertex opposite it
+  static const int faces[4][4]
+      = {{0, 1, 2, 3}, {0, 1, 3, 2}, {0, 2, 3, 1}, {1, 2, 3, 0}};
+
+  bool inside = true;
+  s_t bestDistance = std::numeric_limits<s_t>::infinity();
+  GJKVertex best[3];
+  int bestN = 0;
+  s_t bestLambda[3];
+
+  for (int f = 0; f < 4; f++)
+  {
+    const Eigen::Vector3s& p0 = simplex[faces[f][0]].w;
+    const Eigen::Vector3s normal = (simplex[faces[f][1]].w - p0)
+                                       .cross(simplex[faces[f][2]].w - p0);
+    const s_t originSide = -normal.dot(p0);
+    const s_t oppositeSide = normal.dot(simplex[faces[f][3]].w - p0);
+    // The origin can only be closest to this face if it's on the other side of
+    // it from the opposite vertex
+    if (originSide * oppositeSide > 0
+        || (originSide == 0 && oppositeSide != 0))
+      continue;
+
+    inside = false;
+    GJKVertex triangle[3]
+        = {simplex[faces[f][0]], simplex[faces[f][1]], simplex[faces[f][2]]};
+    int triangleN = 3;
+    s_t triangleLambda[3];
+    reduceTriangle(triangle, triangleN, triangleLambda);
+
+    Eigen::Vector3s closest = Eigen::Vector3s::Zero();
+    for (int i = 0; i < triangleN; i++)
+      closest += triangleLambda[i] * triangle[i].w;
+    const s_t distance = closest.squaredNorm();
+    if (distance < bestDistance)
+    {
+      bestDistance = distance;
+      bestN = triangleN;
+      for (int i = 0; i < triangleN; i++)
+      {
+        best[i] = triangle[i];
+        bestLambda[i] = triangleLambda[i];
+      }
+    }
+  }
+
+  if (inside)
+    return;
+
+  n = bestN;
+  for (int i = 0; i < bestN; i++)
+  {
+    simplex[i] = best[i];
+    lambda[i] = bestLambda[i];
+  }
+}
+
+//==============================================================================
+/// Shrinks the simplex to the feature closest to the origin, and returns the
+/// closest point.
+Eigen::Vector3s reduceSimplex(GJKVertex* simplex, int& n, s_t* lambda)
+{
+  if (n == 1)
+    lambda[0] = 1.0;
+  else if (n == 2)
+    reduceSegment(simplex, n, lambda);
+  else if (n == 3)
+    reduceTriangle(simplex, n, lambda);
+  else if (n == 4)
+    reduceTetrahedron(simplex, n, lambda);
+
+  if (n == 4)
+    return Eigen::Vector3s::Zero();
+
+  Eigen::Vector3s closest = Eigen::Vector3s::Zero();
+  for (int i = 0; i < n; i++)
+    closest += lambda[i] * simplex[i].w;
+  return closest;
+}
+
+//==============================================================================
+/// EPA needs a tetrahedron to start from, but GJK can stop with a smaller
+/// simplex if the origin lands exactly on it. This pads the simplex back out
+/// to a tetrahedron. Returns false if A - B is flat, which only happens if the
+/// shapes are just touching.
+bool expandToTetrahedron(
+    const GJKShape& a,
+    const GJKShape& b,
+    GJKVertex* simplex,
+    int& n,
+    s_t tolerance,
+    GJKResult& result)
+{
+  if (n == 1)
+  {
+    for (int axis = 0; axis < 6 && n == 1; axis++)
+    {
+      const Eigen::Vector3s dir
+          = Eigen::Vector3s::Unit(axis / 2) * (axis % 2 == 0 ? 1.0 : -1.0);
+      GJKVertex vertex = getSupport(a, b, dir, result);
+      if ((vertex.w - simplex[0].w).squaredNorm() > tolerance * tolerance)
+        simplex[n++] = vertex;
+    }
+    if (n == 1)
+      return false;
+  }
+
+  if (n == 2)
+  {
+    const Eigen::Vector3s line = (simplex[1].w - simplex[0].w).normalized();
+    int minAxis;
+    line.cwiseAbs().minCoeff(&minAxis);
+    const Eigen::Vector3s perp
+        = line.cross(Eigen::Vector3s::Unit(minAxis)).normalized();
+    const Eigen::Vector3s perp2 = line.cross(perp);
+    // Try six directions spaced evenly around the line
+    for (int k = 0; k < 6 && n == 2; k++)
+    {
+      const s_t angle = k * M_PI / 3;
+      const Eigen::Vector3s dir = perp * cos(angle) + perp2 * sin(angle);
+      GJKVertex vertex = getSupport(a, b, dir, result);
+      if (line.cross(vertex.w - simplex[0].w).squaredNorm()
+          > tolerance * tolerance)
+        simplex[n++] = vertex;
+    }
+    if (n == 2)
+      return false;
+  }
+
+  if (n == 3)
+  {
+    Eigen::Vector3s normal = (simplex[1].w - simplex[0].w)
+                                 .cross(simplex[2].w - simplex[0].w);
+    if (normal.squaredNorm() <= tolerance * tolerance)
+      return false;
+    normal.normalize();
+
+    GJKVertex vertex = getSupport(a, b, normal, result);
+    if (abs(normal.dot(vertex.w - simplex[0].w)) <= tolerance)
+      vertex = getSupport(a, b, -normal, result);
+    if (abs(normal.dot(vertex.w - simplex[0].w)) <= tolerance)
+      return false;
+    simplex[n++] = vertex;
+  }
+
+  return true;
+}
+
+//==============================================================================
+/// Runs the Expanding Polytope Algorithm from a GJK simplex that contains the
+/// origin, and fills in the penetration depth, normal and witness points.
+void runEPA(
+    const GJKShape& a,
+    const GJKShape& b,
+    GJKVertex* simplex,
+    int n,
+    int maxIterations,
+    s_t tolerance,
+    GJKResult& result)
+{
+  if (!expandToTetrahedron(a, b, simplex, n, tolerance, result))
+  {
+    // Just touching, so there's no depth to speak of
+    result.depth = 0.0;
+    result.pointA = simplex[0].a;
+    result.pointB = simplex[0].b;
+    return;
+  }
+
+  std::vector<GJKVertex> vertices(simplex, simplex + 4);
+  const Eigen::Vector3s interior
+      = (simplex[0].w + simplex[1].w + simplex[2].w + simplex[3].w) / 4;
+
+  std::vector<EPAFace> faces;
+  auto addFace = [&](int i, int j, int k) {
+    EPAFace face;
+    face.v[0] = i;
+    face.v[1] = j;
+    face.v[2] = k;
+    Eigen::Vector3s normal = (vertices[j].w - vertices[i].w)
+                                 .cross(vertices[k].w - vertices[i].w);
+    const s_t norm = normal.norm();
+    if (norm <= tolerance * tolerance)
+      return;
+    normal /= norm;
+    if (normal.dot(vertices[i].w - interior) < 0)
+    {
+      std::swap(face.v[1], face.v[2]);
+      normal = -normal;
+    }
+    face.normal = normal;
+    face.distance = normal.dot(vertices[i].w);
+    face.alive = true;
+    faces.push_back(face);
+  };
+  auto findClosestFace = [&]() {
+    int closest = -1;
+    for (int f = 0; f < static_cast<int>(faces.size()); f++)
+    {
+      if (faces[f].alive
+          && (closest == -1 || faces[f].distance < faces[closest].distance))
+        closest = f;
+    }
+    return closest;
+  };
+
+  addFace(0, 1, 2);
+  addFace(0, 1, 3);
+  addFace(0, 2, 3);
+  addFace(1, 2, 3);
+
+  // EPA converges slowly on curved shapes, so demanding GJK's tolerance here
+  // would just burn the iteration budget
+  const s_t epaTolerance = tolerance > 1e-6 ? tolerance : 1e-6;
+
+  std::vector<std::pair<int, int>> horizon;
+  for (int iter = 0; iter < maxIterations; iter++)
+  {
+    const int closest = findClosestFace();
+    if (closest == -1)
+      break;
+    const Eigen::Vector3s normal = faces[closest].normal;
+    const s_t distance = faces[closest].distance;
+
+    GJKVertex vertex = getSupport(a, b, normal, result);
+    if (vertex.w.dot(normal) - distance <= epaTolerance)
+      break;
+
+    const int newIndex = static_cast<int>(vertices.size());
+    vertices.push_back(vertex);
+
+    // Remove every face the new vertex can see, keeping track of the edges
+    // around the hole that leaves
+    horizon.clear();
+    for (EPAFace& face : faces)
+    {
+      if (!face.alive
+          || face.normal.dot(vertex.w - vertices[face.v[0]].w) <= 0)
+        continue;
+      face.alive = false;
+      for (int e = 0; e < 3; e++)
+      {
+        const std::pair<int, int> edge(face.v[e], face.v[(e + 1) % 3]);
+        bool shared = false;
+        for (std::size_t h = 0; h < horizon.size(); h++)
+        {
+          if (horizon[h].first == edge.second
+              && horizon[h].second == edge.first)
+          {
+            horizon.erase(horizon.begin() + h);
+            shared = true;
+            break;
+          }
+        }
+        if (!shared)
+          horizon.push_back(edge);
+      }
+    }
+    if (horizon.empty())
+      break;
+
+    for (const std::pair<int, int>& edge : horizon)
+      addFace(edge.first, edge.second, newIndex);
+  }
+
+  const int closest = findClosestFace();
+  if (closest == -1)
+  {
+    result.depth = 0.0;
+    result.pointA = simplex[0].a;
+    result.pointB = simplex[0].b;
+    return;
+  }
+  const EPAFace& face = faces[closest];
+
+  // Barycentric coordinates of the origin's projection onto the face
+  const GJKVertex& v0 = vertices[face.v[0]];
+  const GJKVertex& v1 = vertices[face.v[1]];
+  const GJKVertex& v2 = vertices[face.v[2]];
+  const Eigen::Vector3s e0 = v1.w - v0.w;
+  const Eigen::Vector3s e1 = v2.w - v0.w;
+  const Eigen::Vector3s p = face.normal * face.distance - v0.w;
+  const s_t d00 = e0.dot(e0);
+  const s_t d01 = e0.dot(e1);
+  const s_t d11 = e1.dot(e1);
+  const s_t d20 = p.dot(e0);
+  const s_t d21 = p.dot(e1);
+  const s_t denom = d00 * d11 - d01 * d01;
+  s_t l1 = 0.0;
+  s_t l2 = 0.0;
+  if (denom != 0)
+  {
+    l1 = (d11 * d20 - d01 * d21) / denom;
+    l2 = (d00 * d21 - d01 * d20) / denom;
+  }
+  const s_t l0 = 1.0 - l1 - l2;
+
+  result.depth = face.distance > 0 ? face.distance : 0.0;
+  result.normal = -face.normal;
+  result.pointA = l0 * v0.a + l1 * v1.a + l2 * v2.a;
+  result.pointB = l0 * v0.b + l1 * v1.b + l2 * v2.b;
+}
+
+} // namespace
+
+//==============================================================================
+GJKResult gjkPenetration(
+    const GJKShape& a,
+    const GJKShape& b,
+    GJKCache* cache,
+    int maxIterations,
+    s_t tolerance)
+{
+  GJKResult result;
+  GJKVertex simplex[4];
+  s_t lambda[4];
+  int n = 0;
+
+  // Warm start from the directions that built last frame's simplex
+  if (cache != nullptr)
+  {
+    for (int i = 0; i < cache->numDirections; i++)
+    {
+      GJKVertex vertex = getSupport(a, b, cache->directions[i], result);
+      if (!isInSimplex(simplex, n, vertex.w, tolerance))
+        simplex[n++] = vertex;
+    }
+  }
+  if (n == 0)
+  {
+    // A - B is centered around centerA - centerB, so head back towards the
+    // origin from there
+    Eigen::Vector3s dir = getCenter(b) - getCenter(a);
+    if (dir.squaredNorm() <= tolerance * tolerance)
+      dir = Eigen::Vector3s::UnitX();
+    simplex[n++] = getSupport(a, b, dir, result);
+  }
+
+  Eigen::Vector3s closest = reduceSimplex(simplex, n, lambda);
+  bool intersecting = false;
+  for (int iter = 0; iter < maxIterations; iter++)
+  {
+    const s_t closestSquaredNorm = closest.squaredNorm();
+    if (n == 4 || closestSquaredNorm <= tolerance * tolerance)
+    {
+      intersecting = true;
+      break;
+    }
+
+    GJKVertex vertex = getSupport(a, b, -closest, result);
+    // If the new vertex doesn't get us meaningfully closer to the origin, then
+    // `closest` is as close as A - B gets
+    if (closestSquaredNorm - closest.dot(vertex.w)
+            <= tolerance * closestSquaredNorm
+        || isInSimplex(simplex, n, vertex.w, tolerance))
+      break;
+
+    simplex[n++] = vertex;
+    closest = reduceSimplex(simplex, n, lambda);
+  }
+  if (closest.squaredNorm() <= tolerance * tolerance)
+    intersecting = true;
+
+  if (cache != nullptr)
+  {
+    cache->numDirections = n;
+    for (int i = 0; i < n; i++)
+      cache->directions[i] = simplex[i].dir;
+  }
+
+  if (!intersecting)
+  {
+    result.distance = closest.norm();
+    result.normal = closest / result.distance;
+    result.pointA.setZero();
+    result.pointB.setZero();
+    for (int i = 0; i < n; i++)
+    {
+      result.pointA += lambda[i] * simplex[i].a;
+      result.pointB += lambda[i] * simplex[i].b;
+    }
+    return result;
+  }
+
+  result.intersecting = true;
+  runEPA(a, b, simplex, n, maxIterations, tolerance, result);
+  return result;
+}
+
+} // namespace collision
+} // namespace dart
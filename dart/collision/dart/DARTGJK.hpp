@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COLLISION_DART_DARTGJK_HPP_
+#define DART_COLLISION_DART_DARTGJK_HPP_
+
+#include <Eigen/Dense>
+#include <ccd/vec3.h>
+
+#include "dart/math/MathTypes.hpp"
+
+namespace dart {
+namespace collision {
+
+/// A convex shape, described to GJK/EPA by the same support and center
+/// functions we already hand to libccd (ccdSupportBox(), ccdSupportCapsule(),
+/// ccdSupportMesh(), ccdSupportMultiSphere(), etc). `obj` is the matching
+/// ccdBox/ccdCapsule/... struct.
+struct GJKShape
+{
+  const void* obj;
+  void (*support)(const void* obj, const ccd_vec3_t* dir, ccd_vec3_t* out);
+  void (*center)(const void* obj, ccd_vec3_t* center);
+};
+
+/// Per-pair state that GJK carries from one frame to the next. We keep the
+/// directions that produced the final simplex, rather than its vertices,
+/// because the vertices go stale as soon as either shape moves, while the
+/// directions stay good guesses as long as the shapes move smoothly.
+struct GJKCache
+{
+  int numDirections = 0;
+  Eigen::Vector3s directions[4];
+};
+
+struct GJKResult
+{
+  /// True if the shapes overlap, in which case `depth` is filled in by EPA.
+  /// Otherwise `distance` is the gap between them.
+  bool intersecting = false;
+  s_t distance = 0.0;
+  s_t depth = 0.0;
+
+  /// Unit vector pointing from shape B to shape A. For intersecting shapes,
+  /// this is the direction A has to move (by `depth`) to separate them.
+  Eigen::Vector3s normal = Eigen::Vector3s::UnitZ();
+
+  /// The closest (or, if intersecting, deepest) points on A and on B
+  Eigen::Vector3s pointA = Eigen::Vector3s::Zero();
+  Eigen::Vector3s pointB = Eigen::Vector3s::Zero();
+
+  /// How many support queries GJK and EPA needed, which is handy for checking
+  /// that warm starting is doing its job.
+  int numSupportCalls = 0;
+};
+
+/// Runs GJK on the Minkowski difference A - B to find either the distance
+/// between the shapes or, if they overlap, hands the final simplex to EPA to
+/// find the penetration depth and normal.
+///
+/// If `cache` is passed, GJK starts from the simplex directions saved there
+/// (if any) and saves the new ones on the way out. For shapes that move a
+/// little between frames this usually gets GJK down to one or two support
+/// queries.
+GJKResult gjkPenetration(
+    const GJKShape& a,
+    const GJKShape& b,
+    GJKCache* cache = nullptr,
+    int maxIterations = 64,
+    s_t tolerance = 1e-8);
+
+} // namespace collision
+} // namespace dart
+
+#endif // DART_COLLISION_DART_DARTGJK_HPP_
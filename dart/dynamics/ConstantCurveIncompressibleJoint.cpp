@@ -23,6 +23,7 @@ ConstantCurveIncompressibleJoint::ConstantCurveIncompressibleJoint(
     mNeutralPos(Eigen::Vector3s::Zero()),
     mLength(1.0)
 {
+  invalidateCurveCache();
 }
 
 //==============================================================================
@@ -50,6 +51,8 @@ bool ConstantCurveIncompressibleJoint::isCyclic(std::size_t) const
 void ConstantCurveIncompressibleJoint::setFlipAxisMap(Eigen::Vector3s map)
 {
   mFlipAxisMap = map;
+  invalidateCurveCache();
+  notifyPositionUpdated();
 }
 
 //==============================================================================
@@ -62,6 +65,8 @@ Eigen::Vector3s ConstantCurveIncompressibleJoint::getFlipAxisMap() const
 void ConstantCurveIncompressibleJoint::setNeutralPos(Eigen::Vector3s pos)
 {
   mNeutralPos = pos;
+  invalidateCurveCache();
+  notifyPositionUpdated();
 }
 
 //==============================================================================
@@ -74,6 +79,8 @@ Eigen::Vector3s ConstantCurveIncompressibleJoint::getNeutralPos() const
 void ConstantCurveIncompressibleJoint::setLength(s_t len)
 {
   mLength = len;
+  invalidateCurveCache();
+  notifyPositionUpdated();
 }
 
 //==============================================================================
@@ -167,53 +174,173 @@ Eigen::Isometry3s ConstantCurveIncompressibleJoint::getRelativeTransformAt(
 }
 
 //==============================================================================
-void ConstantCurveIncompressibleJoint::updateRelativeTransform() const
+const ConstantCurveIncompressibleJoint::CurveTerms&
+ConstantCurveIncompressibleJoint::getCurveTerms(
+    const Eigen::Vector3s& rawPos) const
 {
-  Eigen::Vector3s pos = this->getPositionsStatic() + mNeutralPos;
   s_t scale = this->getChildScale()(1);
-  s_t d = mLength * scale;
+  if (mCurveTermsValid && rawPos == mCurveTermsRawPos
+      && scale == mCurveTermsScale)
+  {
+    return mCurveTerms;
+  }
+
+  CurveTerms& terms = mCurveTerms;
+  terms.pos = rawPos + mNeutralPos;
+  terms.scale = scale;
+  terms.d = mLength * scale;
 
   // 1. Do the euler rotation
-  Eigen::Isometry3s rot = EulerJoint::convertToTransform(
-      pos, EulerJoint::AxisOrder::XZY, mFlipAxisMap);
+  terms.rot = EulerJoint::convertToTransform(
+      terms.pos, EulerJoint::AxisOrder::XZY, mFlipAxisMap);
+  terms.eulerJacobian = EulerJoint::computeRelativeJacobianStatic(
+      terms.pos,
+      EulerJoint::AxisOrder::XZY,
+      mFlipAxisMap,
+      Eigen::Isometry3s::Identity());
 
-  // 2. Computing translation from vertical
-  Eigen::Isometry3s bentRod = Eigen::Isometry3s::Identity();
+  // Remember, this is X,*Z*,Y
 
-  s_t cx = cos(pos(0));
-  s_t sx = sin(pos(0));
-  s_t cz = cos(pos(1));
-  s_t sz = sin(pos(1));
+  terms.cx = cos(terms.pos(0));
+  terms.sx = sin(terms.pos(0));
+  terms.cz = cos(terms.pos(1));
+  terms.sz = sin(terms.pos(1));
+  const s_t cx = terms.cx;
+  const s_t sx = terms.sx;
+  const s_t cz = terms.cz;
+  const s_t sz = terms.sz;
 
-  Eigen::Vector3s linearAngle
+  const Eigen::Vector3s linearAngle
       = Eigen::Vector3s(-sz, cx * cz, cz * sx); // rot.linear().col(1);
+  terms.linearAngle = linearAngle;
+  terms.dLinearAngle.col(0) = Eigen::Vector3s(0, -sx * cz, cz * cx);
+  terms.dLinearAngle.col(1) = Eigen::Vector3s(-cz, -cx * sz, -sz * sx);
+  terms.dLinearAngle.col(2).setZero();
+  const Eigen::Matrix3s& dLinearAngle = terms.dLinearAngle;
 
-  s_t sinTheta
+  // 2. Computing translation from vertical
+  const s_t sinTheta
       = sqrt(linearAngle(0) * linearAngle(0) + linearAngle(2) * linearAngle(2));
-  if (sinTheta < 0.001 || sinTheta > 0.999)
+  terms.sinTheta = sinTheta;
+  terms.nearVertical = sinTheta < 0.001 || sinTheta > 0.999;
+  terms.bentRod = Eigen::Isometry3s::Identity();
+  if (terms.nearVertical)
   {
     // Near very vertical angles, don't worry about the bend, just approximate
     // with an euler joint
-    bentRod.translation() = Eigen::Vector3s::UnitY() * d;
-    bentRod = rot * bentRod;
+    terms.bentRod.translation() = Eigen::Vector3s::UnitY() * terms.d;
+    terms.bentRod = terms.rot * terms.bentRod;
   }
   else
   {
     // Compute the bend as a function of the angle from vertical
-    s_t theta = asin(sinTheta);
-    s_t r = (d / theta);
-    s_t horizontalDist = r - r * cos(theta);
-    s_t verticalDist = r * sinTheta;
+    for (int i = 0; i < 3; i++)
+    {
+      terms.dSinTheta(i) = (0.5
+                            / sqrt(
+                                linearAngle(0) * linearAngle(0)
+                                + linearAngle(2) * linearAngle(2)))
+                           * (2 * linearAngle(0) * dLinearAngle(0, i)
+                              + 2 * linearAngle(2) * dLinearAngle(2, i));
+    }
+    const Eigen::Vector3s& dSinTheta = terms.dSinTheta;
 
-    bentRod.translation() = Eigen::Vector3s(
+    const s_t d = terms.d;
+    const s_t theta = asin(sinTheta);
+    terms.theta = theta;
+    terms.dTheta = (1.0 / sqrt(1.0 - (sinTheta * sinTheta))) * dSinTheta;
+    const Eigen::Vector3s& dTheta = terms.dTheta;
+
+    const s_t r = (d / theta);
+    terms.r = r;
+    terms.dR = (-d / (theta * theta)) * dTheta;
+    const Eigen::Vector3s& dR = terms.dR;
+
+    const s_t horizontalDist = r - r * cos(theta);
+    const s_t verticalDist = r * sinTheta;
+    terms.horizontalDist = horizontalDist;
+
+    terms.dHorizontalDist = dR + r * sin(theta) * dTheta - dR * cos(theta);
+    terms.dVerticalDist = r * cos(theta) * dTheta + dR * sinTheta;
+    const Eigen::Vector3s& dHorizontalDist = terms.dHorizontalDist;
+
+    terms.dTranslation.row(0)
+        = (linearAngle(0) / sinTheta) * dHorizontalDist.transpose()
+          + (horizontalDist / sinTheta) * dLinearAngle.row(0)
+          + (horizontalDist * linearAngle(0)) * (-1.0 / (sinTheta * sinTheta))
+                * dSinTheta.transpose();
+    terms.dTranslation.row(1) = terms.dVerticalDist;
+    terms.dTranslation.row(2)
+        = (linearAngle(2) / sinTheta) * dHorizontalDist.transpose()
+          + (horizontalDist / sinTheta) * dLinearAngle.row(2)
+          + (horizontalDist * linearAngle(2)) * (-1.0 / (sinTheta * sinTheta))
+                * dSinTheta.transpose();
+
+    terms.bentRod.translation() = Eigen::Vector3s(
         horizontalDist * (linearAngle(0) / sinTheta),
         verticalDist,
         horizontalDist * (linearAngle(2) / sinTheta));
-    bentRod.linear() = rot.linear();
+    terms.bentRod.linear() = terms.rot.linear();
   }
 
+  mCurveTermsRawPos = rawPos;
+  mCurveTermsScale = scale;
+  mCurveTermsValid = true;
+  return terms;
+}
+
+//==============================================================================
+void ConstantCurveIncompressibleJoint::refreshJacobianDerivCache() const
+{
+  const Eigen::Vector3s pos = this->getPositionsStatic();
+  const Eigen::Vector3s scale = this->getChildScale();
+  const Eigen::Matrix4s& childTransform
+      = getTransformFromChildBodyNode().matrix();
+  if (pos == mJacobianDerivsPos && scale == mJacobianDerivsScale
+      && childTransform == mJacobianDerivsChildTransform)
+  {
+    return;
+  }
+
+  mJacobianDerivsPos = pos;
+  mJacobianDerivsScale = scale;
+  mJacobianDerivsChildTransform = childTransform;
+  for (int i = 0; i < 3; i++)
+  {
+    mJacobianDerivsValid[i] = false;
+    for (int j = 0; j < 3; j++)
+    {
+      mJacobianSecondDerivsValid[i][j] = false;
+    }
+  }
+}
+
+//==============================================================================
+void ConstantCurveIncompressibleJoint::invalidateCurveCache()
+{
+  mCurveTermsValid = false;
+  mCurveTermsRawPos.setZero();
+  mCurveTermsScale = 0.0;
+  mJacobianDerivsPos.setZero();
+  mJacobianDerivsScale.setZero();
+  mJacobianDerivsChildTransform.setZero();
+  for (int i = 0; i < 3; i++)
+  {
+    mJacobianDerivsValid[i] = false;
+    for (int j = 0; j < 3; j++)
+    {
+      mJacobianSecondDerivsValid[i][j] = false;
+    }
+  }
+}
+
+//==============================================================================
+void ConstantCurveIncompressibleJoint::updateRelativeTransform() const
+{
+  const CurveTerms& terms = getCurveTerms(this->getPositionsStatic());
+
   // 3. Situate relative to parent and child joints
-  this->mT = Joint::mAspectProperties.mT_ParentBodyToJoint * bentRod
+  this->mT = Joint::mAspectProperties.mT_ParentBodyToJoint * terms.bentRod
              * Joint::mAspectProperties.mT_ChildBodyToJoint.inverse();
 }
 
@@ -224,108 +351,24 @@ ConstantCurveIncompressibleJoint::getRelativeJacobianStatic(
 {
   // Think in terms of the child frame
 
-  Eigen::Vector3s pos = rawPos + mNeutralPos;
-
-  // 1. Do the euler rotation
-  Eigen::Isometry3s rot = EulerJoint::convertToTransform(
-      pos.head<3>(), EulerJoint::AxisOrder::XZY, mFlipAxisMap.head<3>());
-  Eigen::Matrix<s_t, 6, 3> J = Eigen::Matrix<s_t, 6, 3>::Zero();
+  const CurveTerms& terms = getCurveTerms(rawPos);
 
   // 2. Compute the Jacobian of the Euler transformation
-  Eigen::Isometry3s identity = Eigen::Isometry3s::Identity();
-  J.block<6, 3>(0, 0) = EulerJoint::computeRelativeJacobianStatic(
-      pos.head<3>(),
-      EulerJoint::AxisOrder::XZY,
-      mFlipAxisMap.head<3>(),
-      identity);
+  Eigen::Matrix<s_t, 6, 3> J = terms.eulerJacobian;
 
-  s_t scale = this->getChildScale()(1);
-  s_t d = mLength * scale;
-
-  // Remember, this is X,*Z*,Y
-
-  s_t cx = cos(pos(0));
-  s_t sx = sin(pos(0));
-  s_t cz = cos(pos(1));
-  s_t sz = sin(pos(1));
-
-  Eigen::Vector3s linearAngle = Eigen::Vector3s(-sz, cx * cz, cz * sx);
-  Eigen::Matrix<s_t, 3, 3> dLinearAngle = Eigen::Matrix<s_t, 3, 3>::Zero();
-  dLinearAngle.col(0) = Eigen::Vector3s(0, -sx * cz, cz * cx);
-  dLinearAngle.col(1) = Eigen::Vector3s(-cz, -cx * sz, -sz * sx);
-  dLinearAngle.col(2).setZero();
-
-  s_t sinTheta
-      = sqrt(linearAngle(0) * linearAngle(0) + linearAngle(2) * linearAngle(2));
-
-  if (sinTheta < 0.001 || sinTheta > 0.999)
+  if (terms.nearVertical)
   {
     // Near very vertical angles, don't worry about the bend, just approximate
     // with an euler joint
+    const Eigen::Vector3s translation = terms.bentRod.translation();
 
-    // 1. Do the euler rotation
-    Eigen::Isometry3s rot = EulerJoint::convertToTransform(
-        pos.head<3>(), EulerJoint::AxisOrder::XZY, mFlipAxisMap.head<3>());
-
-    // 2. Computing translation from vertical
-    Eigen::Isometry3s bentRod = Eigen::Isometry3s::Identity();
-
-    bentRod.translation() = Eigen::Vector3s::UnitY() * d;
-    bentRod = rot * bentRod;
-
-    J.block<3, 1>(3, 0)
-        = 0.5 * J.block<3, 1>(0, 0).cross(bentRod.translation());
-    J.block<3, 1>(3, 1)
-        = 0.5 * J.block<3, 1>(0, 1).cross(bentRod.translation());
-    J.block<3, 1>(3, 2)
-        = 0.5 * J.block<3, 1>(0, 2).cross(bentRod.translation());
+    J.block<3, 1>(3, 0) = 0.5 * J.block<3, 1>(0, 0).cross(translation);
+    J.block<3, 1>(3, 1) = 0.5 * J.block<3, 1>(0, 1).cross(translation);
+    J.block<3, 1>(3, 2) = 0.5 * J.block<3, 1>(0, 2).cross(translation);
   }
   else
   {
-    // Compute the bend as a function of the angle from vertical
-    Eigen::Vector3s dSinTheta;
-    for (int i = 0; i < 3; i++)
-    {
-      dSinTheta(i) = (0.5
-                      / sqrt(
-                          linearAngle(0) * linearAngle(0)
-                          + linearAngle(2) * linearAngle(2)))
-                     * (2 * linearAngle(0) * dLinearAngle(0, i)
-                        + 2 * linearAngle(2) * dLinearAngle(2, i));
-    }
-
-    s_t theta = asin(sinTheta);
-    Eigen::Vector3s dTheta
-        = (1.0 / sqrt(1.0 - (sinTheta * sinTheta))) * dSinTheta;
-
-    s_t r = (d / theta);
-    Eigen::Vector3s dR = (-d / (theta * theta)) * dTheta;
-
-    s_t horizontalDist = r - r * cos(theta);
-
-    Eigen::Vector3s dHorizontalDist
-        = dR + r * sin(theta) * dTheta - dR * cos(theta);
-    Eigen::Vector3s dVerticalDist = r * cos(theta) * dTheta + dR * sinTheta;
-
-    Eigen::Matrix<s_t, 3, 3> dTranslation = Eigen::Matrix<s_t, 3, 3>::Zero();
-    dTranslation.row(0)
-        = (linearAngle(0) / sinTheta) * dHorizontalDist.transpose()
-          + (horizontalDist / sinTheta) * dLinearAngle.row(0)
-          + (horizontalDist * linearAngle(0)) * (-1.0 / (sinTheta * sinTheta))
-                * dSinTheta.transpose();
-    dTranslation.row(1) = dVerticalDist;
-    dTranslation.row(2)
-        = (linearAngle(2) / sinTheta) * dHorizontalDist.transpose()
-          + (horizontalDist / sinTheta) * dLinearAngle.row(2)
-          + (horizontalDist * linearAngle(2)) * (-1.0 / (sinTheta * sinTheta))
-                * dSinTheta.transpose();
-
-    J.block<3, 1>(3, 0)
-        = rot.linear().transpose() * dTranslation.block<3, 1>(0, 0);
-    J.block<3, 1>(3, 1)
-        = rot.linear().transpose() * dTranslation.block<3, 1>(0, 1);
-    J.block<3, 1>(3, 2)
-        = rot.linear().transpose() * dTranslation.block<3, 1>(0, 2);
+    J.block<3, 3>(3, 0) = terms.rot.linear().transpose() * terms.dTranslation;
   }
 
   // Finally, take into account the transform to the child body node
@@ -337,14 +380,29 @@ ConstantCurveIncompressibleJoint::getRelativeJacobianStatic(
 Eigen::Matrix<s_t, 6, 3>
 ConstantCurveIncompressibleJoint::getRelativeJacobianDerivWrtPositionStatic(
     std::size_t index) const
+{
+  refreshJacobianDerivCache();
+  if (!mJacobianDerivsValid[index])
+  {
+    mJacobianDerivs[index]
+        = computeRelativeJacobianDerivWrtPositionStatic(index);
+    mJacobianDerivsValid[index] = true;
+  }
+  return mJacobianDerivs[index];
+}
+
+//==============================================================================
+Eigen::Matrix<s_t, 6, 3>
+ConstantCurveIncompressibleJoint::computeRelativeJacobianDerivWrtPositionStatic(
+    std::size_t index) const
 {
   // Think in terms of the child frame
 
-  const Eigen::Vector3s pos = getPositionsStatic() + mNeutralPos;
+  const CurveTerms& terms = getCurveTerms(getPositionsStatic());
+  const Eigen::Vector3s& pos = terms.pos;
 
   // 1. Do the euler rotation
-  const Eigen::Isometry3s rot = EulerJoint::convertToTransform(
-      pos.head<3>(), EulerJoint::AxisOrder::XZY, mFlipAxisMap.head<3>());
+  const Eigen::Isometry3s& rot = terms.rot;
   const Eigen::Matrix3s rot_dFirst
       = math::eulerXZYToMatrixGrad(pos.head<3>(), index);
 
@@ -359,22 +417,17 @@ ConstantCurveIncompressibleJoint::getRelativeJacobianDerivWrtPositionStatic(
       mFlipAxisMap.head<3>(),
       identity);
 
-  s_t scale = this->getChildScale()(1);
-  const s_t d = mLength * scale;
+  const s_t d = terms.d;
 
   // Remember, this is X,*Z*,Y
 
-  const s_t cx = cos(pos(0));
-  const s_t sx = sin(pos(0));
-  const s_t cz = cos(pos(1));
-  const s_t sz = sin(pos(1));
-
-  const Eigen::Vector3s linearAngle = Eigen::Vector3s(-sz, cx * cz, cz * sx);
+  const s_t cx = terms.cx;
+  const s_t sx = terms.sx;
+  const s_t cz = terms.cz;
+  const s_t sz = terms.sz;
 
-  Eigen::Matrix<s_t, 3, 3> dLinearAngle = Eigen::Matrix<s_t, 3, 3>::Zero();
-  dLinearAngle.col(0) = Eigen::Vector3s(0, -sx * cz, cz * cx);
-  dLinearAngle.col(1) = Eigen::Vector3s(-cz, -cx * sz, -sz * sx);
-  dLinearAngle.col(2).setZero();
+  const Eigen::Vector3s& linearAngle = terms.linearAngle;
+  const Eigen::Matrix3s& dLinearAngle = terms.dLinearAngle;
 
   Eigen::Matrix<s_t, 3, 3> dLinearAngle_dFirst
       = Eigen::Matrix<s_t, 3, 3>::Zero();
@@ -394,25 +447,16 @@ ConstantCurveIncompressibleJoint::getRelativeJacobianDerivWrtPositionStatic(
     dLinearAngle_dFirst.col(2).setZero();
   }
 
-  const s_t sinTheta
-      = sqrt(linearAngle(0) * linearAngle(0) + linearAngle(2) * linearAngle(2));
+  const s_t sinTheta = terms.sinTheta;
 
-  if (sinTheta < 0.001 || sinTheta > 0.999)
+  if (terms.nearVertical)
   {
     // Near very vertical angles, don't worry about the bend, just approximate
     // with an euler joint
-    const Eigen::Matrix<s_t, 6, 3> J
-        = EulerJoint::computeRelativeJacobianStatic(
-            pos.head<3>(),
-            EulerJoint::AxisOrder::XZY,
-            mFlipAxisMap.head<3>(),
-            identity);
+    const Eigen::Matrix<s_t, 6, 3>& J = terms.eulerJacobian;
 
     // 2. Computing translation from vertical
-    Eigen::Isometry3s bentRod = Eigen::Isometry3s::Identity();
-
-    bentRod.translation() = Eigen::Vector3s::UnitY() * d;
-    bentRod = rot * bentRod;
+    const Eigen::Isometry3s& bentRod = terms.bentRod;
 
     const Eigen::Vector3s translation_dFirst
         = rot.linear() * J.block<3, 1>(0, index).cross(bentRod.translation());
@@ -432,7 +476,7 @@ ConstantCurveIncompressibleJoint::getRelativeJacobianDerivWrtPositionStatic(
   }
   else
   {
-    Eigen::Vector3s dSinTheta;
+    const Eigen::Vector3s& dSinTheta = terms.dSinTheta;
     Eigen::Vector3s dSinTheta_dFirst;
     for (int i = 0; i < 3; i++)
     {
@@ -444,7 +488,6 @@ ConstantCurveIncompressibleJoint::getRelativeJacobianDerivWrtPositionStatic(
       const s_t part2
           = (2 * linearAngle(0) * dLinearAngle(0, i)
              + 2 * linearAngle(2) * dLinearAngle(2, i));
-      dSinTheta(i) = part1 * part2;
 
       const s_t part1_dFirst
           = ((-0.25
@@ -472,36 +515,34 @@ ConstantCurveIncompressibleJoint::getRelativeJacobianDerivWrtPositionStatic(
              + 2 * linearAngle(2) * linearAngle_dFirst(2));
 
     // Compute the bend as a function of the angle from vertical
-    const s_t theta = asin(sinTheta);
+    const s_t theta = terms.theta;
     const s_t theta_dFirst
         = (1.0 / sqrt(1.0 - (sinTheta * sinTheta))) * sinTheta_dFirst;
     (void)theta_dFirst;
 
-    const Eigen::Vector3s dTheta
-        = (1.0 / sqrt(1.0 - (sinTheta * sinTheta))) * dSinTheta;
+    const Eigen::Vector3s& dTheta = terms.dTheta;
     const Eigen::Vector3s dTheta_dFirst
         = (1.0 / pow(1.0 - (sinTheta * sinTheta), 1.5)) * sinTheta
               * sinTheta_dFirst * dSinTheta
           + (1.0 / sqrt(1.0 - (sinTheta * sinTheta))) * dSinTheta_dFirst;
     (void)dTheta_dFirst;
 
-    const s_t r = (d / theta);
+    const s_t r = terms.r;
     const s_t r_dFirst = (-d / (theta * theta)) * theta_dFirst;
     (void)r_dFirst;
 
-    const Eigen::Vector3s dR = (-d / (theta * theta)) * dTheta;
+    const Eigen::Vector3s& dR = terms.dR;
     const Eigen::Vector3s dR_dFirst
         = (2 * d / (theta * theta * theta)) * theta_dFirst * dTheta
           + (-d / (theta * theta)) * dTheta_dFirst;
     (void)dR_dFirst;
 
-    const s_t horizontalDist = r - r * cos(theta);
+    const s_t horizontalDist = terms.horizontalDist;
     const s_t horizontalDist_dFirst
         = r_dFirst - (r_dFirst * cos(theta) - r * sin(theta) * theta_dFirst);
     (void)horizontalDist_dFirst;
 
-    const Eigen::Vector3s dHorizontalDist
-        = dR + r * sin(theta) * dTheta - dR * cos(theta);
+    const Eigen::Vector3s& dHorizontalDist = terms.dHorizontalDist;
     const Eigen::Vector3s dHorizontalDist_dFirst
         = dR_dFirst
           + (r_dFirst * sin(theta) * dTheta
@@ -510,8 +551,6 @@ ConstantCurveIncompressibleJoint::getRelativeJacobianDerivWrtPositionStatic(
           - (dR_dFirst * cos(theta) - dR * sin(theta) * theta_dFirst);
     (void)dHorizontalDist_dFirst;
 
-    const Eigen::Vector3s dVerticalDist
-        = r * cos(theta) * dTheta + dR * sinTheta;
     const Eigen::Vector3s dVerticalDist_dFirst
         = (r_dFirst * cos(theta) * dTheta
            - r * sin(theta) * theta_dFirst * dTheta
@@ -519,18 +558,7 @@ ConstantCurveIncompressibleJoint::getRelativeJacobianDerivWrtPositionStatic(
           + (dR_dFirst * sinTheta + dR * sinTheta_dFirst);
     (void)dVerticalDist_dFirst;
 
-    Eigen::Matrix<s_t, 3, 3> dTranslation = Eigen::Matrix<s_t, 3, 3>::Zero();
-    dTranslation.row(0)
-        = (linearAngle(0) / sinTheta) * dHorizontalDist.transpose()
-          + (horizontalDist / sinTheta) * dLinearAngle.row(0)
-          + (horizontalDist * linearAngle(0)) * (-1.0 / (sinTheta * sinTheta))
-                * dSinTheta.transpose();
-    dTranslation.row(1) = dVerticalDist;
-    dTranslation.row(2)
-        = (linearAngle(2) / sinTheta) * dHorizontalDist.transpose()
-          + (horizontalDist / sinTheta) * dLinearAngle.row(2)
-          + (horizontalDist * linearAngle(2)) * (-1.0 / (sinTheta * sinTheta))
-                * dSinTheta.transpose();
+    const Eigen::Matrix3s& dTranslation = terms.dTranslation;
 
     Eigen::Matrix<s_t, 3, 3> dTranslation_dFirst
         = Eigen::Matrix<s_t, 3, 3>::Zero();
@@ -594,6 +622,22 @@ ConstantCurveIncompressibleJoint::getRelativeJacobianDerivWrtPositionStatic(
 Eigen::Matrix<s_t, 6, 3> ConstantCurveIncompressibleJoint::
     getRelativeJacobianDerivWrtPositionDerivWrtPositionStatic(
         std::size_t firstIndex, std::size_t secondIndex) const
+{
+  refreshJacobianDerivCache();
+  if (!mJacobianSecondDerivsValid[firstIndex][secondIndex])
+  {
+    mJacobianSecondDerivs[firstIndex][secondIndex]
+        = computeRelativeJacobianDerivWrtPositionDerivWrtPositionStatic(
+            firstIndex, secondIndex);
+    mJacobianSecondDerivsValid[firstIndex][secondIndex] = true;
+  }
+  return mJacobianSecondDerivs[firstIndex][secondIndex];
+}
+
+//==============================================================================
+Eigen::Matrix<s_t, 6, 3> ConstantCurveIncompressibleJoint::
+    computeRelativeJacobianDerivWrtPositionDerivWrtPositionStatic(
+        std::size_t firstIndex, std::size_t secondIndex) const
 {
   (void)secondIndex;
 
@@ -1564,8 +1608,7 @@ void ConstantCurveIncompressibleJoint::updateRelativeJacobian(bool) const
 //==============================================================================
 void ConstantCurveIncompressibleJoint::updateRelativeJacobianTimeDeriv() const
 {
-  Eigen::VectorXs pos = this->getPositionsStatic();
-  Eigen::VectorXs vel = this->getVelocitiesStatic();
+  const Eigen::Vector3s& vel = this->getVelocitiesStatic();
 
   Eigen::Matrix<s_t, 6, 3> dJ = Eigen::Matrix<s_t, 6, 3>::Zero();
   for (int i = 0; i < 3; i++)
@@ -1583,11 +1626,10 @@ math::Jacobian
 ConstantCurveIncompressibleJoint::getRelativeJacobianTimeDerivDerivWrtPosition(
     std::size_t index) const
 {
-  Eigen::VectorXs pos = this->getPositionsStatic();
-  Eigen::VectorXs vel = this->getVelocitiesStatic();
+  const Eigen::Vector3s& vel = this->getVelocitiesStatic();
 
   Eigen::Matrix<s_t, 6, 3> ddJ = Eigen::Matrix<s_t, 6, 3>::Zero();
-  for (int i = 0; i < pos.size(); i++)
+  for (int i = 0; i < 3; i++)
   {
     ddJ += getRelativeJacobianDerivWrtPositionDerivWrtPositionStatic(i, index)
            * vel(i);
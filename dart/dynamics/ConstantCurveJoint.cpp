@@ -21,6 +21,7 @@ ConstantCurveJoint::ConstantCurveJoint(
     mFlipAxisMap(Eigen::Vector3s::Ones()),
     mNeutralPos(Eigen::Vector4s::Unit(3) * 0.6)
 {
+  invalidateCurveCache();
 }
 
 //==============================================================================
@@ -48,6 +49,8 @@ bool ConstantCurveJoint::isCyclic(std::size_t) const
 void ConstantCurveJoint::setFlipAxisMap(Eigen::Vector3s map)
 {
   mFlipAxisMap = map;
+  invalidateCurveCache();
+  notifyPositionUpdated();
 }
 
 //==============================================================================
@@ -60,6 +63,8 @@ Eigen::Vector3s ConstantCurveJoint::getFlipAxisMap() const
 void ConstantCurveJoint::setNeutralPos(Eigen::Vector4s pos)
 {
   mNeutralPos = pos;
+  invalidateCurveCache();
+  notifyPositionUpdated();
 }
 
 //==============================================================================
@@ -102,52 +107,176 @@ void ConstantCurveJoint::updateDegreeOfFreedomNames()
 }
 
 //==============================================================================
-void ConstantCurveJoint::updateRelativeTransform() const
+const ConstantCurveJoint::CurveTerms& ConstantCurveJoint::getCurveTerms(
+    const Eigen::Vector4s& rawPos) const
 {
-  Eigen::Vector4s pos = this->getPositionsStatic() + mNeutralPos;
-  s_t d = pos(3) * this->getChildScale()(1);
+  s_t scale = this->getChildScale()(1);
+  if (mCurveTermsValid && rawPos == mCurveTermsRawPos
+      && scale == mCurveTermsScale)
+  {
+    return mCurveTerms;
+  }
+
+  CurveTerms& terms = mCurveTerms;
+  terms.pos = rawPos + mNeutralPos;
+  terms.scale = scale;
+  terms.d = terms.pos(3) * scale;
 
   // 1. Do the euler rotation
-  Eigen::Isometry3s rot = EulerJoint::convertToTransform(
-      pos.head<3>(), EulerJoint::AxisOrder::XZY, mFlipAxisMap.head<3>());
+  terms.rot = EulerJoint::convertToTransform(
+      terms.pos.head<3>(), EulerJoint::AxisOrder::XZY, mFlipAxisMap.head<3>());
+  terms.eulerJacobian = EulerJoint::computeRelativeJacobianStatic(
+      terms.pos.head<3>(),
+      EulerJoint::AxisOrder::XZY,
+      mFlipAxisMap.head<3>(),
+      Eigen::Isometry3s::Identity());
 
-  // 2. Computing translation from vertical
-  Eigen::Isometry3s bentRod = Eigen::Isometry3s::Identity();
+  // Remember, this is X,*Z*,Y
 
-  s_t cx = cos(pos(0));
-  s_t sx = sin(pos(0));
-  s_t cz = cos(pos(1));
-  s_t sz = sin(pos(1));
+  terms.cx = cos(terms.pos(0));
+  terms.sx = sin(terms.pos(0));
+  terms.cz = cos(terms.pos(1));
+  terms.sz = sin(terms.pos(1));
+  const s_t cx = terms.cx;
+  const s_t sx = terms.sx;
+  const s_t cz = terms.cz;
+  const s_t sz = terms.sz;
 
-  Eigen::Vector3s linearAngle
+  const Eigen::Vector3s linearAngle
       = Eigen::Vector3s(-sz, cx * cz, cz * sx); // rot.linear().col(1);
+  terms.linearAngle = linearAngle;
+  terms.dLinearAngle.col(0) = Eigen::Vector3s(0, -sx * cz, cz * cx);
+  terms.dLinearAngle.col(1) = Eigen::Vector3s(-cz, -cx * sz, -sz * sx);
+  terms.dLinearAngle.col(2).setZero();
+  terms.dLinearAngle.col(3).setZero();
+  const Eigen::Matrix<s_t, 3, 4>& dLinearAngle = terms.dLinearAngle;
 
-  s_t sinTheta
+  // 2. Computing translation from vertical
+  const s_t sinTheta
       = sqrt(linearAngle(0) * linearAngle(0) + linearAngle(2) * linearAngle(2));
-  if (sinTheta < 0.001)
+  terms.sinTheta = sinTheta;
+  terms.nearVertical = sinTheta < 0.001;
+  terms.bentRod = Eigen::Isometry3s::Identity();
+  if (terms.nearVertical)
   {
     // Near very vertical angles, don't worry about the bend, just approximate
     // with an euler joint
-    bentRod.translation() = Eigen::Vector3s::UnitY() * d;
-    bentRod = rot * bentRod;
+    terms.bentRod.translation() = Eigen::Vector3s::UnitY() * terms.d;
+    terms.bentRod = terms.rot * terms.bentRod;
   }
   else
   {
     // Compute the bend as a function of the angle from vertical
-    s_t theta = asin(sinTheta);
-    s_t r = (d / theta);
-    s_t horizontalDist = r - r * cos(theta);
-    s_t verticalDist = r * sinTheta;
+    for (int i = 0; i < 3; i++)
+    {
+      terms.dSinTheta(i) = (0.5
+                            / sqrt(
+                                linearAngle(0) * linearAngle(0)
+                                + linearAngle(2) * linearAngle(2)))
+                           * (2 * linearAngle(0) * dLinearAngle(0, i)
+                              + 2 * linearAngle(2) * dLinearAngle(2, i));
+    }
+    terms.dSinTheta(3) = 0;
+    const Eigen::Vector4s& dSinTheta = terms.dSinTheta;
+
+    const s_t d = terms.d;
+    const s_t theta = asin(sinTheta);
+    terms.theta = theta;
+    terms.dTheta = (1.0 / sqrt(1.0 - (sinTheta * sinTheta))) * dSinTheta;
+    const Eigen::Vector4s& dTheta = terms.dTheta;
+
+    const s_t r = (d / theta);
+    terms.r = r;
+    terms.dR.setZero();
+    terms.dR.segment<3>(0) = (-d / (theta * theta)) * dTheta.segment<3>(0);
+    terms.dR(3) = 1.0 / theta;
+    const Eigen::Vector4s& dR = terms.dR;
+
+    const s_t horizontalDist = r - r * cos(theta);
+    const s_t verticalDist = r * sinTheta;
+    terms.horizontalDist = horizontalDist;
+
+    terms.dHorizontalDist = dR + r * sin(theta) * dTheta - dR * cos(theta);
+    terms.dVerticalDist = r * cos(theta) * dTheta + dR * sinTheta;
+    const Eigen::Vector4s& dHorizontalDist = terms.dHorizontalDist;
+
+    terms.dTranslation.row(0)
+        = (linearAngle(0) / sinTheta) * dHorizontalDist.transpose()
+          + (horizontalDist / sinTheta) * dLinearAngle.row(0)
+          + (horizontalDist * linearAngle(0)) * (-1.0 / (sinTheta * sinTheta))
+                * dSinTheta.transpose();
+    terms.dTranslation.row(1) = terms.dVerticalDist;
+    terms.dTranslation.row(2)
+        = (linearAngle(2) / sinTheta) * dHorizontalDist.transpose()
+          + (horizontalDist / sinTheta) * dLinearAngle.row(2)
+          + (horizontalDist * linearAngle(2)) * (-1.0 / (sinTheta * sinTheta))
+                * dSinTheta.transpose();
 
-    bentRod.translation() = Eigen::Vector3s(
+    terms.bentRod.translation() = Eigen::Vector3s(
         horizontalDist * (linearAngle(0) / sinTheta),
         verticalDist,
         horizontalDist * (linearAngle(2) / sinTheta));
-    bentRod.linear() = rot.linear();
+    terms.bentRod.linear() = terms.rot.linear();
   }
 
+  mCurveTermsRawPos = rawPos;
+  mCurveTermsScale = scale;
+  mCurveTermsValid = true;
+  return terms;
+}
+
+//==============================================================================
+void ConstantCurveJoint::refreshJacobianDerivCache() const
+{
+  const Eigen::Vector4s pos = this->getPositionsStatic();
+  const Eigen::Vector3s scale = this->getChildScale();
+  const Eigen::Matrix4s& childTransform
+      = getTransformFromChildBodyNode().matrix();
+  if (pos == mJacobianDerivsPos && scale == mJacobianDerivsScale
+      && childTransform == mJacobianDerivsChildTransform)
+  {
+    return;
+  }
+
+  mJacobianDerivsPos = pos;
+  mJacobianDerivsScale = scale;
+  mJacobianDerivsChildTransform = childTransform;
+  for (int i = 0; i < 4; i++)
+  {
+    mJacobianDerivsValid[i] = false;
+    for (int j = 0; j < 4; j++)
+    {
+      mJacobianSecondDerivsValid[i][j] = false;
+    }
+  }
+}
+
+//==============================================================================
+void ConstantCurveJoint::invalidateCurveCache()
+{
+  mCurveTermsValid = false;
+  mCurveTermsRawPos.setZero();
+  mCurveTermsScale = 0.0;
+  mJacobianDerivsPos.setZero();
+  mJacobianDerivsScale.setZero();
+  mJacobianDerivsChildTransform.setZero();
+  for (int i = 0; i < 4; i++)
+  {
+    mJacobianDerivsValid[i] = false;
+    for (int j = 0; j < 4; j++)
+    {
+      mJacobianSecondDerivsValid[i][j] = false;
+    }
+  }
+}
+
+//==============================================================================
+void ConstantCurveJoint::updateRelativeTransform() const
+{
+  const CurveTerms& terms = getCurveTerms(this->getPositionsStatic());
+
   // 3. Situate relative to parent and child joints
-  this->mT = Joint::mAspectProperties.mT_ParentBodyToJoint * bentRod
+  this->mT = Joint::mAspectProperties.mT_ParentBodyToJoint * terms.bentRod
              * Joint::mAspectProperties.mT_ChildBodyToJoint.inverse();
 }
 
@@ -157,65 +286,24 @@ Eigen::Matrix<s_t, 6, 4> ConstantCurveJoint::getRelativeJacobianStatic(
 {
   // Think in terms of the child frame
 
-  Eigen::Vector4s pos = rawPos + mNeutralPos;
-
-  // 1. Do the euler rotation
-  Eigen::Isometry3s rot = EulerJoint::convertToTransform(
-      pos.head<3>(), EulerJoint::AxisOrder::XZY, mFlipAxisMap.head<3>());
+  const CurveTerms& terms = getCurveTerms(rawPos);
   Eigen::Matrix<s_t, 6, 4> J = Eigen::Matrix<s_t, 6, 4>::Zero();
 
   // 2. Compute the Jacobian of the Euler transformation
-  Eigen::Isometry3s identity = Eigen::Isometry3s::Identity();
-  J.block<6, 3>(0, 0) = EulerJoint::computeRelativeJacobianStatic(
-      pos.head<3>(),
-      EulerJoint::AxisOrder::XZY,
-      mFlipAxisMap.head<3>(),
-      identity);
-
-  s_t d = pos(3) * this->getChildScale()(1);
+  J.block<6, 3>(0, 0) = terms.eulerJacobian;
 
-  // Remember, this is X,*Z*,Y
-
-  s_t cx = cos(pos(0));
-  s_t sx = sin(pos(0));
-  s_t cz = cos(pos(1));
-  s_t sz = sin(pos(1));
-
-  Eigen::Vector3s linearAngle = Eigen::Vector3s(-sz, cx * cz, cz * sx);
-  Eigen::Matrix<s_t, 3, 4> dLinearAngle = Eigen::Matrix<s_t, 3, 4>::Zero();
-  dLinearAngle.col(0) = Eigen::Vector3s(0, -sx * cz, cz * cx);
-  dLinearAngle.col(1) = Eigen::Vector3s(-cz, -cx * sz, -sz * sx);
-  dLinearAngle.col(2).setZero();
-  dLinearAngle.col(3).setZero();
-
-  s_t sinTheta
-      = sqrt(linearAngle(0) * linearAngle(0) + linearAngle(2) * linearAngle(2));
-
-  if (sinTheta < 0.001)
+  if (terms.nearVertical)
   {
     // Near very vertical angles, don't worry about the bend, just approximate
     // with an euler joint
+    const Eigen::Vector3s translation = terms.bentRod.translation();
 
-    // 1. Do the euler rotation
-    Eigen::Isometry3s rot = EulerJoint::convertToTransform(
-        pos.head<3>(), EulerJoint::AxisOrder::XZY, mFlipAxisMap.head<3>());
-
-    // 2. Computing translation from vertical
-    Eigen::Isometry3s bentRod = Eigen::Isometry3s::Identity();
-
-    bentRod.translation() = Eigen::Vector3s::UnitY() * d;
-    bentRod = rot * bentRod;
-
-    J.block<3, 1>(3, 0)
-        = 0.5 * J.block<3, 1>(0, 0).cross(bentRod.translation());
-    J.block<3, 1>(3, 1)
-        = 0.5 * J.block<3, 1>(0, 1).cross(bentRod.translation());
-    J.block<3, 1>(3, 2)
-        = 0.5 * J.block<3, 1>(0, 2).cross(bentRod.translation());
-    if (bentRod.translation().norm() > 0.003)
+    J.block<3, 1>(3, 0) = 0.5 * J.block<3, 1>(0, 0).cross(translation);
+    J.block<3, 1>(3, 1) = 0.5 * J.block<3, 1>(0, 1).cross(translation);
+    J.block<3, 1>(3, 2) = 0.5 * J.block<3, 1>(0, 2).cross(translation);
+    if (translation.norm() > 0.003)
     {
-      J.block<3, 1>(3, 3)
-          = bentRod.translation().normalized() * this->getChildScale()(1);
+      J.block<3, 1>(3, 3) = translation.normalized() * terms.scale;
     }
     else
     {
@@ -224,55 +312,7 @@ Eigen::Matrix<s_t, 6, 4> ConstantCurveJoint::getRelativeJacobianStatic(
   }
   else
   {
-    // Compute the bend as a function of the angle from vertical
-    Eigen::Vector4s dSinTheta;
-    for (int i = 0; i < 3; i++)
-    {
-      dSinTheta(i) = (0.5
-                      / sqrt(
-                          linearAngle(0) * linearAngle(0)
-                          + linearAngle(2) * linearAngle(2)))
-                     * (2 * linearAngle(0) * dLinearAngle(0, i)
-                        + 2 * linearAngle(2) * dLinearAngle(2, i));
-    }
-    dSinTheta(3) = 0;
-
-    s_t theta = asin(sinTheta);
-    Eigen::Vector4s dTheta
-        = (1.0 / sqrt(1.0 - (sinTheta * sinTheta))) * dSinTheta;
-
-    s_t r = (d / theta);
-    Eigen::Vector4s dR = Eigen::Vector4s::Zero();
-    dR.segment<3>(0) = (-d / (theta * theta)) * dTheta.segment<3>(0);
-    dR(3) = 1.0 / theta;
-
-    s_t horizontalDist = r - r * cos(theta);
-
-    Eigen::Vector4s dHorizontalDist
-        = dR + r * sin(theta) * dTheta - dR * cos(theta);
-    Eigen::Vector4s dVerticalDist = r * cos(theta) * dTheta + dR * sinTheta;
-
-    Eigen::Matrix<s_t, 3, 4> dTranslation = Eigen::Matrix<s_t, 3, 4>::Zero();
-    dTranslation.row(0)
-        = (linearAngle(0) / sinTheta) * dHorizontalDist.transpose()
-          + (horizontalDist / sinTheta) * dLinearAngle.row(0)
-          + (horizontalDist * linearAngle(0)) * (-1.0 / (sinTheta * sinTheta))
-                * dSinTheta.transpose();
-    dTranslation.row(1) = dVerticalDist;
-    dTranslation.row(2)
-        = (linearAngle(2) / sinTheta) * dHorizontalDist.transpose()
-          + (horizontalDist / sinTheta) * dLinearAngle.row(2)
-          + (horizontalDist * linearAngle(2)) * (-1.0 / (sinTheta * sinTheta))
-                * dSinTheta.transpose();
-
-    J.block<3, 1>(3, 0)
-        = rot.linear().transpose() * dTranslation.block<3, 1>(0, 0);
-    J.block<3, 1>(3, 1)
-        = rot.linear().transpose() * dTranslation.block<3, 1>(0, 1);
-    J.block<3, 1>(3, 2)
-        = rot.linear().transpose() * dTranslation.block<3, 1>(0, 2);
-    J.block<3, 1>(3, 3)
-        = rot.linear().transpose() * dTranslation.block<3, 1>(0, 3);
+    J.block<3, 4>(3, 0) = terms.rot.linear().transpose() * terms.dTranslation;
   }
 
   // Finally, take into account the transform to the child body node
@@ -284,14 +324,29 @@ Eigen::Matrix<s_t, 6, 4> ConstantCurveJoint::getRelativeJacobianStatic(
 Eigen::Matrix<s_t, 6, 4>
 ConstantCurveJoint::getRelativeJacobianDerivWrtPositionStatic(
     std::size_t index) const
+{
+  refreshJacobianDerivCache();
+  if (!mJacobianDerivsValid[index])
+  {
+    mJacobianDerivs[index]
+        = computeRelativeJacobianDerivWrtPositionStatic(index);
+    mJacobianDerivsValid[index] = true;
+  }
+  return mJacobianDerivs[index];
+}
+
+//==============================================================================
+Eigen::Matrix<s_t, 6, 4>
+ConstantCurveJoint::computeRelativeJacobianDerivWrtPositionStatic(
+    std::size_t index) const
 {
   // Think in terms of the child frame
 
-  Eigen::Vector4s pos = getPositionsStatic() + mNeutralPos;
+  const CurveTerms& terms = getCurveTerms(getPositionsStatic());
+  const Eigen::Vector4s& pos = terms.pos;
 
   // 1. Do the euler rotation
-  Eigen::Isometry3s rot = EulerJoint::convertToTransform(
-      pos.head<3>(), EulerJoint::AxisOrder::XZY, mFlipAxisMap.head<3>());
+  const Eigen::Isometry3s& rot = terms.rot;
   Eigen::Matrix3s rot_dFirst;
   if (index < 3)
   {
@@ -316,24 +371,19 @@ ConstantCurveJoint::getRelativeJacobianDerivWrtPositionStatic(
         identity);
   }
 
-  s_t scale = this->getChildScale()(1);
-  s_t d = pos(3) * scale;
+  s_t scale = terms.scale;
+  s_t d = terms.d;
   s_t d_dFirst = index == 3 ? scale : 0.0;
 
   // Remember, this is X,*Z*,Y
 
-  s_t cx = cos(pos(0));
-  s_t sx = sin(pos(0));
-  s_t cz = cos(pos(1));
-  s_t sz = sin(pos(1));
+  const s_t cx = terms.cx;
+  const s_t sx = terms.sx;
+  const s_t cz = terms.cz;
+  const s_t sz = terms.sz;
 
-  Eigen::Vector3s linearAngle = Eigen::Vector3s(-sz, cx * cz, cz * sx);
-
-  Eigen::Matrix<s_t, 3, 4> dLinearAngle = Eigen::Matrix<s_t, 3, 4>::Zero();
-  dLinearAngle.col(0) = Eigen::Vector3s(0, -sx * cz, cz * cx);
-  dLinearAngle.col(1) = Eigen::Vector3s(-cz, -cx * sz, -sz * sx);
-  dLinearAngle.col(2).setZero();
-  dLinearAngle.col(3).setZero();
+  const Eigen::Vector3s& linearAngle = terms.linearAngle;
+  const Eigen::Matrix<s_t, 3, 4>& dLinearAngle = terms.dLinearAngle;
 
   Eigen::Matrix<s_t, 3, 4> dLinearAngle_dFirst
       = Eigen::Matrix<s_t, 3, 4>::Zero();
@@ -355,25 +405,16 @@ ConstantCurveJoint::getRelativeJacobianDerivWrtPositionStatic(
     dLinearAngle_dFirst.col(3).setZero();
   }
 
-  s_t sinTheta
-      = sqrt(linearAngle(0) * linearAngle(0) + linearAngle(2) * linearAngle(2));
+  const s_t sinTheta = terms.sinTheta;
 
-  if (sinTheta < 0.001)
+  if (terms.nearVertical)
   {
     // Near very vertical angles, don't worry about the bend, just approximate
     // with an euler joint
-    Eigen::Matrix<s_t, 6, 4> J = Eigen::Matrix<s_t, 6, 4>::Zero();
-    J.block<6, 3>(0, 0) = EulerJoint::computeRelativeJacobianStatic(
-        pos.head<3>(),
-        EulerJoint::AxisOrder::XZY,
-        mFlipAxisMap.head<3>(),
-        identity);
+    const Eigen::Matrix<s_t, 6, 3>& J = terms.eulerJacobian;
 
     // 2. Computing translation from vertical
-    Eigen::Isometry3s bentRod = Eigen::Isometry3s::Identity();
-
-    bentRod.translation() = Eigen::Vector3s::UnitY() * d;
-    bentRod = rot * bentRod;
+    const Eigen::Isometry3s& bentRod = terms.bentRod;
 
     Eigen::Vector3s translation_dFirst;
     if (index < 3)
@@ -417,7 +458,7 @@ ConstantCurveJoint::getRelativeJacobianDerivWrtPositionStatic(
   }
   else
   {
-    Eigen::Vector4s dSinTheta;
+    const Eigen::Vector4s& dSinTheta = terms.dSinTheta;
     Eigen::Vector4s dSinTheta_dFirst;
     for (int i = 0; i < 3; i++)
     {
@@ -429,7 +470,6 @@ ConstantCurveJoint::getRelativeJacobianDerivWrtPositionStatic(
       s_t part2
           = (2 * linearAngle(0) * dLinearAngle(0, i)
              + 2 * linearAngle(2) * dLinearAngle(2, i));
-      dSinTheta(i) = part1 * part2;
 
       s_t part1_dFirst
           = ((-0.25
@@ -447,7 +487,6 @@ ConstantCurveJoint::getRelativeJacobianDerivWrtPositionStatic(
 
       dSinTheta_dFirst(i) = part1_dFirst * part2 + part1 * part2_dFirst;
     }
-    dSinTheta(3) = 0;
     dSinTheta_dFirst(3) = 0;
 
     s_t sinTheta_dFirst = (0.5
@@ -458,26 +497,23 @@ ConstantCurveJoint::getRelativeJacobianDerivWrtPositionStatic(
                              + 2 * linearAngle(2) * linearAngle_dFirst(2));
 
     // Compute the bend as a function of the angle from vertical
-    s_t theta = asin(sinTheta);
+    const s_t theta = terms.theta;
     s_t theta_dFirst
         = (1.0 / sqrt(1.0 - (sinTheta * sinTheta))) * sinTheta_dFirst;
     (void)theta_dFirst;
 
-    Eigen::Vector4s dTheta
-        = (1.0 / sqrt(1.0 - (sinTheta * sinTheta))) * dSinTheta;
+    const Eigen::Vector4s& dTheta = terms.dTheta;
     Eigen::Vector4s dTheta_dFirst
         = (1.0 / pow(1.0 - (sinTheta * sinTheta), 1.5)) * sinTheta
               * sinTheta_dFirst * dSinTheta
           + (1.0 / sqrt(1.0 - (sinTheta * sinTheta))) * dSinTheta_dFirst;
     (void)dTheta_dFirst;
 
-    s_t r = (d / theta);
+    const s_t r = terms.r;
     s_t r_dFirst = (-d / (theta * theta)) * theta_dFirst + (d_dFirst / theta);
     (void)r_dFirst;
 
-    Eigen::Vector4s dR = Eigen::Vector4s::Zero();
-    dR.segment<3>(0) = (-d / (theta * theta)) * dTheta.segment<3>(0);
-    dR(3) = 1.0 / theta;
+    const Eigen::Vector4s& dR = terms.dR;
 
     Eigen::Vector4s dR_dFirst = Eigen::Vector4s::Zero();
     dR_dFirst.segment<3>(0)
@@ -488,13 +524,12 @@ ConstantCurveJoint::getRelativeJacobianDerivWrtPositionStatic(
     dR_dFirst(3) = -theta_dFirst / (theta * theta);
     (void)dR_dFirst;
 
-    s_t horizontalDist = r - r * cos(theta);
+    const s_t horizontalDist = terms.horizontalDist;
     s_t horizontalDist_dFirst
         = r_dFirst - (r_dFirst * cos(theta) - r * sin(theta) * theta_dFirst);
     (void)horizontalDist_dFirst;
 
-    Eigen::Vector4s dHorizontalDist
-        = dR + r * sin(theta) * dTheta - dR * cos(theta);
+    const Eigen::Vector4s& dHorizontalDist = terms.dHorizontalDist;
     Eigen::Vector4s dHorizontalDist_dFirst
         = dR_dFirst
           + (r_dFirst * sin(theta) * dTheta
@@ -503,7 +538,6 @@ ConstantCurveJoint::getRelativeJacobianDerivWrtPositionStatic(
           - (dR_dFirst * cos(theta) - dR * sin(theta) * theta_dFirst);
     (void)dHorizontalDist_dFirst;
 
-    Eigen::Vector4s dVerticalDist = r * cos(theta) * dTheta + dR * sinTheta;
     Eigen::Vector4s dVerticalDist_dFirst
         = (r_dFirst * cos(theta) * dTheta
            - r * sin(theta) * theta_dFirst * dTheta
@@ -511,18 +545,7 @@ ConstantCurveJoint::getRelativeJacobianDerivWrtPositionStatic(
           + (dR_dFirst * sinTheta + dR * sinTheta_dFirst);
     (void)dVerticalDist_dFirst;
 
-    Eigen::Matrix<s_t, 3, 4> dTranslation = Eigen::Matrix<s_t, 3, 4>::Zero();
-    dTranslation.row(0)
-        = (linearAngle(0) / sinTheta) * dHorizontalDist.transpose()
-          + (horizontalDist / sinTheta) * dLinearAngle.row(0)
-          + (horizontalDist * linearAngle(0)) * (-1.0 / (sinTheta * sinTheta))
-                * dSinTheta.transpose();
-    dTranslation.row(1) = dVerticalDist;
-    dTranslation.row(2)
-        = (linearAngle(2) / sinTheta) * dHorizontalDist.transpose()
-          + (horizontalDist / sinTheta) * dLinearAngle.row(2)
-          + (horizontalDist * linearAngle(2)) * (-1.0 / (sinTheta * sinTheta))
-                * dSinTheta.transpose();
+    const Eigen::Matrix<s_t, 3, 4>& dTranslation = terms.dTranslation;
 
     Eigen::Matrix<s_t, 3, 4> dTranslation_dFirst
         = Eigen::Matrix<s_t, 3, 4>::Zero();
@@ -832,6 +855,22 @@ ConstantCurveJoint::getRelativeJacobianDerivWrtSegmentLengthStatic(
 Eigen::Matrix<s_t, 6, 4>
 ConstantCurveJoint::getRelativeJacobianDerivWrtPositionDerivWrtPositionStatic(
     std::size_t firstIndex, std::size_t secondIndex) const
+{
+  refreshJacobianDerivCache();
+  if (!mJacobianSecondDerivsValid[firstIndex][secondIndex])
+  {
+    mJacobianSecondDerivs[firstIndex][secondIndex]
+        = computeRelativeJacobianDerivWrtPositionDerivWrtPositionStatic(
+            firstIndex, secondIndex);
+    mJacobianSecondDerivsValid[firstIndex][secondIndex] = true;
+  }
+  return mJacobianSecondDerivs[firstIndex][secondIndex];
+}
+
+//==============================================================================
+Eigen::Matrix<s_t, 6, 4> ConstantCurveJoint::
+    computeRelativeJacobianDerivWrtPositionDerivWrtPositionStatic(
+        std::size_t firstIndex, std::size_t secondIndex) const
 {
   (void)secondIndex;
 
@@ -2790,8 +2829,7 @@ void ConstantCurveJoint::updateRelativeJacobian(bool) const
 //==============================================================================
 void ConstantCurveJoint::updateRelativeJacobianTimeDeriv() const
 {
-  Eigen::VectorXs pos = this->getPositionsStatic();
-  Eigen::VectorXs vel = this->getVelocitiesStatic();
+  const Eigen::Vector4s& vel = this->getVelocitiesStatic();
 
   Eigen::Matrix<s_t, 6, 4> dJ = Eigen::Matrix<s_t, 6, 4>::Zero();
   for (int i = 0; i < 4; i++)
@@ -2808,11 +2846,10 @@ void ConstantCurveJoint::updateRelativeJacobianTimeDeriv() const
 math::Jacobian ConstantCurveJoint::getRelativeJacobianTimeDerivDerivWrtPosition(
     std::size_t index) const
 {
-  Eigen::VectorXs pos = this->getPositionsStatic();
-  Eigen::VectorXs vel = this->getVelocitiesStatic();
+  const Eigen::Vector4s& vel = this->getVelocitiesStatic();
 
   Eigen::Matrix<s_t, 6, 4> ddJ = Eigen::Matrix<s_t, 6, 4>::Zero();
-  for (int i = 0; i < pos.size(); i++)
+  for (int i = 0; i < 4; i++)
   {
     ddJ += getRelativeJacobianDerivWrtPositionDerivWrtPositionStatic(i, index)
            * vel(i);
@@ -50,6 +50,11 @@ namespace dynamics {
 /**
  * This class is an effort to reproduce enough of OpenSim's custom joint
  * behavior in Nimble.
+ *
+ * The terms of the curve are cached the first time they're needed at a given
+ * configuration, including from const getters like getRelativeJacobianStatic().
+ * That means even const calls on one joint must not run concurrently from
+ * several threads. Give each thread its own Skeleton clone instead.
  */
 class ConstantCurveJoint : public GenericJoint<math::RealVectorSpace<4>>
 {
@@ -172,11 +177,84 @@ public:
   Eigen::MatrixXs finiteDifferenceScratch(int firstIndex, int secondIndex);
 
 protected:
+  /// The intermediate terms of the curve at one configuration. These are
+  /// shared by the transform, the Jacobian and its derivatives, so we compute
+  /// them once per configuration instead of once per query.
+  struct CurveTerms
+  {
+    // Positions, including mNeutralPos
+    Eigen::Vector4s pos;
+    s_t scale;
+    s_t d;
+    Eigen::Isometry3s rot;
+    // The Jacobian of the Euler rotation, in the joint frame
+    Eigen::Matrix<s_t, 6, 3> eulerJacobian;
+    s_t cx;
+    s_t sx;
+    s_t cz;
+    s_t sz;
+    Eigen::Vector3s linearAngle;
+    Eigen::Matrix<s_t, 3, 4> dLinearAngle;
+    s_t sinTheta;
+    // If true, we approximate the curve with an Euler joint, and the bend
+    // terms below are not filled in
+    bool nearVertical;
+    // The curve from the parent joint frame to the child joint frame
+    Eigen::Isometry3s bentRod;
+
+    s_t theta;
+    s_t r;
+    s_t horizontalDist;
+    Eigen::Vector4s dSinTheta;
+    Eigen::Vector4s dTheta;
+    Eigen::Vector4s dR;
+    Eigen::Vector4s dHorizontalDist;
+    Eigen::Vector4s dVerticalDist;
+    Eigen::Matrix<s_t, 3, 4> dTranslation;
+  };
+
+  /// This returns the CurveTerms at `rawPos` (not including mNeutralPos),
+  /// only recomputing them if the configuration has changed since the last
+  /// call.
+  const CurveTerms& getCurveTerms(const Eigen::Vector4s& rawPos) const;
+
+  /// This clears the cached Jacobian derivatives if the positions, scale or
+  /// child transform have changed since they were computed.
+  void refreshJacobianDerivCache() const;
+
+  /// This drops all cached terms, for when the neutral pos or the flip axis
+  /// map change.
+  void invalidateCurveCache();
+
+  JacobianMatrix computeRelativeJacobianDerivWrtPositionStatic(
+      std::size_t index) const;
+
+  JacobianMatrix computeRelativeJacobianDerivWrtPositionDerivWrtPositionStatic(
+      std::size_t firstIndex, std::size_t secondIndex) const;
+
   Eigen::Vector4s mNeutralPos;
 
   /// This contains 1's and -1's to indicate whether we should flip a given
   /// input axis.
   Eigen::Vector3s mFlipAxisMap;
+
+  // These caches are written by const methods, so they aren't thread safe.
+  // See the class comment.
+  mutable CurveTerms mCurveTerms;
+  mutable Eigen::Vector4s mCurveTermsRawPos;
+  mutable s_t mCurveTermsScale;
+  mutable bool mCurveTermsValid;
+
+  /// The Jacobian derivatives wrt position (and wrt position twice) at the
+  /// configuration in mJacobianDerivsPos, filled in lazily as they're
+  /// requested.
+  mutable Eigen::Vector4s mJacobianDerivsPos;
+  mutable Eigen::Vector3s mJacobianDerivsScale;
+  mutable Eigen::Matrix4s mJacobianDerivsChildTransform;
+  mutable JacobianMatrix mJacobianDerivs[4];
+  mutable bool mJacobianDerivsValid[4];
+  mutable JacobianMatrix mJacobianSecondDerivs[4][4];
+  mutable bool mJacobianSecondDerivsValid[4][4];
 };
 
 }; // namespace dynamics
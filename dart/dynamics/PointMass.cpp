@@ -148,20 +148,6 @@ PointMass::PointMass(SoftBodyNode* _softBodyNode)
     mVelocityChanges(Eigen::Vector3s::Zero()),
     // mImpulse(Eigen::Vector3s::Zero()),
     mConstraintImpulses(Eigen::Vector3s::Zero()),
-    mW(Eigen::Vector3s::Zero()),
-    mX(Eigen::Vector3s::Zero()),
-    mV(Eigen::Vector3s::Zero()),
-    mEta(Eigen::Vector3s::Zero()),
-    mAlpha(Eigen::Vector3s::Zero()),
-    mBeta(Eigen::Vector3s::Zero()),
-    mA(Eigen::Vector3s::Zero()),
-    mF(Eigen::Vector3s::Zero()),
-    mPsi(0.0),
-    mImplicitPsi(0.0),
-    mPi(0.0),
-    mImplicitPi(0.0),
-    mB(Eigen::Vector3s::Zero()),
-    mFext(Eigen::Vector3s::Zero()),
     mIsColliding(false),
     mDelV(Eigen::Vector3s::Zero()),
     mImpB(Eigen::Vector3s::Zero()),
@@ -220,28 +206,28 @@ s_t PointMass::getMass() const
 s_t PointMass::getPsi() const
 {
   mParentSoftBodyNode->checkArticulatedInertiaUpdate();
-  return mPsi;
+  return mParentSoftBodyNode->mPointMassBuffers.mPsi[mIndex];
 }
 
 //==============================================================================
 s_t PointMass::getImplicitPsi() const
 {
   mParentSoftBodyNode->checkArticulatedInertiaUpdate();
-  return mImplicitPsi;
+  return mParentSoftBodyNode->mPointMassBuffers.mImplicitPsi[mIndex];
 }
 
 //==============================================================================
 s_t PointMass::getPi() const
 {
   mParentSoftBodyNode->checkArticulatedInertiaUpdate();
-  return mPi;
+  return mParentSoftBodyNode->mPointMassBuffers.mPi[mIndex];
 }
 
 //==============================================================================
 s_t PointMass::getImplicitPi() const
 {
   mParentSoftBodyNode->checkArticulatedInertiaUpdate();
-  return mImplicitPi;
+  return mParentSoftBodyNode->mPointMassBuffers.mImplicitPi[mIndex];
 }
 
 //==============================================================================
@@ -420,7 +406,7 @@ const Vector3s& PointMass::getPartialAccelerations() const
 {
   if(mNotifier->needsPartialAccelerationUpdate())
     mParentSoftBodyNode->updatePartialAcceleration();
-  return mEta;
+  return mParentSoftBodyNode->mPointMassBuffers.mEta[mIndex];
 }
 
 //==============================================================================
@@ -523,21 +509,22 @@ void PointMass::integrateVelocities(s_t _dt)
 //==============================================================================
 void PointMass::addExtForce(const Eigen::Vector3s& _force, bool _isForceLocal)
 {
+  Eigen::Vector3s& fext = mParentSoftBodyNode->mPointMassBuffers.mFext[mIndex];
   if (_isForceLocal)
   {
-    mFext += _force;
+    fext += _force;
   }
   else
   {
-    mFext += mParentSoftBodyNode->getWorldTransform().linear().transpose()
-             * _force;
+    fext += mParentSoftBodyNode->getWorldTransform().linear().transpose()
+            * _force;
   }
 }
 
 //==============================================================================
 void PointMass::clearExtForce()
 {
-  mFext.setZero();
+  mParentSoftBodyNode->mPointMassBuffers.mFext[mIndex].setZero();
 }
 
 //==============================================================================
@@ -615,7 +602,7 @@ const Eigen::Vector3s& PointMass::getLocalPosition() const
 {
   if(mNotifier->needsTransformUpdate())
     mParentSoftBodyNode->updateTransform();
-  return mX;
+  return mParentSoftBodyNode->mPointMassBuffers.mX[mIndex];
 }
 
 //==============================================================================
@@ -623,7 +610,7 @@ const Eigen::Vector3s& PointMass::getWorldPosition() const
 {
   if(mNotifier && mNotifier->needsTransformUpdate())
     mParentSoftBodyNode->updateTransform();
-  return mW;
+  return mParentSoftBodyNode->mPointMassBuffers.mW[mIndex];
 }
 
 //==============================================================================
@@ -691,7 +678,7 @@ const Eigen::Vector3s&PointMass::getBodyVelocity() const
 {
   if(mNotifier->needsVelocityUpdate())
     mParentSoftBodyNode->updateVelocity();
-  return mV;
+  return mParentSoftBodyNode->mPointMassBuffers.mV[mIndex];
 }
 
 //==============================================================================
@@ -705,7 +692,7 @@ const Eigen::Vector3s& PointMass::getBodyAcceleration() const
 {
   if(mNotifier->needsAccelerationUpdate())
     mParentSoftBodyNode->updateAccelerationID();
-  return mA;
+  return mParentSoftBodyNode->mPointMassBuffers.mA[mIndex];
 }
 
 //==============================================================================
@@ -720,87 +707,25 @@ void PointMass::init()
   mDependentGenCoordIndices = mParentSoftBodyNode->getDependentGenCoordIndices();
 }
 
-//==============================================================================
-void PointMass::updateTransform() const
-{
-  // Local translation
-  mX = getPositions() + getRestingPosition();
-  assert(!math::isNan(mX));
-
-  // World translation
-  const Eigen::Isometry3s& parentW = mParentSoftBodyNode->getWorldTransform();
-  mW = parentW.translation() + parentW.linear() * mX;
-  assert(!math::isNan(mW));
-}
-
-//==============================================================================
-void PointMass::updateVelocity() const
-{
-  // v = w(parent) x mX + v(parent) + dq
-  const Eigen::Vector6s& v_parent = mParentSoftBodyNode->getSpatialVelocity();
-  mV = v_parent.head<3>().cross(getLocalPosition()) + v_parent.tail<3>()
-       + getVelocities();
-  assert(!math::isNan(mV));
-}
-
-//==============================================================================
-void PointMass::updatePartialAcceleration() const
-{
-  // eta = w(parent) x dq
-  const Eigen::Vector3s& dq = getVelocities();
-  mEta = mParentSoftBodyNode->getSpatialVelocity().head<3>().cross(dq);
-  assert(!math::isNan(mEta));
-}
-
-//==============================================================================
-void PointMass::updateAccelerationID() const
-{
-  // dv = dw(parent) x mX + dv(parent) + eata + ddq
-  const Eigen::Vector6s& a_parent = mParentSoftBodyNode->getSpatialAcceleration();
-  mA = a_parent.head<3>().cross(getLocalPosition()) + a_parent.tail<3>()
-       + getPartialAccelerations() + getAccelerations();
-  assert(!math::isNan(mA));
-}
-
 //==============================================================================
 void PointMass::updateTransmittedForceID(const Eigen::Vector3s& _gravity,
                                          bool /*_withExternalForces*/)
 {
+  SoftBodyNode::PointMassBuffers& buffers
+      = mParentSoftBodyNode->mPointMassBuffers;
+  Eigen::Vector3s& F = buffers.mF[mIndex];
+
   // f = m*dv + w(parent) x m*v - fext
-  mF.noalias() = getMass() * getBodyAcceleration();
-  mF += mParentSoftBodyNode->getSpatialVelocity().head<3>().cross(
-        getMass() * getBodyVelocity()) - mFext;
+  F.noalias() = getMass() * getBodyAcceleration();
+  F += mParentSoftBodyNode->getSpatialVelocity().head<3>().cross(
+        getMass() * getBodyVelocity()) - buffers.mFext[mIndex];
   if (mParentSoftBodyNode->getGravityMode() == true)
   {
-    mF -= getMass() * (mParentSoftBodyNode->getWorldTransform().linear().transpose()
-                   * _gravity);
+    F -= getMass()
+         * (mParentSoftBodyNode->getWorldTransform().linear().transpose()
+            * _gravity);
   }
-  assert(!math::isNan(mF));
-}
-
-//==============================================================================
-void PointMass::updateArtInertiaFD(s_t _timeStep) const
-{
-  // Articulated inertia
-  // - Do nothing
-
-  // Cache data: PsiK and Psi
-  mPsi = 1.0 / getMass();
-  mImplicitPsi
-      = 1.0 / (getMass()
-               + _timeStep * mParentSoftBodyNode->getDampingCoefficient()
-               + _timeStep * _timeStep
-                 * mParentSoftBodyNode->getVertexSpringStiffness());
-  assert(!math::isNan(mImplicitPsi));
-
-  // Cache data: AI_S_Psi
-  // - Do nothing
-
-  // Cache data: Pi
-  mPi         = getMass() - getMass() * getMass() * mPsi;
-  mImplicitPi = getMass() - getMass() * getMass() * mImplicitPsi;
-  assert(!math::isNan(mPi));
-  assert(!math::isNan(mImplicitPi));
+  assert(!math::isNan(F));
 }
 
 //==============================================================================
@@ -809,25 +734,31 @@ void PointMass::updateJointForceID(s_t /*_timeStep*/,
                                    s_t /*_withSpringForces*/)
 {
   // tau = f
-  getState().mForces = mF;
+  getState().mForces = mParentSoftBodyNode->mPointMassBuffers.mF[mIndex];
   // TODO: need to add spring and damping forces
 }
 
 //==============================================================================
 void PointMass::updateBiasForceFD(s_t _dt, const Eigen::Vector3s& _gravity)
 {
+  SoftBodyNode::PointMassBuffers& buffers
+      = mParentSoftBodyNode->mPointMassBuffers;
+  Eigen::Vector3s& B = buffers.mB[mIndex];
+  Eigen::Vector3s& alpha = buffers.mAlpha[mIndex];
+  Eigen::Vector3s& beta = buffers.mBeta[mIndex];
+
   // B = w(parent) x m*v - fext - fgravity
   // - w(parent) x m*v - fext
-  mB = mParentSoftBodyNode->getSpatialVelocity().head<3>().cross(
-        getMass() * getBodyVelocity()) - mFext;
+  B = mParentSoftBodyNode->getSpatialVelocity().head<3>().cross(
+        getMass() * getBodyVelocity()) - buffers.mFext[mIndex];
   // - fgravity
   if (mParentSoftBodyNode->getGravityMode() == true)
   {
-    mB -= getMass()
-          * (mParentSoftBodyNode->getWorldTransform().linear().transpose()
-             * _gravity);
+    B -= getMass()
+         * (mParentSoftBodyNode->getWorldTransform().linear().transpose()
+            * _gravity);
   }
-  assert(!math::isNan(mB));
+  assert(!math::isNan(B));
 
   const State& state = getState();
 
@@ -836,49 +767,61 @@ void PointMass::updateBiasForceFD(s_t _dt, const Eigen::Vector3s& _gravity)
   s_t ke = mParentSoftBodyNode->getEdgeSpringStiffness();
   s_t kd = mParentSoftBodyNode->getDampingCoefficient();
   int nN = getNumConnectedPointMasses();
-  mAlpha = state.mForces
-           - (kv + nN * ke) * getPositions()
-           - (_dt * (kv + nN * ke) + kd) * getVelocities()
-           - getMass() * getPartialAccelerations()
-           - mB;
-  for (std::size_t i = 0; i < getNumConnectedPointMasses(); ++i)
+  alpha = state.mForces
+          - (kv + nN * ke) * getPositions()
+          - (_dt * (kv + nN * ke) + kd) * getVelocities()
+          - getMass() * getPartialAccelerations()
+          - B;
+  const std::vector<State>& states
+      = mParentSoftBodyNode->mAspectState.mPointStates;
+  for (std::size_t index : mParentSoftBodyNode->mAspectProperties
+                               .mPointProps[mIndex].mConnectedPointMassIndices)
   {
-    const State& i_state = getConnectedPointMass(i)->getState();
-    mAlpha += ke * (i_state.mPositions + _dt * i_state.mVelocities);
+    const State& i_state = states[index];
+    alpha += ke * (i_state.mPositions + _dt * i_state.mVelocities);
   }
-  assert(!math::isNan(mAlpha));
+  assert(!math::isNan(alpha));
 
   // Cache data: beta
-  mBeta = mB;
-  mBeta.noalias() += getMass() * (getPartialAccelerations() + getImplicitPsi() * mAlpha);
-  assert(!math::isNan(mBeta));
+  beta = B;
+  beta.noalias()
+      += getMass() * (getPartialAccelerations() + getImplicitPsi() * alpha);
+  assert(!math::isNan(beta));
 }
 
 //==============================================================================
 void PointMass::updateAccelerationFD()
 {
   // ddq = imp_psi*(alpha - m*(dw(parent) x mX + dv(parent))
+  SoftBodyNode::PointMassBuffers& buffers
+      = mParentSoftBodyNode->mPointMassBuffers;
   const Eigen::Vector3s& X = getLocalPosition();
   const Eigen::Vector6s& a_parent = mParentSoftBodyNode->getSpatialAcceleration();
   Eigen::Vector3s ddq =
       getImplicitPsi()
-      * (mAlpha - getMass() * (a_parent.head<3>().cross(X) + a_parent.tail<3>()));
+      * (buffers.mAlpha[mIndex]
+         - getMass() * (a_parent.head<3>().cross(X) + a_parent.tail<3>()));
   setAccelerations(ddq);
   assert(!math::isNan(ddq));
 
   // dv = dw(parent) x mX + dv(parent) + eata + ddq
-  mA = a_parent.head<3>().cross(X) + a_parent.tail<3>()
-       + getPartialAccelerations() + getAccelerations();
-  assert(!math::isNan(mA));
+  Eigen::Vector3s& A = buffers.mA[mIndex];
+  A = a_parent.head<3>().cross(X) + a_parent.tail<3>()
+      + getPartialAccelerations() + getAccelerations();
+  assert(!math::isNan(A));
 }
 
 //==============================================================================
 void PointMass::updateTransmittedForce()
 {
+  SoftBodyNode::PointMassBuffers& buffers
+      = mParentSoftBodyNode->mPointMassBuffers;
+  Eigen::Vector3s& F = buffers.mF[mIndex];
+
   // f = m*dv + B
-  mF = mB;
-  mF.noalias() += getMass() * getBodyAcceleration();
-  assert(!math::isNan(mF));
+  F = buffers.mB[mIndex];
+  F.noalias() += getMass() * getBodyAcceleration();
+  assert(!math::isNan(F));
 }
 
 //==============================================================================
@@ -957,7 +900,7 @@ void PointMass::updateConstrainedTermsFD(s_t _timeStep)
   setAccelerations( getAccelerations() + mDelV / _timeStep );
 
   ///
-  mF += _timeStep * mImpF;
+  mParentSoftBodyNode->mPointMassBuffers.mF[mIndex] += _timeStep * mImpF;
 }
 
 //==============================================================================
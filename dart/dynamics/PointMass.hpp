@@ -420,19 +420,6 @@ protected:
   /// \{ \name Recursive dynamics routines
   //----------------------------------------------------------------------------
 
-  /// \brief Update transformation.
-  void updateTransform() const;
-
-  /// \brief Update body velocity.
-  void updateVelocity() const;
-
-  /// \brief Update partial body acceleration due to parent joint's velocity.
-  void updatePartialAcceleration() const;
-
-  /// \brief Update articulated body inertia. Forward dynamics routine.
-  /// \param[in] _timeStep Rquired for implicit joint stiffness and damping.
-  void updateArtInertiaFD(s_t _timeStep) const;
-
   /// \brief Update bias force associated with the articulated body inertia.
   /// Forward dynamics routine.
   /// \param[in] _dt Required for implicit joint stiffness and damping.
@@ -443,9 +430,6 @@ protected:
   /// Impulse-based forward dynamics routine.
   void updateBiasImpulseFD();
 
-  /// \brief Update body acceleration with the partial body acceleration.
-  void updateAccelerationID() const;
-
   /// \brief Update body acceleration. Forward dynamics routine.
   void updateAccelerationFD();
 
@@ -595,47 +579,9 @@ protected:
 
   //----------------------------------------------------------------------------
 
-  /// Current position viewed in world frame.
-  mutable Eigen::Vector3s mW;
-
-  /// Current position viewed in parent soft body node frame.
-  mutable Eigen::Vector3s mX;
-
-  /// Current velocity viewed in parent soft body node frame.
-  mutable Eigen::Vector3s mV;
-
-  /// Partial Acceleration of this PointMass
-  mutable Eigen::Vector3s mEta;
-
-  ///
-  Eigen::Vector3s mAlpha;
-
-  ///
-  Eigen::Vector3s mBeta;
-
-  /// Current acceleration viewed in parent body node frame.
-  mutable Eigen::Vector3s mA;
-
-  ///
-  Eigen::Vector3s mF;
-
-  ///
-  mutable s_t mPsi;
-
-  ///
-  mutable s_t mImplicitPsi;
-
-  ///
-  mutable s_t mPi;
-
-  ///
-  mutable s_t mImplicitPi;
-
-  /// Bias force
-  Eigen::Vector3s mB;
-
-  /// External force.
-  Eigen::Vector3s mFext;
+  // The positions, velocities, accelerations, forces and bias terms of this
+  // PointMass are stored in the PointMassBuffers of the parent SoftBodyNode at
+  // index mIndex.
 
   /// A increasingly sorted list of dependent dof indices.
   std::vector<std::size_t> mDependentGenCoordIndices;
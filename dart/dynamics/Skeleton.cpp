@@ -34,8 +34,10 @@
 
 #include <algorithm>
 #include <array>
+#include <future>
 #include <limits>
 #include <queue>
+#include <random>
 #include <string>
 #include <valarray>
 #include <vector>
@@ -520,6 +522,7 @@ SkeletonPtr Skeleton::cloneSkeleton(const std::string& cloneName) const
   skelClone->setProperties(getAspectProperties());
   skelClone->setName(cloneName);
   skelClone->setState(getState());
+  skelClone->setParallelSoftBodyUpdates(mParallelSoftBodyUpdates);
 
   // Fix mimic joint references
   for (std::size_t i = 0; i < getNumJoints(); ++i)
@@ -625,6 +628,7 @@ SkeletonPtr Skeleton::simplifySkeleton(
   skelClone->setProperties(getAspectProperties());
   skelClone->setName(cloneName);
   skelClone->setState(getState());
+  skelClone->setParallelSoftBodyUpdates(mParallelSoftBodyUpdates);
 
   // Fix mimic joint references
   for (std::size_t i = 0; i < getNumJoints(); ++i)
@@ -2935,7 +2939,29 @@ Eigen::VectorXs Skeleton::finiteDifferenceGradientOfLowestPointWrtJoints(
 /// This gets a random pose that's valid within joint limits
 Eigen::VectorXs Skeleton::getRandomPose()
 {
-  Eigen::VectorXs pose = Eigen::VectorXs::Random(getNumDofs());
+  return getPoseWithinLimits(Eigen::VectorXs::Random(getNumDofs()));
+}
+
+//==============================================================================
+/// This is the same as getRandomPose(), but it draws from `generator` rather
+/// than the global std::rand() stream, so that each thread can have its own
+/// reproducible sequence.
+Eigen::VectorXs Skeleton::getRandomPose(std::mt19937& generator)
+{
+  std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+  Eigen::VectorXs random(getNumDofs());
+  for (int i = 0; i < getNumDofs(); i++)
+  {
+    random(i) = distribution(generator);
+  }
+  return getPoseWithinLimits(random);
+}
+
+//==============================================================================
+/// This maps `pose`, which has an entry in [-1, 1] for each DOF, to a pose
+/// within the joint limits.
+Eigen::VectorXs Skeleton::getPoseWithinLimits(Eigen::VectorXs pose)
+{
   for (int i = 0; i < getNumDofs(); i++)
   {
     s_t upperLimit = getDof(i)->getPositionUpperLimit() - 0.02;
@@ -3026,7 +3052,25 @@ Eigen::VectorXs Skeleton::getRandomVelocity()
 Eigen::VectorXs Skeleton::getRandomPoseForJoints(
     std::vector<dynamics::Joint*> joints)
 {
-  Eigen::VectorXs randomPose = getRandomPose();
+  return getInitialPoseWithJoints(joints, getRandomPose());
+}
+
+//==============================================================================
+/// This is the same as getRandomPoseForJoints(), but it draws from
+/// `generator` rather than the global std::rand() stream.
+Eigen::VectorXs Skeleton::getRandomPoseForJoints(
+    std::vector<dynamics::Joint*> joints, std::mt19937& generator)
+{
+  return getInitialPoseWithJoints(joints, getRandomPose(generator));
+}
+
+//==============================================================================
+/// This returns the initial pose, with the DOFs of `joints` replaced by the
+/// ones in `randomPose`.
+Eigen::VectorXs Skeleton::getInitialPoseWithJoints(
+    const std::vector<dynamics::Joint*>& joints,
+    const Eigen::VectorXs& randomPose)
+{
   Eigen::VectorXs pose = Eigen::VectorXs::Zero(getNumDofs());
 
   for (int i = 0; i < getNumDofs(); i++)
@@ -4191,6 +4235,42 @@ void Skeleton::updateGroupScaleIndices()
       mGroupScaleIndices.emplace_back(mBodyScaleGroups.at(i), 2);
     }
   }
+
+  // The map from body COMs to the unnormalized COM only depends on the group
+  // structure, so we rebuild it here rather than at every timestep
+  std::vector<Eigen::Triplet<s_t>> triplets;
+  for (int i = 0; i < mBodyScaleGroups.size(); i++)
+  {
+    s_t weight = 1.0 / mBodyScaleGroups[i].nodes.size();
+    for (auto* body : mBodyScaleGroups[i].nodes)
+    {
+      triplets.emplace_back(body->getIndexInSkeleton(), i + 1, weight);
+    }
+  }
+  mLinearizedMassesBodyMap.resize(
+      getNumBodyNodes(), mBodyScaleGroups.size() + 1);
+  mLinearizedMassesBodyMap.setFromTriplets(triplets.begin(), triplets.end());
+
+  // Same for the map from body scales to group scales
+  std::vector<Eigen::Triplet<s_t>> scaleTriplets;
+  int cursor = 0;
+  for (int i = 0; i < mBodyScaleGroups.size(); i++)
+  {
+    for (auto* body : mBodyScaleGroups[i].nodes)
+    {
+      for (int axis = 0; axis < 3; axis++)
+      {
+        scaleTriplets.emplace_back(
+            body->getIndexInSkeleton() * 3 + axis,
+            mBodyScaleGroups[i].uniformScaling ? cursor : cursor + axis,
+            1.0);
+      }
+    }
+    cursor += mBodyScaleGroups[i].uniformScaling ? 1 : 3;
+  }
+  mBodyScalesToGroupScalesMap.resize(getNumBodyNodes() * 3, cursor);
+  mBodyScalesToGroupScalesMap.setFromTriplets(
+      scaleTriplets.begin(), scaleTriplets.end());
 }
 
 //==============================================================================
@@ -4896,15 +4976,13 @@ Eigen::MatrixXs Skeleton::getGroupMassesJacobianWrtLinearizedMasses()
   ensureBodyScaleGroups();
   int numGroups = mBodyScaleGroups.size();
   s_t totalMass = getMass();
-  s_t inverseMass = 1.0 / totalMass;
-  (void)inverseMass;
-  Eigen::VectorXs linearized = getLinearizedMasses();
 
+  // With p_i = n_i * m_i / M, d(m_i)/d(1/M) = -p_i * M^2 / n_i = -m_i * M, so
+  // we can read everything we need off the body masses directly
   Eigen::MatrixXs result = Eigen::MatrixXs::Zero(numGroups, 1 + numGroups);
   for (int i = 0; i < mBodyScaleGroups.size(); i++)
   {
-    result(i, 0) = -(linearized(i + 1) / mBodyScaleGroups[i].nodes.size())
-                   / (inverseMass * inverseMass);
+    result(i, 0) = -mBodyScaleGroups[i].nodes[0]->getMass() * totalMass;
     result(i, i + 1) = totalMass / mBodyScaleGroups[i].nodes.size();
   }
   return result;
@@ -4948,20 +5026,7 @@ Skeleton::finiteDifferenceGroupMassesJacobianWrtLinearizedMasses()
 Eigen::MatrixXs Skeleton::getUnnormalizedCOMJacobianWrtLinearizedMasses()
 {
   ensureBodyScaleGroups();
-  int numGroups = mBodyScaleGroups.size();
-  Eigen::VectorXs linearized = getLinearizedMasses();
-
-  Eigen::MatrixXs result = Eigen::MatrixXs::Zero(3, 1 + numGroups);
-  for (int i = 0; i < mBodyScaleGroups.size(); i++)
-  {
-    // s_t percentage = linearized(i + 1);
-    // s_t bodyPercentage = percentage / mBodyScaleGroups[i].nodes.size();
-    for (auto* body : mBodyScaleGroups[i].nodes)
-    {
-      result.col(i + 1) += body->getCOM() / mBodyScaleGroups[i].nodes.size();
-    }
-  }
-  return result;
+  return getBodyCOMs() * mLinearizedMassesBodyMap;
 }
 
 //==============================================================================
@@ -5062,21 +5127,13 @@ Skeleton::finiteDifferenceUnnormalizedCOMFDAccJacobianWrtLinearizedMasses()
 Eigen::MatrixXs
 Skeleton::getUnnormalizedCOMAnalyticalAccJacobianWrtLinearizedMasses()
 {
-  int numGroups = mBodyScaleGroups.size();
-  Eigen::VectorXs linearized = getLinearizedMasses();
-
-  Eigen::MatrixXs result = Eigen::MatrixXs::Zero(3, 1 + numGroups);
-  for (int i = 0; i < mBodyScaleGroups.size(); i++)
+  ensureBodyScaleGroups();
+  Eigen::Matrix<s_t, 3, Eigen::Dynamic> bodyAccs(3, getNumBodyNodes());
+  for (int i = 0; i < getNumBodyNodes(); i++)
   {
-    // s_t percentage = linearized(i + 1);
-    // s_t bodyPercentage = percentage / mBodyScaleGroups[i].nodes.size();
-    for (auto* body : mBodyScaleGroups[i].nodes)
-    {
-      result.col(i + 1) += body->getCOMLinearAcceleration()
-                           / mBodyScaleGroups[i].nodes.size();
-    }
+    bodyAccs.col(i) = getBodyNode(i)->getCOMLinearAcceleration();
   }
-  return result;
+  return bodyAccs * mLinearizedMassesBodyMap;
 }
 
 //==============================================================================
@@ -5147,6 +5204,155 @@ Eigen::MatrixXs Skeleton::
   return result;
 }
 
+//==============================================================================
+/// This returns the world COM of every body, one per column, in the order
+/// of getBodyNode(i)
+Eigen::Matrix<s_t, 3, Eigen::Dynamic> Skeleton::getBodyCOMs()
+{
+  Eigen::Matrix<s_t, 3, Eigen::Dynamic> coms(3, getNumBodyNodes());
+  for (int i = 0; i < getNumBodyNodes(); i++)
+  {
+    coms.col(i) = getBodyNode(i)->getCOM();
+  }
+  return coms;
+}
+
+//==============================================================================
+/// This returns the sparse map from body COMs to the unnormalized COM
+/// Jacobian wrt the linearized masses
+const Eigen::SparseMatrix<s_t>& Skeleton::getLinearizedMassesBodyMap()
+{
+  ensureBodyScaleGroups();
+  return mLinearizedMassesBodyMap;
+}
+
+//==============================================================================
+/// This computes the unnormalized COM Jacobian and the COM acceleration offset
+/// Jacobian wrt the linearized masses for every timestep of a trajectory
+void Skeleton::getLinearizedMassesJacobiansOverTrajectory(
+    const Eigen::MatrixXs& poses,
+    const Eigen::MatrixXs& vels,
+    const Eigen::MatrixXs& accs,
+    std::vector<Eigen::MatrixXs>& comJacs,
+    std::vector<Eigen::MatrixXs>& accOffsetJacs,
+    int numThreads)
+{
+  numThreads = std::max(1, std::min(numThreads, (int)poses.cols()));
+  std::vector<std::shared_ptr<dynamics::Skeleton>> threadSkels;
+  if (numThreads > 1)
+  {
+    for (int threadIdx = 0; threadIdx < numThreads; threadIdx++)
+      threadSkels.push_back(cloneSkeleton());
+  }
+  getLinearizedMassesJacobiansOverTrajectory(
+      poses, vels, accs, comJacs, accOffsetJacs, threadSkels);
+}
+
+//==============================================================================
+void Skeleton::forEachTimestepBlock(
+    int numTimesteps,
+    int numThreads,
+    std::function<void(Skeleton*, int, int)> fn,
+    int blockAlignment)
+{
+  // Only clone as many Skeletons as there will be non-empty blocks
+  const int numAlignedBlocks
+      = (numTimesteps + blockAlignment - 1) / blockAlignment;
+  numThreads = std::max(1, std::min(numThreads, numAlignedBlocks));
+  const int alignedBlocksPerThread
+      = (numAlignedBlocks + numThreads - 1) / numThreads;
+  numThreads = (numAlignedBlocks + alignedBlocksPerThread - 1)
+               / alignedBlocksPerThread;
+
+  std::vector<std::shared_ptr<Skeleton>> threadSkels;
+  if (numThreads > 1)
+  {
+    for (int threadIdx = 0; threadIdx < numThreads; threadIdx++)
+      threadSkels.push_back(cloneSkeleton());
+  }
+  forEachTimestepBlock(numTimesteps, threadSkels, fn, blockAlignment);
+}
+
+//==============================================================================
+void Skeleton::forEachTimestepBlock(
+    int numTimesteps,
+    const std::vector<std::shared_ptr<Skeleton>>& threadSkels,
+    std::function<void(Skeleton*, int, int)> fn,
+    int blockAlignment)
+{
+  if (numTimesteps <= 0)
+    return;
+
+  const int numAlignedBlocks
+      = (numTimesteps + blockAlignment - 1) / blockAlignment;
+  const int numThreads
+      = std::max(1, std::min((int)threadSkels.size(), numAlignedBlocks));
+
+  if (numThreads == 1)
+  {
+    Eigen::VectorXs originalPos = getPositions();
+    Eigen::VectorXs originalVel = getVelocities();
+    Eigen::VectorXs originalAcc = getAccelerations();
+    fn(this, 0, numTimesteps);
+    setPositions(originalPos);
+    setVelocities(originalVel);
+    setAccelerations(originalAcc);
+    return;
+  }
+
+  const int blockSize
+      = ((numAlignedBlocks + numThreads - 1) / numThreads) * blockAlignment;
+  std::vector<std::future<void>> futures;
+  for (int threadIdx = 0; threadIdx < numThreads; threadIdx++)
+  {
+    int start = threadIdx * blockSize;
+    int end = std::min(numTimesteps, start + blockSize);
+    if (start >= end)
+      break;
+    std::shared_ptr<Skeleton> skel = threadSkels[threadIdx];
+    futures.push_back(std::async(std::launch::async, [skel, start, end, &fn] {
+      fn(skel.get(), start, end);
+    }));
+  }
+  for (auto& future : futures)
+  {
+    future.get();
+  }
+}
+
+//==============================================================================
+/// This computes the same Jacobians as above, splitting the timesteps across
+/// the provided clones of this Skeleton
+void Skeleton::getLinearizedMassesJacobiansOverTrajectory(
+    const Eigen::MatrixXs& poses,
+    const Eigen::MatrixXs& vels,
+    const Eigen::MatrixXs& accs,
+    std::vector<Eigen::MatrixXs>& comJacs,
+    std::vector<Eigen::MatrixXs>& accOffsetJacs,
+    const std::vector<std::shared_ptr<dynamics::Skeleton>>& threadSkels)
+{
+  ensureBodyScaleGroups();
+  assert(poses.cols() == vels.cols() && poses.cols() == accs.cols());
+  int numTimesteps = poses.cols();
+  comJacs.resize(numTimesteps);
+  accOffsetJacs.resize(numTimesteps);
+
+  forEachTimestepBlock(
+      numTimesteps,
+      threadSkels,
+      [&](dynamics::Skeleton* skel, int start, int end) {
+        for (int t = start; t < end; t++)
+        {
+          skel->setPositions(poses.col(t));
+          skel->setVelocities(vels.col(t));
+          skel->setAccelerations(accs.col(t));
+          comJacs[t] = skel->getUnnormalizedCOMJacobianWrtLinearizedMasses();
+          accOffsetJacs[t]
+              = skel->getUnnormalizedCOMAccelerationOffsetJacobianWrtLinearizedMasses();
+        }
+      });
+}
+
 //==============================================================================
 /// This gets the COMs of each scale group, concatenated
 Eigen::VectorXs Skeleton::getGroupCOMs()
@@ -5377,6 +5583,15 @@ Eigen::MatrixXs Skeleton::convertBodyScalesJacobianToGroupScales(
   return J;
 }
 
+//==============================================================================
+/// This returns the sparse map P such that (J * P) converts a Jacobian wrt
+/// Body scales to one wrt Group scales
+const Eigen::SparseMatrix<s_t>& Skeleton::getBodyScalesToGroupScalesMap()
+{
+  ensureBodyScaleGroups();
+  return mBodyScalesToGroupScalesMap;
+}
+
 //==============================================================================
 /// This returns the Jacobian of the joint positions wrt the scales of the
 /// groups
@@ -5387,6 +5602,18 @@ Eigen::MatrixXs Skeleton::getJointWorldPositionsJacobianWrtGroupScales(
       getJointWorldPositionsJacobianWrtBodyScales(joints));
 }
 
+//==============================================================================
+/// This is the same as getJointWorldPositionsJacobianWrtGroupScales(), but
+/// only fills in the bodies on each joint's ancestor chain
+Eigen::SparseMatrix<s_t>
+Skeleton::getJointWorldPositionsSparseJacobianWrtGroupScales(
+    const std::vector<dynamics::Joint*>& joints)
+{
+  Eigen::SparseMatrix<s_t> bodyScalesJac
+      = getJointWorldPositionsSparseJacobianWrtBodyScales(joints);
+  return bodyScalesJac * getBodyScalesToGroupScalesMap();
+}
+
 //==============================================================================
 /// This returns the Jacobian of the joint positions wrt the scales of the
 /// groups
@@ -5428,6 +5655,18 @@ Eigen::MatrixXs Skeleton::getMarkerWorldPositionsJacobianWrtGroupScales(
       getMarkerWorldPositionsJacobianWrtBodyScales(markers));
 }
 
+//==============================================================================
+/// This is the same as getMarkerWorldPositionsJacobianWrtGroupScales(), but
+/// only fills in the bodies on each marker's ancestor chain
+Eigen::SparseMatrix<s_t>
+Skeleton::getMarkerWorldPositionsSparseJacobianWrtGroupScales(
+    const std::vector<std::pair<dynamics::BodyNode*, Eigen::Vector3s>>& markers)
+{
+  Eigen::SparseMatrix<s_t> bodyScalesJac
+      = getMarkerWorldPositionsSparseJacobianWrtBodyScales(markers);
+  return bodyScalesJac * getBodyScalesToGroupScalesMap();
+}
+
 //==============================================================================
 /// This returns the Jacobian relating changes in body scales to changes in
 /// marker world positions.
@@ -5966,6 +6205,47 @@ Eigen::MatrixXs Skeleton::getJointWorldPositionsJacobianWrtJointPositions(
   return jac;
 }
 
+//==============================================================================
+/// This is the same as getJointWorldPositionsJacobianWrtJointPositions(), but
+/// walks up from each joint to the root, and only stores the entries for the
+/// DOFs of the ancestor joints.
+Eigen::SparseMatrix<s_t>
+Skeleton::getJointWorldPositionsSparseJacobianWrtJointPositions(
+    const std::vector<dynamics::Joint*>& joints) const
+{
+  std::vector<Eigen::Triplet<s_t>> triplets;
+  for (int j = 0; j < joints.size(); j++)
+  {
+    const dynamics::BodyNode* childBody = joints[j]->getChildBodyNode();
+    Eigen::Vector3s worldPos
+        = childBody->getWorldTransform()
+          * joints[j]->getTransformFromChildBodyNode().translation();
+
+    // Each DOF on the way up to the root moves the joint along its screw
+    const dynamics::BodyNode* ancestor = childBody;
+    while (ancestor != nullptr)
+    {
+      const dynamics::Joint* parentJoint = ancestor->getParentJoint();
+      for (int d = 0; d < parentJoint->getNumDofs(); d++)
+      {
+        Eigen::Vector6s screw = parentJoint->getWorldAxisScrewForPosition(d);
+        Eigen::Vector3s dPos
+            = screw.tail<3>() + screw.head<3>().cross(worldPos);
+        for (int k = 0; k < 3; k++)
+        {
+          triplets.emplace_back(
+              j * 3 + k, parentJoint->getDof(d)->getIndexInSkeleton(), dPos(k));
+        }
+      }
+      ancestor = ancestor->getParentBodyNode();
+    }
+  }
+
+  Eigen::SparseMatrix<s_t> jac(joints.size() * 3, getNumDofs());
+  jac.setFromTriplets(triplets.begin(), triplets.end());
+  return jac;
+}
+
 //==============================================================================
 /// This returns the Jacobian relating changes in source skeleton joint
 /// positions to changes in source joint world positions.
@@ -6112,6 +6392,66 @@ Eigen::MatrixXs Skeleton::getJointWorldPositionsJacobianWrtBodyScales(
   return jac;
 }
 
+//==============================================================================
+/// This is the same as getJointWorldPositionsJacobianWrtBodyScales(), but
+/// walks up from each joint to the root, and only stores the entries for the
+/// ancestor bodies.
+Eigen::SparseMatrix<s_t>
+Skeleton::getJointWorldPositionsSparseJacobianWrtBodyScales(
+    const std::vector<dynamics::Joint*>& joints)
+{
+  std::vector<Eigen::Triplet<s_t>> triplets;
+  auto addBlock = [&triplets](int row, int col, const Eigen::Vector3s& v) {
+    for (int k = 0; k < 3; k++)
+      triplets.emplace_back(row + k, col, v(k));
+  };
+
+  for (int j = 0; j < joints.size(); j++)
+  {
+    // The dense version matches joints by name, so we do too
+    dynamics::Joint* joint = getJoint(joints[j]->getName());
+    if (joint == nullptr)
+      continue;
+
+    // Scaling the child body moves the joint by the child offset, minus the
+    // translation of the child body due to simply scaling the child offset,
+    // since the joint isn't attached to the child offset
+    dynamics::BodyNode* childBody = joint->getChildBodyNode();
+    for (int axis = 0; axis < 3; axis++)
+    {
+      addBlock(
+          j * 3,
+          childBody->getIndexInSkeleton() * 3 + axis,
+          joint->getWorldTranslationOfChildBodyWrtChildScale(axis)
+              - joint->Joint::getWorldTranslationOfChildBodyWrtChildScale(
+                  axis));
+    }
+
+    // Every ancestor body moves the joint by both of its offsets
+    dynamics::Joint* childJoint = joint;
+    dynamics::BodyNode* ancestor = joint->getParentBodyNode();
+    while (ancestor != nullptr)
+    {
+      for (int axis = 0; axis < 3; axis++)
+      {
+        addBlock(
+            j * 3,
+            ancestor->getIndexInSkeleton() * 3 + axis,
+            ancestor->getParentJoint()
+                    ->getWorldTranslationOfChildBodyWrtChildScale(axis)
+                + childJoint->getWorldTranslationOfChildBodyWrtParentScale(
+                    axis));
+      }
+      childJoint = ancestor->getParentJoint();
+      ancestor = ancestor->getParentBodyNode();
+    }
+  }
+
+  Eigen::SparseMatrix<s_t> jac(joints.size() * 3, getNumBodyNodes() * 3);
+  jac.setFromTriplets(triplets.begin(), triplets.end());
+  return jac;
+}
+
 //==============================================================================
 /// This returns the Jacobian relating changes in source skeleton body scales
 /// to changes in source joint world positions.
@@ -6418,6 +6758,54 @@ Eigen::MatrixXs Skeleton::getJointDistanceToOtherJointsJacobianWrt(
   return Eigen::MatrixXs::Zero(joints.size(), dim);
 }
 
+//==============================================================================
+/// This is the same as getJointDistanceToOtherJointsJacobianWrt(), but returns
+/// a sparse matrix
+Eigen::SparseMatrix<s_t>
+Skeleton::getJointDistanceToOtherJointsSparseJacobianWrt(
+    const std::vector<dynamics::Joint*>& joints,
+    int jointIndex,
+    neural::WithRespectTo* wrt)
+{
+  if (wrt != neural::WithRespectTo::POSITION
+      && wrt != neural::WithRespectTo::GROUP_SCALES)
+  {
+    return Eigen::SparseMatrix<s_t>(joints.size(), wrt->dim(this));
+  }
+
+  // Row i only touches joint i and joint `jointIndex`, so multiplying by the
+  // sparse joint position Jacobian gives the union of their ancestor chains
+  std::vector<Eigen::Triplet<s_t>> triplets;
+  Eigen::VectorXs jointLocations = getJointWorldPositions(joints);
+  for (int i = 0; i < joints.size(); i++)
+  {
+    if (i == jointIndex)
+      continue;
+    Eigen::Vector3s diff
+        = (jointLocations.segment<3>(i * 3)
+           - jointLocations.segment<3>(jointIndex * 3));
+    for (int k = 0; k < 3; k++)
+    {
+      triplets.emplace_back(i, i * 3 + k, 2 * diff(k));
+      triplets.emplace_back(i, jointIndex * 3 + k, -2 * diff(k));
+    }
+  }
+  Eigen::SparseMatrix<s_t> dDistance_dJointLocations(
+      joints.size(), joints.size() * 3);
+  dDistance_dJointLocations.setFromTriplets(triplets.begin(), triplets.end());
+
+  if (wrt == neural::WithRespectTo::POSITION)
+  {
+    return dDistance_dJointLocations
+           * getJointWorldPositionsSparseJacobianWrtJointPositions(joints);
+  }
+  else
+  {
+    return dDistance_dJointLocations
+           * getJointWorldPositionsSparseJacobianWrtGroupScales(joints);
+  }
+}
+
 //==============================================================================
 /// This returns a Jacobian of the distance to every joint in the body with
 /// respect to WRT
@@ -6684,6 +7072,61 @@ Eigen::MatrixXs Skeleton::getMarkerWorldPositionsJacobianWrtBodyScales(
   return jac;
 }
 
+//==============================================================================
+/// This is the same as getMarkerWorldPositionsJacobianWrtBodyScales(), but
+/// walks up from each marker to the root, and only stores the entries for the
+/// ancestor bodies.
+Eigen::SparseMatrix<s_t>
+Skeleton::getMarkerWorldPositionsSparseJacobianWrtBodyScales(
+    const std::vector<std::pair<dynamics::BodyNode*, Eigen::Vector3s>>& markers)
+{
+  std::vector<Eigen::Triplet<s_t>> triplets;
+  auto addBlock = [&triplets](int row, int col, const Eigen::Vector3s& v) {
+    for (int k = 0; k < 3; k++)
+      triplets.emplace_back(row + k, col, v(k));
+  };
+
+  for (int j = 0; j < markers.size(); j++)
+  {
+    // The marker is directly attached to this body, so it moves with the
+    // marker offset as well as the parent joint offset
+    dynamics::BodyNode* bodyNode = markers[j].first;
+    Eigen::Matrix3s R = bodyNode->getWorldTransform().linear();
+    for (int axis = 0; axis < 3; axis++)
+    {
+      addBlock(
+          j * 3,
+          bodyNode->getIndexInSkeleton() * 3 + axis,
+          (R.col(axis) * markers[j].second(axis))
+              + bodyNode->getParentJoint()
+                    ->getWorldTranslationOfChildBodyWrtChildScale(axis));
+    }
+
+    // Every ancestor body moves the marker by both of its offsets
+    dynamics::Joint* childJoint = bodyNode->getParentJoint();
+    dynamics::BodyNode* ancestor = bodyNode->getParentBodyNode();
+    while (ancestor != nullptr)
+    {
+      for (int axis = 0; axis < 3; axis++)
+      {
+        addBlock(
+            j * 3,
+            ancestor->getIndexInSkeleton() * 3 + axis,
+            ancestor->getParentJoint()
+                    ->getWorldTranslationOfChildBodyWrtChildScale(axis)
+                + childJoint->getWorldTranslationOfChildBodyWrtParentScale(
+                    axis));
+      }
+      childJoint = ancestor->getParentJoint();
+      ancestor = ancestor->getParentBodyNode();
+    }
+  }
+
+  Eigen::SparseMatrix<s_t> jac(markers.size() * 3, getNumBodyNodes() * 3);
+  jac.setFromTriplets(triplets.begin(), triplets.end());
+  return jac;
+}
+
 //==============================================================================
 /// This returns the Jacobian relating changes in body scales to changes in
 /// marker world positions.
@@ -8484,6 +8927,107 @@ Skeleton::finiteDifferenceMagnetometerReadingsJacobianWrtMagneticField(
   return result;
 }
 
+//==============================================================================
+/// This computes accelerometer and gyro readings for every sensor at every
+/// timestep of a trajectory, with optional noise and bias
+Skeleton::TrajectorySensorReadings Skeleton::getTrajectorySensorReadings(
+    const Eigen::MatrixXs& poses,
+    const Eigen::MatrixXs& vels,
+    const Eigen::MatrixXs& accs,
+    const SensorMap& sensors,
+    SensorNoiseModel noise,
+    int numThreads)
+{
+  const int numTimesteps = poses.cols();
+  const int numSensors = sensors.size();
+  if (vels.cols() != numTimesteps || accs.cols() != numTimesteps)
+  {
+    throw std::runtime_error(
+        "Invalid input to getTrajectorySensorReadings! Need the same number "
+        "of timesteps in poses, vels and accs");
+  }
+
+  TrajectorySensorReadings result;
+  std::vector<std::pair<int, Eigen::Isometry3s>> sensorBodies;
+  for (auto& pair : sensors)
+  {
+    result.sensorNames.push_back(pair.first);
+    sensorBodies.emplace_back(
+        pair.second.first->getIndexInSkeleton(), pair.second.second);
+  }
+  result.accReadings = Eigen::MatrixXs::Zero(numSensors * 3, numTimesteps);
+  result.gyroReadings = Eigen::MatrixXs::Zero(numSensors * 3, numTimesteps);
+  if (numTimesteps == 0)
+    return result;
+
+  const bool addNoise = noise.accNoiseStddev > 0 || noise.gyroNoiseStddev > 0;
+  const int noiseBlockSize = 256;
+
+  // The biases come from their own stream, ahead of all the noise streams
+  Eigen::VectorXs accBias = Eigen::VectorXs::Zero(numSensors * 3);
+  Eigen::VectorXs gyroBias = Eigen::VectorXs::Zero(numSensors * 3);
+  if (noise.accBiasStddev > 0 || noise.gyroBiasStddev > 0)
+  {
+    std::seed_seq seq{noise.seed, 0u};
+    std::mt19937 rng(seq);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    for (int i = 0; i < numSensors * 3; i++)
+    {
+      accBias(i) = noise.accBiasStddev * normal(rng);
+    }
+    for (int i = 0; i < numSensors * 3; i++)
+    {
+      gyroBias(i) = noise.gyroBiasStddev * normal(rng);
+    }
+  }
+
+  auto computeBlock = [&](dynamics::Skeleton* skel, int start, int end) {
+    std::vector<std::pair<dynamics::BodyNode*, Eigen::Isometry3s>> list;
+    for (auto& pair : sensorBodies)
+    {
+      list.emplace_back(skel->getBodyNode(pair.first), pair.second);
+    }
+    for (int t = start; t < end; t++)
+    {
+      skel->setPositions(poses.col(t));
+      skel->setVelocities(vels.col(t));
+      skel->setAccelerations(accs.col(t));
+      result.accReadings.col(t)
+          = skel->getAccelerometerReadings(list) + accBias;
+      result.gyroReadings.col(t) = skel->getGyroReadings(list) + gyroBias;
+    }
+
+    if (addNoise)
+    {
+      for (int block = start / noiseBlockSize; block * noiseBlockSize < end;
+           block++)
+      {
+        std::seed_seq seq{noise.seed, static_cast<unsigned int>(block + 1)};
+        std::mt19937 rng(seq);
+        std::normal_distribution<double> normal(0.0, 1.0);
+        const int blockEnd = std::min(end, (block + 1) * noiseBlockSize);
+        for (int t = block * noiseBlockSize; t < blockEnd; t++)
+        {
+          for (int i = 0; i < numSensors * 3; i++)
+          {
+            result.accReadings(i, t) += noise.accNoiseStddev * normal(rng);
+          }
+          for (int i = 0; i < numSensors * 3; i++)
+          {
+            result.gyroReadings(i, t) += noise.gyroNoiseStddev * normal(rng);
+          }
+        }
+      }
+    }
+  };
+
+  // Thread blocks are whole noise blocks, so every noise stream is drawn by
+  // exactly one thread
+  forEachTimestepBlock(numTimesteps, numThreads, computeBlock, noiseBlockSize);
+
+  return result;
+}
+
 //==============================================================================
 /// This measures the distance between two markers in world space, at the
 /// current configuration and scales.
@@ -9065,6 +9609,118 @@ Eigen::MatrixXs Skeleton::getBodyWorldAccelerationsJacobian(
   return jac;
 }
 
+//==============================================================================
+/// This is the same as getBodyWorldAccelerationsJacobian(), but only stores
+/// the entries for each body's ancestor DOFs and ancestor scale groups
+Eigen::SparseMatrix<s_t> Skeleton::getBodyWorldAccelerationsSparseJacobian(
+    neural::WithRespectTo* wrt)
+{
+  int dim = wrt->dim(this);
+  Eigen::SparseMatrix<s_t> jac(getNumBodyNodes() * 6, dim);
+  if (wrt != neural::WithRespectTo::ACCELERATION
+      && wrt != neural::WithRespectTo::POSITION
+      && wrt != neural::WithRespectTo::VELOCITY
+      && wrt != neural::WithRespectTo::GROUP_SCALES)
+  {
+    return jac;
+  }
+
+  std::vector<Eigen::Triplet<s_t>> triplets;
+  auto addColumn = [&triplets](int body, int col, const Eigen::Vector6s& v) {
+    for (int k = 0; k < 6; k++)
+      triplets.emplace_back(body * 6 + k, col, v(k));
+  };
+
+  // We need to look up which groups each body's scales map to
+  Eigen::SparseMatrix<s_t, Eigen::RowMajor> scalesToGroups;
+  if (wrt == neural::WithRespectTo::GROUP_SCALES)
+  {
+    scalesToGroups = getBodyScalesToGroupScalesMap();
+  }
+
+  std::vector<BodyNode*>& bodyNodes = mSkelCache.mBodyNodes;
+  for (int i = 0; i < bodyNodes.size(); i++)
+  {
+    BodyNode* body = bodyNodes[i];
+
+    if (wrt == neural::WithRespectTo::ACCELERATION)
+    {
+      // The body Jacobian is already compact, with a column per ancestor DOF
+      const math::Jacobian J = body->getJacobian(Frame::World());
+      const std::vector<std::size_t>& indices
+          = body->getDependentGenCoordIndices();
+      for (int k = 0; k < indices.size(); k++)
+      {
+        addColumn(i, indices[k], J.col(k));
+      }
+      continue;
+    }
+
+    // Walk up to the root, collecting the columns this body can depend on
+    std::vector<int> cols;
+    std::vector<const DegreeOfFreedom*> dofs;
+    BodyNode* ancestor = body;
+    while (ancestor != nullptr)
+    {
+      if (wrt == neural::WithRespectTo::GROUP_SCALES)
+      {
+        for (int axis = 0; axis < 3; axis++)
+        {
+          for (Eigen::SparseMatrix<s_t, Eigen::RowMajor>::InnerIterator it(
+                   scalesToGroups, ancestor->getIndexInSkeleton() * 3 + axis);
+               it;
+               ++it)
+          {
+            cols.push_back(it.col());
+          }
+        }
+      }
+      else
+      {
+        Joint* parentJoint = ancestor->getParentJoint();
+        for (int d = 0; d < parentJoint->getNumDofs(); d++)
+        {
+          dofs.push_back(parentJoint->getDof(d));
+          cols.push_back(parentJoint->getDof(d)->getIndexInSkeleton());
+        }
+      }
+      ancestor = ancestor->getParentBodyNode();
+    }
+    // Scale groups can contain more than one of the ancestors
+    std::sort(cols.begin(), cols.end());
+    cols.erase(std::unique(cols.begin(), cols.end()), cols.end());
+
+    body->computeJacobianOfCForward(wrt, true);
+    const Eigen::Isometry3s& T = body->getWorldTransform();
+    for (int col : cols)
+    {
+      addColumn(i, col, math::AdR(T, body->mCg_dV_p.col(col)));
+    }
+
+    // See getBodyWorldAccelerationsJacobian() for this correction for the
+    // rotation of the world frame
+    if (wrt == neural::WithRespectTo::POSITION)
+    {
+      Eigen::Vector6s spatialAcc
+          = body->getSpatialAcceleration(Frame::World(), Frame::World());
+      for (const DegreeOfFreedom* dof : dofs)
+      {
+        Eigen::Vector3s worldRot
+            = dof->getJoint()
+                  ->getWorldAxisScrewForPosition(dof->getIndexInJoint())
+                  .head<3>();
+        Eigen::Vector6s correction;
+        correction.head<3>() = -spatialAcc.head<3>().cross(worldRot);
+        correction.tail<3>() = -spatialAcc.tail<3>().cross(worldRot);
+        addColumn(i, dof->getIndexInSkeleton(), correction);
+      }
+    }
+  }
+
+  jac.setFromTriplets(triplets.begin(), triplets.end());
+  return jac;
+}
+
 //==============================================================================
 /// This brute forces our world accelerations jacobian
 Eigen::MatrixXs Skeleton::finiteDifferenceBodyWorldAccelerationsJacobian(
@@ -9441,16 +10097,59 @@ Eigen::MatrixXs Skeleton::finiteDifferenceCOMWorldLinearAccelerationsJacobian(
   return result;
 }
 
+//==============================================================================
+/// SoftBodyNodes with fewer point masses than this are integrated on the
+/// calling thread, because launching a task costs more than the sweep itself
+static const std::size_t PARALLEL_SOFT_BODY_MIN_POINT_MASSES = 2048;
+
+//==============================================================================
+/// This runs `integrate` on every SoftBodyNode. If `parallel` is true, the
+/// large SoftBodyNodes each get their own task while the small ones are swept
+/// on the calling thread. `integrate` must not touch any shared state.
+template <typename IntegrateFn>
+static void integrateSoftBodyNodeStates(
+    const std::vector<SoftBodyNode*>& softBodyNodes,
+    bool parallel,
+    IntegrateFn integrate)
+{
+  std::vector<std::future<void>> futures;
+  for (SoftBodyNode* softBodyNode : softBodyNodes)
+  {
+    if (parallel
+        && softBodyNode->getNumPointMasses()
+               >= PARALLEL_SOFT_BODY_MIN_POINT_MASSES)
+    {
+      futures.push_back(std::async(
+          std::launch::async,
+          [softBodyNode, &integrate] { integrate(softBodyNode); }));
+    }
+    else
+    {
+      integrate(softBodyNode);
+    }
+  }
+  for (std::future<void>& future : futures)
+    future.get();
+}
+
 //==============================================================================
 void Skeleton::integratePositions(s_t _dt)
 {
   for (std::size_t i = 0; i < mSkelCache.mBodyNodes.size(); ++i)
     mSkelCache.mBodyNodes[i]->getParentJoint()->integratePositions(_dt);
 
-  for (std::size_t i = 0; i < mSoftBodyNodes.size(); ++i)
+  // Dirtying the caches reaches back into this Skeleton, so only the state
+  // sweeps run concurrently and the notifications go out from this thread
+  integrateSoftBodyNodeStates(
+      mSoftBodyNodes,
+      mParallelSoftBodyUpdates && mSoftBodyNodes.size() > 1,
+      [_dt](SoftBodyNode* softBodyNode) {
+        softBodyNode->integratePointMassPositionStates(_dt);
+      });
+  for (SoftBodyNode* softBodyNode : mSoftBodyNodes)
   {
-    for (std::size_t j = 0; j < mSoftBodyNodes[i]->getNumPointMasses(); ++j)
-      mSoftBodyNodes[i]->getPointMass(j)->integratePositions(_dt);
+    if (softBodyNode->getNumPointMasses() > 0)
+      softBodyNode->mNotifier->dirtyTransform();
   }
 }
 
@@ -9517,13 +10216,31 @@ void Skeleton::integrateVelocities(s_t _dt)
   for (std::size_t i = 0; i < mSkelCache.mBodyNodes.size(); ++i)
     mSkelCache.mBodyNodes[i]->getParentJoint()->integrateVelocities(_dt);
 
-  for (std::size_t i = 0; i < mSoftBodyNodes.size(); ++i)
+  integrateSoftBodyNodeStates(
+      mSoftBodyNodes,
+      mParallelSoftBodyUpdates && mSoftBodyNodes.size() > 1,
+      [_dt](SoftBodyNode* softBodyNode) {
+        softBodyNode->integratePointMassVelocityStates(_dt);
+      });
+  for (SoftBodyNode* softBodyNode : mSoftBodyNodes)
   {
-    for (std::size_t j = 0; j < mSoftBodyNodes[i]->getNumPointMasses(); ++j)
-      mSoftBodyNodes[i]->getPointMass(j)->integrateVelocities(_dt);
+    if (softBodyNode->getNumPointMasses() > 0)
+      softBodyNode->mNotifier->dirtyVelocity();
   }
 }
 
+//==============================================================================
+void Skeleton::setParallelSoftBodyUpdates(bool enable)
+{
+  mParallelSoftBodyUpdates = enable;
+}
+
+//==============================================================================
+bool Skeleton::getParallelSoftBodyUpdates() const
+{
+  return mParallelSoftBodyUpdates;
+}
+
 //==============================================================================
 Eigen::VectorXs Skeleton::getPositionDifferences(
     const Eigen::VectorXs& _q2, const Eigen::VectorXs& _q1) const
@@ -10865,6 +11582,150 @@ Skeleton::EnergyAccountingFrame Skeleton::getEnergyAccounting(
   return frame;
 }
 
+//==============================================================================
+/// This computes the same quantities as getEnergyAccounting() for every
+/// timestep of a trajectory, stored as one matrix per quantity
+Skeleton::TrajectoryEnergyAccounting Skeleton::getTrajectoryEnergyAccounting(
+    const Eigen::MatrixXs& poses,
+    const Eigen::MatrixXs& vels,
+    const Eigen::MatrixXs& accs,
+    s_t dt,
+    s_t heightZeroPoint,
+    Eigen::Vector3s referenceFrameVelocity,
+    std::vector<dynamics::BodyNode*> contactBodies,
+    const Eigen::MatrixXs& forces,
+    const Eigen::MatrixXs& moments,
+    int numThreads)
+{
+  const int numTimesteps = poses.cols();
+  const int numBodies = getNumBodyNodes();
+  const int numJoints = getNumJoints();
+  const int numContacts = contactBodies.size();
+  if (vels.cols() != numTimesteps || accs.cols() != numTimesteps)
+  {
+    throw std::runtime_error(
+        "Invalid input to getTrajectoryEnergyAccounting! Need the same number "
+        "of timesteps in poses, vels and accs");
+  }
+  if (numContacts > 0
+      && (forces.rows() != numContacts * 3 || forces.cols() != numTimesteps
+          || moments.rows() != numContacts * 3
+          || moments.cols() != numTimesteps))
+  {
+    throw std::runtime_error(
+        "Invalid input to getTrajectoryEnergyAccounting! Need forces and "
+        "moments to be (3 * contactBodies.size() x numTimesteps)");
+  }
+
+  std::vector<int> contactBodyIndices;
+  for (dynamics::BodyNode* body : contactBodies)
+  {
+    contactBodyIndices.push_back(body->getIndexInSkeleton());
+  }
+
+  TrajectoryEnergyAccounting result;
+  result.bodyKineticEnergy = Eigen::MatrixXs::Zero(numBodies, numTimesteps);
+  result.bodyPotentialEnergy = Eigen::MatrixXs::Zero(numBodies, numTimesteps);
+  result.bodyKineticEnergyDeriv
+      = Eigen::MatrixXs::Zero(numBodies, numTimesteps);
+  result.bodyPotentialEnergyDeriv
+      = Eigen::MatrixXs::Zero(numBodies, numTimesteps);
+  result.bodyGravityPower = Eigen::MatrixXs::Zero(numBodies, numTimesteps);
+  result.bodyExternalForcePower
+      = Eigen::MatrixXs::Zero(numBodies, numTimesteps);
+  result.bodyParentJointPower = Eigen::MatrixXs::Zero(numBodies, numTimesteps);
+  result.bodyChildJointPowerSum
+      = Eigen::MatrixXs::Zero(numBodies, numTimesteps);
+  result.jointPowerToParent = Eigen::MatrixXs::Zero(numJoints, numTimesteps);
+  result.jointPowerToChild = Eigen::MatrixXs::Zero(numJoints, numTimesteps);
+  result.contactPower = Eigen::MatrixXs::Zero(numContacts, numTimesteps);
+  result.contactWork = Eigen::VectorXs::Zero(numContacts);
+  if (numTimesteps == 0)
+    return result;
+
+  // Every output is written straight into its column of the preallocated
+  // result, and the per-thread state vectors are allocated once per block, so
+  // nothing inside the timestep loop touches the heap.
+  auto computeBlock = [&](dynamics::Skeleton* skel, int start, int end) {
+    Eigen::VectorXs q(skel->getNumDofs());
+    Eigen::VectorXs dq(skel->getNumDofs());
+    Eigen::VectorXs ddq(skel->getNumDofs());
+    const Eigen::Vector3s gravity = skel->getGravity();
+    const Eigen::Vector3s gravityDir = gravity.normalized();
+    const s_t gravityNorm = gravity.norm();
+    for (int t = start; t < end; t++)
+    {
+      q = poses.col(t);
+      dq = vels.col(t);
+      ddq = accs.col(t);
+      skel->setPositions(q);
+      skel->setVelocities(dq);
+      skel->setAccelerations(ddq);
+      skel->computeInverseDynamics(true);
+
+      for (int i = 0; i < numBodies; i++)
+      {
+        dynamics::BodyNode* body = skel->getBodyNode(i);
+        const Eigen::Isometry3s& T = body->getWorldTransform();
+        const Eigen::Vector6s& bodyV = body->getSpatialVelocity();
+        const Eigen::Matrix6s& I = body->getSpatialInertia();
+        Eigen::Vector6s V = bodyV;
+        V.tail<3>() += T.linear().transpose() * referenceFrameVelocity;
+
+        result.bodyKineticEnergy(i, t) = 0.5 * V.dot(I * V);
+        result.bodyPotentialEnergy(i, t)
+            = (heightZeroPoint - T.translation().dot(gravityDir))
+              * body->getMass() * gravityNorm;
+
+        // See getEnergyAccounting() for the derivation of each of these
+        Eigen::Vector6s totalForceIDFormula
+            = I * body->getSpatialAcceleration() - math::dad(bodyV, I * bodyV);
+        Eigen::Vector6s gravityForce = I * math::AdInvRLinear(T, gravity);
+        s_t powerFromParent = V.dot(body->getBodyForce());
+        result.jointPowerToChild(
+            body->getParentJoint()->getJointIndexInSkeleton(), t)
+            = powerFromParent;
+        result.bodyParentJointPower(i, t) = powerFromParent;
+        result.bodyGravityPower(i, t) = V.dot(gravityForce);
+        result.bodyExternalForcePower(i, t)
+            = V.dot(body->getExternalForceLocal());
+        s_t childPowerSum = 0.0;
+        for (int c = 0; c < body->getNumChildBodyNodes(); c++)
+        {
+          Joint* childJoint = body->getChildJoint(c);
+          s_t powerFromChild = -V.dot(math::dAdInvT(
+              childJoint->getRelativeTransform(),
+              childJoint->getChildBodyNode()->getBodyForce()));
+          childPowerSum += powerFromChild;
+          result.jointPowerToParent(childJoint->getJointIndexInSkeleton(), t)
+              = powerFromChild;
+        }
+        result.bodyChildJointPowerSum(i, t) = childPowerSum;
+        result.bodyKineticEnergyDeriv(i, t) = V.dot(totalForceIDFormula);
+        result.bodyPotentialEnergyDeriv(i, t) = bodyV.dot(-gravityForce);
+      }
+
+      for (int c = 0; c < numContacts; c++)
+      {
+        dynamics::BodyNode* body = skel->getBodyNode(contactBodyIndices[c]);
+        Eigen::Vector6s worldF;
+        worldF.head<3>() = moments.block<3, 1>(c * 3, t);
+        worldF.tail<3>() = forces.block<3, 1>(c * 3, t);
+        Eigen::Vector6s worldV
+            = body->getSpatialVelocity(Frame::World(), Frame::World());
+        worldV.tail<3>() += referenceFrameVelocity;
+        result.contactPower(c, t) = worldF.dot(worldV);
+      }
+    }
+  };
+  forEachTimestepBlock(numTimesteps, numThreads, computeBlock);
+
+  // Summing in timestep order after the join keeps the totals independent of
+  // the number of threads
+  result.contactWork = result.contactPower.rowwise().sum() * dt;
+  return result;
+}
+
 //==============================================================================
 static bool isValidBodyNode(
     const Skeleton* _skeleton,
@@ -11679,7 +12540,10 @@ const Eigen::VectorXs& Skeleton::getConstraintForces() const
 
 //==============================================================================
 Skeleton::Skeleton(const AspectPropertiesData& properties)
-  : mTotalMass(0.0), mIsImpulseApplied(false), mUnionSize(1)
+  : mParallelSoftBodyUpdates(false),
+    mTotalMass(0.0),
+    mIsImpulseApplied(false),
+    mUnionSize(1)
 {
   createAspect<Aspect>(properties);
   createAspect<detail::BodyNodeVectorProxyAspect>();
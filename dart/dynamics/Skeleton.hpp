@@ -36,6 +36,10 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <random>
+#include <vector>
+
+#include <Eigen/Sparse>
 
 #include "dart/common/NameManager.hpp"
 #include "dart/common/VersionCounter.hpp"
@@ -812,6 +816,11 @@ public:
   /// This gets a random pose that's valid within joint limits
   Eigen::VectorXs getRandomPose();
 
+  /// This is the same as getRandomPose(), but it draws from `generator` rather
+  /// than the global std::rand() stream, so that each thread can have its own
+  /// reproducible sequence.
+  Eigen::VectorXs getRandomPose(std::mt19937& generator);
+
   /// This gets a random velocity that's valid within joint limits
   Eigen::VectorXs getRandomVelocity();
 
@@ -819,6 +828,11 @@ public:
   /// the specified joints. All unspecified joints are left as 0.
   Eigen::VectorXs getRandomPoseForJoints(std::vector<dynamics::Joint*> joints);
 
+  /// This is the same as getRandomPoseForJoints(), but it draws from
+  /// `generator` rather than the global std::rand() stream.
+  Eigen::VectorXs getRandomPoseForJoints(
+      std::vector<dynamics::Joint*> joints, std::mt19937& generator);
+
   //----------------------------------------------------------------------------
   // Trajectory optimization
   //----------------------------------------------------------------------------
@@ -1190,6 +1204,46 @@ public:
   Eigen::MatrixXs
   finiteDifferenceUnnormalizedCOMAccelerationOffsetJacobianWrtLinearizedMasses();
 
+  /// This returns the world COM of every body, one per column, in the order
+  /// of getBodyNode(i)
+  Eigen::Matrix<s_t, 3, Eigen::Dynamic> getBodyCOMs();
+
+  /// The unnormalized COM (and its acceleration, and their Jacobians) are all
+  /// linear in the body COMs, through a map that only depends on the scale
+  /// groups. This returns that map, as a sparse matrix G with one row per
+  /// body and one column per linearized mass, where G(b, i + 1) = 1/|group i|
+  /// for every body b in scale group i. The (1/m) column is empty. With that,
+  ///
+  ///   getUnnormalizedCOMJacobianWrtLinearizedMasses() == getBodyCOMs() * G
+  ///
+  /// G is rebuilt whenever the scale groups change, so this is free to call
+  /// at every timestep.
+  const Eigen::SparseMatrix<s_t>& getLinearizedMassesBodyMap();
+
+  /// This computes getUnnormalizedCOMJacobianWrtLinearizedMasses() and
+  /// getUnnormalizedCOMAccelerationOffsetJacobianWrtLinearizedMasses() for
+  /// every timestep of a trajectory, on up to `numThreads` threads (see
+  /// forEachTimestepBlock()).
+  void getLinearizedMassesJacobiansOverTrajectory(
+      const Eigen::MatrixXs& poses,
+      const Eigen::MatrixXs& vels,
+      const Eigen::MatrixXs& accs,
+      std::vector<Eigen::MatrixXs>& comJacs,
+      std::vector<Eigen::MatrixXs>& accOffsetJacs,
+      int numThreads = 1);
+
+  /// This is the same as above, but runs on the clones in `threadSkels`
+  /// instead of cloning this Skeleton on every call. This lets callers that
+  /// compute these repeatedly reuse their clones. The clones must have the
+  /// same scale groups, scales and masses as this Skeleton.
+  void getLinearizedMassesJacobiansOverTrajectory(
+      const Eigen::MatrixXs& poses,
+      const Eigen::MatrixXs& vels,
+      const Eigen::MatrixXs& accs,
+      std::vector<Eigen::MatrixXs>& comJacs,
+      std::vector<Eigen::MatrixXs>& accOffsetJacs,
+      const std::vector<std::shared_ptr<dynamics::Skeleton>>& threadSkels);
+
   /// This gets the COMs of each scale group, concatenated
   Eigen::VectorXs getGroupCOMs();
 
@@ -1226,11 +1280,21 @@ public:
   Eigen::MatrixXs convertBodyScalesJacobianToGroupScales(
       Eigen::MatrixXs bodyScalesJac);
 
+  /// This returns the sparse map P such that (J * P) converts a Jacobian wrt
+  /// Body scales to one wrt Group scales. P is rebuilt whenever the scale
+  /// groups change.
+  const Eigen::SparseMatrix<s_t>& getBodyScalesToGroupScalesMap();
+
   /// This returns the Jacobian of the joint positions wrt the scales of the
   /// groups
   Eigen::MatrixXs getJointWorldPositionsJacobianWrtGroupScales(
       const std::vector<dynamics::Joint*>& joints);
 
+  /// This is the same as getJointWorldPositionsJacobianWrtGroupScales(), but
+  /// only fills in the bodies on each joint's ancestor chain
+  Eigen::SparseMatrix<s_t> getJointWorldPositionsSparseJacobianWrtGroupScales(
+      const std::vector<dynamics::Joint*>& joints);
+
   /// This returns the Jacobian of the joint positions wrt the scales of the
   /// groups
   Eigen::MatrixXs finiteDifferenceJointWorldPositionsJacobianWrtGroupScales(
@@ -1242,6 +1306,12 @@ public:
       const std::vector<std::pair<dynamics::BodyNode*, Eigen::Vector3s>>&
           markers);
 
+  /// This is the same as getMarkerWorldPositionsJacobianWrtGroupScales(), but
+  /// only fills in the bodies on each marker's ancestor chain
+  Eigen::SparseMatrix<s_t> getMarkerWorldPositionsSparseJacobianWrtGroupScales(
+      const std::vector<std::pair<dynamics::BodyNode*, Eigen::Vector3s>>&
+          markers);
+
   /// This returns the Jacobian relating changes in body scales to changes in
   /// marker world positions.
   Eigen::MatrixXs finiteDifferenceMarkerWorldPositionsJacobianWrtGroupScales(
@@ -1341,6 +1411,13 @@ public:
   Eigen::MatrixXs getJointWorldPositionsJacobianWrtJointPositions(
       const std::vector<dynamics::Joint*>& joints) const;
 
+  /// This is the same as getJointWorldPositionsJacobianWrtJointPositions(),
+  /// but walks up from each joint to the root, and only stores the entries
+  /// for the DOFs of the ancestor joints.
+  Eigen::SparseMatrix<s_t>
+  getJointWorldPositionsSparseJacobianWrtJointPositions(
+      const std::vector<dynamics::Joint*>& joints) const;
+
   /// This returns the Jacobian relating changes in source skeleton joint
   /// positions to changes in source joint world positions.
   Eigen::MatrixXs finiteDifferenceJointWorldPositionsJacobianWrtJointPositions(
@@ -1362,6 +1439,12 @@ public:
   Eigen::MatrixXs getJointWorldPositionsJacobianWrtBodyScales(
       const std::vector<dynamics::Joint*>& joints);
 
+  /// This is the same as getJointWorldPositionsJacobianWrtBodyScales(), but
+  /// walks up from each joint to the root instead of testing every body, and
+  /// only stores the entries for the ancestor bodies.
+  Eigen::SparseMatrix<s_t> getJointWorldPositionsSparseJacobianWrtBodyScales(
+      const std::vector<dynamics::Joint*>& joints);
+
   /// This returns the Jacobian relating changes in source skeleton body scales
   /// to changes in source joint world positions.
   Eigen::MatrixXs finiteDifferenceJointWorldPositionsJacobianWrtBodyScales(
@@ -1440,6 +1523,15 @@ public:
       int jointIndex,
       neural::WithRespectTo* wrt);
 
+  /// This is the same as getJointDistanceToOtherJointsJacobianWrt(), but
+  /// returns a sparse matrix. Row i only depends on joint i and joint
+  /// `jointIndex`, so it only has entries for the union of their ancestor
+  /// chains.
+  Eigen::SparseMatrix<s_t> getJointDistanceToOtherJointsSparseJacobianWrt(
+      const std::vector<dynamics::Joint*>& joints,
+      int jointIndex,
+      neural::WithRespectTo* wrt);
+
   /// This returns a Jacobian of the distance to every joint in the body with
   /// respect to WRT
   Eigen::MatrixXs finiteDifferenceJointDistanceToOtherJointsJacobianWrt(
@@ -1495,6 +1587,13 @@ public:
       const std::vector<std::pair<dynamics::BodyNode*, Eigen::Vector3s>>&
           markers);
 
+  /// This is the same as getMarkerWorldPositionsJacobianWrtBodyScales(), but
+  /// walks up from each marker to the root instead of testing every body, and
+  /// only stores the entries for the ancestor bodies.
+  Eigen::SparseMatrix<s_t> getMarkerWorldPositionsSparseJacobianWrtBodyScales(
+      const std::vector<std::pair<dynamics::BodyNode*, Eigen::Vector3s>>&
+          markers);
+
   /// This returns the Jacobian relating changes in body scales to changes in
   /// marker world positions.
   Eigen::MatrixXs finiteDifferenceMarkerWorldPositionsJacobianWrtBodyScales(
@@ -1765,6 +1864,56 @@ public:
           mags,
       Eigen::Vector3s magneticField);
 
+  typedef struct SensorNoiseModel
+  {
+    // The standard deviation of white noise added to every reading
+    s_t accNoiseStddev;
+    s_t gyroNoiseStddev;
+    // The standard deviation of a constant bias drawn once per sensor axis,
+    // and added to every reading of that axis over the whole trajectory
+    s_t accBiasStddev;
+    s_t gyroBiasStddev;
+    // Noise is drawn from one stream per block of timesteps, each seeded from
+    // this and the block index, so the readings for a given seed don't depend
+    // on the number of threads
+    unsigned int seed;
+
+    // This is spelled out rather than using default member initializers,
+    // because SensorNoiseModel() is used as a default argument below, inside
+    // the enclosing class
+    SensorNoiseModel()
+      : accNoiseStddev(0.0),
+        gyroNoiseStddev(0.0),
+        accBiasStddev(0.0),
+        gyroBiasStddev(0.0),
+        seed(0)
+    {
+    }
+  } SensorNoiseModel;
+
+  typedef struct TrajectorySensorReadings
+  {
+    // The sensors in the order their readings are stored, which is the
+    // (sorted) order of the SensorMap
+    std::vector<std::string> sensorNames;
+    // Each of these is (3 * numSensors x numTimesteps), with the same meaning
+    // as getAccelerometerReadings() and getGyroReadings() at each timestep.
+    Eigen::MatrixXs accReadings;
+    Eigen::MatrixXs gyroReadings;
+  } TrajectorySensorReadings;
+
+  /// This computes getAccelerometerReadings() and getGyroReadings() for every
+  /// sensor in `sensors` at every timestep of a trajectory, optionally adding
+  /// noise and bias from `noise`, on up to `numThreads` threads (see
+  /// forEachTimestepBlock()).
+  TrajectorySensorReadings getTrajectorySensorReadings(
+      const Eigen::MatrixXs& poses,
+      const Eigen::MatrixXs& vels,
+      const Eigen::MatrixXs& accs,
+      const SensorMap& sensors,
+      SensorNoiseModel noise = SensorNoiseModel(),
+      int numThreads = 1);
+
   //----------------------------------------------------------------------------
   // Handling anthropometric measurements
   //----------------------------------------------------------------------------
@@ -1871,6 +2020,13 @@ public:
   /// respect to `wrt`
   Eigen::MatrixXs getBodyWorldAccelerationsJacobian(neural::WithRespectTo* wrt);
 
+  /// This is the same as getBodyWorldAccelerationsJacobian(), but returns a
+  /// sparse matrix. A body's acceleration only depends on the DOFs of its
+  /// ancestor joints, and the scales of its ancestor bodies (and itself), so
+  /// those are the only entries stored.
+  Eigen::SparseMatrix<s_t> getBodyWorldAccelerationsSparseJacobian(
+      neural::WithRespectTo* wrt);
+
   /// This brute forces our world accelerations jacobian
   Eigen::MatrixXs finiteDifferenceBodyWorldAccelerationsJacobian(
       neural::WithRespectTo* wrt);
@@ -1934,6 +2090,17 @@ public:
   // Documentation inherited
   void integrateVelocities(s_t _dt);
 
+  /// If this is true, integratePositions() and integrateVelocities() update
+  /// the point masses of different SoftBodyNodes concurrently, one task per
+  /// SoftBodyNode with at least a couple thousand point masses. Smaller
+  /// SoftBodyNodes are always swept on the calling thread. This only pays off
+  /// for Skeletons with several large soft bodies, so it defaults to false.
+  void setParallelSoftBodyUpdates(bool enable);
+
+  /// Returns true if point masses of different SoftBodyNodes are integrated
+  /// concurrently
+  bool getParallelSoftBodyUpdates() const;
+
   /// Return the difference of two generalized positions which are measured in
   /// the configuration space of this Skeleton. If the configuration space is
   /// Euclidean space, this function returns _q2 - _q1. Otherwise, it depends on
@@ -2209,6 +2376,51 @@ public:
       std::vector<Eigen::Vector3s> forces = std::vector<Eigen::Vector3s>(),
       std::vector<Eigen::Vector3s> moments = std::vector<Eigen::Vector3s>());
 
+  typedef struct TrajectoryEnergyAccounting
+  {
+    // Each of these is (numBodies x numTimesteps), with the same meaning as
+    // the matching EnergyAccountingFrame field at each timestep.
+    Eigen::MatrixXs bodyKineticEnergy;
+    Eigen::MatrixXs bodyPotentialEnergy;
+    Eigen::MatrixXs bodyKineticEnergyDeriv;
+    Eigen::MatrixXs bodyPotentialEnergyDeriv;
+    Eigen::MatrixXs bodyGravityPower;
+    Eigen::MatrixXs bodyExternalForcePower;
+    Eigen::MatrixXs bodyParentJointPower;
+    Eigen::MatrixXs bodyChildJointPowerSum;
+
+    // Each of these is (numJoints x numTimesteps), matching
+    // JointEnergyTransmitter::powerToParent and powerToChild.
+    Eigen::MatrixXs jointPowerToParent;
+    Eigen::MatrixXs jointPowerToChild;
+
+    // (numContactBodies x numTimesteps), matching
+    // ContactEnergyTransmitter::powerToBody.
+    Eigen::MatrixXs contactPower;
+    // The total work done on each contact body over the trajectory, which is
+    // the sum of contactPower * dt over timesteps.
+    Eigen::VectorXs contactWork;
+  } TrajectoryEnergyAccounting;
+
+  /// This computes the same quantities as getEnergyAccounting() for every
+  /// timestep of a trajectory, and stores them as one matrix per quantity
+  /// (rows are bodies/joints/contacts, columns are timesteps). `forces` and
+  /// `moments` are (3 * contactBodies.size() x numTimesteps), in world
+  /// coordinates about the world origin. This runs on up to `numThreads`
+  /// threads (see forEachTimestepBlock()).
+  TrajectoryEnergyAccounting getTrajectoryEnergyAccounting(
+      const Eigen::MatrixXs& poses,
+      const Eigen::MatrixXs& vels,
+      const Eigen::MatrixXs& accs,
+      s_t dt,
+      s_t heightZeroPoint = 0.0,
+      Eigen::Vector3s referenceFrameVelocity = Eigen::Vector3s::Zero(),
+      std::vector<dynamics::BodyNode*> contactBodies
+      = std::vector<dynamics::BodyNode*>(),
+      const Eigen::MatrixXs& forces = EMPTY,
+      const Eigen::MatrixXs& moments = EMPTY,
+      int numThreads = 1);
+
   //----------------------------------------------------------------------------
   /// \{ \name Support Polygon
   //----------------------------------------------------------------------------
@@ -2680,6 +2892,40 @@ public:
 protected:
   struct DataCache;
 
+  /// This maps `pose`, which has an entry in [-1, 1] for each DOF, to a pose
+  /// within the joint limits.
+  Eigen::VectorXs getPoseWithinLimits(Eigen::VectorXs pose);
+
+  /// This returns the initial pose, with the DOFs of `joints` replaced by the
+  /// ones in `randomPose`.
+  Eigen::VectorXs getInitialPoseWithJoints(
+      const std::vector<dynamics::Joint*>& joints,
+      const Eigen::VectorXs& randomPose);
+
+  /// This is how the trajectory APIs split their work across threads. It
+  /// splits [0, numTimesteps) into one contiguous block per thread, with
+  /// every block but the last a multiple of `blockAlignment` timesteps long,
+  /// and calls `fn(skel, start, end)` for each block on its own clone of this
+  /// Skeleton. The clones aren't this Skeleton, so `fn` has to look up any
+  /// bodies it needs on `skel` (by index, say) rather than capturing them.
+  /// With a single thread, `fn` runs on this Skeleton itself. Either way, the
+  /// positions, velocities and accelerations of this Skeleton are unchanged
+  /// afterwards.
+  void forEachTimestepBlock(
+      int numTimesteps,
+      int numThreads,
+      std::function<void(Skeleton*, int, int)> fn,
+      int blockAlignment = 1);
+
+  /// This is the same as above, but runs one block on each of the clones in
+  /// `threadSkels`, instead of cloning this Skeleton. If `threadSkels` has
+  /// fewer than two clones, this runs on this Skeleton.
+  void forEachTimestepBlock(
+      int numTimesteps,
+      const std::vector<std::shared_ptr<Skeleton>>& threadSkels,
+      std::function<void(Skeleton*, int, int)> fn,
+      int blockAlignment = 1);
+
   /// Constructor called by create()
   Skeleton(const AspectPropertiesData& _properties);
 
@@ -2852,6 +3098,10 @@ protected:
   /// List of Soft body node list in the skeleton
   std::vector<SoftBodyNode*> mSoftBodyNodes;
 
+  /// If true, the point masses of different SoftBodyNodes are integrated
+  /// concurrently
+  bool mParallelSoftBodyUpdates;
+
   /// NameManager for tracking BodyNodes
   dart::common::NameManager<BodyNode*> mNameMgrForBodyNodes;
 
@@ -2870,6 +3120,14 @@ protected:
   /// This is a cache for the data around our group scales
   std::vector<BodyScaleGroupAndIndex> mGroupScaleIndices;
 
+  /// This is a cache for getLinearizedMassesBodyMap(), rebuilt along with
+  /// mGroupScaleIndices
+  Eigen::SparseMatrix<s_t> mLinearizedMassesBodyMap;
+
+  /// This is a cache for getBodyScalesToGroupScalesMap(), rebuilt along with
+  /// mGroupScaleIndices
+  Eigen::SparseMatrix<s_t> mBodyScalesToGroupScalesMap;
+
   /// This is a cache for looking up meshes attached to bodies
   std::map<std::string, std::pair<dynamics::BodyNode*, Eigen::Isometry3s>>
       mMeshBodyCache;
@@ -126,6 +126,61 @@ SoftBodyNodeProperties::SoftBodyNodeProperties(
 
 } // namespace detail
 
+namespace {
+
+// The point mass buffers are swept as 3xN matrices, which relies on a
+// std::vector<Eigen::Vector3s> being laid out as tightly packed columns.
+static_assert(
+    sizeof(Eigen::Vector3s) == 3 * sizeof(s_t),
+    "Eigen::Vector3s must not be padded to view point mass buffers as 3xN");
+
+using PointMassColumns = Eigen::Map<Eigen::Matrix<s_t, 3, Eigen::Dynamic>>;
+
+//==============================================================================
+PointMassColumns asColumns(std::vector<Eigen::Vector3s>& _buffer)
+{
+  return PointMassColumns(
+      _buffer.empty() ? nullptr : _buffer.front().data(), 3, _buffer.size());
+}
+
+//==============================================================================
+template <typename Buffer>
+void resizeBuffer(Buffer& _buffer, std::size_t _numPointMasses)
+{
+  _buffer.resize(_numPointMasses, Eigen::Vector3s::Zero());
+}
+
+//==============================================================================
+void resizeScalarBuffer(Eigen::VectorXs& _buffer, std::size_t _numPointMasses)
+{
+  const std::size_t oldSize = _buffer.size();
+  _buffer.conservativeResize(_numPointMasses);
+  if (oldSize < _numPointMasses)
+    _buffer.tail(_numPointMasses - oldSize).setZero();
+}
+
+} // anonymous namespace
+
+//==============================================================================
+void SoftBodyNode::PointMassBuffers::resize(std::size_t _numPointMasses)
+{
+  resizeBuffer(mX, _numPointMasses);
+  resizeBuffer(mW, _numPointMasses);
+  resizeBuffer(mV, _numPointMasses);
+  resizeBuffer(mEta, _numPointMasses);
+  resizeBuffer(mA, _numPointMasses);
+  resizeBuffer(mF, _numPointMasses);
+  resizeBuffer(mB, _numPointMasses);
+  resizeBuffer(mAlpha, _numPointMasses);
+  resizeBuffer(mBeta, _numPointMasses);
+  resizeBuffer(mFext, _numPointMasses);
+  resizeScalarBuffer(mMasses, _numPointMasses);
+  resizeScalarBuffer(mPsi, _numPointMasses);
+  resizeScalarBuffer(mImplicitPsi, _numPointMasses);
+  resizeScalarBuffer(mPi, _numPointMasses);
+  resizeScalarBuffer(mImplicitPi, _numPointMasses);
+}
+
 //==============================================================================
 SoftBodyNode::~SoftBodyNode()
 {
@@ -295,6 +350,11 @@ void SoftBodyNode::configurePointMasses(ShapeNode* softNode)
   std::size_t newCount = softProperties.mPointProps.size();
   std::size_t oldCount = mPointMasses.size();
 
+  // addPointMass() creates its PointMass before calling this function, so the
+  // states and buffers must be kept in sync even when the count matches
+  mAspectState.mPointStates.resize(newCount, PointMass::State());
+  mPointMassBuffers.resize(newCount);
+
   if (newCount == oldCount)
     return;
 
@@ -316,10 +376,6 @@ void SoftBodyNode::configurePointMasses(ShapeNode* softNode)
     }
   }
 
-  // Resize the number of States in the Aspect
-  mAspectState.mPointStates.resize(
-      softProperties.mPointProps.size(), PointMass::State());
-
   // Access the SoftMeshShape and reallocate its meshes
   if (softNode)
   {
@@ -531,6 +587,38 @@ void SoftBodyNode::clearConstraintImpulse()
     mPointMasses.at(i)->clearConstraintImpulse();
 }
 
+//==============================================================================
+void SoftBodyNode::integratePointMassPositions(s_t _dt)
+{
+  integratePointMassPositionStates(_dt);
+
+  if (!mAspectState.mPointStates.empty())
+    mNotifier->dirtyTransform();
+}
+
+//==============================================================================
+void SoftBodyNode::integratePointMassVelocities(s_t _dt)
+{
+  integratePointMassVelocityStates(_dt);
+
+  if (!mAspectState.mPointStates.empty())
+    mNotifier->dirtyVelocity();
+}
+
+//==============================================================================
+void SoftBodyNode::integratePointMassPositionStates(s_t _dt)
+{
+  for (PointMass::State& state : mAspectState.mPointStates)
+    state.mPositions.noalias() += _dt * state.mVelocities;
+}
+
+//==============================================================================
+void SoftBodyNode::integratePointMassVelocityStates(s_t _dt)
+{
+  for (PointMass::State& state : mAspectState.mPointStates)
+    state.mVelocities.noalias() += _dt * state.mAccelerations;
+}
+
 //==============================================================================
 void SoftBodyNode::checkArticulatedInertiaUpdate() const
 {
@@ -544,8 +632,22 @@ void SoftBodyNode::updateTransform()
 {
   BodyNode::updateTransform();
 
-  for (std::size_t i = 0; i < mPointMasses.size(); ++i)
-    mPointMasses.at(i)->updateTransform();
+  // X = q + X0
+  const std::size_t numPointMasses = mPointMasses.size();
+  const std::vector<PointMass::State>& states = mAspectState.mPointStates;
+  const std::vector<PointMass::Properties>& props
+      = mAspectProperties.mPointProps;
+  std::vector<Eigen::Vector3s>& X = mPointMassBuffers.mX;
+  for (std::size_t i = 0; i < numPointMasses; ++i)
+    X[i] = states[i].mPositions + props[i].mX0;
+  assert(!math::isNan(asColumns(X)));
+
+  // W = R * X + p, done as a single 3x3 times 3xN product
+  const Eigen::Isometry3s& parentW = getWorldTransform();
+  PointMassColumns W = asColumns(mPointMassBuffers.mW);
+  W.noalias() = parentW.linear() * asColumns(X);
+  W.colwise() += parentW.translation();
+  assert(!math::isNan(W));
 
   mNotifier->clearTransformNotice();
 }
@@ -555,8 +657,19 @@ void SoftBodyNode::updateVelocity()
 {
   BodyNode::updateVelocity();
 
-  for (std::size_t i = 0; i < mPointMasses.size(); ++i)
-    mPointMasses.at(i)->updateVelocity();
+  if (mNotifier->needsTransformUpdate())
+    updateTransform();
+
+  // v = w(parent) x X + v(parent) + dq
+  const std::size_t numPointMasses = mPointMasses.size();
+  const std::vector<PointMass::State>& states = mAspectState.mPointStates;
+  const Eigen::Vector6s& v_parent = getSpatialVelocity();
+  PointMassColumns V = asColumns(mPointMassBuffers.mV);
+  V.noalias() = math::makeSkewSymmetric(v_parent.head<3>())
+                * asColumns(mPointMassBuffers.mX);
+  for (std::size_t i = 0; i < numPointMasses; ++i)
+    V.col(i) += v_parent.tail<3>() + states[i].mVelocities;
+  assert(!math::isNan(V));
 
   mNotifier->clearVelocityNotice();
 }
@@ -566,8 +679,14 @@ void SoftBodyNode::updatePartialAcceleration() const
 {
   BodyNode::updatePartialAcceleration();
 
-  for (std::size_t i = 0; i < mPointMasses.size(); ++i)
-    mPointMasses.at(i)->updatePartialAcceleration();
+  // eta = w(parent) x dq
+  const std::size_t numPointMasses = mPointMasses.size();
+  const std::vector<PointMass::State>& states = mAspectState.mPointStates;
+  const Eigen::Vector3s w_parent = getSpatialVelocity().head<3>();
+  std::vector<Eigen::Vector3s>& eta = mPointMassBuffers.mEta;
+  for (std::size_t i = 0; i < numPointMasses; ++i)
+    eta[i] = w_parent.cross(states[i].mVelocities);
+  assert(!math::isNan(asColumns(eta)));
 
   mNotifier->clearPartialAccelerationNotice();
 }
@@ -577,8 +696,22 @@ void SoftBodyNode::updateAccelerationID()
 {
   BodyNode::updateAccelerationID();
 
-  for (std::size_t i = 0; i < mPointMasses.size(); ++i)
-    mPointMasses.at(i)->updateAccelerationID();
+  if (mNotifier->needsTransformUpdate())
+    updateTransform();
+  if (mNotifier->needsPartialAccelerationUpdate())
+    updatePartialAcceleration();
+
+  // dv = dw(parent) x X + dv(parent) + eta + ddq
+  const std::size_t numPointMasses = mPointMasses.size();
+  const std::vector<PointMass::State>& states = mAspectState.mPointStates;
+  const std::vector<Eigen::Vector3s>& eta = mPointMassBuffers.mEta;
+  const Eigen::Vector6s& a_parent = getSpatialAcceleration();
+  PointMassColumns A = asColumns(mPointMassBuffers.mA);
+  A.noalias() = math::makeSkewSymmetric(a_parent.head<3>())
+                * asColumns(mPointMassBuffers.mX);
+  for (std::size_t i = 0; i < numPointMasses; ++i)
+    A.col(i) += a_parent.tail<3>() + eta[i] + states[i].mAccelerations;
+  assert(!math::isNan(A));
 
   mNotifier->clearAccelerationNotice();
 }
@@ -625,11 +758,13 @@ void SoftBodyNode::updateTransmittedForceID(
     mF += math::dAdInvT(
         childJoint->getRelativeTransform(), childBodyNode->getBodyForce());
   }
-  for (auto& pointMass : mPointMasses)
-  {
-    mF.head<3>() += pointMass->getLocalPosition().cross(pointMass->mF);
-    mF.tail<3>() += pointMass->mF;
-  }
+  if (mNotifier->needsTransformUpdate())
+    updateTransform();
+  const std::vector<Eigen::Vector3s>& pointMassX = mPointMassBuffers.mX;
+  const std::vector<Eigen::Vector3s>& pointMassF = mPointMassBuffers.mF;
+  for (std::size_t i = 0; i < mPointMasses.size(); ++i)
+    mF.head<3>() += pointMassX[i].cross(pointMassF[i]);
+  mF.tail<3>() += asColumns(mPointMassBuffers.mF).rowwise().sum();
 
   // Verification
   assert(!math::isNan(mF));
@@ -666,8 +801,30 @@ void SoftBodyNode::updateArtInertia(s_t _timeStep) const
 {
   const Eigen::Matrix6s& mI
       = BodyNode::mAspectProperties.mInertia.getSpatialTensor();
-  for (auto& pointMass : mPointMasses)
-    pointMass->updateArtInertiaFD(_timeStep);
+  // Psi and Pi of every point mass, as whole-array operations
+  const std::size_t numPointMasses = mPointMasses.size();
+  const std::vector<PointMass::Properties>& props
+      = mAspectProperties.mPointProps;
+  Eigen::VectorXs& masses = mPointMassBuffers.mMasses;
+  for (std::size_t i = 0; i < numPointMasses; ++i)
+    masses[i] = props[i].mMass;
+  const s_t implicitTerms
+      = _timeStep * getDampingCoefficient()
+        + _timeStep * _timeStep * getVertexSpringStiffness();
+  mPointMassBuffers.mPsi = masses.cwiseInverse();
+  mPointMassBuffers.mImplicitPsi
+      = (masses.array() + implicitTerms).inverse().matrix();
+  mPointMassBuffers.mPi
+      = (masses.array()
+         - masses.array().square() * mPointMassBuffers.mPsi.array())
+            .matrix();
+  mPointMassBuffers.mImplicitPi
+      = (masses.array()
+         - masses.array().square() * mPointMassBuffers.mImplicitPsi.array())
+            .matrix();
+  assert(!math::isNan(mPointMassBuffers.mImplicitPsi));
+  assert(!math::isNan(mPointMassBuffers.mPi));
+  assert(!math::isNan(mPointMassBuffers.mImplicitPi));
 
   assert(mParentJoint != nullptr);
 
@@ -686,11 +843,14 @@ void SoftBodyNode::updateArtInertia(s_t _timeStep) const
   }
 
   //
-  for (const auto& pointMass : mPointMasses)
+  if (mNotifier->needsTransformUpdate())
+    const_cast<SoftBodyNode*>(this)->updateTransform();
+  const std::vector<Eigen::Vector3s>& pointMassX = mPointMassBuffers.mX;
+  for (std::size_t i = 0; i < numPointMasses; ++i)
   {
-    _addPiToArtInertia(pointMass->getLocalPosition(), pointMass->mPi);
+    _addPiToArtInertia(pointMassX[i], mPointMassBuffers.mPi[i]);
     _addPiToArtInertiaImplicit(
-        pointMass->getLocalPosition(), pointMass->mImplicitPi);
+        pointMassX[i], mPointMassBuffers.mImplicitPi[i]);
   }
 
   // Verification
@@ -748,12 +908,13 @@ void SoftBodyNode::updateBiasForce(
   }
 
   //
-  for (const auto& pointMass : mPointMasses)
-  {
-    mBiasForce.head<3>()
-        += pointMass->getLocalPosition().cross(pointMass->mBeta);
-    mBiasForce.tail<3>() += pointMass->mBeta;
-  }
+  if (mNotifier->needsTransformUpdate())
+    updateTransform();
+  const std::vector<Eigen::Vector3s>& pointMassX = mPointMassBuffers.mX;
+  const std::vector<Eigen::Vector3s>& pointMassBeta = mPointMassBuffers.mBeta;
+  for (std::size_t i = 0; i < mPointMasses.size(); ++i)
+    mBiasForce.head<3>() += pointMassX[i].cross(pointMassBeta[i]);
+  mBiasForce.tail<3>() += asColumns(mPointMassBuffers.mBeta).rowwise().sum();
 
   // Verifycation
   assert(!math::isNan(mBiasForce));
@@ -1226,8 +1387,10 @@ void SoftBodyNode::aggregateExternalForces(Eigen::VectorXs& _Fext)
        it != mPointMasses.end();
        ++it)
   {
-    mFext_F.head<3>() += (*it)->getLocalPosition().cross((*it)->mFext);
-    mFext_F.tail<3>() += (*it)->mFext;
+    const Eigen::Vector3s& fext
+        = mPointMassBuffers.mFext[(*it)->getIndexInSoftBodyNode()];
+    mFext_F.head<3>() += (*it)->getLocalPosition().cross(fext);
+    mFext_F.tail<3>() += fext;
   }
 
   int nGenCoords = mParentJoint->getNumDofs();
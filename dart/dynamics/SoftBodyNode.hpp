@@ -151,7 +151,22 @@ public:
   // Documentation inherited.
   void clearConstraintImpulse() override;
 
+  /// Integrate the positions of all the point masses of this SoftBodyNode in a
+  /// single sweep over their states
+  void integratePointMassPositions(s_t _dt);
+
+  /// Integrate the velocities of all the point masses of this SoftBodyNode in
+  /// a single sweep over their states
+  void integratePointMassVelocities(s_t _dt);
+
 protected:
+  /// Sweep the point mass positions forward without dirtying any caches. This
+  /// touches nothing outside this SoftBodyNode, so the Skeleton can run it for
+  /// several SoftBodyNodes concurrently and notify afterwards.
+  void integratePointMassPositionStates(s_t _dt);
+
+  /// Sweep the point mass velocities forward without dirtying any caches
+  void integratePointMassVelocityStates(s_t _dt);
 
   /// Constructor called by Skeleton class
   SoftBodyNode(BodyNode* _parentBodyNode, Joint* _parentJoint,
@@ -296,9 +311,68 @@ protected:
 
 protected:
 
+  /// Structure-of-arrays storage for the quantities that the recursive
+  /// dynamics routines compute for the point masses. Entry i of every buffer
+  /// belongs to the PointMass whose index is i, so each pass can sweep one
+  /// contiguous array instead of visiting the PointMass objects one by one.
+  struct PointMassBuffers
+  {
+    /// Current positions viewed in this SoftBodyNode's frame
+    std::vector<Eigen::Vector3s> mX;
+
+    /// Current positions viewed in the world frame
+    std::vector<Eigen::Vector3s> mW;
+
+    /// Current velocities viewed in this SoftBodyNode's frame
+    std::vector<Eigen::Vector3s> mV;
+
+    /// Partial accelerations
+    std::vector<Eigen::Vector3s> mEta;
+
+    /// Current accelerations viewed in this SoftBodyNode's frame
+    std::vector<Eigen::Vector3s> mA;
+
+    /// Transmitted forces
+    std::vector<Eigen::Vector3s> mF;
+
+    /// Bias forces
+    std::vector<Eigen::Vector3s> mB;
+
+    /// Cache data for the bias forces
+    std::vector<Eigen::Vector3s> mAlpha;
+
+    /// Cache data for the bias forces
+    std::vector<Eigen::Vector3s> mBeta;
+
+    /// External forces
+    std::vector<Eigen::Vector3s> mFext;
+
+    /// Masses, gathered from the point mass properties
+    Eigen::VectorXs mMasses;
+
+    /// Inverse of the masses
+    Eigen::VectorXs mPsi;
+
+    /// Inverse of the masses augmented with implicit damping and stiffness
+    Eigen::VectorXs mImplicitPsi;
+
+    /// Articulated inertia contributions
+    Eigen::VectorXs mPi;
+
+    /// Articulated inertia contributions with implicit damping and stiffness
+    Eigen::VectorXs mImplicitPi;
+
+    /// Resize every buffer to hold _numPointMasses entries. New entries are
+    /// zero-initialized, existing entries are preserved.
+    void resize(std::size_t _numPointMasses);
+  };
+
   /// \brief List of point masses composing deformable mesh.
   std::vector<PointMass*> mPointMasses;
 
+  /// Contiguous per-point-mass dynamics quantities, indexed like mPointMasses
+  mutable PointMassBuffers mPointMassBuffers;
+
   /// An Entity which tracks when the point masses need to be updated
   PointMassNotifier* mNotifier;
 
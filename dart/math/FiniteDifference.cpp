@@ -3,6 +3,8 @@
 #include <array>
 #include <exception>
 #include <iostream>
+#include <limits>
+#include <random>
 
 using namespace dart;
 
@@ -581,6 +583,67 @@ void finiteDifference(
   return;
 }
 
+//==============================================================================
+s_t checkJacobianAlongRandomDirections(
+    std::function<Eigen::VectorXs(const Eigen::VectorXs& x)> eval,
+    std::function<Eigen::VectorXs(const Eigen::VectorXs& direction)> jvp,
+    const Eigen::VectorXs& x,
+    int numDirections,
+    s_t eps)
+{
+  if (x.size() == 0)
+    return 0.0;
+
+  // This has its own generator, rather than using math::Random, so that
+  // turning the check on doesn't perturb anyone else's random numbers
+  static thread_local std::mt19937 generator(20210412u);
+  std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+
+  s_t worstError = 0.0;
+  for (int i = 0; i < numDirections; i++)
+  {
+    Eigen::VectorXs direction(x.size());
+    for (int j = 0; j < x.size(); j++)
+      direction(j) = distribution(generator);
+    s_t norm = direction.norm();
+    if (norm == 0)
+      continue;
+    direction /= norm;
+
+    Eigen::VectorXs plus = eval(x + eps * direction);
+    Eigen::VectorXs minus = eval(x - eps * direction);
+    Eigen::VectorXs fd = (plus - minus) / (2 * eps);
+    Eigen::VectorXs analytical = jvp(direction);
+
+    s_t scale = std::max((s_t)1.0, std::max(fd.norm(), analytical.norm()));
+    s_t error = (fd - analytical).norm() / scale;
+    if (!isfinite(error))
+      return std::numeric_limits<s_t>::infinity();
+    worstError = std::max(worstError, error);
+  }
+  return worstError;
+}
+
+//==============================================================================
+s_t checkGradientAlongRandomDirections(
+    std::function<s_t(const Eigen::VectorXs& x)> eval,
+    const Eigen::VectorXs& gradient,
+    const Eigen::VectorXs& x,
+    int numDirections,
+    s_t eps)
+{
+  return checkJacobianAlongRandomDirections(
+      [&](const Eigen::VectorXs& point) {
+        return Eigen::VectorXs::Constant(1, eval(point));
+      },
+      [&](const Eigen::VectorXs& direction) {
+        return Eigen::VectorXs::Constant(1, gradient.dot(direction));
+      },
+      x,
+      numDirections,
+      eps);
+}
+
 //==============================================================================
 // Explicit instantiations
 template void finiteDifference<Eigen::MatrixXs>(
@@ -63,6 +63,35 @@ void finiteDifference(
     s_t eps = 1e-7,
     bool useRidders = false);
 
+/// Checks an analytical Jacobian against central differences along
+/// `numDirections` random unit directions, rather than perturbing every input
+/// one at a time. `eval` evaluates the function at a point, and `jvp` returns
+/// the analytical Jacobian at `x` times a direction. Returns the largest error
+/// seen, relative to the size of the derivative (or absolute, for derivatives
+/// smaller than 1).
+///
+/// This costs 2 * numDirections calls to `eval` no matter how big `x` is,
+/// which makes it cheap enough to leave on in production, which is what the
+/// setRandomDerivativeCheck() options on the optimizers are for. The
+/// directions come from a generator private to this function (one per
+/// thread, with a fixed seed), so turning the check on doesn't change the
+/// numbers math::Random hands out to the rest of the code.
+s_t checkJacobianAlongRandomDirections(
+    std::function<Eigen::VectorXs(const Eigen::VectorXs& x)> eval,
+    std::function<Eigen::VectorXs(const Eigen::VectorXs& direction)> jvp,
+    const Eigen::VectorXs& x,
+    int numDirections = 1,
+    s_t eps = 1e-6);
+
+/// The scalar version of checkJacobianAlongRandomDirections(), where the
+/// analytical directional derivative is just `gradient.dot(direction)`.
+s_t checkGradientAlongRandomDirections(
+    std::function<s_t(const Eigen::VectorXs& x)> eval,
+    const Eigen::VectorXs& gradient,
+    const Eigen::VectorXs& x,
+    int numDirections = 1,
+    s_t eps = 1e-6);
+
 struct non_differentiable_point_exception : public std::exception
 {
   const char* what() const throw()
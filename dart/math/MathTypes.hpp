@@ -78,6 +78,7 @@ using Vector6d = Matrix<double, 6, 1>;
 
 typedef Matrix<s_t, Dynamic, Dynamic> MatrixXs;
 typedef Matrix<s_t, Dynamic, 1> VectorXs;
+typedef Matrix<bool, Dynamic, Dynamic> MatrixXb;
 typedef Matrix<s_t, 1, 1> Vector1s;
 typedef Matrix<s_t, 2, 1> Vector2s;
 typedef Matrix<s_t, 3, 1> Vector3s;
@@ -1,5 +1,8 @@
 #include "dart/neural/IKMapping.hpp"
 
+#include <algorithm>
+#include <future>
+
 #include "dart/dynamics/BodyNode.hpp"
 #include "dart/dynamics/Frame.hpp"
 #include "dart/dynamics/Skeleton.hpp"
@@ -90,9 +93,26 @@ void IKMapping::setPositions(
   // Reset to 0, so that solutions are always deterministic even if IK is
   // under/over specified
   world->setPositions(Eigen::VectorXs::Zero(world->getNumDofs()));
+  solvePositionsIK(world, positions);
+}
+
+//==============================================================================
+void IKMapping::setPositionsWarmStart(
+    std::shared_ptr<simulation::World> world,
+    const Eigen::Ref<Eigen::VectorXs>& positions,
+    const Eigen::VectorXs& initialGuess)
+{
+  world->setPositions(initialGuess);
+  solvePositionsIK(world, positions);
+}
 
+//==============================================================================
+void IKMapping::solvePositionsIK(
+    std::shared_ptr<simulation::World> world,
+    const Eigen::Ref<Eigen::VectorXs>& positions)
+{
   math::solveIK(
-      Eigen::VectorXs::Zero(world->getNumDofs()),
+      world->getPositions(),
       world->getPositionUpperLimits(),
       world->getPositionLowerLimits(),
       positions.size(),
@@ -521,6 +541,197 @@ Eigen::MatrixXs IKMapping::bruteForceJacobianOfJacVelWrtPosition(
   return jac;
 }
 
+//==============================================================================
+Eigen::MatrixXs IKMapping::getMappedPositionsTrajectory(
+    std::shared_ptr<simulation::World> world,
+    const Eigen::MatrixXs& realPositions,
+    int numThreads)
+{
+  Eigen::MatrixXs mapped
+      = Eigen::MatrixXs::Zero(getPosDim(), realPositions.cols());
+  forEachTimestepBlock(
+      world,
+      realPositions.cols(),
+      numThreads,
+      [this, &realPositions, &mapped](
+          std::shared_ptr<simulation::World> threadWorld, int start, int end) {
+        for (int t = start; t < end; t++)
+        {
+          threadWorld->setPositions(realPositions.col(t));
+          getPositionsInPlace(threadWorld, mapped.col(t));
+        }
+      });
+  return mapped;
+}
+
+//==============================================================================
+Eigen::MatrixXs IKMapping::getMappedVelocitiesTrajectory(
+    std::shared_ptr<simulation::World> world,
+    const Eigen::MatrixXs& realPositions,
+    const Eigen::MatrixXs& realVelocities,
+    int numThreads)
+{
+  assert(realPositions.cols() == realVelocities.cols());
+  Eigen::MatrixXs mapped
+      = Eigen::MatrixXs::Zero(getVelDim(), realPositions.cols());
+  forEachTimestepBlock(
+      world,
+      realPositions.cols(),
+      numThreads,
+      [this, &realPositions, &realVelocities, &mapped](
+          std::shared_ptr<simulation::World> threadWorld, int start, int end) {
+        for (int t = start; t < end; t++)
+        {
+          threadWorld->setPositions(realPositions.col(t));
+          threadWorld->setVelocities(realVelocities.col(t));
+          getVelocitiesInPlace(threadWorld, mapped.col(t));
+        }
+      });
+  return mapped;
+}
+
+//==============================================================================
+Eigen::MatrixXs IKMapping::getRealPositionsTrajectory(
+    std::shared_ptr<simulation::World> world,
+    const Eigen::MatrixXs& mappedPositions,
+    int numThreads)
+{
+  Eigen::MatrixXs real
+      = Eigen::MatrixXs::Zero(world->getNumDofs(), mappedPositions.cols());
+  forEachTimestepBlock(
+      world,
+      mappedPositions.cols(),
+      numThreads,
+      [this, &mappedPositions, &real](
+          std::shared_ptr<simulation::World> threadWorld, int start, int end) {
+        for (int t = start; t < end; t++)
+        {
+          Eigen::VectorXs target = mappedPositions.col(t);
+          if (t == start)
+          {
+            setPositions(threadWorld, target);
+          }
+          else
+          {
+            setPositionsWarmStart(threadWorld, target, real.col(t - 1));
+          }
+          real.col(t) = threadWorld->getPositions();
+        }
+      });
+  return real;
+}
+
+//==============================================================================
+Eigen::MatrixXs IKMapping::getRealVelocitiesTrajectory(
+    std::shared_ptr<simulation::World> world,
+    const Eigen::MatrixXs& realPositions,
+    const Eigen::MatrixXs& mappedVelocities,
+    int numThreads)
+{
+  assert(realPositions.cols() == mappedVelocities.cols());
+  Eigen::MatrixXs real
+      = Eigen::MatrixXs::Zero(world->getNumDofs(), realPositions.cols());
+  forEachTimestepBlock(
+      world,
+      realPositions.cols(),
+      numThreads,
+      [this, &realPositions, &mappedVelocities, &real](
+          std::shared_ptr<simulation::World> threadWorld, int start, int end) {
+        for (int t = start; t < end; t++)
+        {
+          threadWorld->setPositions(realPositions.col(t));
+          real.col(t)
+              = getVelJacobianInverse(threadWorld) * mappedVelocities.col(t);
+        }
+      });
+  return real;
+}
+
+//==============================================================================
+Eigen::MatrixXs IKMapping::getRealPosToMappedPosJacTrajectory(
+    std::shared_ptr<simulation::World> world,
+    const Eigen::MatrixXs& realPositions,
+    int numThreads)
+{
+  const int dim = getPosDim();
+  Eigen::MatrixXs jacs = Eigen::MatrixXs::Zero(
+      dim * realPositions.cols(), world->getNumDofs());
+  forEachTimestepBlock(
+      world,
+      realPositions.cols(),
+      numThreads,
+      [this, dim, &realPositions, &jacs](
+          std::shared_ptr<simulation::World> threadWorld, int start, int end) {
+        for (int t = start; t < end; t++)
+        {
+          threadWorld->setPositions(realPositions.col(t));
+          jacs.block(t * dim, 0, dim, jacs.cols())
+              = getRealPosToMappedPosJac(threadWorld);
+        }
+      });
+  return jacs;
+}
+
+//==============================================================================
+Eigen::MatrixXs IKMapping::getRealVelToMappedVelJacTrajectory(
+    std::shared_ptr<simulation::World> world,
+    const Eigen::MatrixXs& realPositions,
+    int numThreads)
+{
+  const int dim = getVelDim();
+  Eigen::MatrixXs jacs = Eigen::MatrixXs::Zero(
+      dim * realPositions.cols(), world->getNumDofs());
+  forEachTimestepBlock(
+      world,
+      realPositions.cols(),
+      numThreads,
+      [this, dim, &realPositions, &jacs](
+          std::shared_ptr<simulation::World> threadWorld, int start, int end) {
+        for (int t = start; t < end; t++)
+        {
+          threadWorld->setPositions(realPositions.col(t));
+          jacs.block(t * dim, 0, dim, jacs.cols())
+              = getRealVelToMappedVelJac(threadWorld);
+        }
+      });
+  return jacs;
+}
+
+//==============================================================================
+void IKMapping::forEachTimestepBlock(
+    std::shared_ptr<simulation::World> world,
+    int numTimesteps,
+    int numThreads,
+    std::function<void(std::shared_ptr<simulation::World>, int, int)> fn)
+{
+  numThreads = std::max(1, std::min(numThreads, numTimesteps));
+  if (numThreads == 1)
+  {
+    RestorableSnapshot snapshot(world);
+    fn(world, 0, numTimesteps);
+    snapshot.restore();
+    return;
+  }
+
+  // Each thread gets a contiguous block of timesteps, so that IK can be warm
+  // started from the previous timestep within the block.
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < numThreads; i++)
+  {
+    const int start = (int)((long)numTimesteps * i / numThreads);
+    const int end = (int)((long)numTimesteps * (i + 1) / numThreads);
+    std::shared_ptr<simulation::World> threadWorld = world->clone();
+    futures.push_back(
+        std::async(std::launch::async, [fn, threadWorld, start, end]() {
+          fn(threadWorld, start, end);
+        }));
+  }
+  for (auto& future : futures)
+  {
+    future.get();
+  }
+}
+
 //==============================================================================
 Eigen::VectorXs IKMapping::getPositionLowerLimits(
     std::shared_ptr<simulation::World> /* world */)
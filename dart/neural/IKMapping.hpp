@@ -1,6 +1,7 @@
 #ifndef DART_NEURAL_IK_MAPPING_HPP_
 #define DART_NEURAL_IK_MAPPING_HPP_
 
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -127,6 +128,67 @@ public:
   Eigen::MatrixXs getRealMassToMappedMassJac(
       std::shared_ptr<simulation::World> world) override;
 
+  /// This runs the same IK solve as setPositions(), but starts from
+  /// `initialGuess` instead of from zero. When the target is close to the
+  /// pose that produced `initialGuess` (for example, the previous timestep of
+  /// a trajectory) this converges in far fewer iterations.
+  void setPositionsWarmStart(
+      std::shared_ptr<simulation::World> world,
+      const Eigen::Ref<Eigen::VectorXs>& positions,
+      const Eigen::VectorXs& initialGuess);
+
+  /// This maps a whole trajectory of "real" positions, one timestep per
+  /// column, to the corresponding "mapped" positions. Timesteps are split
+  /// across `numThreads` clones of the world. The state of `world` is left
+  /// unchanged.
+  Eigen::MatrixXs getMappedPositionsTrajectory(
+      std::shared_ptr<simulation::World> world,
+      const Eigen::MatrixXs& realPositions,
+      int numThreads = 1);
+
+  /// This maps a whole trajectory of "real" velocities to "mapped"
+  /// velocities. The Jacobians depend on the positions, so the "real"
+  /// positions at each timestep are needed as well.
+  Eigen::MatrixXs getMappedVelocitiesTrajectory(
+      std::shared_ptr<simulation::World> world,
+      const Eigen::MatrixXs& realPositions,
+      const Eigen::MatrixXs& realVelocities,
+      int numThreads = 1);
+
+  /// This solves IK for a whole trajectory of "mapped" positions, returning
+  /// the "real" positions, one timestep per column. The trajectory is split
+  /// into `numThreads` contiguous blocks. The first timestep of each block is
+  /// solved from zero, exactly like setPositions(), and every later timestep
+  /// is warm-started from the solution of the timestep before it.
+  Eigen::MatrixXs getRealPositionsTrajectory(
+      std::shared_ptr<simulation::World> world,
+      const Eigen::MatrixXs& mappedPositions,
+      int numThreads = 1);
+
+  /// This converts a whole trajectory of "mapped" velocities back into "real"
+  /// velocities, given the "real" positions at each timestep.
+  Eigen::MatrixXs getRealVelocitiesTrajectory(
+      std::shared_ptr<simulation::World> world,
+      const Eigen::MatrixXs& realPositions,
+      const Eigen::MatrixXs& mappedVelocities,
+      int numThreads = 1);
+
+  /// This returns getRealPosToMappedPosJac() at every timestep of the
+  /// trajectory, stacked vertically, so block `t` is rows
+  /// [t * getPosDim(), (t + 1) * getPosDim()).
+  Eigen::MatrixXs getRealPosToMappedPosJacTrajectory(
+      std::shared_ptr<simulation::World> world,
+      const Eigen::MatrixXs& realPositions,
+      int numThreads = 1);
+
+  /// This returns getRealVelToMappedVelJac() at every timestep of the
+  /// trajectory, stacked vertically, so block `t` is rows
+  /// [t * getVelDim(), (t + 1) * getVelDim()).
+  Eigen::MatrixXs getRealVelToMappedVelJacTrajectory(
+      std::shared_ptr<simulation::World> world,
+      const Eigen::MatrixXs& realPositions,
+      int numThreads = 1);
+
   Eigen::VectorXs getPositionLowerLimits(
       std::shared_ptr<simulation::World> world) override;
   Eigen::VectorXs getPositionUpperLimits(
@@ -172,6 +234,22 @@ protected:
   Eigen::MatrixXs bruteForceJacobianOfJacVelWrtPosition(
       std::shared_ptr<simulation::World> world);
 
+  /// Runs the IK solve behind setPositions(), starting from whatever
+  /// positions `world` currently has.
+  void solvePositionsIK(
+      std::shared_ptr<simulation::World> world,
+      const Eigen::Ref<Eigen::VectorXs>& positions);
+
+  /// Splits [0, numTimesteps) into `numThreads` contiguous blocks, and calls
+  /// `fn(world, start, end)` for each block on its own clone of `world`. With
+  /// a single thread this runs on `world` itself, and restores its state
+  /// afterwards.
+  void forEachTimestepBlock(
+      std::shared_ptr<simulation::World> world,
+      int numTimesteps,
+      int numThreads,
+      std::function<void(std::shared_ptr<simulation::World>, int, int)> fn);
+
   std::vector<IKMappingEntry> mEntries;
 
   int mMassDim;
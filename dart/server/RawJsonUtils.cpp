@@ -1,12 +1,48 @@
 #include "dart/server/RawJsonUtils.hpp"
 
+#include <cstdio>
+
 namespace dart {
 
 //==============================================================================
 std::string escapeJson(const std::string& str)
 {
-  // TODO
-  return str;
+  std::string escaped;
+  escaped.reserve(str.size());
+  for (char c : str)
+  {
+    switch (c)
+    {
+      case '"':
+        escaped += "\\\"";
+        break;
+      case '\\':
+        escaped += "\\\\";
+        break;
+      case '\n':
+        escaped += "\\n";
+        break;
+      case '\r':
+        escaped += "\\r";
+        break;
+      case '\t':
+        escaped += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+        {
+          // Any other control character has to be written as a \u escape
+          char buf[8];
+          std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+          escaped += buf;
+        }
+        else
+        {
+          escaped += c;
+        }
+    }
+  }
+  return escaped;
 }
 
 //==============================================================================
@@ -81,4 +117,35 @@ void vecToJson(std::stringstream& json, const std::vector<s_t>& vec)
   json << "]";
 }
 
+//==============================================================================
+void appendNumberToJson(std::string& json, s_t number)
+{
+  if (!isfinite(number))
+  {
+    json += '0';
+    return;
+  }
+  // Same formatting as std::to_string(double), which numberToJson() uses
+  char buf[64];
+  int len = std::snprintf(buf, sizeof(buf), "%f", (double)number);
+  if (len < 0 || len >= (int)sizeof(buf))
+  {
+    json += numberToJson(number);
+    return;
+  }
+  json.append(buf, len);
+}
+
+//==============================================================================
+void appendVec3ToJson(std::string& json, const Eigen::Vector3s& vec)
+{
+  json += '[';
+  appendNumberToJson(json, vec(0));
+  json += ',';
+  appendNumberToJson(json, vec(1));
+  json += ',';
+  appendNumberToJson(json, vec(2));
+  json += ']';
+}
+
 } // namespace dart
\ No newline at end of file
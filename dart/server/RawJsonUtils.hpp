@@ -2,6 +2,7 @@
 #define DART_JSON_UTILS
 
 #include <sstream>
+#include <string>
 #include <vector>
 
 #include <Eigen/Dense>
@@ -19,6 +20,11 @@ void vec3iToJson(std::stringstream& json, const Eigen::Vector3i& vec);
 void vecXToJson(std::stringstream& json, const Eigen::VectorXs& vec);
 void vecToJson(std::stringstream& json, const std::vector<s_t>& vec);
 
+// These append to an existing string without any temporary allocations, which
+// is useful when the same buffer gets reused across many exports.
+void appendNumberToJson(std::string& json, s_t number);
+void appendVec3ToJson(std::string& json, const Eigen::Vector3s& vec);
+
 } // namespace dart
 
 #endif
\ No newline at end of file
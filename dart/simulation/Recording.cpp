@@ -40,23 +40,41 @@
 
 #include <iostream>
 
+#include "dart/common/Console.hpp"
 #include "dart/dynamics/Skeleton.hpp"
+#include "dart/simulation/detail/RecordingBuffer.hpp"
 
 namespace dart {
 namespace simulation {
 
 //==============================================================================
 Recording::Recording(const std::vector<dynamics::SkeletonPtr>& _skeletons)
+  : mConfigs(new detail::RecordingBuffer()),
+    mContacts(new detail::RecordingBuffer()),
+    mContactOffsets(1, 0),
+    mTotalNumDofs(0),
+    mMaxResidentBytes(0),
+    mReleasedConfigs(0),
+    mReleasedContacts(0)
 {
   for (std::size_t i = 0; i < _skeletons.size(); i++)
     mNumGenCoordsForSkeletons.push_back(_skeletons[i]->getNumDofs());
+  updateDofOffsets();
 }
 
 //==============================================================================
 Recording::Recording(const std::vector<int>& _skelDofs)
+  : mConfigs(new detail::RecordingBuffer()),
+    mContacts(new detail::RecordingBuffer()),
+    mContactOffsets(1, 0),
+    mTotalNumDofs(0),
+    mMaxResidentBytes(0),
+    mReleasedConfigs(0),
+    mReleasedContacts(0)
 {
   for (std::size_t i = 0; i < _skelDofs.size(); i++)
     mNumGenCoordsForSkeletons.push_back(_skelDofs[i]);
+  updateDofOffsets();
 }
 
 //==============================================================================
@@ -67,7 +85,7 @@ Recording::~Recording()
 //==============================================================================
 int Recording::getNumFrames() const
 {
-  return mBakedStates.size();
+  return mContactOffsets.size() - 1;
 }
 
 //==============================================================================
@@ -82,71 +100,188 @@ int Recording::getNumDofs(int _skelIdx) const
   return mNumGenCoordsForSkeletons[_skelIdx];
 }
 
+//==============================================================================
+int Recording::getTotalNumDofs() const
+{
+  return mTotalNumDofs;
+}
+
 //==============================================================================
 int Recording::getNumContacts(int _frameIdx) const
 {
-  int totalDofs = 0;
-  for (std::size_t i = 0; i < mNumGenCoordsForSkeletons.size(); i++)
-    totalDofs += mNumGenCoordsForSkeletons[i];
-  return (mBakedStates[_frameIdx].size() - totalDofs) / 6;
+  return mContactOffsets[_frameIdx + 1] - mContactOffsets[_frameIdx];
 }
 
 //==============================================================================
-Eigen::VectorXs Recording::getConfig(int _frameIdx, int _skelIdx) const
+Eigen::Map<const Eigen::VectorXs> Recording::getConfig(
+    int _frameIdx, int _skelIdx) const
 {
-  int index = 0;
-  for (int i = 0; i < _skelIdx; i++)
-    index += mNumGenCoordsForSkeletons[i];
-  return mBakedStates[_frameIdx].segment(index, getNumDofs(_skelIdx));
+  return Eigen::Map<const Eigen::VectorXs>(
+      mConfigs->data()
+          + static_cast<std::size_t>(_frameIdx) * mTotalNumDofs
+          + mDofOffsets[_skelIdx],
+      getNumDofs(_skelIdx));
+}
+
+//==============================================================================
+Eigen::Map<const Eigen::MatrixXs> Recording::getConfigs() const
+{
+  return Eigen::Map<const Eigen::MatrixXs>(
+      mConfigs->data(), mTotalNumDofs, getNumFrames());
 }
 
 //==============================================================================
 s_t Recording::getGenCoord(int _frameIdx, int _skelIdx, int _dofIdx) const
 {
-  int index = 0;
-  for (int i = 0; i < _skelIdx; i++)
-    index += mNumGenCoordsForSkeletons[i];
-  return mBakedStates[_frameIdx][index + _dofIdx];
+  return mConfigs->data()
+      [static_cast<std::size_t>(_frameIdx) * mTotalNumDofs
+       + mDofOffsets[_skelIdx] + _dofIdx];
+}
+
+//==============================================================================
+Eigen::Map<const Eigen::Vector3s> Recording::getContactPoint(
+    int _frameIdx, int _contactIdx) const
+{
+  return Eigen::Map<const Eigen::Vector3s>(
+      mContacts->data() + (mContactOffsets[_frameIdx] + _contactIdx) * 6);
 }
 
 //==============================================================================
-Eigen::Vector3s Recording::getContactPoint(int _frameIdx, int _contactIdx) const
+Eigen::Map<const Eigen::Vector3s> Recording::getContactForce(
+    int _frameIdx, int _contactIdx) const
 {
-  int totalDofs = 0;
-  for (std::size_t i = 0; i < mNumGenCoordsForSkeletons.size(); i++)
-    totalDofs += mNumGenCoordsForSkeletons[i];
-  return mBakedStates[_frameIdx].segment(totalDofs + _contactIdx * 6, 3);
+  return Eigen::Map<const Eigen::Vector3s>(
+      mContacts->data() + (mContactOffsets[_frameIdx] + _contactIdx) * 6 + 3);
 }
 
 //==============================================================================
-Eigen::Vector3s Recording::getContactForce(int _frameIdx, int _contactIdx) const
+void Recording::clear()
 {
-  int totalDofs = 0;
-  for (std::size_t i = 0; i < mNumGenCoordsForSkeletons.size(); i++)
-    totalDofs += mNumGenCoordsForSkeletons[i];
-  return mBakedStates[_frameIdx].segment(totalDofs + _contactIdx * 6 + 3, 3);
+  mConfigs->clear();
+  mContacts->clear();
+  mContactOffsets.assign(1, 0);
+  mReleasedConfigs = 0;
+  mReleasedContacts = 0;
 }
 
 //==============================================================================
-void Recording::clear() {
-  mBakedStates.clear();
+void Recording::reserve(int _numFrames)
+{
+  mConfigs->reserve(static_cast<std::size_t>(_numFrames) * mTotalNumDofs);
+  mContactOffsets.reserve(_numFrames + 1);
 }
 
 //==============================================================================
 void Recording::addState(const Eigen::VectorXs& _state)
 {
-  mBakedStates.push_back(_state);
+  if (_state.size() < mTotalNumDofs || (_state.size() - mTotalNumDofs) % 6 != 0)
+  {
+    dterr << "[Recording::addState] The size of the state ("
+          << _state.size() << ") must be the total number of dofs ("
+          << mTotalNumDofs << ") plus 6 values per contact. Ignoring it.\n";
+    return;
+  }
+
+  // A frame only counts once both of its halves are stored, so that a failed
+  // append can't leave the buffers and mContactOffsets out of step
+  const std::size_t numContacts = (_state.size() - mTotalNumDofs) / 6;
+  const std::size_t numConfigs = mConfigs->size();
+  if (!mConfigs->append(_state.data(), mTotalNumDofs))
+    return;
+  if (!mContacts->append(_state.data() + mTotalNumDofs, 6 * numContacts))
+  {
+    mConfigs->truncate(numConfigs);
+    return;
+  }
+  mContactOffsets.push_back(mContactOffsets.back() + numContacts);
+
+  if (mConfigs->isMapped())
+    releaseResidentFrames();
 }
 
 //==============================================================================
 void Recording::updateNumGenCoords(
     const std::vector<dynamics::SkeletonPtr>& _skeletons)
 {
+  const int oldTotalNumDofs = mTotalNumDofs;
+
   mNumGenCoordsForSkeletons.clear();
   for (std::size_t i = 0; i < _skeletons.size(); ++i)
     mNumGenCoordsForSkeletons.push_back(_skeletons[i]->getNumDofs());
+  updateDofOffsets();
+
+  if (mTotalNumDofs != oldTotalNumDofs && getNumFrames() > 0)
+  {
+    dtwarn << "[Recording::updateNumGenCoords] The total number of dofs "
+           << "changed from " << oldTotalNumDofs << " to " << mTotalNumDofs
+           << ". Clearing the " << getNumFrames() << " recorded frames.\n";
+    clear();
+  }
 }
 
-}  // namespace simulation
-}  // namespace dart
+//==============================================================================
+bool Recording::setMemoryMappedFile(
+    const std::string& _path, std::size_t _maxResidentBytes)
+{
+  if (!detail::RecordingBuffer::supportsMemoryMapping())
+  {
+    dtwarn << "[Recording::setMemoryMappedFile] Memory-mapped recordings are "
+           << "not supported in this build. The recording stays in memory.\n";
+    return false;
+  }
+
+  if (!mConfigs->mapToFile(_path + ".configs"))
+    return false;
+  if (!mContacts->mapToFile(_path + ".contacts"))
+  {
+    // Don't leave the configs mapped with the contacts on the heap
+    mConfigs->moveToHeap();
+    mReleasedConfigs = 0;
+    mReleasedContacts = 0;
+    return false;
+  }
+
+  mMaxResidentBytes = _maxResidentBytes;
+  mReleasedConfigs = 0;
+  mReleasedContacts = 0;
+  releaseResidentFrames();
+  return true;
+}
+
+//==============================================================================
+void Recording::flush()
+{
+  mConfigs->flush();
+  mContacts->flush();
+}
+
+//==============================================================================
+void Recording::updateDofOffsets()
+{
+  mDofOffsets.resize(mNumGenCoordsForSkeletons.size());
+  mTotalNumDofs = 0;
+  for (std::size_t i = 0; i < mNumGenCoordsForSkeletons.size(); ++i)
+  {
+    mDofOffsets[i] = mTotalNumDofs;
+    mTotalNumDofs += mNumGenCoordsForSkeletons[i];
+  }
+}
+
+//==============================================================================
+void Recording::releaseResidentFrames()
+{
+  const std::size_t residentBytes
+      = (mConfigs->size() - mReleasedConfigs
+         + mContacts->size() - mReleasedContacts)
+        * sizeof(s_t);
+  if (residentBytes <= mMaxResidentBytes)
+    return;
+
+  mConfigs->release(mConfigs->size());
+  mContacts->release(mContacts->size());
+  mReleasedConfigs = mConfigs->size();
+  mReleasedContacts = mContacts->size();
+}
 
+} // namespace simulation
+} // namespace dart
@@ -39,6 +39,8 @@
 #ifndef DART_SIMULATION_RECORDING_HPP_
 #define DART_SIMULATION_RECORDING_HPP_
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include <Eigen/Dense>
@@ -53,7 +55,18 @@ class Skeleton;
 
 namespace simulation {
 
+namespace detail {
+class RecordingBuffer;
+} // namespace detail
+
 /// \brief class Recording
+///
+/// Frames are stored back to back in a single contiguous buffer of
+/// getTotalNumDofs() values per frame, with the contact points and forces of
+/// every frame packed in a second buffer. The accessors return views into that
+/// storage rather than copies. Long recordings can be spilled to a
+/// memory-mapped file with setMemoryMappedFile(), which keeps the resident
+/// memory bounded.
 class Recording
 {
 public:
@@ -79,9 +92,18 @@ public:
   /// \brief Get number of contacts at frame number _frameIdx
   int getNumContacts(int _frameIdx) const;
 
+  /// \brief Get the sum of the number of generalized coordinates of all the
+  /// skeletons, which is the size of one frame of configurations
+  int getTotalNumDofs() const;
+
   /// \brief Get skeleton configurations whose index is _skelIdx at frame number
   /// _frameIdx
-  Eigen::VectorXs getConfig(int _frameIdx, int _skelIdx) const;
+  Eigen::Map<const Eigen::VectorXs> getConfig(
+      int _frameIdx, int _skelIdx) const;
+
+  /// \brief Get the configurations of all the skeletons for every frame, as a
+  /// (getTotalNumDofs() x getNumFrames()) matrix
+  Eigen::Map<const Eigen::MatrixXs> getConfigs() const;
 
   /// \brief Get _dofIdx-th single configruation of a skeleton whose index is
   /// _skelIdx at frame number _frameIdx
@@ -89,27 +111,81 @@ public:
 
   /// \brief Get contact point whose index is _contactIdx at frame number
   /// _frameIdx
-  Eigen::Vector3s getContactPoint(int _frameIdx, int _contactIdx) const;
+  Eigen::Map<const Eigen::Vector3s> getContactPoint(
+      int _frameIdx, int _contactIdx) const;
 
   /// \brief Get contact force whose index is _contactIdx at frame number
   /// _frameIdx
-  Eigen::Vector3s getContactForce(int _frameIdx, int _contactIdx) const;
+  Eigen::Map<const Eigen::Vector3s> getContactForce(
+      int _frameIdx, int _contactIdx) const;
 
   /// \brief Clear the saved histories
-  void clear();  
+  void clear();
+
+  /// \brief Preallocate room for _numFrames frames of configurations
+  void reserve(int _numFrames);
 
-  /// \brief Add state
+  /// \brief Add state. The state is the configurations of all the skeletons
+  /// followed by 6 values (point, then force) for each contact. If a
+  /// memory-mapped recording can't grow to fit the frame, the frame is dropped
+  /// and every earlier frame is kept.
   void addState(const Eigen::VectorXs& _state);
 
-  /// \brief Update list for number of generalized coordinates
+  /// \brief Update list for number of generalized coordinates. If the total
+  /// number of dofs changes, the recorded frames can no longer be interpreted
+  /// and are cleared.
   void updateNumGenCoords(const std::vector<dynamics::SkeletonPtr>& _skeletons);
 
+  /// \brief Move the recording into memory-mapped files at
+  /// (_path + ".configs") and (_path + ".contacts"). After that, whenever more
+  /// than _maxResidentBytes of frames have been written since the last
+  /// eviction, the older pages are flushed and dropped from memory. They are
+  /// read back from disk on demand by the accessors. The ".configs" file is a
+  /// flat array of (getNumFrames() x getTotalNumDofs()) s_t values. Returns
+  /// false, and keeps the whole recording in memory, if mapping is not
+  /// supported or either file fails to map.
+  bool setMemoryMappedFile(
+      const std::string& _path, std::size_t _maxResidentBytes = 64 << 20);
+
+  /// \brief Write any pending frames to the memory-mapped files, if any
+  void flush();
+
 private:
-  /// \brief Baked states
-  std::vector<Eigen::VectorXs> mBakedStates;
+  /// \brief Recompute mDofOffsets and mTotalNumDofs from
+  /// mNumGenCoordsForSkeletons
+  void updateDofOffsets();
+
+  /// \brief Evict pages of a memory-mapped recording once the resident budget
+  /// is exceeded
+  void releaseResidentFrames();
+
+  /// \brief Configurations of all the frames, getTotalNumDofs() values per
+  /// frame
+  std::unique_ptr<detail::RecordingBuffer> mConfigs;
+
+  /// \brief Contact points and forces of all the frames, 6 values per contact
+  std::unique_ptr<detail::RecordingBuffer> mContacts;
+
+  /// \brief Index of the first contact of each frame in mContacts, with one
+  /// extra entry at the end
+  std::vector<std::size_t> mContactOffsets;
 
   /// \brief Number of generalized coordinates for skeletons
   std::vector<int> mNumGenCoordsForSkeletons;
+
+  /// \brief Index of the first dof of each skeleton within a frame
+  std::vector<int> mDofOffsets;
+
+  /// \brief Sum of mNumGenCoordsForSkeletons
+  int mTotalNumDofs;
+
+  /// \brief Bytes of frames that may stay resident before being evicted, when
+  /// the recording is memory-mapped
+  std::size_t mMaxResidentBytes;
+
+  /// \brief Values of mConfigs and mContacts already evicted from memory
+  std::size_t mReleasedConfigs;
+  std::size_t mReleasedContacts;
 };
 
 }  // namespace simulation
@@ -57,6 +57,7 @@
 #include "dart/neural/RestorableSnapshot.hpp"
 #include "dart/neural/WithRespectToMass.hpp"
 #include "dart/server/RawJsonUtils.hpp"
+#include "dart/simulation/detail/SkeletonWorkerPool.hpp"
 
 namespace dart {
 namespace simulation {
@@ -85,6 +86,7 @@ World::World(const std::string& _name)
     mFallbackConstraintForceMixingConstant(1e-4),
     mContactClippingDepth(0.03),
     mPenetrationCorrectionEnabled(false),
+    mNumThreads(1),
     mWrtMass(std::make_shared<neural::WithRespectToMass>()),
     mUseFDOverride(false),
     mSlowDebugResultsAgainstFD(false),
@@ -123,6 +125,7 @@ WorldPtr World::clone() const
   worldClone->setPenetrationCorrectionEnabled(mPenetrationCorrectionEnabled);
   worldClone->setParallelVelocityAndPositionUpdates(
       mParallelVelocityAndPositionUpdates);
+  worldClone->setNumThreads(mNumThreads);
 
   // Copy the WithRespectToMass pointer, so we have the same object
   worldClone->mWrtMass = mWrtMass;
@@ -207,14 +210,14 @@ void World::reset()
 void World::integrateVelocities()
 {
   // Integrate velocity for unconstrained skeletons
-  for (auto& skel : mSkeletons)
-  {
+  runOnSkeletons([this](std::size_t i) {
+    const dynamics::SkeletonPtr& skel = mSkeletons[i];
     if (!skel->isMobile())
-      continue;
+      return;
 
     skel->computeForwardDynamics();
     skel->integrateVelocities(mTimeStep);
-  }
+  });
 }
 
 //==============================================================================
@@ -222,15 +225,9 @@ void World::step(bool _resetCommand)
 {
   Eigen::VectorXs initialVelocity = getVelocities();
 
-  // Integrate velocity for unconstrained skeletons
-  for (auto& skel : mSkeletons)
-  {
-    if (!skel->isMobile())
-      continue;
-
-    skel->computeForwardDynamics();
-    skel->integrateVelocities(mTimeStep);
-  }
+  // Integrate velocity for unconstrained skeletons. Skeletons don't interact
+  // until the constraint solve, so each one can run on its own thread.
+  integrateVelocities();
 
   // Record the unconstrained velocities, cause we need them for backprop
   if (mConstraintSolver->getGradientEnabled())
@@ -283,10 +280,10 @@ void World::replaceConstraintEngineFn(const constraintEngineFnType& engineFn)
 void World::integrateVelocitiesFromImpulses(bool _resetCommand)
 {
   // Compute velocity changes given constraint impulses
-  for (auto& skel : mSkeletons)
-  {
+  runOnSkeletons([this, _resetCommand](std::size_t i) {
+    const dynamics::SkeletonPtr& skel = mSkeletons[i];
     if (!skel->isMobile())
-      continue;
+      return;
 
     if (skel->isImpulseApplied())
     {
@@ -300,15 +297,25 @@ void World::integrateVelocitiesFromImpulses(bool _resetCommand)
       skel->clearExternalForces();
       skel->resetCommands();
     }
-  }
+  });
 }
 
 //==============================================================================
 void World::integratePositions(Eigen::VectorXs initialVelocity)
 {
+  // Find each skeleton's slice of initialVelocity up front, so the skeletons
+  // can be integrated in any order
+  std::vector<int> cursors;
+  cursors.reserve(mSkeletons.size());
   int cursor = 0;
   for (auto& skel : mSkeletons)
   {
+    cursors.push_back(cursor);
+    cursor += skel->getNumDofs();
+  }
+
+  runOnSkeletons([&](std::size_t i) {
+    const dynamics::SkeletonPtr& skel = mSkeletons[i];
     if (mParallelVelocityAndPositionUpdates)
     {
       // <Nimble>: This is an easier way to compute gradients for. We update
@@ -316,9 +323,8 @@ void World::integratePositions(Eigen::VectorXs initialVelocity)
       int dofs = skel->getNumDofs();
       skel->setPositions(skel->integratePositionsExplicit(
           skel->getPositions(),
-          initialVelocity.segment(cursor, dofs),
+          initialVelocity.segment(cursors[i], dofs),
           mTimeStep));
-      cursor += dofs;
       // </Nimble>: Integrate positions before velocity changes, instead of
       // after
     }
@@ -329,7 +335,28 @@ void World::integratePositions(Eigen::VectorXs initialVelocity)
       skel->integratePositions(mTimeStep);
       // </Nimble>
     }
+  });
+}
+
+//==============================================================================
+void World::runOnSkeletons(const std::function<void(std::size_t)>& fn)
+{
+  // With a single skeleton there is nothing to spread out, and waking the
+  // workers would only add latency
+  if (!mWorkerPool || mSkeletons.size() <= 1)
+  {
+    for (std::size_t i = 0; i < mSkeletons.size(); i++)
+    {
+      fn(i);
+    }
+    return;
   }
+
+  // Skeletons are dealt out round-robin, and each one only ever writes to its
+  // own state, so the results don't depend on the number of threads. The
+  // workers stay alive between calls, so this is cheap to do several times
+  // per step.
+  mWorkerPool->run(mSkeletons.size(), fn);
 }
 
 //==============================================================================
@@ -356,6 +383,27 @@ bool World::getParallelVelocityAndPositionUpdates()
   return mParallelVelocityAndPositionUpdates;
 }
 
+//==============================================================================
+void World::setNumThreads(int numThreads)
+{
+  numThreads = std::max(1, numThreads);
+  if (numThreads == mNumThreads)
+    return;
+
+  mNumThreads = numThreads;
+  // The calling thread does a share of the work, so we only need
+  // mNumThreads - 1 workers in the background
+  mWorkerPool.reset();
+  if (mNumThreads > 1)
+    mWorkerPool.reset(new detail::SkeletonWorkerPool(mNumThreads - 1));
+}
+
+//==============================================================================
+int World::getNumThreads() const
+{
+  return mNumThreads;
+}
+
 //==============================================================================
 void World::setPenetrationCorrectionEnabled(bool enable)
 {
@@ -427,7 +475,8 @@ std::string World::toJson()
     }
     */
     json << "{";
-    std::string name = skel->getName() + "." + bodyNode->getName();
+    std::string name
+        = escapeJson(skel->getName() + "." + bodyNode->getName());
     json << "\"name\": \"" << name << "\",";
     json << "\"shapes\": [";
     const std::vector<dynamics::ShapeNode*> visualShapeNodes
@@ -510,7 +559,8 @@ std::string World::positionsToJson()
       }
     }
     */
-    std::string name = skel->getName() + "." + bodyNode->getName();
+    std::string name
+        = escapeJson(skel->getName() + "." + bodyNode->getName());
     json << "\"" << name << "\": {";
     const Eigen::Isometry3s& bodyTransform = bodyNode->getWorldTransform();
     json << "\"pos\":";
@@ -553,7 +603,8 @@ std::string World::colorsToJson()
       ]
     }
     */
-    std::string name = skel->getName() + "." + bodyNode->getName();
+    std::string name
+        = escapeJson(skel->getName() + "." + bodyNode->getName());
     json << "\"" << name << "\": [";
 
     const std::vector<dynamics::ShapeNode*> visualShapeNodes
@@ -39,6 +39,7 @@
 #ifndef DART_SIMULATION_WORLD_HPP_
 #define DART_SIMULATION_WORLD_HPP_
 
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -83,6 +84,10 @@ class BackpropSnapshot;
 
 namespace simulation {
 
+namespace detail {
+class SkeletonWorkerPool;
+} // namespace detail
+
 DART_COMMON_DECLARE_SHARED_WEAK(World)
 
 /// class World
@@ -641,6 +646,16 @@ public:
 
   bool getParallelVelocityAndPositionUpdates();
 
+  /// Sets how many threads step() uses for the per-skeleton work (forward
+  /// dynamics, velocity integration, impulse integration and position
+  /// integration). The constraint solve between them is still serial. Each
+  /// skeleton is only touched by one thread, so results are identical for any
+  /// thread count. The worker threads are kept alive until the next call to
+  /// setNumThreads(), or until the World is destroyed. 1 (serial) by default.
+  void setNumThreads(int numThreads);
+
+  int getNumThreads() const;
+
   /// True by default. Sets whether or not to apply artifical "penetration
   /// correction" forces to objects that inter-penetrate.
   void setPenetrationCorrectionEnabled(bool enable);
@@ -726,6 +741,10 @@ protected:
   /// instructions.
   bool mSlowDebugResultsAgainstFD;
 
+  /// Runs fn(i) for each skeleton index i, spread over mNumThreads threads.
+  /// This isn't reentrant, since all the calls share the same worker pool.
+  void runOnSkeletons(const std::function<void(std::size_t)>& fn);
+
   /// Register when a Skeleton's name is changed
   void handleSkeletonNameChange(
       const dynamics::ConstMetaSkeletonPtr& _skeleton);
@@ -807,6 +826,13 @@ protected:
   /// True if we want to enable artificial penetration correction forces
   bool mPenetrationCorrectionEnabled;
 
+  /// The number of threads to use for the per-skeleton parts of step()
+  int mNumThreads;
+
+  /// The background threads for runOnSkeletons(), or nullptr when
+  /// mNumThreads is 1
+  std::unique_ptr<detail::SkeletonWorkerPool> mWorkerPool;
+
   /// We add this value to the diagonal entries of A, ONLY IF our initial LCP
   /// solution fails, to help prevent A from being low-rank. This both increases
   /// the stability of the forward LCP solution, and it also helps prevent cases
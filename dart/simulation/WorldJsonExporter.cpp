@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * This code incorporates portions of Open Dynamics Engine
+ *     (Copyright (c) 2001-2004, Russell L. Smith. All rights
+ *     reserved.) and portions of FCL (Copyright (c) 2011, Willow
+ *     Garage, Inc. All rights reserved.), which were released under
+ *     the same BSD license as below
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/simulation/WorldJsonExporter.hpp"
+
+#include <unordered_map>
+
+#include "dart/dynamics/BodyNode.hpp"
+#include "dart/dynamics/ShapeFrame.hpp"
+#include "dart/dynamics/ShapeNode.hpp"
+#include "dart/dynamics/Skeleton.hpp"
+#include "dart/math/Geometry.hpp"
+#include "dart/server/RawJsonUtils.hpp"
+#include "dart/simulation/World.hpp"
+
+namespace dart {
+namespace simulation {
+
+//==============================================================================
+WorldJsonExporter::WorldJsonExporter(std::shared_ptr<World> world)
+  : mWorld(world), mNumExportedBodies(0)
+{
+  // Do nothing
+}
+
+//==============================================================================
+const std::string& WorldJsonExporter::toJson()
+{
+  syncBodies();
+
+  mBuffer.assign(mWorld->toJson());
+  for (BodyEntry& entry : mBodies)
+  {
+    entry.mExportedTransform = entry.mBodyNode->getWorldTransform();
+    entry.mExportedVersion = entry.mBodyNode->getVersion();
+    entry.mHasExportedTransform = true;
+    entry.mHasExportedVersion = true;
+  }
+  mNumExportedBodies = mBodies.size();
+
+  return mBuffer;
+}
+
+//==============================================================================
+const std::string& WorldJsonExporter::positionsToJson()
+{
+  syncBodies();
+
+  mBuffer.clear();
+  mBuffer += '{';
+  mNumExportedBodies = 0;
+  for (BodyEntry& entry : mBodies)
+  {
+    const Eigen::Isometry3s& bodyTransform
+        = entry.mBodyNode->getWorldTransform();
+    if (entry.mHasExportedTransform
+        && entry.mExportedTransform.matrix() == bodyTransform.matrix())
+      continue;
+
+    updateKey(entry);
+    if (mNumExportedBodies > 0)
+      mBuffer += ',';
+    mBuffer += entry.mKey;
+    mBuffer += ": {\"pos\":";
+    appendVec3ToJson(mBuffer, bodyTransform.translation());
+    mBuffer += ",\"angle\":";
+    appendVec3ToJson(mBuffer, math::matrixToEulerXYZ(bodyTransform.linear()));
+    mBuffer += '}';
+
+    entry.mExportedTransform = bodyTransform;
+    entry.mHasExportedTransform = true;
+    mNumExportedBodies++;
+  }
+  mBuffer += '}';
+
+  return mBuffer;
+}
+
+//==============================================================================
+const std::string& WorldJsonExporter::colorsToJson()
+{
+  syncBodies();
+
+  mBuffer.clear();
+  mBuffer += '{';
+  mNumExportedBodies = 0;
+  for (BodyEntry& entry : mBodies)
+  {
+    const std::size_t version = entry.mBodyNode->getVersion();
+    if (entry.mHasExportedVersion && entry.mExportedVersion == version)
+      continue;
+
+    updateKey(entry);
+    if (mNumExportedBodies > 0)
+      mBuffer += ',';
+    mBuffer += entry.mKey;
+    mBuffer += ": [";
+
+    // BodyNode::getShapeNodesWith() allocates a vector, so walk the
+    // ShapeNodes directly instead.
+    bool first = true;
+    const std::size_t numShapeNodes = entry.mBodyNode->getNumShapeNodes();
+    for (std::size_t j = 0; j < numShapeNodes; j++)
+    {
+      const dynamics::ShapeNode* shape = entry.mBodyNode->getShapeNode(j);
+      const dynamics::VisualAspect* visual = shape->getVisualAspect();
+      if (visual == nullptr)
+        continue;
+      if (!first)
+        mBuffer += ',';
+      appendVec3ToJson(mBuffer, visual->getColor());
+      first = false;
+    }
+    mBuffer += ']';
+
+    entry.mExportedVersion = version;
+    entry.mHasExportedVersion = true;
+    mNumExportedBodies++;
+  }
+  mBuffer += '}';
+
+  return mBuffer;
+}
+
+//==============================================================================
+std::size_t WorldJsonExporter::getNumExportedBodies() const
+{
+  return mNumExportedBodies;
+}
+
+//==============================================================================
+void WorldJsonExporter::reset()
+{
+  mBodies.clear();
+  mNumExportedBodies = 0;
+}
+
+//==============================================================================
+void WorldJsonExporter::syncBodies()
+{
+  // Fast path: the world still holds exactly the bodies we are tracking, in
+  // the same order
+  std::size_t index = 0;
+  bool matches = true;
+  for (std::size_t i = 0; i < mWorld->getNumSkeletons() && matches; i++)
+  {
+    const dynamics::SkeletonPtr& skel = mWorld->getSkeleton(i);
+    for (std::size_t j = 0; j < skel->getNumBodyNodes(); j++, index++)
+    {
+      if (index >= mBodies.size()
+          || mBodies[index].mBodyNode != skel->getBodyNode(j))
+      {
+        matches = false;
+        break;
+      }
+    }
+  }
+  if (matches && index == mBodies.size())
+    return;
+
+  std::unordered_map<const dynamics::BodyNode*, std::size_t> previous;
+  for (std::size_t i = 0; i < mBodies.size(); i++)
+    previous[mBodies[i].mBodyNode] = i;
+
+  std::vector<BodyEntry> bodies;
+  for (dynamics::BodyNode* body : mWorld->getAllBodyNodes())
+  {
+    auto it = previous.find(body);
+    if (it != previous.end())
+    {
+      bodies.push_back(mBodies[it->second]);
+      continue;
+    }
+
+    BodyEntry entry;
+    entry.mBodyNode = body;
+    entry.mKeyVersion = 0;
+    entry.mExportedTransform = Eigen::Isometry3s::Identity();
+    entry.mExportedVersion = 0;
+    entry.mHasExportedTransform = false;
+    entry.mHasExportedVersion = false;
+    bodies.push_back(entry);
+    updateKey(bodies.back());
+  }
+  mBodies = std::move(bodies);
+}
+
+//==============================================================================
+void WorldJsonExporter::updateKey(BodyEntry& _entry)
+{
+  const std::size_t version = _entry.mBodyNode->getVersion();
+  if (!_entry.mKey.empty() && _entry.mKeyVersion == version)
+    return;
+
+  _entry.mKey = "\""
+                + escapeJson(
+                    _entry.mBodyNode->getSkeleton()->getName() + "."
+                    + _entry.mBodyNode->getName())
+                + "\"";
+  _entry.mKeyVersion = version;
+}
+
+} // namespace simulation
+} // namespace dart
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * This code incorporates portions of Open Dynamics Engine
+ *     (Copyright (c) 2001-2004, Russell L. Smith. All rights
+ *     reserved.) and portions of FCL (Copyright (c) 2011, Willow
+ *     Garage, Inc. All rights reserved.), which were released under
+ *     the same BSD license as below
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_SIMULATION_WORLDJSONEXPORTER_HPP_
+#define DART_SIMULATION_WORLDJSONEXPORTER_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/math/MathTypes.hpp"
+
+namespace dart {
+
+namespace dynamics {
+class BodyNode;
+} // namespace dynamics
+
+namespace simulation {
+
+class World;
+
+/// WorldJsonExporter produces the same JSON blobs as World::toJson(),
+/// World::positionsToJson() and World::colorsToJson(), but the positions and
+/// colors blobs only contain the bodies that changed since the previous call
+/// on this exporter. This is meant for viewers and loggers that poll the world
+/// every frame and merge the updates into what they already have.
+///
+/// A body's transform is considered changed when its world transform differs
+/// from the one that was last exported. Its visual properties are considered
+/// changed when the version counter of the BodyNode moves, which happens
+/// whenever one of its ShapeNodes, their Shapes or their VisualAspects is
+/// modified.
+///
+/// The returned strings are owned by the exporter and reused from call to
+/// call, so they stay valid only until the next export.
+class WorldJsonExporter
+{
+public:
+  explicit WorldJsonExporter(std::shared_ptr<World> world);
+
+  /// Returns the full world as World::toJson() does, and marks every body as
+  /// up to date for both positionsToJson() and colorsToJson().
+  const std::string& toJson();
+
+  /// Returns the positions, in the format of World::positionsToJson(), of the
+  /// bodies that moved since the last call.
+  const std::string& positionsToJson();
+
+  /// Returns the colors, in the format of World::colorsToJson(), of the bodies
+  /// whose visual properties changed since the last call.
+  const std::string& colorsToJson();
+
+  /// Returns the number of bodies written by the last export
+  std::size_t getNumExportedBodies() const;
+
+  /// Forgets everything that has been exported, so that the next call to
+  /// positionsToJson() or colorsToJson() emits every body.
+  void reset();
+
+protected:
+  struct BodyEntry
+  {
+    dynamics::BodyNode* mBodyNode;
+
+    /// "skeleton.body", already escaped and quoted for JSON
+    std::string mKey;
+
+    /// BodyNode version mKey was computed at
+    std::size_t mKeyVersion;
+
+    /// World transform as of the last positionsToJson()
+    Eigen::Isometry3s mExportedTransform;
+
+    /// BodyNode version as of the last colorsToJson()
+    std::size_t mExportedVersion;
+
+    bool mHasExportedTransform;
+    bool mHasExportedVersion;
+  };
+
+  /// Makes mBodies match the bodies currently in the world, in the order of
+  /// World::getAllBodyNodes(). Bodies that were already tracked keep their
+  /// export state.
+  void syncBodies();
+
+  /// Refreshes the cached key of _entry if the body changed
+  void updateKey(BodyEntry& _entry);
+
+  std::shared_ptr<World> mWorld;
+
+  std::vector<BodyEntry> mBodies;
+
+  /// Reused output buffer
+  std::string mBuffer;
+
+  std::size_t mNumExportedBodies;
+};
+
+} // namespace simulation
+} // namespace dart
+
+#endif // DART_SIMULATION_WORLDJSONEXPORTER_HPP_
@@ -0,0 +1,332 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * This code incorporates portions of Open Dynamics Engine
+ *     (Copyright (c) 2001-2004, Russell L. Smith. All rights
+ *     reserved.) and portions of FCL (Copyright (c) 2011, Willow
+ *     Garage, Inc. All rights reserved.), which were released under
+ *     the same BSD license as below
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/simulation/detail/RecordingBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "dart/common/Console.hpp"
+#include "dart/common/Platform.hpp"
+
+#if !defined(DART_USE_ARBITRARY_PRECISION)                                     \
+    && (defined(DART_OS_LINUX) || defined(DART_OS_MACOS))
+#define DART_RECORDING_USE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dart {
+namespace simulation {
+namespace detail {
+
+#ifdef DART_RECORDING_USE_MMAP
+namespace {
+
+//==============================================================================
+std::size_t getPageSize()
+{
+  static const std::size_t pageSize
+      = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  return pageSize;
+}
+
+//==============================================================================
+/// Resizes the file behind _fd to hold at least _capacity values, rounded up
+/// to whole pages, and maps all of it. Returns nullptr on failure. The file
+/// may have been grown even then, which is harmless.
+s_t* mapFile(int _fd, std::size_t _capacity, std::size_t& _mappedCapacity)
+{
+  const std::size_t pageSize = getPageSize();
+  const std::size_t bytes
+      = ((_capacity * sizeof(s_t) + pageSize - 1) / pageSize) * pageSize;
+
+  if (ftruncate(_fd, static_cast<off_t>(bytes)) != 0)
+  {
+    dterr << "[RecordingBuffer] Failed to resize the backing file to " << bytes
+          << " bytes.\n";
+    return nullptr;
+  }
+
+  void* ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+  if (ptr == MAP_FAILED)
+  {
+    dterr << "[RecordingBuffer] Failed to map " << bytes
+          << " bytes of the backing file.\n";
+    return nullptr;
+  }
+
+  _mappedCapacity = bytes / sizeof(s_t);
+  return static_cast<s_t*>(ptr);
+}
+
+} // namespace
+#endif
+
+//==============================================================================
+RecordingBuffer::RecordingBuffer()
+  : mMapped(nullptr), mMappedCapacity(0), mMappedSize(0), mFileDescriptor(-1)
+{
+  // Do nothing
+}
+
+//==============================================================================
+RecordingBuffer::~RecordingBuffer()
+{
+  unmap();
+}
+
+//==============================================================================
+bool RecordingBuffer::supportsMemoryMapping()
+{
+#ifdef DART_RECORDING_USE_MMAP
+  return true;
+#else
+  return false;
+#endif
+}
+
+//==============================================================================
+bool RecordingBuffer::mapToFile(const std::string& _path)
+{
+#ifdef DART_RECORDING_USE_MMAP
+  const int fd = ::open(_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+  {
+    dterr << "[RecordingBuffer::mapToFile] Failed to open [" << _path
+          << "] for writing.\n";
+    return false;
+  }
+
+  // Map the new file before letting go of the current storage, so that a
+  // failure leaves the buffer untouched
+  const std::size_t count = size();
+  std::size_t capacity = 0;
+  s_t* mapped = mapFile(fd, std::max<std::size_t>(count, 1), capacity);
+  if (mapped == nullptr)
+  {
+    ::close(fd);
+    return false;
+  }
+  if (count > 0)
+    std::memcpy(mapped, data(), count * sizeof(s_t));
+
+  unmap();
+  mHeap.clear();
+  mHeap.shrink_to_fit();
+  mMapped = mapped;
+  mMappedCapacity = capacity;
+  mMappedSize = count;
+  mFileDescriptor = fd;
+  return true;
+#else
+  dtwarn << "[RecordingBuffer::mapToFile] Memory-mapped recordings are not "
+         << "supported on this platform. [" << _path << "] is ignored and "
+         << "the recording stays in memory.\n";
+  return false;
+#endif
+}
+
+//==============================================================================
+void RecordingBuffer::moveToHeap()
+{
+  if (!isMapped())
+    return;
+
+  std::vector<s_t> contents(mMapped, mMapped + mMappedSize);
+  unmap();
+  mHeap = std::move(contents);
+}
+
+//==============================================================================
+bool RecordingBuffer::isMapped() const
+{
+  return mMapped != nullptr;
+}
+
+//==============================================================================
+void RecordingBuffer::reserve(std::size_t _capacity)
+{
+  if (isMapped())
+  {
+    if (_capacity > mMappedCapacity)
+      growMapping(_capacity);
+  }
+  else
+  {
+    mHeap.reserve(_capacity);
+  }
+}
+
+//==============================================================================
+bool RecordingBuffer::append(const s_t* _data, std::size_t _count)
+{
+  if (_count == 0)
+    return true;
+
+  if (!isMapped())
+  {
+    mHeap.insert(mHeap.end(), _data, _data + _count);
+    return true;
+  }
+
+  if (mMappedSize + _count > mMappedCapacity
+      && !growMapping(std::max(mMappedSize + _count, 2 * mMappedCapacity)))
+  {
+    dterr << "[RecordingBuffer::append] Failed to grow the memory-mapped "
+          << "file. Dropping " << _count << " values.\n";
+    return false;
+  }
+
+  std::copy(_data, _data + _count, mMapped + mMappedSize);
+  mMappedSize += _count;
+  return true;
+}
+
+//==============================================================================
+void RecordingBuffer::truncate(std::size_t _size)
+{
+  if (isMapped())
+    mMappedSize = std::min(mMappedSize, _size);
+  else if (_size < mHeap.size())
+    mHeap.resize(_size);
+}
+
+//==============================================================================
+void RecordingBuffer::clear()
+{
+  mHeap.clear();
+  mMappedSize = 0;
+}
+
+//==============================================================================
+const s_t* RecordingBuffer::data() const
+{
+  return isMapped() ? mMapped : mHeap.data();
+}
+
+//==============================================================================
+std::size_t RecordingBuffer::size() const
+{
+  return isMapped() ? mMappedSize : mHeap.size();
+}
+
+//==============================================================================
+void RecordingBuffer::flush()
+{
+#ifdef DART_RECORDING_USE_MMAP
+  if (isMapped())
+    msync(mMapped, mMappedCapacity * sizeof(s_t), MS_SYNC);
+#endif
+}
+
+//==============================================================================
+void RecordingBuffer::release(std::size_t _end)
+{
+#ifdef DART_RECORDING_USE_MMAP
+  if (!isMapped())
+    return;
+
+  const std::size_t pageSize = getPageSize();
+  const std::size_t bytes
+      = (std::min(_end, mMappedSize) * sizeof(s_t)) / pageSize * pageSize;
+  if (bytes == 0)
+    return;
+
+  // MADV_DONTNEED drops dirty pages of a shared mapping only after they have
+  // been written back, so sync first to be safe on every platform.
+  msync(mMapped, bytes, MS_SYNC);
+  madvise(mMapped, bytes, MADV_DONTNEED);
+#else
+  (void)_end;
+#endif
+}
+
+//==============================================================================
+bool RecordingBuffer::growMapping(std::size_t _capacity)
+{
+#ifdef DART_RECORDING_USE_MMAP
+  // Both mappings share the same file, so the values already written show up
+  // in the new one without copying
+  std::size_t capacity = 0;
+  s_t* mapped = mapFile(mFileDescriptor, _capacity, capacity);
+  if (mapped == nullptr)
+    return false;
+
+  munmap(mMapped, mMappedCapacity * sizeof(s_t));
+  mMapped = mapped;
+  mMappedCapacity = capacity;
+  return true;
+#else
+  (void)_capacity;
+  return false;
+#endif
+}
+
+//==============================================================================
+void RecordingBuffer::unmap()
+{
+#ifdef DART_RECORDING_USE_MMAP
+  if (mMapped != nullptr)
+  {
+    msync(mMapped, mMappedCapacity * sizeof(s_t), MS_SYNC);
+    munmap(mMapped, mMappedCapacity * sizeof(s_t));
+  }
+  if (mFileDescriptor >= 0)
+  {
+    // Trim the file to the values actually written, so it can be read back
+    // as a flat array.
+    if (ftruncate(mFileDescriptor, static_cast<off_t>(mMappedSize * sizeof(s_t)))
+        != 0)
+    {
+      dtwarn << "[RecordingBuffer] Failed to trim the backing file.\n";
+    }
+    ::close(mFileDescriptor);
+  }
+#endif
+  mMapped = nullptr;
+  mMappedCapacity = 0;
+  mMappedSize = 0;
+  mFileDescriptor = -1;
+}
+
+} // namespace detail
+} // namespace simulation
+} // namespace dart
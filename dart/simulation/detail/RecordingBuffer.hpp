@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * This code incorporates portions of Open Dynamics Engine
+ *     (Copyright (c) 2001-2004, Russell L. Smith. All rights
+ *     reserved.) and portions of FCL (Copyright (c) 2011, Willow
+ *     Garage, Inc. All rights reserved.), which were released under
+ *     the same BSD license as below
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_SIMULATION_DETAIL_RECORDINGBUFFER_HPP_
+#define DART_SIMULATION_DETAIL_RECORDINGBUFFER_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "dart/math/MathTypes.hpp"
+
+namespace dart {
+namespace simulation {
+namespace detail {
+
+/// RecordingBuffer is a growable, contiguous array of s_t used to store the
+/// frames of a Recording. By default the storage lives on the heap. Calling
+/// mapToFile() moves it into a shared memory-mapped file instead, so that
+/// already written pages can be handed back to the kernel with release() and
+/// the resident set stays bounded no matter how long the recording gets.
+class RecordingBuffer
+{
+public:
+  RecordingBuffer();
+
+  ~RecordingBuffer();
+
+  RecordingBuffer(const RecordingBuffer&) = delete;
+  RecordingBuffer& operator=(const RecordingBuffer&) = delete;
+
+  /// Returns true if memory-mapped files are supported on this platform and
+  /// for this scalar type.
+  static bool supportsMemoryMapping();
+
+  /// Moves the contents of the buffer into the file at _path (truncating it)
+  /// and keeps all future appends there. Returns false, and leaves the buffer
+  /// exactly as it was, if the file cannot be created or mapped.
+  bool mapToFile(const std::string& _path);
+
+  /// Moves the contents of a mapped buffer back onto the heap, and closes the
+  /// file. Does nothing if the buffer is already on the heap.
+  void moveToHeap();
+
+  /// Returns true if the buffer is backed by a memory-mapped file.
+  bool isMapped() const;
+
+  /// Makes sure there is room for _capacity values without reallocating.
+  void reserve(std::size_t _capacity);
+
+  /// Appends _count values starting at _data. Returns false, and leaves the
+  /// buffer unchanged, if a mapped buffer could not grow to fit them.
+  bool append(const s_t* _data, std::size_t _count);
+
+  /// Drops every value from index _size on. Does nothing if fewer than _size
+  /// values are stored.
+  void truncate(std::size_t _size);
+
+  /// Drops all values. A mapped buffer stays mapped to the same file.
+  void clear();
+
+  /// Returns a pointer to the first value.
+  const s_t* data() const;
+
+  /// Returns the number of values stored.
+  std::size_t size() const;
+
+  /// Writes dirty pages of a mapped buffer back to its file. Does nothing on
+  /// the heap.
+  void flush();
+
+  /// Flushes and evicts every mapped page that lies entirely before value
+  /// index _end. Evicted pages are transparently re-read from the file when
+  /// they are accessed again. Does nothing on the heap.
+  void release(std::size_t _end);
+
+private:
+  /// Remaps the file to hold at least _capacity values. The old mapping is
+  /// only released once the new one exists, so on failure this returns false
+  /// and the buffer still holds everything it held before.
+  bool growMapping(std::size_t _capacity);
+
+  void unmap();
+
+  /// Heap storage, used when the buffer is not mapped
+  std::vector<s_t> mHeap;
+
+  /// Start of the mapping, or nullptr when the buffer lives on the heap
+  s_t* mMapped;
+
+  /// Number of values the current mapping can hold
+  std::size_t mMappedCapacity;
+
+  /// Number of values stored in the mapping
+  std::size_t mMappedSize;
+
+  /// File descriptor of the backing file, or -1
+  int mFileDescriptor;
+};
+
+} // namespace detail
+} // namespace simulation
+} // namespace dart
+
+#endif // DART_SIMULATION_DETAIL_RECORDINGBUFFER_HPP_
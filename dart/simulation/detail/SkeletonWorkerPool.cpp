@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * This code incorporates portions of Open Dynamics Engine
+ *     (Copyright (c) 2001-2004, Russell L. Smith. All rights
+ *     reserved.) and portions of FCL (Copyright (c) 2011, Willow
+ *     Garage, Inc. All rights reserved.), which were released under
+ *     the same BSD license as below
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/simulation/detail/SkeletonWorkerPool.hpp"
+
+namespace dart {
+namespace simulation {
+namespace detail {
+
+//==============================================================================
+SkeletonWorkerPool::SkeletonWorkerPool(int _numWorkers)
+  : mFn(nullptr), mCount(0), mGeneration(0), mNumBusy(0), mStopping(false)
+{
+  for (int i = 0; i < _numWorkers; ++i)
+  {
+    // Share 0 belongs to the thread that calls run()
+    mWorkers.emplace_back(&SkeletonWorkerPool::workerLoop, this, i + 1);
+  }
+}
+
+//==============================================================================
+SkeletonWorkerPool::~SkeletonWorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStopping = true;
+  }
+  mWorkReady.notify_all();
+  for (std::thread& worker : mWorkers)
+    worker.join();
+}
+
+//==============================================================================
+int SkeletonWorkerPool::getNumWorkers() const
+{
+  return static_cast<int>(mWorkers.size());
+}
+
+//==============================================================================
+void SkeletonWorkerPool::run(
+    std::size_t _count, const std::function<void(std::size_t)>& _fn)
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mFn = &_fn;
+    mCount = _count;
+    mError = nullptr;
+    mNumBusy = static_cast<int>(mWorkers.size());
+    ++mGeneration;
+  }
+  mWorkReady.notify_all();
+
+  runShare(0);
+
+  std::unique_lock<std::mutex> lock(mMutex);
+  mWorkDone.wait(lock, [this] { return mNumBusy == 0; });
+  mFn = nullptr;
+  if (mError)
+    std::rethrow_exception(mError);
+}
+
+//==============================================================================
+void SkeletonWorkerPool::workerLoop(int _share)
+{
+  std::size_t lastGeneration = 0;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mWorkReady.wait(lock, [this, lastGeneration] {
+        return mStopping || mGeneration != lastGeneration;
+      });
+      if (mStopping)
+        return;
+      lastGeneration = mGeneration;
+    }
+
+    runShare(_share);
+
+    bool last = false;
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      last = (--mNumBusy == 0);
+    }
+    if (last)
+      mWorkDone.notify_one();
+  }
+}
+
+//==============================================================================
+void SkeletonWorkerPool::runShare(int _share)
+{
+  const std::size_t numShares = mWorkers.size() + 1;
+  try
+  {
+    for (std::size_t i = _share; i < mCount; i += numShares)
+      (*mFn)(i);
+  }
+  catch (...)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mError)
+      mError = std::current_exception();
+  }
+}
+
+} // namespace detail
+} // namespace simulation
+} // namespace dart
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * This code incorporates portions of Open Dynamics Engine
+ *     (Copyright (c) 2001-2004, Russell L. Smith. All rights
+ *     reserved.) and portions of FCL (Copyright (c) 2011, Willow
+ *     Garage, Inc. All rights reserved.), which were released under
+ *     the same BSD license as below
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_SIMULATION_DETAIL_SKELETONWORKERPOOL_HPP_
+#define DART_SIMULATION_DETAIL_SKELETONWORKERPOOL_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dart {
+namespace simulation {
+namespace detail {
+
+/// SkeletonWorkerPool keeps a fixed set of worker threads alive between calls
+/// to run(), so that World::step() can spread its per-skeleton work across
+/// threads several times per step without paying to spawn and join threads
+/// each time. The calling thread always takes a share of the work too.
+class SkeletonWorkerPool
+{
+public:
+  /// Starts _numWorkers background threads, which sleep until run() is called
+  explicit SkeletonWorkerPool(int _numWorkers);
+
+  /// Wakes up and joins all the background threads
+  ~SkeletonWorkerPool();
+
+  SkeletonWorkerPool(const SkeletonWorkerPool&) = delete;
+  SkeletonWorkerPool& operator=(const SkeletonWorkerPool&) = delete;
+
+  /// Returns the number of background threads, not counting the caller
+  int getNumWorkers() const;
+
+  /// Runs _fn(i) for every i in [0, _count), and returns once they have all
+  /// finished. The indices are dealt out round-robin to the calling thread
+  /// and the background threads, so each index always runs on exactly one
+  /// thread. If any call throws, the first exception is rethrown here after
+  /// the rest of the work is done.
+  void run(std::size_t _count, const std::function<void(std::size_t)>& _fn);
+
+private:
+  /// The loop each background thread runs until the pool is destroyed
+  void workerLoop(int _share);
+
+  /// Runs every index belonging to _share, and records the first exception
+  void runShare(int _share);
+
+  std::vector<std::thread> mWorkers;
+
+  std::mutex mMutex;
+
+  /// Signalled when a new batch of work is ready, or when we're shutting down
+  std::condition_variable mWorkReady;
+
+  /// Signalled when the last background thread finishes its share
+  std::condition_variable mWorkDone;
+
+  /// The batch currently being run, which is only valid during run()
+  const std::function<void(std::size_t)>* mFn;
+  std::size_t mCount;
+
+  /// Bumped once per call to run(), so the workers can tell a new batch apart
+  /// from a spurious wakeup
+  std::size_t mGeneration;
+
+  /// The number of background threads still working on the current batch
+  int mNumBusy;
+
+  /// The first exception thrown by the current batch, if any
+  std::exception_ptr mError;
+
+  bool mStopping;
+};
+
+} // namespace detail
+} // namespace simulation
+} // namespace dart
+
+#endif // DART_SIMULATION_DETAIL_SKELETONWORKERPOOL_HPP_
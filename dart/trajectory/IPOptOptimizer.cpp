@@ -26,6 +26,8 @@ IPOptOptimizer::IPOptOptimizer()
     mTolerance(1e-7),
     mLBFGSHistoryLength(1),
     mCheckDerivatives(false),
+    mDerivativeCheckDirections(0),
+    mDerivativeCheckTolerance(1e-4),
     mPrintFrequency(1),
     mRecordPerfLog(false),
     mRecoverBest(true),
@@ -124,6 +126,8 @@ std::shared_ptr<Solution> IPOptOptimizer::optimize(
       mRecordFullDebugInfo,
       mSuppressOutput && !mSilenceOutput,
       mRecordIterations);
+  problem->setRandomDerivativeCheck(
+      mDerivativeCheckDirections, mDerivativeCheckTolerance);
   for (auto& callback : mIntermediateCallbacks)
   {
     problem->registerIntermediateCallback(callback);
@@ -177,6 +181,13 @@ void IPOptOptimizer::setCheckDerivatives(bool checkDerivatives)
   mCheckDerivatives = checkDerivatives;
 }
 
+//==============================================================================
+void IPOptOptimizer::setRandomDerivativeCheck(int numDirections, s_t tolerance)
+{
+  mDerivativeCheckDirections = numDirections;
+  mDerivativeCheckTolerance = tolerance;
+}
+
 //==============================================================================
 void IPOptOptimizer::setPrintFrequency(int frequency)
 {
@@ -45,6 +45,13 @@ public:
 
   void setCheckDerivatives(bool checkDerivatives);
 
+  /// Unlike setCheckDerivatives(), which finite differences the whole gradient
+  /// and Jacobian once up front, this checks every evaluation along
+  /// `numDirections` random directions (see
+  /// math::checkJacobianAlongRandomDirections()). Failures are logged. Pass 0
+  /// to turn it off.
+  void setRandomDerivativeCheck(int numDirections, s_t tolerance = 1e-4);
+
   void setPrintFrequency(int frequency);
 
   void setRecordPerformanceLog(bool recordPerfLog);
@@ -66,6 +73,8 @@ protected:
   s_t mTolerance;
   int mLBFGSHistoryLength;
   bool mCheckDerivatives;
+  int mDerivativeCheckDirections;
+  s_t mDerivativeCheckTolerance;
   int mPrintFrequency;
   bool mRecordPerfLog;
   bool mRecoverBest;
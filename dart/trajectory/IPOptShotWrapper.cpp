@@ -7,6 +7,7 @@
 #include <coin/IpSolveStatistics.hpp>
 #include <coin/IpTNLP.hpp>
 
+#include "dart/math/FiniteDifference.hpp"
 #include "dart/math/MathTypes.hpp"
 #include "dart/performance/PerformanceLog.hpp"
 #include "dart/realtime/Millis.hpp"
@@ -48,7 +49,10 @@ IPOptShotWrapper::IPOptShotWrapper(
     mFCalls(0),
     mGradFCalls(0),
     mGCalls(0),
-    mJacGCalls(0)
+    mJacGCalls(0),
+    mDerivativeCheckDirections(0),
+    mDerivativeCheckTolerance(1e-4),
+    mDerivativeCheckFailures(0)
 {
   if (mRecoverBest)
   {
@@ -335,6 +339,23 @@ bool IPOptShotWrapper::eval_grad_f(
   mWrapped->backpropGradient(mWrapped->mWorld, grad, perflog);
 #endif
 
+  if (mDerivativeCheckDirections > 0 && _n > 0)
+  {
+    const Eigen::VectorXs x
+        = Eigen::Map<const Eigen::VectorXd>(_x, _n).cast<s_t>();
+    const Eigen::VectorXs analytical = grad.cast<s_t>();
+    s_t error = math::checkGradientAlongRandomDirections(
+        [&](const Eigen::VectorXs& point) {
+          mWrapped->unflatten(mWrapped->mWorld, point);
+          return mWrapped->getLoss(mWrapped->mWorld);
+        },
+        analytical,
+        x,
+        mDerivativeCheckDirections);
+    mWrapped->unflatten(mWrapped->mWorld, x);
+    reportDerivativeCheck("eval_grad_f", error);
+  }
+
   if (mRecordFullDebugInfo)
   {
     if (_new_x)
@@ -519,6 +540,35 @@ bool IPOptShotWrapper::eval_jac_g(
     mWrapped->getSparseJacobian(mWrapped->mWorld, sparse, perflog);
 #endif
 
+    if (mDerivativeCheckDirections > 0 && _n > 0 && _m > 0)
+    {
+      Eigen::VectorXi rows = Eigen::VectorXi::Zero(_nnzj);
+      Eigen::VectorXi cols = Eigen::VectorXi::Zero(_nnzj);
+      mWrapped->getJacobianSparsityStructure(mWrapped->mWorld, rows, cols);
+      const Eigen::VectorXs x
+          = Eigen::Map<const Eigen::VectorXd>(_x, _n).cast<s_t>();
+      const Eigen::VectorXs values = sparse.cast<s_t>();
+      s_t error = math::checkJacobianAlongRandomDirections(
+          [&](const Eigen::VectorXs& point) {
+            mWrapped->unflatten(mWrapped->mWorld, point);
+            Eigen::VectorXs constraints = Eigen::VectorXs::Zero(_m);
+            mWrapped->computeConstraints(mWrapped->mWorld, constraints);
+            return constraints;
+          },
+          [&](const Eigen::VectorXs& direction) {
+            Eigen::VectorXs jvp = Eigen::VectorXs::Zero(_m);
+            for (int i = 0; i < _nnzj; i++)
+            {
+              jvp(rows(i)) += values(i) * direction(cols(i));
+            }
+            return jvp;
+          },
+          x,
+          mDerivativeCheckDirections);
+      mWrapped->unflatten(mWrapped->mWorld, x);
+      reportDerivativeCheck("eval_jac_g", error);
+    }
+
     if (mRecordFullDebugInfo)
     {
       if (_new_x)
@@ -839,5 +889,36 @@ void IPOptShotWrapper::registerIntermediateCallback(
   mIntermediateCallbacks.push_back(callback);
 }
 
+/// This checks the gradient and constraint Jacobian on every evaluation
+/// along `numDirections` random directions (see
+/// math::checkJacobianAlongRandomDirections()). Errors above `tolerance`
+/// get logged.
+/// Pass 0 directions to turn the check off.
+void IPOptShotWrapper::setRandomDerivativeCheck(
+    int numDirections, s_t tolerance)
+{
+  mDerivativeCheckDirections = numDirections;
+  mDerivativeCheckTolerance = tolerance;
+}
+
+/// This returns how many evaluations have failed the random derivative check
+/// so far.
+int IPOptShotWrapper::getNumDerivativeCheckFailures() const
+{
+  return mDerivativeCheckFailures;
+}
+
+/// This logs (and counts) a failed random derivative check
+void IPOptShotWrapper::reportDerivativeCheck(
+    const std::string& evalName, s_t error)
+{
+  if (error <= mDerivativeCheckTolerance)
+    return;
+  mDerivativeCheckFailures++;
+  std::cout << "WARNING: IPOptShotWrapper::" << evalName
+            << "() failed the random derivative check, with error " << error
+            << " > tolerance " << mDerivativeCheckTolerance << std::endl;
+}
+
 } // namespace trajectory
 } // namespace dart
\ No newline at end of file
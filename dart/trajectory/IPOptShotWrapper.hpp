@@ -3,6 +3,7 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <Eigen/Dense>
@@ -187,7 +188,21 @@ public:
       std::function<bool(Problem* problem, int, s_t primal, s_t dual)>
           callback);
 
+  /// This checks the gradient and constraint Jacobian on every evaluation
+  /// along `numDirections` random directions (see
+  /// math::checkJacobianAlongRandomDirections()). Errors above `tolerance`
+  /// get logged.
+  /// Pass 0 directions to turn the check off.
+  void setRandomDerivativeCheck(int numDirections, s_t tolerance);
+
+  /// This returns how many evaluations have failed the random derivative
+  /// check so far.
+  int getNumDerivativeCheckFailures() const;
+
 private:
+  /// This logs (and counts) a failed random derivative check
+  void reportDerivativeCheck(const std::string& evalName, s_t error);
+
   Problem* mWrapped;
   std::shared_ptr<Solution> mRecord;
   bool mRecoverBest;
@@ -205,6 +220,10 @@ private:
   int mGCalls;
   int mJacGCalls;
 
+  int mDerivativeCheckDirections;
+  s_t mDerivativeCheckTolerance;
+  int mDerivativeCheckFailures;
+
   Eigen::VectorXd mSaved_zU;
   Eigen::VectorXd mSaved_zL;
   Eigen::VectorXd mSaved_lambda;
@@ -0,0 +1,336 @@
+#include "dart/utils/ModelCache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <thread>
+
+#include "dart/common/Console.hpp"
+#include "dart/common/LocalResourceRetriever.hpp"
+#include "dart/common/Resource.hpp"
+#include "dart/dynamics/Skeleton.hpp"
+#include "dart/simulation/World.hpp"
+#include "dart/utils/CompositeResourceRetriever.hpp"
+#include "dart/utils/DartResourceRetriever.hpp"
+#include "dart/utils/SkelParser.hpp"
+#include "dart/utils/sdf/SdfParser.hpp"
+#include "dart/utils/urdf/DartLoader.hpp"
+
+namespace dart {
+namespace utils {
+
+namespace {
+
+//==============================================================================
+bool hasSuffix(const std::string& str, const std::string& suffix)
+{
+  return str.size() >= suffix.size()
+         && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+//==============================================================================
+/// A read-only Resource over a string held in memory
+class StringResource : public common::Resource
+{
+public:
+  explicit StringResource(std::shared_ptr<const std::string> content)
+    : mContent(std::move(content)), mPosition(0)
+  {
+  }
+
+  std::size_t getSize() override
+  {
+    return mContent->size();
+  }
+
+  std::size_t tell() override
+  {
+    return mPosition;
+  }
+
+  bool seek(ptrdiff_t offset, SeekType origin) override
+  {
+    ptrdiff_t base = 0;
+    if (origin == SEEKTYPE_CUR)
+      base = static_cast<ptrdiff_t>(mPosition);
+    else if (origin == SEEKTYPE_END)
+      base = static_cast<ptrdiff_t>(mContent->size());
+    const ptrdiff_t position = base + offset;
+    if (position < 0 || position > static_cast<ptrdiff_t>(mContent->size()))
+      return false;
+    mPosition = static_cast<std::size_t>(position);
+    return true;
+  }
+
+  std::size_t read(void* buffer, std::size_t size, std::size_t count) override
+  {
+    if (size == 0)
+      return 0;
+    count = std::min(count, (mContent->size() - mPosition) / size);
+    std::memcpy(buffer, mContent->data() + mPosition, size * count);
+    mPosition += size * count;
+    return count;
+  }
+
+  std::string readAll() override
+  {
+    return *mContent;
+  }
+
+private:
+  std::shared_ptr<const std::string> mContent;
+  std::size_t mPosition;
+};
+
+//==============================================================================
+/// Serves `content` for `uri`, and forwards every other URI (meshes, included
+/// files) to `retriever`. This lets the parsers that only take a URI parse the
+/// exact bytes we hashed, even if the file changes on disk in the meantime.
+/// Parsers may hang on to the retriever (e.g. in MeshShape), so it keeps its
+/// own copy of the contents.
+class PinnedResourceRetriever : public common::ResourceRetriever
+{
+public:
+  PinnedResourceRetriever(
+      const common::Uri& uri,
+      const std::string& content,
+      const common::ResourceRetrieverPtr& retriever)
+    : mUri(uri.toString()),
+      mContent(std::make_shared<const std::string>(content)),
+      mRetriever(retriever)
+  {
+  }
+
+  bool exists(const common::Uri& uri) override
+  {
+    return uri.toString() == mUri || mRetriever->exists(uri);
+  }
+
+  common::ResourcePtr retrieve(const common::Uri& uri) override
+  {
+    if (uri.toString() == mUri)
+      return std::make_shared<StringResource>(mContent);
+    return mRetriever->retrieve(uri);
+  }
+
+  std::string readAll(const common::Uri& uri) override
+  {
+    if (uri.toString() == mUri)
+      return *mContent;
+    return mRetriever->readAll(uri);
+  }
+
+  std::string getFilePath(const common::Uri& uri) override
+  {
+    return mRetriever->getFilePath(uri);
+  }
+
+private:
+  std::string mUri;
+  std::shared_ptr<const std::string> mContent;
+  common::ResourceRetrieverPtr mRetriever;
+};
+
+} // namespace
+
+//==============================================================================
+ModelCache::ModelCache(const common::ResourceRetrieverPtr& retriever)
+  : mRetriever(retriever), mNextParseId(0)
+{
+  if (!mRetriever)
+  {
+    auto composite = std::make_shared<utils::CompositeResourceRetriever>();
+    composite->addSchemaRetriever(
+        "file", std::make_shared<common::LocalResourceRetriever>());
+    composite->addSchemaRetriever(
+        "dart", utils::DartResourceRetriever::create());
+    mRetriever = composite;
+  }
+}
+
+//==============================================================================
+void ModelCache::addPackageDirectory(
+    const std::string& packageName, const std::string& packageDirectory)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mPackageDirectories.emplace_back(packageName, packageDirectory);
+  // Anything already parsed may have resolved packages differently
+  mModels.clear();
+}
+
+//==============================================================================
+std::shared_ptr<dynamics::Skeleton> ModelCache::loadSkeleton(
+    const common::Uri& uri)
+{
+  std::shared_ptr<dynamics::Skeleton> skeleton = getTemplate(uri);
+  if (skeleton == nullptr)
+    return nullptr;
+  return skeleton->cloneSkeleton();
+}
+
+//==============================================================================
+std::vector<std::shared_ptr<dynamics::Skeleton>> ModelCache::loadSkeletons(
+    const std::vector<common::Uri>& uris)
+{
+  std::vector<std::shared_ptr<dynamics::Skeleton>> skeletons(uris.size());
+  const std::size_t numThreads = std::min<std::size_t>(
+      uris.size(), std::max(1u, std::thread::hardware_concurrency()));
+
+  // Each worker takes the next file that nobody has started on yet
+  std::atomic<std::size_t> next(0);
+  std::vector<std::future<void>> futures;
+  for (std::size_t t = 0; t < numThreads; t++)
+  {
+    futures.push_back(std::async(std::launch::async, [&]() {
+      for (std::size_t i = next++; i < uris.size(); i = next++)
+        skeletons[i] = loadSkeleton(uris[i]);
+    }));
+  }
+  for (auto& future : futures)
+    future.get();
+  return skeletons;
+}
+
+//==============================================================================
+std::shared_ptr<simulation::World> ModelCache::loadWorld(
+    const std::vector<common::Uri>& uris)
+{
+  std::shared_ptr<simulation::World> world = simulation::World::create();
+  std::vector<std::shared_ptr<dynamics::Skeleton>> skeletons
+      = loadSkeletons(uris);
+  for (std::size_t i = 0; i < skeletons.size(); i++)
+  {
+    if (skeletons[i] == nullptr)
+    {
+      dtwarn << "[ModelCache::loadWorld] Failed to load model ["
+             << uris[i].toString() << "], skipping it.\n";
+      continue;
+    }
+    world->addSkeleton(skeletons[i]);
+  }
+  return world;
+}
+
+//==============================================================================
+std::size_t ModelCache::getNumCachedModels()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mModels.size();
+}
+
+//==============================================================================
+void ModelCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mModels.clear();
+}
+
+//==============================================================================
+std::shared_ptr<dynamics::Skeleton> ModelCache::getTemplate(
+    const common::Uri& uri)
+{
+  if (!mRetriever->exists(uri))
+  {
+    dterr << "[ModelCache::loadSkeleton] Unable to find model ["
+          << uri.toString() << "].\n";
+    return nullptr;
+  }
+  // Reading the file is cheap next to parsing it and loading its meshes, and
+  // it lets us notice when a file has changed under us
+  const std::string content = mRetriever->readAll(uri);
+  const std::size_t contentHash = std::hash<std::string>()(content);
+  const std::string key = uri.toString();
+
+  std::promise<std::shared_ptr<dynamics::Skeleton>> promise;
+  std::shared_future<std::shared_ptr<dynamics::Skeleton>> skeleton;
+  bool shouldParse = false;
+  std::size_t parseId = 0;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mModels.find(key);
+    if (it == mModels.end() || it->second.contentHash != contentHash)
+    {
+      CachedModel& model = mModels[key];
+      model.contentHash = contentHash;
+      model.parseId = parseId = mNextParseId++;
+      model.skeleton = promise.get_future().share();
+      shouldParse = true;
+    }
+    skeleton = mModels[key].skeleton;
+  }
+
+  // Anyone else asking for this file while we parse it will block on the
+  // shared future, rather than parsing it again
+  if (shouldParse)
+  {
+    std::shared_ptr<dynamics::Skeleton> parsed;
+    try
+    {
+      parsed = parseSkeleton(uri, content);
+      promise.set_value(parsed);
+    }
+    catch (...)
+    {
+      promise.set_exception(std::current_exception());
+    }
+
+    // Don't keep failures around, so the next load tries the file again
+    if (parsed == nullptr)
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      auto it = mModels.find(key);
+      if (it != mModels.end() && it->second.parseId == parseId)
+        mModels.erase(it);
+    }
+  }
+
+  try
+  {
+    return skeleton.get();
+  }
+  catch (const std::exception& e)
+  {
+    dterr << "[ModelCache::loadSkeleton] Failed to parse model ["
+          << uri.toString() << "]: " << e.what() << "\n";
+    return nullptr;
+  }
+}
+
+//==============================================================================
+std::shared_ptr<dynamics::Skeleton> ModelCache::parseSkeleton(
+    const common::Uri& uri, const std::string& content)
+{
+  const std::string path = uri.toString();
+  // The SDF and skel parsers read the file themselves, so serve them the
+  // contents we already have
+  const common::ResourceRetrieverPtr pinned
+      = std::make_shared<PinnedResourceRetriever>(uri, content, mRetriever);
+  if (hasSuffix(path, ".urdf"))
+  {
+    DartLoader urdfLoader;
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      for (const auto& package : mPackageDirectories)
+        urdfLoader.addPackageDirectory(package.first, package.second);
+    }
+    return urdfLoader.parseSkeletonString(content, uri, mRetriever);
+  }
+  else if (hasSuffix(path, ".sdf"))
+  {
+    return SdfParser::readSkeleton(uri, pinned);
+  }
+  else if (hasSuffix(path, ".skel"))
+  {
+    return SkelParser::readSkeleton(uri, pinned);
+  }
+
+  dterr << "[ModelCache::loadSkeleton] Attempting to load a file [" << path
+        << "] that does not have a supported extension. Currently, only "
+           "\".skel\", \".urdf\" and \".sdf\" files are supported.\n";
+  return nullptr;
+}
+
+} // namespace utils
+} // namespace dart
@@ -0,0 +1,103 @@
+#ifndef DART_UTILS_MODEL_CACHE_HPP_
+#define DART_UTILS_MODEL_CACHE_HPP_
+
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dart/common/ResourceRetriever.hpp"
+#include "dart/common/Uri.hpp"
+
+namespace dart {
+
+namespace dynamics {
+class Skeleton;
+}
+
+namespace simulation {
+class World;
+}
+
+namespace utils {
+
+/// This parses each model file (".urdf", ".sdf" or ".skel") once, keeps the
+/// resulting Skeleton around as a template, and hands out clones of it. Clones
+/// get their own copies of the template's shapes, but a cloned MeshShape
+/// still points at the template's imported mesh, so meshes are only read from
+/// disk on the first load. This is meant for setups like RL, where we spawn
+/// lots of worlds from the same handful of files.
+///
+/// Templates are keyed by URI and a hash of the file contents, so editing a
+/// file on disk will cause it to be re-parsed on the next load. The parsers
+/// are handed the exact contents that were hashed. Files that fail to parse
+/// aren't cached, so they are retried on the next load. All the methods are
+/// safe to call from multiple threads, and concurrent loads of the same file
+/// will only parse it once.
+class ModelCache
+{
+public:
+  /// If `retriever` is null, this reads "file://" and "dart://" URIs.
+  ModelCache(const common::ResourceRetrieverPtr& retriever = nullptr);
+
+  /// This is forwarded to the DartLoader used for URDF files. See
+  /// DartLoader::addPackageDirectory().
+  void addPackageDirectory(
+      const std::string& packageName, const std::string& packageDirectory);
+
+  /// Returns a fresh copy of the Skeleton in the file at `uri`, parsing the
+  /// file only if we haven't seen it (or its current contents) before.
+  /// Returns nullptr if the file can't be read or parsed.
+  std::shared_ptr<dynamics::Skeleton> loadSkeleton(const common::Uri& uri);
+
+  /// This loads the files in `uris` in parallel, on at most
+  /// std::thread::hardware_concurrency() threads, and returns the Skeletons in
+  /// the same order. Files that show up more than once are only parsed once.
+  std::vector<std::shared_ptr<dynamics::Skeleton>> loadSkeletons(
+      const std::vector<common::Uri>& uris);
+
+  /// This loads all of `uris` in parallel with loadSkeletons(), and adds them
+  /// to a new World, in order. Files that fail to load are skipped, with a
+  /// warning.
+  std::shared_ptr<simulation::World> loadWorld(
+      const std::vector<common::Uri>& uris);
+
+  /// Returns the number of files we're currently holding templates for
+  std::size_t getNumCachedModels();
+
+  /// Drops all the templates. Skeletons that were already handed out are not
+  /// affected.
+  void clear();
+
+protected:
+  /// Returns the parsed template for `uri`, parsing it if needed.
+  std::shared_ptr<dynamics::Skeleton> getTemplate(const common::Uri& uri);
+
+  /// Parses a model file, based on its extension
+  std::shared_ptr<dynamics::Skeleton> parseSkeleton(
+      const common::Uri& uri, const std::string& content);
+
+  struct CachedModel
+  {
+    std::size_t contentHash;
+    /// Tells apart entries for the same file, so a failed parse only evicts
+    /// its own entry
+    std::size_t parseId;
+    std::shared_future<std::shared_ptr<dynamics::Skeleton>> skeleton;
+  };
+
+  common::ResourceRetrieverPtr mRetriever;
+
+  std::mutex mMutex;
+  std::size_t mNextParseId;
+  std::vector<std::pair<std::string, std::string>> mPackageDirectories;
+  std::unordered_map<std::string, CachedModel> mModels;
+};
+
+} // namespace utils
+} // namespace dart
+
+#endif
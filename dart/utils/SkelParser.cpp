@@ -34,6 +34,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <future>
 #include <vector>
 
 #include <Eigen/Dense>
@@ -737,15 +738,23 @@ simulation::WorldPtr readWorld(
 
   //--------------------------------------------------------------------------
   // Load soft skeletons
+  // Skeletons don't depend on each other, so read them in parallel and then
+  // add them in file order
+  std::vector<std::future<dynamics::SkeletonPtr>> skeletonFutures;
   ElementEnumerator SkeletonElements(_worldElement, "skeleton");
   while (SkeletonElements.next())
   {
-    dynamics::SkeletonPtr newSkeleton = ::dart::utils::readSkeleton(
-        SkeletonElements.get(), _baseUri, _retriever);
-
-    newWorld->addSkeleton(newSkeleton);
+    tinyxml2::XMLElement* skeletonElement = SkeletonElements.get();
+    skeletonFutures.push_back(std::async(
+        std::launch::async, [skeletonElement, &_baseUri, &_retriever]() {
+          return ::dart::utils::readSkeleton(
+              skeletonElement, _baseUri, _retriever);
+        }));
   }
 
+  for (auto& future : skeletonFutures)
+    newWorld->addSkeleton(future.get());
+
   return newWorld;
 }
 
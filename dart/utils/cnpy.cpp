@@ -10,6 +10,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <iomanip>
+#include <limits>
 #include <regex>
 #include <stdexcept>
 
@@ -118,7 +119,7 @@ void cnpy::parse_npy_header(
   std::string str_shape = header.substr(loc1 + 1, loc2 - loc1 - 1);
   while (std::regex_search(str_shape, sm, num_regex))
   {
-    shape.push_back(std::stoi(sm[0].str()));
+    shape.push_back(std::stoull(sm[0].str()));
     str_shape = sm.suffix().str();
   }
 
@@ -176,7 +177,7 @@ void cnpy::parse_npy_header(
   std::string str_shape = header.substr(loc1 + 1, loc2 - loc1 - 1);
   while (std::regex_search(str_shape, sm, num_regex))
   {
-    shape.push_back(std::stoi(sm[0].str()));
+    shape.push_back(std::stoull(sm[0].str()));
     str_shape = sm.suffix().str();
   }
 
@@ -424,3 +425,547 @@ cnpy::NpyArray cnpy::npy_load(std::string fname)
   fclose(fp);
   return arr;
 }
+
+std::vector<char> cnpy::create_padded_npy_header(
+    char type,
+    size_t word_size,
+    const std::vector<size_t>& shape,
+    size_t min_header_size)
+{
+  std::vector<char> dict;
+  dict += "{'descr': '";
+  dict += BigEndianTest();
+  dict += type;
+  dict += std::to_string(word_size);
+  dict += "', 'fortran_order': False, 'shape': (";
+  dict += std::to_string(shape[0]);
+  for (size_t i = 1; i < shape.size(); i++)
+  {
+    dict += ", ";
+    dict += std::to_string(shape[i]);
+  }
+  if (shape.size() == 1)
+    dict += ",";
+  dict += "), }";
+
+  // preamble is 10 bytes, and the dict needs at least one trailing '\n'. pad
+  // to a multiple of 64 bytes, which newer numpy versions expect for alignment
+  size_t total = 10 + dict.size() + 1;
+  total = ((total + 63) / 64) * 64;
+  if (min_header_size > total)
+    total = ((min_header_size + 63) / 64) * 64;
+  dict.insert(dict.end(), total - 10 - dict.size(), ' ');
+  dict.back() = '\n';
+
+  std::vector<char> header;
+  header += (char)0x93;
+  header += "NUMPY";
+  header += (char)0x01; // major version of numpy format
+  header += (char)0x00; // minor version of numpy format
+  header += (uint16_t)dict.size();
+  header.insert(header.end(), dict.begin(), dict.end());
+
+  return header;
+}
+
+cnpy::NpyStreamWriter::NpyStreamWriter(
+    const std::string& _fname,
+    char _type,
+    size_t _word_size,
+    const std::vector<size_t>& _row_shape,
+    bool _track_crc)
+  : fname(_fname),
+    header_offset(0),
+    word_size(_word_size),
+    track_crc(_track_crc)
+{
+  fp.reset(fopen(fname.c_str(), "wb"));
+  if (!fp)
+    throw std::runtime_error(
+        "NpyStreamWriter: Unable to open file " + fname + " for writing");
+  init(_type, _row_shape);
+}
+
+cnpy::NpyStreamWriter::NpyStreamWriter(
+    FilePtr _fp,
+    long _header_offset,
+    const std::string& _fname,
+    char _type,
+    size_t _word_size,
+    const std::vector<size_t>& _row_shape,
+    bool _track_crc)
+  : fname(_fname),
+    fp(std::move(_fp)),
+    header_offset(_header_offset),
+    word_size(_word_size),
+    track_crc(_track_crc)
+{
+  init(_type, _row_shape);
+}
+
+void cnpy::NpyStreamWriter::init(
+    char _type, const std::vector<size_t>& _row_shape)
+{
+  type = _type;
+  row_shape = _row_shape;
+  row_size = 1;
+  rows = 0;
+  crc = crc32(0L, Z_NULL, 0);
+  for (size_t dim : row_shape)
+    row_size *= dim;
+
+  // reserve room for the largest possible leading dimension, so that close()
+  // can rewrite the header without moving any data
+  std::vector<size_t> shape;
+  shape.push_back(std::numeric_limits<size_t>::max());
+  shape.insert(shape.end(), row_shape.begin(), row_shape.end());
+  size_t reserved = create_padded_npy_header(type, word_size, shape).size();
+
+  shape[0] = 0;
+  header_bytes = create_padded_npy_header(type, word_size, shape, reserved);
+
+  if (fwrite(&header_bytes[0], sizeof(char), header_bytes.size(), fp.get())
+      != header_bytes.size())
+    throw std::runtime_error("NpyStreamWriter: failed fwrite to " + fname);
+}
+
+cnpy::NpyStreamWriter::~NpyStreamWriter()
+{
+  try
+  {
+    close();
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+  }
+}
+
+void cnpy::NpyStreamWriter::append_bytes(const void* data, size_t num_rows)
+{
+  if (!fp)
+    throw std::runtime_error(
+        "NpyStreamWriter: appending to closed file " + fname);
+
+  size_t nels = num_rows * row_size;
+  if (nels == 0)
+    return;
+  if (fwrite(data, word_size, nels, fp.get()) != nels)
+    throw std::runtime_error("NpyStreamWriter: failed fwrite to " + fname);
+
+  if (track_crc)
+  {
+    // crc32() takes a 32-bit length, so feed huge chunks piecewise
+    const Bytef* bytes = reinterpret_cast<const Bytef*>(data);
+    size_t remaining = nels * word_size;
+    while (remaining > 0)
+    {
+      uInt chunk = static_cast<uInt>(
+          std::min<size_t>(remaining, std::numeric_limits<uInt>::max()));
+      crc = crc32(crc, bytes, chunk);
+      bytes += chunk;
+      remaining -= chunk;
+    }
+  }
+  rows += num_rows;
+}
+
+cnpy::FilePtr cnpy::NpyStreamWriter::finish()
+{
+  FilePtr file = std::move(fp);
+  if (!file)
+    return file;
+
+  std::vector<size_t> shape;
+  shape.push_back(rows);
+  shape.insert(shape.end(), row_shape.begin(), row_shape.end());
+  std::vector<char> final_header = create_padded_npy_header(
+      type, word_size, shape, header_bytes.size());
+  assert(final_header.size() == header_bytes.size());
+  header_bytes = final_header;
+
+  if (fseek(file.get(), header_offset, SEEK_SET) != 0
+      || fwrite(
+             &header_bytes[0], sizeof(char), header_bytes.size(), file.get())
+             != header_bytes.size())
+    throw std::runtime_error(
+        "NpyStreamWriter: failed to finalize the header of " + fname);
+  return file;
+}
+
+void cnpy::NpyStreamWriter::close()
+{
+  FilePtr file = finish();
+  if (file && fclose(file.release()) != 0)
+    throw std::runtime_error("NpyStreamWriter: failed to close " + fname);
+}
+
+void cnpy::NpyStreamWriter::abandon()
+{
+  fp.reset();
+}
+
+size_t cnpy::NpyStreamWriter::num_rows() const
+{
+  return rows;
+}
+
+const std::vector<char>& cnpy::NpyStreamWriter::header() const
+{
+  return header_bytes;
+}
+
+uint32_t cnpy::NpyStreamWriter::data_crc() const
+{
+  return static_cast<uint32_t>(crc);
+}
+
+size_t cnpy::NpyStreamWriter::data_bytes() const
+{
+  return rows * row_size * word_size;
+}
+
+const std::string& cnpy::NpyStreamWriter::file_name() const
+{
+  return fname;
+}
+
+namespace cnpy {
+namespace {
+
+const uint64_t max32 = 0xFFFFFFFF;
+const uint64_t max16 = 0xFFFF;
+
+// Local file header of a stored (uncompressed) zip entry. With zip64_extra the
+// sizes live in a ZIP64 extra field, which is always 20 bytes long, so the
+// header length doesn't depend on the sizes.
+std::vector<char> create_zip_local_header(
+    const std::string& fname, uint32_t crc, uint64_t nbytes, bool zip64_extra)
+{
+  const bool zip64_sizes = zip64_extra && nbytes >= max32;
+
+  std::vector<char> local_header;
+  local_header += "PK";                                 // first part of sig
+  local_header += (uint16_t)0x0403;                     // second part of sig
+  local_header += (uint16_t)(zip64_extra ? 45 : 20);    // min version
+  local_header += (uint16_t)0;                          // general purpose flag
+  local_header += (uint16_t)0;                          // compression method
+  local_header += (uint16_t)0;                          // file last mod time
+  local_header += (uint16_t)0;                          // file last mod date
+  local_header += (uint32_t)crc;                        // crc
+  local_header += (uint32_t)(zip64_sizes ? max32 : nbytes); // compressed
+  local_header += (uint32_t)(zip64_sizes ? max32 : nbytes); // uncompressed
+  local_header += (uint16_t)fname.size();               // fname length
+  local_header += (uint16_t)(zip64_extra ? 20 : 0);     // extra field length
+  local_header += fname;
+  if (zip64_extra)
+  {
+    local_header += (uint16_t)0x0001; // zip64 extra field tag
+    local_header += (uint16_t)16;     // size of the extra field
+    local_header += (uint64_t)nbytes; // uncompressed size
+    local_header += (uint64_t)nbytes; // compressed size
+  }
+  return local_header;
+}
+
+// Central directory record for an entry whose local header is local_header
+void append_zip_global_header(
+    std::vector<char>& global_header,
+    const std::vector<char>& local_header,
+    const std::string& fname,
+    uint64_t nbytes,
+    uint64_t offset)
+{
+  const bool zip64_sizes = nbytes >= max32;
+  const bool zip64_offset = offset >= max32;
+
+  std::vector<char> extra;
+  if (zip64_sizes)
+  {
+    extra += (uint64_t)nbytes;
+    extra += (uint64_t)nbytes;
+  }
+  if (zip64_offset)
+    extra += (uint64_t)offset;
+
+  global_header += "PK";             // first part of sig
+  global_header += (uint16_t)0x0201; // second part of sig
+  global_header += (uint16_t)((zip64_sizes || zip64_offset) ? 45 : 20);
+  global_header += (uint16_t)((zip64_sizes || zip64_offset) ? 45 : 20);
+  global_header.insert(
+      global_header.end(),
+      local_header.begin() + 6,
+      local_header.begin() + 18);
+  global_header += (uint32_t)(zip64_sizes ? max32 : nbytes); // compressed
+  global_header += (uint32_t)(zip64_sizes ? max32 : nbytes); // uncompressed
+  global_header += (uint16_t)fname.size();
+  global_header += (uint16_t)(extra.empty() ? 0 : extra.size() + 4);
+  global_header += (uint16_t)0; // file comment length
+  global_header += (uint16_t)0; // disk number where file starts
+  global_header += (uint16_t)0; // internal file attributes
+  global_header += (uint32_t)0; // external file attributes
+  global_header += (uint32_t)(zip64_offset ? max32 : offset);
+  global_header += fname;
+  if (!extra.empty())
+  {
+    global_header += (uint16_t)0x0001;
+    global_header += (uint16_t)extra.size();
+    global_header.insert(global_header.end(), extra.begin(), extra.end());
+  }
+}
+
+} // namespace
+} // namespace cnpy
+
+cnpy::NpzStreamWriter::NpzStreamWriter(const std::string& _zipname)
+  : zipname(_zipname), closed(false)
+{
+}
+
+cnpy::NpzStreamWriter::~NpzStreamWriter()
+{
+  try
+  {
+    close();
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+  }
+}
+
+cnpy::NpyStreamWriter& cnpy::NpzStreamWriter::add_array(
+    const std::string& varname,
+    char type,
+    size_t word_size,
+    const std::vector<size_t>& row_shape)
+{
+  if (closed)
+    throw std::runtime_error(
+        "NpzStreamWriter: adding an array to closed archive " + zipname);
+  if (std::find(varnames.begin(), varnames.end(), varname) != varnames.end())
+    throw std::runtime_error(
+        "NpzStreamWriter: duplicate array " + varname + " in " + zipname);
+
+  if (writers.empty())
+  {
+    // the first entry goes straight into the archive, behind a placeholder
+    // local header that close() overwrites once the size and CRC are known
+    FilePtr fp(fopen(zipname.c_str(), "wb"));
+    if (!fp)
+      throw std::runtime_error(
+          "NpzStreamWriter: Unable to open file " + zipname + " for writing");
+    std::vector<char> local_header
+        = create_zip_local_header(varname + ".npy", 0, 0, true);
+    std::unique_ptr<NpyStreamWriter> writer;
+    try
+    {
+      if (fwrite(&local_header[0], sizeof(char), local_header.size(), fp.get())
+          != local_header.size())
+        throw std::runtime_error(
+            "NpzStreamWriter: failed fwrite to " + zipname);
+      writer.reset(new NpyStreamWriter(
+          std::move(fp),
+          static_cast<long>(local_header.size()),
+          zipname,
+          type,
+          word_size,
+          row_shape,
+          true));
+    }
+    catch (const std::exception&)
+    {
+      fp.reset();
+      std::remove(zipname.c_str());
+      throw;
+    }
+    varnames.push_back(varname);
+    writers.push_back(std::move(writer));
+    return *writers.back();
+  }
+
+  const std::string tmpname = zipname + "." + varname + ".npy.tmp";
+  std::unique_ptr<NpyStreamWriter> writer;
+  try
+  {
+    writer.reset(
+        new NpyStreamWriter(tmpname, type, word_size, row_shape, true));
+  }
+  catch (const std::exception&)
+  {
+    std::remove(tmpname.c_str());
+    throw;
+  }
+  varnames.push_back(varname);
+  writers.push_back(std::move(writer));
+  return *writers.back();
+}
+
+void cnpy::NpzStreamWriter::close()
+{
+  if (closed)
+    return;
+  closed = true;
+
+  try
+  {
+    write_archive();
+  }
+  catch (const std::exception&)
+  {
+    discard();
+    throw;
+  }
+  writers.clear();
+}
+
+void cnpy::NpzStreamWriter::discard()
+{
+  for (size_t i = 0; i < writers.size(); i++)
+  {
+    writers[i]->abandon();
+    if (i > 0)
+      std::remove(writers[i]->file_name().c_str());
+  }
+  writers.clear();
+  std::remove(zipname.c_str());
+}
+
+void cnpy::NpzStreamWriter::write_archive()
+{
+  FilePtr fp;
+  std::vector<char> global_header;
+  uint64_t offset = 0;
+
+  if (writers.empty())
+  {
+    fp.reset(fopen(zipname.c_str(), "wb"));
+    if (!fp)
+      throw std::runtime_error(
+          "NpzStreamWriter: Unable to open file " + zipname + " for writing");
+  }
+  else
+  {
+    // the first array was streamed into the archive itself, so all that is
+    // left is to fill in its local header
+    NpyStreamWriter& writer = *writers[0];
+    fp = writer.finish();
+    if (!fp)
+    {
+      // the caller already closed the first array itself
+      fp.reset(fopen(zipname.c_str(), "r+b"));
+      if (!fp)
+        throw std::runtime_error(
+            "NpzStreamWriter: Unable to reopen " + zipname);
+    }
+
+    const std::string fname = varnames[0] + ".npy";
+    const std::vector<char>& npy_header = writer.header();
+    const uint64_t nbytes = npy_header.size() + writer.data_bytes();
+    uint32_t crc = crc32(0L, (uint8_t*)&npy_header[0], npy_header.size());
+    crc = crc32_combine(crc, writer.data_crc(), writer.data_bytes());
+
+    std::vector<char> local_header
+        = create_zip_local_header(fname, crc, nbytes, true);
+    if (fseek(fp.get(), 0, SEEK_SET) != 0
+        || fwrite(&local_header[0], sizeof(char), local_header.size(), fp.get())
+               != local_header.size()
+        || fseek(fp.get(), 0, SEEK_END) != 0)
+      throw std::runtime_error(
+          "NpzStreamWriter: failed to write " + fname + " into " + zipname);
+    append_zip_global_header(global_header, local_header, fname, nbytes, 0);
+    offset += local_header.size() + nbytes;
+  }
+
+  std::vector<char> buffer(1 << 20);
+  for (size_t i = 1; i < writers.size(); i++)
+  {
+    NpyStreamWriter& writer = *writers[i];
+    writer.close();
+
+    const std::string fname = varnames[i] + ".npy";
+    const std::vector<char>& npy_header = writer.header();
+    const uint64_t nbytes = npy_header.size() + writer.data_bytes();
+    uint32_t crc = crc32(0L, (uint8_t*)&npy_header[0], npy_header.size());
+    crc = crc32_combine(crc, writer.data_crc(), writer.data_bytes());
+
+    std::vector<char> local_header
+        = create_zip_local_header(fname, crc, nbytes, nbytes >= max32);
+    append_zip_global_header(
+        global_header, local_header, fname, nbytes, offset);
+
+    // copy the finished .npy over in bounded chunks
+    FilePtr in(fopen(writer.file_name().c_str(), "rb"));
+    if (!in)
+      throw std::runtime_error(
+          "NpzStreamWriter: Unable to reopen " + writer.file_name());
+    bool ok
+        = fwrite(&local_header[0], sizeof(char), local_header.size(), fp.get())
+          == local_header.size();
+    uint64_t copied = 0;
+    while (ok)
+    {
+      size_t nread = fread(&buffer[0], sizeof(char), buffer.size(), in.get());
+      if (nread == 0)
+        break;
+      ok = fwrite(&buffer[0], sizeof(char), nread, fp.get()) == nread;
+      copied += nread;
+    }
+    in.reset();
+    if (!ok || copied != nbytes)
+      throw std::runtime_error(
+          "NpzStreamWriter: failed to copy " + fname + " into " + zipname);
+    std::remove(writer.file_name().c_str());
+
+    offset += local_header.size() + nbytes;
+  }
+
+  const uint64_t nrecs = writers.size();
+  const uint64_t global_header_offset = offset;
+  const uint64_t global_header_size = global_header.size();
+  const bool zip64_footer = nrecs >= max16 || global_header_offset >= max32
+                            || global_header_size >= max32;
+
+  std::vector<char> footer;
+  if (zip64_footer)
+  {
+    const uint64_t zip64_footer_offset
+        = global_header_offset + global_header_size;
+    footer += "PK";                            // first part of sig
+    footer += (uint16_t)0x0606;                // second part of sig
+    footer += (uint64_t)44;                    // size of the rest of record
+    footer += (uint16_t)45;                    // version made by
+    footer += (uint16_t)45;                    // version needed to extract
+    footer += (uint32_t)0;                     // number of this disk
+    footer += (uint32_t)0;                     // disk where footer starts
+    footer += (uint64_t)nrecs;                 // number of records on disk
+    footer += (uint64_t)nrecs;                 // total number of records
+    footer += (uint64_t)global_header_size;    // nbytes of global headers
+    footer += (uint64_t)global_header_offset;  // offset of global headers
+
+    footer += "PK";                            // first part of sig
+    footer += (uint16_t)0x0706;                // second part of sig
+    footer += (uint32_t)0;                     // disk with zip64 footer
+    footer += (uint64_t)zip64_footer_offset;   // offset of zip64 footer
+    footer += (uint32_t)1;                     // total number of disks
+  }
+  footer += "PK";                   // first part of sig
+  footer += (uint16_t)0x0605;       // second part of sig
+  footer += (uint16_t)0;            // number of this disk
+  footer += (uint16_t)0;            // disk where footer starts
+  footer += (uint16_t)std::min(nrecs, max16); // number of records on disk
+  footer += (uint16_t)std::min(nrecs, max16); // total number of records
+  footer += (uint32_t)std::min(global_header_size, max32);
+  footer += (uint32_t)std::min(global_header_offset, max32);
+  footer += (uint16_t)0; // zip file comment length
+
+  bool ok = true;
+  if (!global_header.empty())
+    ok = fwrite(&global_header[0], sizeof(char), global_header.size(), fp.get())
+         == global_header.size();
+  ok = ok && fwrite(&footer[0], sizeof(char), footer.size(), fp.get())
+                 == footer.size();
+  ok = (fclose(fp.release()) == 0) && ok;
+  if (!ok)
+    throw std::runtime_error("NpzStreamWriter: failed to write " + zipname);
+}
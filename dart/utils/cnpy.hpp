@@ -321,6 +321,187 @@ void npz_save(
   npz_save(zipname, fname, &data[0], shape, mode);
 }
 
+// Builds an npy header for an array of the given element type and shape whose
+// total length is at least min_header_size bytes (and always a multiple of 64).
+// Padding the header lets a streaming writer rewrite the final shape in place
+// once it knows how many rows it wrote.
+std::vector<char> create_padded_npy_header(
+    char type,
+    size_t word_size,
+    const std::vector<size_t>& shape,
+    size_t min_header_size = 0);
+
+// Closes a FILE* owned by a std::unique_ptr
+struct FileCloser
+{
+  void operator()(FILE* fp) const
+  {
+    if (fp)
+      fclose(fp);
+  }
+};
+
+typedef std::unique_ptr<FILE, FileCloser> FilePtr;
+
+// Streams a C-ordered .npy file one chunk of rows at a time, so arrays much
+// larger than memory can be exported. The header is written up front with
+// enough padding to hold any leading dimension, and is fixed up in place with
+// the real number of rows by close(). Only the FILE* buffer is held in memory.
+//
+// A single NpyStreamWriter must not be used from several threads at once, but
+// separate writers are independent and can be fed concurrently.
+class NpyStreamWriter
+{
+public:
+  // row_shape is the shape of a single row, i.e. every dimension but the
+  // first. It may be empty, in which case the array is 1D.
+  NpyStreamWriter(
+      const std::string& fname,
+      char type,
+      size_t word_size,
+      const std::vector<size_t>& row_shape,
+      bool track_crc = false);
+
+  template <typename T>
+  static std::unique_ptr<NpyStreamWriter> create(
+      const std::string& fname,
+      const std::vector<size_t>& row_shape,
+      bool track_crc = false)
+  {
+    return std::unique_ptr<NpyStreamWriter>(new NpyStreamWriter(
+        fname, map_type(typeid(T)), sizeof(T), row_shape, track_crc));
+  }
+
+  NpyStreamWriter(const NpyStreamWriter&) = delete;
+  NpyStreamWriter& operator=(const NpyStreamWriter&) = delete;
+
+  // Calls close() if it has not been called yet
+  ~NpyStreamWriter();
+
+  // Appends num_rows rows, stored contiguously in C order at data
+  template <typename T>
+  void append_rows(const T* data, size_t num_rows)
+  {
+    if (sizeof(T) != word_size)
+      throw std::runtime_error(
+          "NpyStreamWriter: appending data with the wrong word size to "
+          + fname);
+    append_bytes(data, num_rows);
+  }
+
+  template <typename T>
+  void append_rows(const std::vector<T>& data)
+  {
+    if (data.size() % row_size != 0)
+      throw std::runtime_error(
+          "NpyStreamWriter: appending a partial row to " + fname);
+    append_rows(data.data(), data.size() / row_size);
+  }
+
+  // Writes the final shape into the header and closes the file
+  void close();
+
+  size_t num_rows() const;
+
+  // Header as it is (or will be) on disk after close()
+  const std::vector<char>& header() const;
+
+  // CRC-32 of the data written after the header, if track_crc was set
+  uint32_t data_crc() const;
+
+  size_t data_bytes() const;
+
+  const std::string& file_name() const;
+
+private:
+  friend class NpzStreamWriter;
+
+  // Streams into fp, which is already open, starting at header_offset. Used by
+  // NpzStreamWriter to write an array directly into the archive.
+  NpyStreamWriter(
+      FilePtr fp,
+      long header_offset,
+      const std::string& fname,
+      char type,
+      size_t word_size,
+      const std::vector<size_t>& row_shape,
+      bool track_crc);
+
+  void init(char type, const std::vector<size_t>& row_shape);
+
+  void append_bytes(const void* data, size_t num_rows);
+
+  // Writes the final shape into the header and hands back the still open file,
+  // or nullptr if it was already closed
+  FilePtr finish();
+
+  // Closes the file without finalizing it, after an error elsewhere
+  void abandon();
+
+  std::string fname;
+  FilePtr fp;
+  long header_offset;
+  char type;
+  size_t word_size;
+  std::vector<size_t> row_shape;
+  size_t row_size;
+  size_t rows;
+  std::vector<char> header_bytes;
+  bool track_crc;
+  uLong crc;
+};
+
+// Streams several arrays into one .npz archive. The first array is written
+// straight into the archive. Zip entries must be contiguous, so every later
+// array goes to a temporary file next to the archive, and close() appends it.
+// Each array has its own NpyStreamWriter, so different arrays can be fed from
+// different threads at the same time. ZIP64 records are used wherever a size
+// or offset does not fit in 32 bits. The data CRCs are accumulated while
+// appending, so close() only needs one sequential copy of the later arrays.
+//
+// If close() fails, the temporary files and the partial archive are removed.
+class NpzStreamWriter
+{
+public:
+  explicit NpzStreamWriter(const std::string& zipname);
+
+  NpzStreamWriter(const NpzStreamWriter&) = delete;
+  NpzStreamWriter& operator=(const NpzStreamWriter&) = delete;
+
+  // Calls close() if it has not been called yet
+  ~NpzStreamWriter();
+
+  // Adds an array named varname. The returned writer stays owned by this
+  // object and is valid until close(). Not thread-safe: add every array before
+  // handing the writers to worker threads.
+  template <typename T>
+  NpyStreamWriter& add_array(
+      const std::string& varname, const std::vector<size_t>& row_shape)
+  {
+    return add_array(varname, map_type(typeid(T)), sizeof(T), row_shape);
+  }
+
+  NpyStreamWriter& add_array(
+      const std::string& varname,
+      char type,
+      size_t word_size,
+      const std::vector<size_t>& row_shape);
+
+  // Finalizes every array and writes the archive
+  void close();
+
+private:
+  void write_archive();
+
+  // Closes every writer and removes the temporary files and the archive
+  void discard();
+
+  std::string zipname;
+  std::vector<std::string> varnames;
+  std::vector<std::unique_ptr<NpyStreamWriter>> writers;
+  bool closed;
+};
+
 template <typename T>
 std::vector<char> create_npy_header(const std::vector<size_t>& shape)
 {
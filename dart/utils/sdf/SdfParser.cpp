@@ -34,6 +34,7 @@
 
 #include <fstream>
 #include <functional>
+#include <future>
 #include <iostream>
 #include <map>
 #include <string>
@@ -775,15 +776,23 @@ simulation::WorldPtr readWorld(
 
   //--------------------------------------------------------------------------
   // Load skeletons
+  // Each model is independent of the others, so we read them all at once
+  // (which mostly means loading their meshes in parallel), and then add them
+  // to the world in the order they appear in the file
+  std::vector<std::future<dynamics::SkeletonPtr>> skeletonFutures;
   ElementEnumerator skeletonElements(worldElement, "model");
   while (skeletonElements.next())
   {
-    dynamics::SkeletonPtr newSkeleton
-        = readSkeleton(skeletonElements.get(), baseUri, retriever);
-
-    newWorld->addSkeleton(newSkeleton);
+    tinyxml2::XMLElement* skeletonElement = skeletonElements.get();
+    skeletonFutures.push_back(std::async(
+        std::launch::async, [skeletonElement, &baseUri, &retriever]() {
+          return readSkeleton(skeletonElement, baseUri, retriever);
+        }));
   }
 
+  for (auto& future : skeletonFutures)
+    newWorld->addSkeleton(future.get());
+
   return newWorld;
 }
 
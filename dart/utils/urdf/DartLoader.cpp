@@ -33,6 +33,7 @@
 #include "dart/utils/urdf/DartLoader.hpp"
 
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <map>
 
@@ -164,11 +165,22 @@ simulation::WorldPtr DartLoader::parseWorldString(
 
   simulation::WorldPtr world = simulation::World::create();
 
+  // Building each Skeleton (and loading its meshes) is independent of the
+  // others, so do them all at once, and then add them to the world in order
+  std::vector<std::future<dynamics::SkeletonPtr>> skeletonFutures;
   for (std::size_t i = 0; i < worldInterface->models.size(); ++i)
   {
     const urdf_parsing::Entity& entity = worldInterface->models[i];
-    dynamics::SkeletonPtr skeleton = modelInterfaceToSkeleton(
-        entity.model.get(), entity.uri, resourceRetriever);
+    skeletonFutures.push_back(
+        std::async(std::launch::async, [&entity, &resourceRetriever]() {
+          return modelInterfaceToSkeleton(
+              entity.model.get(), entity.uri, resourceRetriever);
+        }));
+  }
+
+  for (std::size_t i = 0; i < worldInterface->models.size(); ++i)
+  {
+    dynamics::SkeletonPtr skeleton = skeletonFutures[i].get();
 
     if (!skeleton)
     {
@@ -163,7 +163,18 @@ void DynamicsFitter(py::module& m)
           ::py::arg("ddq"),
           ::py::arg("forcesConcat"),
           "This computes the acceleration we would need at the root in order "
-          "to remove all residual forces.");
+          "to remove all residual forces.")
+      .def(
+          "calculateResidualFreeRootAccelerationWithoutMassMatrix",
+          &dart::biomechanics::ResidualForceHelper::
+              calculateResidualFreeRootAccelerationWithoutMassMatrix,
+          ::py::arg("q"),
+          ::py::arg("dq"),
+          ::py::arg("ddq"),
+          ::py::arg("forcesConcat"),
+          "This computes the same thing as "
+          "calculateResidualFreeRootAcceleration(), but without forming the "
+          "full mass matrix.");
 
   ::py::class_<
       dart::biomechanics::DynamicsInitialization,
@@ -542,7 +553,13 @@ protected:
       .def(
           "setNumThreads",
           &dart::biomechanics::DynamicsFitProblemConfig::setNumThreads,
-          ::py::arg("value"));
+          ::py::arg("value"))
+      .def(
+          "setRandomDerivativeCheck",
+          &dart::biomechanics::DynamicsFitProblemConfig::
+              setRandomDerivativeCheck,
+          ::py::arg("numDirections"),
+          ::py::arg("tolerance") = 1e-4);
   ;
 
   ::py::class_<
@@ -953,7 +970,11 @@ protected:
       .def(
           "setDisableLinesearch",
           &dart::biomechanics::DynamicsFitter::setDisableLinesearch,
-          ::py::arg("value"));
+          ::py::arg("value"))
+      .def(
+          "setNumThreads",
+          &dart::biomechanics::DynamicsFitter::setNumThreads,
+          ::py::arg("numThreads"));
 }
 
 } // namespace python
@@ -301,6 +301,46 @@ void MarkerFitter(py::module& m)
             (a "warp"), in parallel, using the first timestep of the warp as the
             initialization for the whole warp. Defaults to False.
           )pydoc")
+      .def(
+          "setWarmStartIK",
+          &dart::biomechanics::MarkerFitter::setWarmStartIK,
+          ::py::arg("warmStart"),
+          R"pydoc(If True, trajectory IK seeds each timestep from a constant-velocity
+            extrapolation of the previous two solutions, and only falls back to
+            random restarts when the warm-started solve is worse than
+            setWarmStartIKRestartLoss(). The trajectory is split into contiguous
+            chunks that run in parallel. Takes precedence over
+            setParallelIKWarps(). Defaults to False.
+          )pydoc")
+      .def(
+          "setWarmStartIKRestartLoss",
+          &dart::biomechanics::MarkerFitter::setWarmStartIKRestartLoss,
+          ::py::arg("loss"))
+      .def(
+          "setWarmStartIKMaxRestarts",
+          &dart::biomechanics::MarkerFitter::setWarmStartIKMaxRestarts,
+          ::py::arg("maxRestarts"))
+      .def(
+          "setWarmStartIKNumChunks",
+          &dart::biomechanics::MarkerFitter::setWarmStartIKNumChunks,
+          ::py::arg("numChunks"))
+      .def(
+          "setSlidingWindowIK",
+          &dart::biomechanics::MarkerFitter::setSlidingWindowIK,
+          ::py::arg("slidingWindow"),
+          R"pydoc(If True, fineTuneIK() and smoothOutIK() solve fixed-length
+            overlapping windows of each trial in parallel, and blend the
+            overlapping timesteps linearly, so peak memory doesn't grow with the
+            length of the trial. Defaults to False.
+          )pydoc")
+      .def(
+          "setSlidingWindowIKSize",
+          &dart::biomechanics::MarkerFitter::setSlidingWindowIKSize,
+          ::py::arg("windowSize"))
+      .def(
+          "setSlidingWindowIKOverlap",
+          &dart::biomechanics::MarkerFitter::setSlidingWindowIKOverlap,
+          ::py::arg("overlap"))
       .def(
           "setMaxMarkerOffset",
           &dart::biomechanics::MarkerFitter::setMaxMarkerOffset,
@@ -313,6 +353,11 @@ void MarkerFitter(py::module& m)
           "setLBFGSHistory",
           &dart::biomechanics::MarkerFitter::setLBFGSHistory,
           ::py::arg("historyLen"))
+      .def(
+          "setRandomDerivativeCheck",
+          &dart::biomechanics::MarkerFitter::setRandomDerivativeCheck,
+          ::py::arg("numDirections"),
+          ::py::arg("tolerance") = 1e-4)
       .def(
           "setDebugLoss",
           &dart::biomechanics::MarkerFitter::setDebugLoss,
@@ -149,7 +149,24 @@ void MarkerLabeller(py::module& m)
           ::py::init<
               std::function<std::vector<std::map<std::string, Eigen::Vector3s>>(
                   const std::vector<std::vector<Eigen::Vector3s>>&)>>(),
-          ::py::arg("jointCenterPredictor"));
+          ::py::arg("jointCenterPredictor"))
+      .def(
+          ::py::init<
+              std::function<Eigen::MatrixXs(
+                  const Eigen::MatrixXs&, const Eigen::VectorXi&)>,
+              std::vector<std::string>,
+              int,
+              int>(),
+          ::py::arg("batchedJointCenterPredictor"),
+          ::py::arg("jointNames"),
+          ::py::arg("batchSize"),
+          ::py::arg("maxPoints"),
+          "This creates a labeller that packs the point clouds into "
+          "fixed-shape batches of shape 3 x (batchSize * width), zero padded "
+          "past numPoints[b] for each frame b, and calls "
+          "`batchedJointCenterPredictor(points, numPoints)` once per batch. "
+          "The predictor must return a (3 * len(jointNames)) x batchSize "
+          "matrix of joint centers.");
 }
 
 } // namespace python
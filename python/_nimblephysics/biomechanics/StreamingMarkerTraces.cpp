@@ -35,6 +35,7 @@
 #include <dart/dynamics/BodyNode.hpp>
 #include <dart/dynamics/Skeleton.hpp>
 #include <pybind11/eigen.h>
+#include <pybind11/functional.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
@@ -88,6 +89,37 @@ void StreamingMarkerTraces(py::module& m)
           "This method takes in the logits for each point, and the trace IDs "
           "for each point, and updates the internal state of the trace "
           "classifier to reflect the new information.")
+      .def(
+          "setBatchedTraceClassifier",
+          &dart::biomechanics::StreamingMarkerTraces::setBatchedTraceClassifier,
+          ::py::arg("classifier"),
+          ::py::arg("batchSize"),
+          ::py::arg("maxPoints"),
+          ::py::arg("maxLatencyMillis"),
+          "This sets a batched classifier for the traces. queueTraceFeatures() "
+          "collects features, and we call `classifier(features, numPoints)` "
+          "once per batch, with a 4 x (batchSize * maxPoints) features matrix "
+          "where frame b fills the first numPoints[b] columns of its "
+          "maxPoints-wide slot and the rest is zero padding. It must return a "
+          "numClasses x (batchSize * maxPoints) matrix of logits in the same "
+          "layout.")
+      .def(
+          "queueTraceFeatures",
+          &dart::biomechanics::StreamingMarkerTraces::queueTraceFeatures,
+          ::py::arg("numWindows"),
+          ::py::arg("windowDuration"),
+          ::py::arg("now"),
+          ::py::arg("center") = true,
+          "This computes the current trace features and queues them for the "
+          "batched classifier. Once a full batch is queued, or the oldest "
+          "queued frame is at least maxLatencyMillis older than `now`, the "
+          "batch is classified and the logits are applied to the traces. This "
+          "returns true if it classified a batch.")
+      .def(
+          "flushTraceFeatures",
+          &dart::biomechanics::StreamingMarkerTraces::flushTraceFeatures,
+          "This classifies whatever trace features are currently queued, even "
+          "if we don't have a full batch yet.")
       .def(
           "setMaxJoinDistance",
           &dart::biomechanics::StreamingMarkerTraces::setMaxJoinDistance,
@@ -660,7 +660,8 @@ Note that these are specified in the local body frame, acting on the body at its
                 ::py::arg("moments"),
                 ::py::arg("cops"),
                 ::py::arg("rootHistoryLen") = 5,
-                ::py::arg("rootHistoryStride") = 1)
+                ::py::arg("rootHistoryStride") = 1,
+                ::py::arg("numThreads") = 1)
             .def(
                 "computeKinematicValues",
                 &dart::biomechanics::SubjectOnDiskTrialPass::
@@ -671,7 +672,8 @@ Note that these are specified in the local body frame, acting on the body at its
                 ::py::arg("rootHistoryLen") = 5,
                 ::py::arg("rootHistoryStride") = 1,
                 ::py::arg("explicitVels") = Eigen::MatrixXs::Zero(0, 0),
-                ::py::arg("explicitAccs") = Eigen::MatrixXs::Zero(0, 0))
+                ::py::arg("explicitAccs") = Eigen::MatrixXs::Zero(0, 0),
+                ::py::arg("numThreads") = 1)
             .def(
                 "computeValuesFromForcePlates",
                 &dart::biomechanics::SubjectOnDiskTrialPass::
@@ -685,7 +687,8 @@ Note that these are specified in the local body frame, acting on the body at its
                 ::py::arg("rootHistoryStride") = 1,
                 ::py::arg("explicitVels") = Eigen::MatrixXs::Zero(0, 0),
                 ::py::arg("explicitAccs") = Eigen::MatrixXs::Zero(0, 0),
-                ::py::arg("forcePlateZeroThresholdNewtons") = 3.0)
+                ::py::arg("forcePlateZeroThresholdNewtons") = 3.0,
+                ::py::arg("numThreads") = 1)
             .def(
                 "setLinearResidual",
                 &dart::biomechanics::SubjectOnDiskTrialPass::setLinearResidual,
@@ -1146,8 +1149,11 @@ Note that these are specified in the local body frame, acting on the body at its
             dart::biomechanics::SubjectOnDisk,
             std::shared_ptr<dart::biomechanics::SubjectOnDisk>>(
             m, "SubjectOnDisk")
-            //   SubjectOnDisk(const std::string& path);
-            .def(::py::init<std::string>(), ::py::arg("path"))
+            //   SubjectOnDisk(const std::string& path, int64_t fileOffset = 0);
+            .def(
+                ::py::init<std::string, int64_t>(),
+                ::py::arg("path"),
+                ::py::arg("fileOffset") = 0)
             //   SubjectOnDisk(const std::string& path);
             .def(
                 ::py::init<
@@ -1565,6 +1571,54 @@ Note that these are specified in the local body frame, acting on the body at its
                 "The notes (if any) added by the person who uploaded this data "
                 "to AddBiomechanics.");
 
+  ::py::class_<
+      dart::biomechanics::SubjectOnDiskShard,
+      std::shared_ptr<dart::biomechanics::SubjectOnDiskShard>>(
+      m, "SubjectOnDiskShard")
+      .def(::py::init<std::string>(), ::py::arg("path"))
+      .def_static(
+          "packB3Ds",
+          &dart::biomechanics::SubjectOnDiskShard::packB3Ds,
+          ::py::arg("b3dPaths"),
+          ::py::arg("shardPath"),
+          "This packs many B3D files into a single shard file, with an index "
+          "at the front, so that large datasets can be moved and opened as "
+          "one file. Returns False, without touching `shardPath`, if any "
+          "input can't be read or two inputs share a file name.")
+      .def_static(
+          "unpackB3Ds",
+          &dart::biomechanics::SubjectOnDiskShard::unpackB3Ds,
+          ::py::arg("shardPath"),
+          ::py::arg("outputFolder"),
+          "This writes every subject in a shard back out as its own B3D file "
+          "in `outputFolder`, and returns the paths it wrote.")
+      .def(
+          "getNumSubjects",
+          &dart::biomechanics::SubjectOnDiskShard::getNumSubjects,
+          "The number of subjects packed in this shard.")
+      .def(
+          "getSubjectName",
+          &dart::biomechanics::SubjectOnDiskShard::getSubjectName,
+          ::py::arg("subject"),
+          "The original B3D file name of this subject.")
+      .def(
+          "getSubjectNumTrials",
+          &dart::biomechanics::SubjectOnDiskShard::getSubjectNumTrials,
+          ::py::arg("subject"),
+          "The number of trials on this subject, read from the shard index.")
+      .def(
+          "getSubjectTrialLength",
+          &dart::biomechanics::SubjectOnDiskShard::getSubjectTrialLength,
+          ::py::arg("subject"),
+          ::py::arg("trial"),
+          "The number of frames in this trial, read from the shard index.")
+      .def(
+          "getSubject",
+          &dart::biomechanics::SubjectOnDiskShard::getSubject,
+          ::py::arg("subject"),
+          "This returns a SubjectOnDisk that lazily reads this subject's "
+          "frames straight out of the shard.");
+
   subjectOnDisk.doc() = R"doc(
         This is for doing ML and large-scale data analysis. The idea here is to
         create a lazy-loadable view of a subject, where everything remains on disk
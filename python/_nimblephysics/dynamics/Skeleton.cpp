@@ -340,6 +340,75 @@ void Skeleton(
       .def_readwrite(
           "joints", &dynamics::Skeleton::EnergyAccountingFrame::joints);
 
+  ::py::class_<dart::dynamics::Skeleton::TrajectoryEnergyAccounting>(
+      m, "TrajectoryEnergyAccounting")
+      .def(::py::init<>())
+      .def_readwrite(
+          "bodyKineticEnergy",
+          &dynamics::Skeleton::TrajectoryEnergyAccounting::bodyKineticEnergy)
+      .def_readwrite(
+          "bodyPotentialEnergy",
+          &dynamics::Skeleton::TrajectoryEnergyAccounting::bodyPotentialEnergy)
+      .def_readwrite(
+          "bodyKineticEnergyDeriv",
+          &dynamics::Skeleton::TrajectoryEnergyAccounting::bodyKineticEnergyDeriv)
+      .def_readwrite(
+          "bodyPotentialEnergyDeriv",
+          &dynamics::Skeleton::TrajectoryEnergyAccounting::bodyPotentialEnergyDeriv)
+      .def_readwrite(
+          "bodyGravityPower",
+          &dynamics::Skeleton::TrajectoryEnergyAccounting::bodyGravityPower)
+      .def_readwrite(
+          "bodyExternalForcePower",
+          &dynamics::Skeleton::TrajectoryEnergyAccounting::bodyExternalForcePower)
+      .def_readwrite(
+          "bodyParentJointPower",
+          &dynamics::Skeleton::TrajectoryEnergyAccounting::bodyParentJointPower)
+      .def_readwrite(
+          "bodyChildJointPowerSum",
+          &dynamics::Skeleton::TrajectoryEnergyAccounting::bodyChildJointPowerSum)
+      .def_readwrite(
+          "jointPowerToParent",
+          &dynamics::Skeleton::TrajectoryEnergyAccounting::jointPowerToParent)
+      .def_readwrite(
+          "jointPowerToChild",
+          &dynamics::Skeleton::TrajectoryEnergyAccounting::jointPowerToChild)
+      .def_readwrite(
+          "contactPower",
+          &dynamics::Skeleton::TrajectoryEnergyAccounting::contactPower)
+      .def_readwrite(
+          "contactWork",
+          &dynamics::Skeleton::TrajectoryEnergyAccounting::contactWork);
+
+  ::py::class_<dart::dynamics::Skeleton::SensorNoiseModel>(
+      m, "SensorNoiseModel")
+      .def(::py::init<>())
+      .def_readwrite(
+          "accNoiseStddev",
+          &dynamics::Skeleton::SensorNoiseModel::accNoiseStddev)
+      .def_readwrite(
+          "gyroNoiseStddev",
+          &dynamics::Skeleton::SensorNoiseModel::gyroNoiseStddev)
+      .def_readwrite(
+          "accBiasStddev", &dynamics::Skeleton::SensorNoiseModel::accBiasStddev)
+      .def_readwrite(
+          "gyroBiasStddev",
+          &dynamics::Skeleton::SensorNoiseModel::gyroBiasStddev)
+      .def_readwrite("seed", &dynamics::Skeleton::SensorNoiseModel::seed);
+
+  ::py::class_<dart::dynamics::Skeleton::TrajectorySensorReadings>(
+      m, "TrajectorySensorReadings")
+      .def(::py::init<>())
+      .def_readwrite(
+          "sensorNames",
+          &dynamics::Skeleton::TrajectorySensorReadings::sensorNames)
+      .def_readwrite(
+          "accReadings",
+          &dynamics::Skeleton::TrajectorySensorReadings::accReadings)
+      .def_readwrite(
+          "gyroReadings",
+          &dynamics::Skeleton::TrajectorySensorReadings::gyroReadings);
+
   skeleton
       .def(::py::init(+[]() -> dart::dynamics::SkeletonPtr {
         return dart::dynamics::Skeleton::create();
@@ -845,10 +914,17 @@ void Skeleton(
           "getGradientOfLowestPointWrtJoints",
           &dart::dynamics::Skeleton::getGradientOfLowestPointWrtJoints,
           ::py::arg("up") = Eigen::Vector3s::UnitY())
-      .def("getRandomPose", &dart::dynamics::Skeleton::getRandomPose)
+      .def(
+          "getRandomPose",
+          +[](dart::dynamics::Skeleton* self) -> Eigen::VectorXs {
+            return self->getRandomPose();
+          })
       .def(
           "getRandomPoseForJoints",
-          &dart::dynamics::Skeleton::getRandomPoseForJoints,
+          +[](dart::dynamics::Skeleton* self,
+              std::vector<dart::dynamics::Joint*> joints) -> Eigen::VectorXs {
+            return self->getRandomPoseForJoints(joints);
+          },
           ::py::arg("joints"))
       .def(
           "getControlForceUpperLimits",
@@ -1244,6 +1320,13 @@ This returns the Jacobian relating changes in the magnetic field to changes in m
             return self->integrateVelocities(_dt);
           },
           ::py::arg("dt"))
+      .def(
+          "setParallelSoftBodyUpdates",
+          &dart::dynamics::Skeleton::setParallelSoftBodyUpdates,
+          ::py::arg("enable"))
+      .def(
+          "getParallelSoftBodyUpdates",
+          &dart::dynamics::Skeleton::getParallelSoftBodyUpdates)
 
       .def(
           "getPositionDifferences",
@@ -1312,6 +1395,31 @@ This returns the Jacobian relating changes in the magnetic field to changes in m
           ::py::arg("cops") = std::vector<Eigen::Vector3s>(),
           ::py::arg("forces") = std::vector<Eigen::Vector3s>(),
           ::py::arg("moments") = std::vector<Eigen::Vector3s>())
+      .def(
+          "getTrajectoryEnergyAccounting",
+          &dart::dynamics::Skeleton::getTrajectoryEnergyAccounting,
+          ::py::arg("poses"),
+          ::py::arg("vels"),
+          ::py::arg("accs"),
+          ::py::arg("dt"),
+          ::py::arg("heightAtZeroPoint") = 0,
+          ::py::arg("referenceFrameVelocity") = Eigen::Vector3s::Zero(),
+          ::py::arg("contactBodies") = std::vector<dynamics::BodyNode*>(),
+          ::py::arg("forces") = dart::dynamics::Skeleton::EMPTY,
+          ::py::arg("moments") = dart::dynamics::Skeleton::EMPTY,
+          ::py::arg("numThreads") = 1)
+      .def(
+          "getTrajectorySensorReadings",
+          &dart::dynamics::Skeleton::getTrajectorySensorReadings,
+          ::py::arg("poses"),
+          ::py::arg("vels"),
+          ::py::arg("accs"),
+          ::py::arg("sensors"),
+          ::py::arg("noise") = dart::dynamics::Skeleton::SensorNoiseModel(),
+          ::py::arg("numThreads") = 1,
+          R"docs(
+This computes the accelerometer and gyro readings for every sensor at every timestep of a trajectory, in one (3 * numSensors x numTimesteps) matrix each, optionally with noise and bias. The timesteps are split across `numThreads` threads, and the results for a given noise seed don't depend on the number of threads.
+    )docs")
       .def(
           "getSupportVersion",
           +[](const dart::dynamics::Skeleton* self) -> std::size_t {
@@ -63,7 +63,55 @@ void IKMapping(py::module& m)
           "addAngularBodyNode",
           &dart::neural::IKMapping::addAngularBodyNode,
           "This adds the angular (3D) coordinates of a body node to the "
-          "mapping, increasing the dimension of the mapped space by 3");
+          "mapping, increasing the dimension of the mapped space by 3")
+      .def(
+          "setPositionsWarmStart",
+          &dart::neural::IKMapping::setPositionsWarmStart,
+          ::py::arg("world"),
+          ::py::arg("positions"),
+          ::py::arg("initialGuess"),
+          "This runs the same IK solve as setPositions(), but starts from "
+          "initialGuess instead of from zero")
+      .def(
+          "getMappedPositionsTrajectory",
+          &dart::neural::IKMapping::getMappedPositionsTrajectory,
+          ::py::arg("world"),
+          ::py::arg("realPositions"),
+          ::py::arg("numThreads") = 1)
+      .def(
+          "getMappedVelocitiesTrajectory",
+          &dart::neural::IKMapping::getMappedVelocitiesTrajectory,
+          ::py::arg("world"),
+          ::py::arg("realPositions"),
+          ::py::arg("realVelocities"),
+          ::py::arg("numThreads") = 1)
+      .def(
+          "getRealPositionsTrajectory",
+          &dart::neural::IKMapping::getRealPositionsTrajectory,
+          ::py::arg("world"),
+          ::py::arg("mappedPositions"),
+          ::py::arg("numThreads") = 1,
+          "This solves IK for every column of mappedPositions, warm starting "
+          "each timestep from the solution of the one before it")
+      .def(
+          "getRealVelocitiesTrajectory",
+          &dart::neural::IKMapping::getRealVelocitiesTrajectory,
+          ::py::arg("world"),
+          ::py::arg("realPositions"),
+          ::py::arg("mappedVelocities"),
+          ::py::arg("numThreads") = 1)
+      .def(
+          "getRealPosToMappedPosJacTrajectory",
+          &dart::neural::IKMapping::getRealPosToMappedPosJacTrajectory,
+          ::py::arg("world"),
+          ::py::arg("realPositions"),
+          ::py::arg("numThreads") = 1)
+      .def(
+          "getRealVelToMappedVelJacTrajectory",
+          &dart::neural::IKMapping::getRealVelToMappedVelJacTrajectory,
+          ::py::arg("world"),
+          ::py::arg("realPositions"),
+          ::py::arg("numThreads") = 1);
 }
 
 } // namespace python
@@ -35,6 +35,7 @@
 #include <dart/dynamics/Skeleton.hpp>
 #include <dart/neural/WithRespectToMass.hpp>
 #include <dart/simulation/World.hpp>
+#include <dart/simulation/WorldJsonExporter.hpp>
 #include <dart/utils/UniversalLoader.hpp>
 #include <pybind11/eigen.h>
 #include <pybind11/functional.h>
@@ -52,7 +53,6 @@ void World(
         dart::simulation::World,
         std::shared_ptr<dart::simulation::World>>& world)
 {
-  (void)m;
   world
       .def(::py::init(+[]() -> dart::simulation::WorldPtr {
         return dart::simulation::World::create();
@@ -459,6 +459,11 @@ void World(
           "setParallelVelocityAndPositionUpdates",
           &dart::simulation::World::setParallelVelocityAndPositionUpdates,
           ::py::arg("enabled"))
+      .def("getNumThreads", &dart::simulation::World::getNumThreads)
+      .def(
+          "setNumThreads",
+          &dart::simulation::World::setNumThreads,
+          ::py::arg("numThreads"))
       .def(
           "getPenetrationCorrectionEnabled",
           &dart::simulation::World::getPenetrationCorrectionEnabled)
@@ -521,6 +526,23 @@ void World(
           ::py::arg("dofIndex"))
       .def("getStateJacobian", &dart::simulation::World::getStateJacobian)
       .def("getActionJacobian", &dart::simulation::World::getActionJacobian);
+
+  ::py::class_<
+      dart::simulation::WorldJsonExporter,
+      std::shared_ptr<dart::simulation::WorldJsonExporter>>(
+      m, "WorldJsonExporter")
+      .def(
+          ::py::init<std::shared_ptr<dart::simulation::World>>(),
+          ::py::arg("world"))
+      .def("toJson", &dart::simulation::WorldJsonExporter::toJson)
+      .def(
+          "positionsToJson",
+          &dart::simulation::WorldJsonExporter::positionsToJson)
+      .def("colorsToJson", &dart::simulation::WorldJsonExporter::colorsToJson)
+      .def(
+          "getNumExportedBodies",
+          &dart::simulation::WorldJsonExporter::getNumExportedBodies)
+      .def("reset", &dart::simulation::WorldJsonExporter::reset);
 }
 
 } // namespace python
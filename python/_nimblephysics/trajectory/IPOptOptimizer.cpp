@@ -69,6 +69,11 @@ void IPOptOptimizer(py::module& m)
           "setCheckDerivatives",
           &dart::trajectory::IPOptOptimizer::setCheckDerivatives,
           ::py::arg("checkDerivatives") = true)
+      .def(
+          "setRandomDerivativeCheck",
+          &dart::trajectory::IPOptOptimizer::setRandomDerivativeCheck,
+          ::py::arg("numDirections"),
+          ::py::arg("tolerance") = 1e-4)
       .def(
           "setPrintFrequency",
           &dart::trajectory::IPOptOptimizer::setPrintFrequency,
@@ -4371,6 +4371,19 @@ bool verifySkeletonMarkerJacobians(
     return false;
   }
 
+  Eigen::MatrixXs sparseScaleJac = Eigen::MatrixXs(
+      skel->getMarkerWorldPositionsSparseJacobianWrtBodyScales(markers));
+  Eigen::MatrixXs sparseGroupScaleJac = Eigen::MatrixXs(
+      skel->getMarkerWorldPositionsSparseJacobianWrtGroupScales(markers));
+  if (!equals(sparseScaleJac, scaleJac, 1e-12)
+      || !equals(sparseGroupScaleJac, groupScaleJac, 1e-12))
+  {
+    EXPECT_TRUE(equals(sparseScaleJac, scaleJac, 1e-12));
+    EXPECT_TRUE(equals(sparseGroupScaleJac, groupScaleJac, 1e-12));
+    std::cout << "Error on sparse Jac of markers wrt scales" << std::endl;
+    return false;
+  }
+
   Eigen::VectorXs target = Eigen::VectorXs::Random(markers.size() * 3);
 
   Eigen::VectorXs diffGrad
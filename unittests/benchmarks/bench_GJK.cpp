@@ -0,0 +1,164 @@
+#include <benchmark/benchmark.h>
+
+#include "dart/collision/CollisionResult.hpp"
+#include "dart/collision/dart/DARTCollide.hpp"
+#include "dart/collision/dart/DARTGJK.hpp"
+
+using namespace dart;
+using namespace collision;
+
+// All the benchmarks below slide the second shape along a little each
+// iteration, so warm starting sees the kind of coherence it gets in a
+// simulation, rather than the exact same query over and over.
+
+static Eigen::Isometry3s getSlidingTransform(int i)
+{
+  Eigen::Isometry3s T = Eigen::Isometry3s::Identity();
+  T.linear() = Eigen::AngleAxis_s(0.001 * (i % 1000), Eigen::Vector3s::UnitZ())
+                   .toRotationMatrix();
+  T.translation() = Eigen::Vector3s(0.0002 * (i % 1000), 0.1, 0.95);
+  return T;
+}
+
+static dynamics::MultiSphereConvexHullShape::Spheres getHullSpheres()
+{
+  dynamics::MultiSphereConvexHullShape::Spheres spheres;
+  spheres.emplace_back(0.1, Eigen::Vector3s(-0.3, -0.2, 0));
+  spheres.emplace_back(0.1, Eigen::Vector3s(0.3, -0.2, 0));
+  spheres.emplace_back(0.08, Eigen::Vector3s(-0.3, 0.2, 0.05));
+  spheres.emplace_back(0.08, Eigen::Vector3s(0.3, 0.2, 0.05));
+  spheres.emplace_back(0.05, Eigen::Vector3s(0, 0, 0.3));
+  return spheres;
+}
+
+static void BM_BoxBoxAsMesh_MPR(benchmark::State& state)
+{
+  Eigen::Vector3s size = Eigen::Vector3s::Ones();
+  Eigen::Isometry3s T0 = Eigen::Isometry3s::Identity();
+  CollisionOption option;
+  int i = 0;
+  for (auto _ : state)
+  {
+    CollisionResult result;
+    Eigen::Isometry3s T1 = getSlidingTransform(i++);
+    benchmark::DoNotOptimize(collideBoxBoxAsMesh(
+        nullptr, nullptr, size, T0, size, T1, option, result));
+  }
+}
+BENCHMARK(BM_BoxBoxAsMesh_MPR);
+
+static void BM_BoxBox_GJK(benchmark::State& state)
+{
+  Eigen::Vector3s size = Eigen::Vector3s::Ones();
+  Eigen::Isometry3s T0 = Eigen::Isometry3s::Identity();
+  Eigen::Isometry3s T1 = Eigen::Isometry3s::Identity();
+  ccdBox box0;
+  box0.size = &size;
+  box0.transform = &T0;
+  ccdBox box1;
+  box1.size = &size;
+  box1.transform = &T1;
+  GJKShape a{&box0, ccdSupportBox, ccdCenterBox};
+  GJKShape b{&box1, ccdSupportBox, ccdCenterBox};
+
+  GJKCache cache;
+  const bool warmStart = state.range(0) != 0;
+  int i = 0;
+  for (auto _ : state)
+  {
+    T1 = getSlidingTransform(i++);
+    benchmark::DoNotOptimize(
+        gjkPenetration(a, b, warmStart ? &cache : nullptr));
+  }
+}
+BENCHMARK(BM_BoxBox_GJK)->Arg(0)->Arg(1);
+
+static void BM_CapsuleBox_MPR(benchmark::State& state)
+{
+  Eigen::Vector3s size = Eigen::Vector3s(2.0, 2.0, 1.0);
+  Eigen::Isometry3s boxT = Eigen::Isometry3s::Identity();
+  CollisionOption option;
+  int i = 0;
+  for (auto _ : state)
+  {
+    CollisionResult result;
+    Eigen::Isometry3s capsuleT = getSlidingTransform(i++);
+    capsuleT.translation()(2) = 1.18;
+    benchmark::DoNotOptimize(collideCapsuleBox(
+        nullptr, nullptr, 1.0, 0.2, capsuleT, size, boxT, option, result));
+  }
+}
+BENCHMARK(BM_CapsuleBox_MPR);
+
+static void BM_CapsuleBox_GJK(benchmark::State& state)
+{
+  Eigen::Vector3s size = Eigen::Vector3s(2.0, 2.0, 1.0);
+  Eigen::Isometry3s boxT = Eigen::Isometry3s::Identity();
+  Eigen::Isometry3s capsuleT = Eigen::Isometry3s::Identity();
+  ccdCapsule capsule;
+  capsule.radius = 0.2;
+  capsule.height = 1.0;
+  capsule.transform = &capsuleT;
+  ccdBox box;
+  box.size = &size;
+  box.transform = &boxT;
+  GJKShape a{&capsule, ccdSupportCapsule, ccdCenterCapsule};
+  GJKShape b{&box, ccdSupportBox, ccdCenterBox};
+
+  GJKCache cache;
+  const bool warmStart = state.range(0) != 0;
+  int i = 0;
+  for (auto _ : state)
+  {
+    capsuleT = getSlidingTransform(i++);
+    capsuleT.translation()(2) = 1.18;
+    benchmark::DoNotOptimize(
+        gjkPenetration(a, b, warmStart ? &cache : nullptr));
+  }
+}
+BENCHMARK(BM_CapsuleBox_GJK)->Arg(0)->Arg(1);
+
+// What you'd do without a hull routine: collide every sphere in the hull
+// against the box on its own.
+static void BM_MultiSphereBox_PerSphere(benchmark::State& state)
+{
+  const auto spheres = getHullSpheres();
+  Eigen::Vector3s size = Eigen::Vector3s(2.0, 2.0, 1.0);
+  Eigen::Isometry3s boxT = Eigen::Isometry3s::Identity();
+  CollisionOption option;
+  int i = 0;
+  for (auto _ : state)
+  {
+    CollisionResult result;
+    Eigen::Isometry3s hullT = getSlidingTransform(i++);
+    hullT.translation()(2) = 0.595;
+    for (const auto& sphere : spheres)
+    {
+      Eigen::Isometry3s sphereT = Eigen::Isometry3s::Identity();
+      sphereT.translation() = hullT * sphere.second;
+      benchmark::DoNotOptimize(collideSphereBox(
+          nullptr, nullptr, sphere.first, sphereT, size, boxT, option, result));
+    }
+  }
+}
+BENCHMARK(BM_MultiSphereBox_PerSphere);
+
+static void BM_MultiSphereBox_GJK(benchmark::State& state)
+{
+  const auto spheres = getHullSpheres();
+  Eigen::Vector3s size = Eigen::Vector3s(2.0, 2.0, 1.0);
+  Eigen::Isometry3s boxT = Eigen::Isometry3s::Identity();
+  CollisionOption option;
+  int i = 0;
+  for (auto _ : state)
+  {
+    CollisionResult result;
+    Eigen::Isometry3s hullT = getSlidingTransform(i++);
+    hullT.translation()(2) = 0.595;
+    benchmark::DoNotOptimize(collideMultiSphereBox(
+        nullptr, nullptr, spheres, hullT, size, boxT, option, result));
+  }
+}
+BENCHMARK(BM_MultiSphereBox_GJK);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+
+#include "dart/dynamics/BallJoint.hpp"
+#include "dart/dynamics/BodyNode.hpp"
+#include "dart/dynamics/ConstantCurveIncompressibleJoint.hpp"
+#include "dart/dynamics/ConstantCurveJoint.hpp"
+#include "dart/dynamics/Skeleton.hpp"
+
+using namespace dart;
+using namespace dynamics;
+
+// Each iteration moves the joint to a new configuration and then asks for
+// everything a forward dynamics step asks of a joint at that configuration, so
+// the ConstantCurve joints can be compared against the BallJoint they stand in
+// for.
+
+static Eigen::VectorXs getSlidingPositions(int dofs, int i)
+{
+  Eigen::VectorXs pos = Eigen::VectorXs::Zero(dofs);
+  for (int d = 0; d < dofs; d++)
+  {
+    pos(d) = 0.3 * sin(0.01 * (i % 1000) + d);
+  }
+  return pos;
+}
+
+template <typename JointType>
+static void BM_JointStep(benchmark::State& state)
+{
+  SkeletonPtr skel = Skeleton::create();
+  JointType* joint = skel->createJointAndBodyNodePair<JointType>().first;
+  const int dofs = static_cast<int>(joint->getNumDofs());
+  joint->setVelocities(Eigen::VectorXs::Ones(dofs) * 0.5);
+
+  int i = 0;
+  for (auto _ : state)
+  {
+    joint->setPositions(getSlidingPositions(dofs, i++));
+    benchmark::DoNotOptimize(joint->getRelativeTransform());
+    benchmark::DoNotOptimize(joint->getRelativeJacobian());
+    benchmark::DoNotOptimize(joint->getRelativeJacobianTimeDeriv());
+  }
+}
+BENCHMARK_TEMPLATE(BM_JointStep, BallJoint);
+BENCHMARK_TEMPLATE(BM_JointStep, ConstantCurveJoint);
+BENCHMARK_TEMPLATE(BM_JointStep, ConstantCurveIncompressibleJoint);
+
+template <typename JointType>
+static void BM_JointJacobianDerivs(benchmark::State& state)
+{
+  SkeletonPtr skel = Skeleton::create();
+  JointType* joint = skel->createJointAndBodyNodePair<JointType>().first;
+  const int dofs = static_cast<int>(joint->getNumDofs());
+
+  int i = 0;
+  for (auto _ : state)
+  {
+    joint->setPositions(getSlidingPositions(dofs, i++));
+    for (int d = 0; d < dofs; d++)
+    {
+      benchmark::DoNotOptimize(joint->getRelativeJacobianDerivWrtPosition(d));
+    }
+  }
+}
+BENCHMARK_TEMPLATE(BM_JointJacobianDerivs, BallJoint);
+BENCHMARK_TEMPLATE(BM_JointJacobianDerivs, ConstantCurveJoint);
+BENCHMARK_TEMPLATE(BM_JointJacobianDerivs, ConstantCurveIncompressibleJoint);
+
+BENCHMARK_MAIN();
@@ -357,4 +357,84 @@ TEST(GRADIENTS, WORLD_SPACE_BOXES_FREE_JOINT)
 {
   testWorldSpaceWithBoxes(2);
 }
-#endif
\ No newline at end of file
+#endif
+#ifdef ALL_TESTS
+TEST(GRADIENTS, IK_MAPPING_TRAJECTORY_MATCHES_PER_TIMESTEP)
+{
+  WorldPtr world = World::create();
+  SkeletonPtr arm = Skeleton::create("arm");
+  BodyNode* parent = nullptr;
+  for (std::size_t i = 0; i < 3; i++)
+  {
+    std::pair<RevoluteJoint*, BodyNode*> jointPair
+        = arm->createJointAndBodyNodePair<RevoluteJoint>(parent);
+    if (parent != nullptr)
+    {
+      Eigen::Isometry3s armOffset = Eigen::Isometry3s::Identity();
+      armOffset.translation() = Eigen::Vector3s(0, 1.0, 0);
+      jointPair.first->setTransformFromParentBodyNode(armOffset);
+    }
+    jointPair.first->setAxis(Eigen::Vector3s(1, 0, 0));
+    parent = jointPair.second;
+  }
+  world->addSkeleton(arm);
+
+  std::shared_ptr<IKMapping> mapping = std::make_shared<IKMapping>(world);
+  mapping->addLinearBodyNode(arm->getBodyNode(1));
+  mapping->addLinearBodyNode(arm->getBodyNode(2));
+
+  const int steps = 20;
+  Eigen::MatrixXs realPoses = Eigen::MatrixXs::Zero(3, steps);
+  Eigen::MatrixXs realVels = Eigen::MatrixXs::Zero(3, steps);
+  for (int t = 0; t < steps; t++)
+  {
+    realPoses.col(t) = Eigen::Vector3s(0.1, 0.2, -0.3) * (1.0 + 0.05 * t);
+    realVels.col(t) = Eigen::Vector3s(0.5, -0.1, 0.2);
+  }
+
+  world->setPositions(Eigen::Vector3s(0.7, 0.7, 0.7));
+  const Eigen::VectorXs originalPositions = world->getPositions();
+
+  Eigen::MatrixXs mappedSerial
+      = mapping->getMappedPositionsTrajectory(world, realPoses, 1);
+  Eigen::MatrixXs mappedParallel
+      = mapping->getMappedPositionsTrajectory(world, realPoses, 4);
+  EXPECT_TRUE(equals(mappedSerial, mappedParallel, 0));
+  EXPECT_TRUE(equals(originalPositions, world->getPositions(), 0));
+
+  Eigen::MatrixXs mappedVels = mapping->getMappedVelocitiesTrajectory(
+      world, realPoses, realVels, 4);
+  Eigen::MatrixXs posJacs
+      = mapping->getRealPosToMappedPosJacTrajectory(world, realPoses, 4);
+  Eigen::MatrixXs velJacs
+      = mapping->getRealVelToMappedVelJacTrajectory(world, realPoses, 4);
+  for (int t = 0; t < steps; t++)
+  {
+    world->setPositions(realPoses.col(t));
+    world->setVelocities(realVels.col(t));
+    EXPECT_TRUE(
+        equals(Eigen::VectorXs(mapping->getPositions(world)),
+               Eigen::VectorXs(mappedSerial.col(t)),
+               0));
+    EXPECT_TRUE(
+        equals(Eigen::VectorXs(mapping->getVelocities(world)),
+               Eigen::VectorXs(mappedVels.col(t)),
+               1e-12));
+    EXPECT_TRUE(equals(
+        mapping->getRealPosToMappedPosJac(world),
+        Eigen::MatrixXs(posJacs.block(t * 6, 0, 6, 3)),
+        0));
+    EXPECT_TRUE(equals(
+        mapping->getRealVelToMappedVelJac(world),
+        Eigen::MatrixXs(velJacs.block(t * 6, 0, 6, 3)),
+        0));
+  }
+
+  // Warm-started IK recovers poses that reproduce the mapped trajectory
+  Eigen::MatrixXs recovered
+      = mapping->getRealPositionsTrajectory(world, mappedSerial, 2);
+  Eigen::MatrixXs remapped
+      = mapping->getMappedPositionsTrajectory(world, recovered, 1);
+  EXPECT_TRUE(equals(mappedSerial, remapped, 1e-6));
+}
+#endif
@@ -39,6 +39,7 @@
 #include "dart/common/Console.hpp"
 #include "dart/dynamics/Joint.hpp"
 #include "dart/dynamics/PointMass.hpp"
+#include "dart/dynamics/RevoluteJoint.hpp"
 #include "dart/dynamics/Skeleton.hpp"
 #include "dart/dynamics/SoftBodyNode.hpp"
 #include "dart/math/Constants.hpp"
@@ -459,3 +460,84 @@ TEST_F(SoftDynamicsTest, compareEquationsOfMotion)
   //    compareEquationsOfMotion(getList()[i]);
   //  }
 }
+
+//==============================================================================
+TEST_F(SoftDynamicsTest, parallelSoftBodyUpdatesMatchSerial)
+{
+  using namespace dynamics;
+
+  SkeletonPtr serialSkel = Skeleton::create("soft_chain");
+  BodyNode* parent = nullptr;
+  for (int i = 0; i < 3; ++i)
+  {
+    SoftBodyNode* softBody
+        = serialSkel
+              ->createJointAndBodyNodePair<RevoluteJoint, SoftBodyNode>(parent)
+              .second;
+    // The first two bodies are big enough to get their own tasks, the last
+    // one is small enough to be swept on the calling thread
+    const int resolution = i < 2 ? 20 : 4;
+    SoftBodyNodeHelper::setBox(
+        softBody,
+        Eigen::Vector3s::Constant(0.3),
+        Eigen::Isometry3s::Identity(),
+        Eigen::Vector3i::Constant(resolution),
+        1.0);
+    parent = softBody;
+  }
+  serialSkel->setPositions(Eigen::VectorXs::Random(serialSkel->getNumDofs()));
+
+  for (std::size_t i = 0; i < serialSkel->getNumSoftBodyNodes(); ++i)
+  {
+    SoftBodyNode* softBody = serialSkel->getSoftBodyNode(i);
+    EXPECT_GT(softBody->getNumPointMasses(), 8u);
+    for (std::size_t j = 0; j < softBody->getNumPointMasses(); ++j)
+    {
+      PointMass* pointMass = softBody->getPointMass(j);
+      pointMass->setPositions(0.01 * Eigen::Vector3s::Random());
+      pointMass->setVelocities(Eigen::Vector3s::Random());
+      pointMass->setAccelerations(Eigen::Vector3s::Random());
+    }
+  }
+
+  SkeletonPtr parallelSkel = serialSkel->cloneSkeleton();
+  parallelSkel->setParallelSoftBodyUpdates(true);
+  EXPECT_TRUE(parallelSkel->getParallelSoftBodyUpdates());
+  EXPECT_FALSE(serialSkel->getParallelSoftBodyUpdates());
+
+  const s_t dt = 1e-3;
+  for (SkeletonPtr skel : {serialSkel, parallelSkel})
+  {
+    skel->integrateVelocities(dt);
+    skel->integratePositions(dt);
+  }
+
+  for (std::size_t i = 0; i < serialSkel->getNumSoftBodyNodes(); ++i)
+  {
+    SoftBodyNode* serialBody = serialSkel->getSoftBodyNode(i);
+    SoftBodyNode* parallelBody = parallelSkel->getSoftBodyNode(i);
+    const Eigen::Isometry3s& T = serialBody->getWorldTransform();
+    for (std::size_t j = 0; j < serialBody->getNumPointMasses(); ++j)
+    {
+      const PointMass* serialPm = serialBody->getPointMass(j);
+      const PointMass* parallelPm = parallelBody->getPointMass(j);
+      EXPECT_TRUE(equals(serialPm->getPositions(), parallelPm->getPositions()));
+      EXPECT_TRUE(
+          equals(serialPm->getVelocities(), parallelPm->getVelocities()));
+
+      // The batched transform update must match the per-point definition
+      Eigen::Vector3s expectedWorld
+          = T * (serialPm->getPositions() + serialPm->getRestingPosition());
+      EXPECT_TRUE(equals(serialPm->getWorldPosition(), expectedWorld));
+      EXPECT_TRUE(equals(
+          parallelPm->getWorldPosition(), serialPm->getWorldPosition()));
+
+      // So must the batched velocity update
+      const Eigen::Vector6s& V = serialBody->getSpatialVelocity();
+      Eigen::Vector3s expectedVel
+          = V.head<3>().cross(serialPm->getLocalPosition()) + V.tail<3>()
+            + serialPm->getVelocities();
+      EXPECT_TRUE(equals(serialPm->getBodyVelocity(), expectedVel));
+    }
+  }
+}
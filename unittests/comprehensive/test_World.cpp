@@ -317,6 +317,52 @@ TEST(World, ValidatingClones)
   }
 }
 
+//==============================================================================
+TEST(World, MultithreadedStepMatchesSerial)
+{
+  std::vector<common::Uri> fileList;
+  fileList.push_back("dart://sample/skel/test/double_pendulum.skel");
+  fileList.push_back("dart://sample/skel/test/serial_chain_ball_joint.skel");
+  fileList.push_back("dart://sample/skel/test/tree_structure.skel");
+  fileList.push_back("dart://sample/skel/fullbody1.skel");
+
+  // Gather the skeletons from several files into one multi-agent world
+  dart::simulation::WorldPtr serial = World::create();
+  for(std::size_t i=0; i<fileList.size(); ++i)
+  {
+    WorldPtr world = utils::SkelParser::readWorld(fileList[i]);
+    for(std::size_t k=0; k<world->getNumSkeletons(); ++k)
+      serial->addSkeleton(world->getSkeleton(k)->cloneSkeleton());
+  }
+  EXPECT_EQ(serial->getNumThreads(), 1);
+
+  dart::simulation::WorldPtr threaded = serial->clone();
+  threaded->setNumThreads(4);
+  EXPECT_EQ(threaded->getNumThreads(), 4);
+
+  for(std::size_t j=0; j<20; ++j)
+  {
+    for(std::size_t k=0; k<serial->getNumSkeletons(); ++k)
+    {
+      Eigen::VectorXs commands = serial->getSkeleton(k)->getCommands();
+      for(int q=0; q<commands.size(); ++q)
+        commands[q] = Random::uniform(-0.1, 0.1);
+      serial->getSkeleton(k)->setCommands(commands);
+      threaded->getSkeleton(k)->setCommands(commands);
+    }
+    serial->step();
+    threaded->step();
+
+    // Resizing the worker pool halfway through shouldn't change anything
+    if (j == 10)
+      threaded->setNumThreads(2);
+  }
+  EXPECT_EQ(threaded->getNumThreads(), 2);
+
+  EXPECT_TRUE(equals(serial->getPositions(), threaded->getPositions(), 0));
+  EXPECT_TRUE(equals(serial->getVelocities(), threaded->getVelocities(), 0));
+}
+
 //==============================================================================
 simulation::WorldPtr createWorld()
 {
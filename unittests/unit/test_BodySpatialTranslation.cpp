@@ -117,6 +117,15 @@ bool verifySpatialJacobians(
     }
 
     Eigen::MatrixXs accJ = skel->getBodyWorldAccelerationsJacobian(wrt);
+    Eigen::MatrixXs accJ_sparse
+        = Eigen::MatrixXs(skel->getBodyWorldAccelerationsSparseJacobian(wrt));
+    if (!equals(accJ_sparse, accJ, 1e-10))
+    {
+      std::cout << "Sparse acc wrt " << wrt->name()
+                << " disagrees with the dense one!" << std::endl;
+      std::cout << "Diff: " << std::endl << accJ_sparse - accJ << std::endl;
+      return false;
+    }
     Eigen::MatrixXs accJ_fd
         = skel->finiteDifferenceBodyWorldAccelerationsJacobian(wrt);
     if (!equals(accJ, accJ_fd, 1e-8))
@@ -113,6 +113,45 @@ TEST(C3D, TEST_VERTICAL_CONVENTION)
 }
 #endif
 
+#ifdef ALL_TESTS
+TEST(C3D, FIXUP_MARKER_FLIPS)
+{
+  // Two markers walk along parallel lines and swap labels for a stretch of
+  // frames that crosses the boundaries between parallel chunks
+  biomechanics::C3D c3d;
+  c3d.markers.push_back("A");
+  c3d.markers.push_back("B");
+  c3d.markers.push_back("C");
+  const int numTimesteps = 10000;
+  for (int t = 0; t < numTimesteps; t++)
+  {
+    Eigen::Vector3s a(0.001 * t, 0, 0);
+    Eigen::Vector3s b(0.001 * t, 0.1, 0);
+    const bool swapped = t >= 4000 && t < 8200;
+    std::map<std::string, Eigen::Vector3s> markers;
+    markers["A"] = swapped ? b : a;
+    markers["B"] = swapped ? a : b;
+    // C drops in and out, and never gets confused with anything
+    if (t % 3 != 0)
+    {
+      markers["C"] = Eigen::Vector3s(0.001 * t, 5.0, 0);
+    }
+    c3d.markerTimesteps.push_back(markers);
+  }
+
+  std::vector<std::vector<std::pair<std::string, std::string>>> flips
+      = biomechanics::C3DLoader::fixupMarkerFlips(&c3d);
+
+  ASSERT_EQ(flips.size(), numTimesteps);
+  for (int t = 0; t < numTimesteps; t++)
+  {
+    EXPECT_EQ(flips[t].size(), t >= 4000 && t < 8200 ? 1 : 0);
+    EXPECT_NEAR(c3d.markerTimesteps[t].at("A")(1), 0.0, 1e-12);
+    EXPECT_NEAR(c3d.markerTimesteps[t].at("B")(1), 0.1, 1e-12);
+  }
+}
+#endif
+
 /*
 #ifdef ALL_TESTS
 TEST(C3D, TEST_NO_NAMED_MARKERS)
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdio>
+#include <future>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "dart/utils/cnpy.hpp"
+
+//==============================================================================
+TEST(Cnpy, StreamedNpyMatchesShape)
+{
+  const std::string fileName = "testStream.npy";
+  {
+    auto writer = cnpy::NpyStreamWriter::create<double>(fileName, {4});
+    for (int chunk = 0; chunk < 10; chunk++)
+    {
+      std::vector<double> rows(4 * (chunk + 1));
+      for (std::size_t i = 0; i < rows.size(); i++)
+        rows[i] = chunk * 1000 + i;
+      writer->append_rows(rows);
+    }
+    writer->close();
+    EXPECT_EQ(55u, writer->num_rows());
+  }
+
+  cnpy::NpyArray array = cnpy::npy_load(fileName);
+  ASSERT_EQ(2u, array.shape.size());
+  EXPECT_EQ(55u, array.shape[0]);
+  EXPECT_EQ(4u, array.shape[1]);
+  EXPECT_FALSE(array.fortran_order);
+  // Row 1 is the first row of chunk 1
+  EXPECT_EQ(1000.0, array.data<double>()[4]);
+  EXPECT_EQ(9000.0 + 39, array.data<double>()[55 * 4 - 1]);
+
+  std::remove(fileName.c_str());
+}
+
+//==============================================================================
+TEST(Cnpy, StreamedNpzFromSeveralThreads)
+{
+  const std::string fileName = "testStream.npz";
+  {
+    cnpy::NpzStreamWriter npz(fileName);
+    cnpy::NpyStreamWriter& poses = npz.add_array<double>("poses", {2, 3});
+    cnpy::NpyStreamWriter& ids = npz.add_array<int>("ids", {});
+
+    std::vector<std::future<void>> futures;
+    futures.push_back(std::async(std::launch::async, [&poses]() {
+      for (int i = 0; i < 300; i++)
+      {
+        double row[6] = {1.0 * i, 2.0 * i, 3.0 * i, 4.0 * i, 5.0 * i, 6.0 * i};
+        poses.append_rows(row, 1);
+      }
+    }));
+    futures.push_back(std::async(std::launch::async, [&ids]() {
+      for (int i = 0; i < 500; i++)
+        ids.append_rows(&i, 1);
+    }));
+    for (auto& future : futures)
+      future.get();
+
+    npz.close();
+  }
+
+  cnpy::npz_t arrays = cnpy::npz_load(fileName);
+  ASSERT_EQ(2u, arrays.size());
+  EXPECT_EQ(300u, arrays["poses"].shape[0]);
+  EXPECT_EQ(3u, arrays["poses"].shape[2]);
+  EXPECT_EQ(6.0 * 299, arrays["poses"].data<double>()[300 * 6 - 1]);
+  EXPECT_EQ(500u, arrays["ids"].shape[0]);
+  EXPECT_EQ(499, arrays["ids"].data<int>()[499]);
+
+  cnpy::NpyArray ids = cnpy::npz_load(fileName, "ids");
+  EXPECT_EQ(500u, ids.num_vals);
+
+  std::remove(fileName.c_str());
+}
+
+//==============================================================================
+TEST(Cnpy, StreamedNpzRemovesFilesOnFailure)
+{
+  const std::string fileName = "testStreamFailure.npz";
+  const std::string tmpName = fileName + ".ids.npy.tmp";
+  {
+    cnpy::NpzStreamWriter npz(fileName);
+    cnpy::NpyStreamWriter& poses = npz.add_array<double>("poses", {3});
+    npz.add_array<int>("ids", {});
+    double row[3] = {1.0, 2.0, 3.0};
+    poses.append_rows(row, 1);
+
+    // Only the arrays after the first one are buffered in temporary files
+    FILE* tmp = fopen(tmpName.c_str(), "rb");
+    ASSERT_NE(nullptr, tmp);
+    fclose(tmp);
+
+    // Pull the second array out from under the writer, so assembling fails
+    std::remove(tmpName.c_str());
+    EXPECT_THROW(npz.close(), std::runtime_error);
+  }
+
+  EXPECT_EQ(nullptr, fopen(fileName.c_str(), "rb"));
+  EXPECT_EQ(nullptr, fopen(tmpName.c_str(), "rb"));
+}
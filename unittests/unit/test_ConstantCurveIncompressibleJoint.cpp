@@ -484,3 +484,92 @@ TEST(ConstantCurveIncompressibleJoint, ConstantCurveJacobians)
   }
 }
 // #endif
+
+//==============================================================================
+// Sets up `joint` like the example shoulder, at a fixed configuration
+void setUpExampleShoulder(ConstantCurveIncompressibleJoint& joint)
+{
+  Eigen::Isometry3s transformFromParent = Eigen::Isometry3s::Identity();
+  transformFromParent.translation() = Eigen::Vector3s(-0.02, -0.0173, 0.07);
+  transformFromParent.linear()
+      = math::eulerXYZToMatrix(Eigen::Vector3s(0, -0.87, 0));
+  joint.setTransformFromParentBodyNode(transformFromParent);
+  Eigen::Isometry3s transformFromChild = Eigen::Isometry3s::Identity();
+  transformFromChild.translation()
+      = Eigen::Vector3s(-0.05982, -0.03904, -0.056);
+  transformFromChild.linear()
+      = math::eulerXYZToMatrix(Eigen::Vector3s(-0.5181, -1.1416, -0.2854));
+  joint.setTransformFromChildBodyNode(transformFromChild);
+  joint.setChildScale(Eigen::Vector3s::Ones() * 0.4);
+  joint.setPositions(Eigen::Vector3s(0.3, -0.2, 0.4));
+  joint.setVelocities(Eigen::Vector3s(0.5, 0.1, -0.3));
+}
+
+//==============================================================================
+// Checks that everything the curve cache feeds into agrees between two joints
+void expectSameCurve(
+    ConstantCurveIncompressibleJoint& expected,
+    ConstantCurveIncompressibleJoint& actual)
+{
+  EXPECT_TRUE(equals(
+      expected.getRelativeTransform().matrix(),
+      actual.getRelativeTransform().matrix(),
+      1e-12));
+  EXPECT_TRUE(equals(
+      expected.getRelativeJacobian(), actual.getRelativeJacobian(), 1e-12));
+  EXPECT_TRUE(equals(
+      expected.getRelativeJacobianTimeDeriv(),
+      actual.getRelativeJacobianTimeDeriv(),
+      1e-12));
+  for (int i = 0; i < expected.getNumDofs(); i++)
+  {
+    EXPECT_TRUE(equals(
+        expected.getRelativeJacobianDerivWrtPositionStatic(i),
+        actual.getRelativeJacobianDerivWrtPositionStatic(i),
+        1e-12));
+    EXPECT_TRUE(equals(
+        expected.getRelativeJacobianTimeDerivDerivWrtPosition(i),
+        actual.getRelativeJacobianTimeDerivDerivWrtPosition(i),
+        1e-12));
+  }
+}
+
+//==============================================================================
+TEST(ConstantCurveIncompressibleJoint, SettersInvalidateCaches)
+{
+  ConstantCurveIncompressibleJoint::Properties props;
+  ConstantCurveIncompressibleJoint joint(props);
+  setUpExampleShoulder(joint);
+
+  // Fill in all the caches at the starting parameters
+  ConstantCurveIncompressibleJoint original(props);
+  setUpExampleShoulder(original);
+  expectSameCurve(original, joint);
+
+  // After each setter, the joint should behave exactly like one that was
+  // built with the new parameters from the start
+  joint.setNeutralPos(Eigen::Vector3s(0.1, 0.2, -0.1));
+  {
+    ConstantCurveIncompressibleJoint fresh(props);
+    fresh.setNeutralPos(Eigen::Vector3s(0.1, 0.2, -0.1));
+    setUpExampleShoulder(fresh);
+    expectSameCurve(fresh, joint);
+  }
+  joint.setFlipAxisMap(Eigen::Vector3s(-1, 1, -1));
+  {
+    ConstantCurveIncompressibleJoint fresh(props);
+    fresh.setNeutralPos(Eigen::Vector3s(0.1, 0.2, -0.1));
+    fresh.setFlipAxisMap(Eigen::Vector3s(-1, 1, -1));
+    setUpExampleShoulder(fresh);
+    expectSameCurve(fresh, joint);
+  }
+  joint.setLength(0.35);
+  {
+    ConstantCurveIncompressibleJoint fresh(props);
+    fresh.setNeutralPos(Eigen::Vector3s(0.1, 0.2, -0.1));
+    fresh.setFlipAxisMap(Eigen::Vector3s(-1, 1, -1));
+    fresh.setLength(0.35);
+    setUpExampleShoulder(fresh);
+    expectSameCurve(fresh, joint);
+  }
+}
@@ -4189,6 +4189,323 @@ TEST(DARTCollide, CAPSULE_CCD_SUPPORT_FN)
 }
 #endif
 
+#ifdef ALL_TESTS
+TEST(DARTCollide, HEIGHTMAP_SPHERE_FACE)
+{
+  dynamics::HeightmapShaped heightmap;
+  heightmap.setHeightField(5, 5, std::vector<s_t>(25, 0.0));
+
+  Eigen::Isometry3s T0 = Eigen::Isometry3s::Identity();
+  Eigen::Isometry3s T1 = Eigen::Isometry3s::Identity();
+  T1.translation() = Eigen::Vector3s(0.3, 0.2, 0.49);
+
+  CollisionResult result;
+  CollisionOption option;
+  int numContacts = collideSphereHeightmap(
+      nullptr, nullptr, 0.5, T1, heightmap, T0, option, result);
+  EXPECT_EQ(numContacts, 1);
+  if (result.getNumContacts() != 1)
+    return;
+  Contact contact = result.getContact(0);
+  EXPECT_EQ(contact.type, SPHERE_FACE);
+  EXPECT_TRUE(equals(contact.normal, Eigen::Vector3s::UnitZ().eval(), 1e-10));
+  EXPECT_TRUE(
+      equals(contact.point, Eigen::Vector3s(0.3, 0.2, -0.01).eval(), 1e-10));
+  EXPECT_NEAR(contact.penetrationDepth, 0.01, 1e-10);
+
+  // Swapping the objects flips the annotations
+  CollisionResult flippedResult;
+  numContacts = collideHeightmapSphere(
+      nullptr, nullptr, heightmap, T0, 0.5, T1, option, flippedResult);
+  EXPECT_EQ(numContacts, 1);
+  if (flippedResult.getNumContacts() != 1)
+    return;
+  Contact flipped = flippedResult.getContact(0);
+  EXPECT_EQ(flipped.type, FACE_SPHERE);
+  EXPECT_TRUE(
+      equals(flipped.normal, (-Eigen::Vector3s::UnitZ()).eval(), 1e-10));
+  EXPECT_TRUE(equals(flipped.point, contact.point, 1e-10));
+}
+#endif
+
+#ifdef ALL_TESTS
+TEST(DARTCollide, HEIGHTMAP_SPHERE_SHARED_VERTEX)
+{
+  // A sphere directly over a grid vertex touches all six triangles around
+  // it, but should only get one contact
+  dynamics::HeightmapShapef heightmap;
+  heightmap.setHeightField(5, 5, std::vector<float>(25, 0.0f));
+
+  Eigen::Isometry3s T0 = Eigen::Isometry3s::Identity();
+  Eigen::Isometry3s T1 = Eigen::Isometry3s::Identity();
+  T1.translation() = Eigen::Vector3s(0, 0, 0.49);
+
+  CollisionResult result;
+  CollisionOption option;
+  int numContacts = collideSphereHeightmap(
+      nullptr, nullptr, 0.5, T1, heightmap, T0, option, result);
+  EXPECT_EQ(numContacts, 1);
+  if (result.getNumContacts() != 1)
+    return;
+  EXPECT_TRUE(equals(
+      result.getContact(0).normal, Eigen::Vector3s::UnitZ().eval(), 1e-6));
+  EXPECT_NEAR(result.getContact(0).penetrationDepth, 0.01, 1e-6);
+}
+#endif
+
+#ifdef ALL_TESTS
+TEST(DARTCollide, HEIGHTMAP_SPHERE_MISSES)
+{
+  dynamics::HeightmapShaped heightmap;
+  heightmap.setHeightField(5, 5, std::vector<s_t>(25, 0.0));
+
+  Eigen::Isometry3s T0 = Eigen::Isometry3s::Identity();
+  Eigen::Isometry3s T1 = Eigen::Isometry3s::Identity();
+  CollisionOption option;
+
+  // Above the terrain
+  T1.translation() = Eigen::Vector3s(0.3, 0.2, 0.6);
+  CollisionResult result;
+  EXPECT_EQ(
+      collideSphereHeightmap(
+          nullptr, nullptr, 0.5, T1, heightmap, T0, option, result),
+      0);
+
+  // Off the edge of the terrain
+  T1.translation() = Eigen::Vector3s(3.0, 0.2, 0.49);
+  EXPECT_EQ(
+      collideSphereHeightmap(
+          nullptr, nullptr, 0.5, T1, heightmap, T0, option, result),
+      0);
+  EXPECT_EQ(result.getNumContacts(), 0);
+}
+#endif
+
+#ifdef ALL_TESTS
+TEST(DARTCollide, HEIGHTMAP_CAPSULE_FLAT)
+{
+  dynamics::HeightmapShaped heightmap;
+  heightmap.setHeightField(5, 5, std::vector<s_t>(25, 0.0));
+
+  Eigen::Isometry3s T0 = Eigen::Isometry3s::Identity();
+  Eigen::Isometry3s T1 = Eigen::Isometry3s::Identity();
+  T1.translation() = Eigen::Vector3s(0, 0.2, 0.49);
+  T1.linear() = math::eulerXYZToMatrix(Eigen::Vector3s(0, M_PI_2, 0));
+
+  // A capsule lying flat should rest on the two spheres at its ends, without
+  // extra contacts where its side crosses grid lines
+  CollisionResult result;
+  CollisionOption option;
+  int numContacts = collideCapsuleHeightmap(
+      nullptr, nullptr, 1.0, 0.5, T1, heightmap, T0, option, result);
+  EXPECT_EQ(numContacts, 2);
+  for (int i = 0; i < result.getNumContacts(); i++)
+  {
+    EXPECT_EQ(result.getContact(i).type, SPHERE_FACE);
+    EXPECT_TRUE(equals(
+        result.getContact(i).normal, Eigen::Vector3s::UnitZ().eval(), 1e-10));
+    EXPECT_NEAR(result.getContact(i).penetrationDepth, 0.01, 1e-10);
+  }
+}
+#endif
+
+#ifdef ALL_TESTS
+TEST(DARTCollide, HEIGHTMAP_CAPSULE_RIDGE)
+{
+  // A ridge of height 1 running along the Y axis, at x = 0
+  dynamics::HeightmapShaped::HeightField heights
+      = dynamics::HeightmapShaped::HeightField::Zero(5, 5);
+  heights.col(2).setConstant(1.0);
+  dynamics::HeightmapShaped heightmap;
+  heightmap.setHeightField(heights);
+
+  Eigen::Isometry3s T0 = Eigen::Isometry3s::Identity();
+  Eigen::Isometry3s T1 = Eigen::Isometry3s::Identity();
+  T1.translation() = Eigen::Vector3s(0, 0.5, 1.49);
+  T1.linear() = math::eulerXYZToMatrix(Eigen::Vector3s(0, M_PI_2, 0));
+
+  CollisionResult result;
+  CollisionOption option;
+  int numContacts = collideCapsuleHeightmap(
+      nullptr, nullptr, 2.0, 0.5, T1, heightmap, T0, option, result);
+  EXPECT_EQ(numContacts, 1);
+  if (result.getNumContacts() != 1)
+    return;
+  Contact contact = result.getContact(0);
+  EXPECT_EQ(contact.type, PIPE_EDGE);
+  EXPECT_TRUE(equals(contact.normal, Eigen::Vector3s::UnitZ().eval(), 1e-10));
+  EXPECT_TRUE(
+      equals(contact.point, Eigen::Vector3s(0, 0.5, 1.0).eval(), 1e-10));
+  EXPECT_NEAR(contact.penetrationDepth, 0.01, 1e-10);
+}
+#endif
+
+#ifdef ALL_TESTS
+TEST(DARTCollide, HEIGHTMAP_BOX)
+{
+  dynamics::HeightmapShaped heightmap;
+  heightmap.setHeightField(5, 5, std::vector<s_t>(25, 0.0));
+
+  Eigen::Isometry3s T0 = Eigen::Isometry3s::Identity();
+  Eigen::Isometry3s T1 = Eigen::Isometry3s::Identity();
+  T1.translation() = Eigen::Vector3s(0.1, 0.1, 0.49);
+
+  // The four bottom corners dip into the terrain, and the terrain vertex at
+  // the origin pokes into the bottom face
+  CollisionResult result;
+  CollisionOption option;
+  int numContacts = collideBoxHeightmap(
+      nullptr,
+      nullptr,
+      Eigen::Vector3s::Ones(),
+      T1,
+      heightmap,
+      T0,
+      option,
+      result);
+  EXPECT_EQ(numContacts, 5);
+  int numVertexFace = 0;
+  for (int i = 0; i < result.getNumContacts(); i++)
+  {
+    const Contact& contact = result.getContact(i);
+    if (contact.type == VERTEX_FACE)
+      numVertexFace++;
+    EXPECT_TRUE(
+        equals(contact.normal, Eigen::Vector3s::UnitZ().eval(), 1e-10));
+    EXPECT_NEAR(contact.penetrationDepth, 0.01, 1e-10);
+  }
+  EXPECT_EQ(numVertexFace, 4);
+}
+#endif
+
+#ifdef ALL_TESTS
+TEST(DARTCollide, HEIGHTMAP_MULTI_SPHERE)
+{
+  dynamics::HeightmapShaped heightmap;
+  heightmap.setHeightField(5, 5, std::vector<s_t>(25, 0.0));
+
+  dynamics::MultiSphereConvexHullShape::Spheres spheres;
+  spheres.emplace_back(0.5, Eigen::Vector3s(-0.5, 0.3, 0));
+  spheres.emplace_back(0.5, Eigen::Vector3s(0.5, 0.3, 0));
+  spheres.emplace_back(0.5, Eigen::Vector3s(0, 0.3, 1.0));
+
+  Eigen::Isometry3s T0 = Eigen::Isometry3s::Identity();
+  Eigen::Isometry3s T1 = Eigen::Isometry3s::Identity();
+  T1.translation() = Eigen::Vector3s(0, 0, 0.49);
+
+  CollisionResult result;
+  CollisionOption option;
+  int numContacts = collideHeightmapMultiSphere(
+      nullptr, nullptr, heightmap, T0, spheres, T1, option, result);
+  EXPECT_EQ(numContacts, 2);
+  for (int i = 0; i < result.getNumContacts(); i++)
+  {
+    EXPECT_EQ(result.getContact(i).type, FACE_SPHERE);
+    EXPECT_TRUE(equals(
+        result.getContact(i).normal,
+        (-Eigen::Vector3s::UnitZ()).eval(),
+        1e-10));
+  }
+}
+#endif
+
+#ifdef ALL_TESTS
+TEST(DARTCollide, HEIGHTMAP_BOX_RIDGE)
+{
+  // A ridge of height 1 running along the Y axis, at x = 0
+  dynamics::HeightmapShaped::HeightField heights
+      = dynamics::HeightmapShaped::HeightField::Zero(5, 5);
+  heights.col(2).setConstant(1.0);
+  dynamics::HeightmapShaped heightmap;
+  heightmap.setHeightField(heights);
+
+  Eigen::Isometry3s T0 = Eigen::Isometry3s::Identity();
+  Eigen::Isometry3s T1 = Eigen::Isometry3s::Identity();
+  T1.translation() = Eigen::Vector3s(0, 0.5, 1.49);
+
+  // The box rests across the ridge with all its corners in the air, and no
+  // terrain vertex inside it. Only its two bottom edges that cross the ridge
+  // hold it up.
+  CollisionResult result;
+  CollisionOption option;
+  int numContacts = collideBoxHeightmap(
+      nullptr,
+      nullptr,
+      Eigen::Vector3s(1.0, 0.6, 1.0),
+      T1,
+      heightmap,
+      T0,
+      option,
+      result);
+  EXPECT_EQ(numContacts, 2);
+  for (int i = 0; i < result.getNumContacts(); i++)
+  {
+    const Contact& contact = result.getContact(i);
+    EXPECT_EQ(contact.type, EDGE_EDGE);
+    EXPECT_TRUE(
+        equals(contact.normal, Eigen::Vector3s::UnitZ().eval(), 1e-10));
+    EXPECT_NEAR(contact.penetrationDepth, 0.01, 1e-10);
+    EXPECT_NEAR(contact.point(0), 0.0, 1e-10);
+    EXPECT_NEAR(contact.edgeBClosestPoint(2), 1.0, 1e-10);
+    EXPECT_NEAR(std::abs(contact.edgeADir(0)), 1.0, 1e-10);
+    EXPECT_NEAR(std::abs(contact.edgeBDir(1)), 1.0, 1e-10);
+  }
+
+  // Flat terrain has no convex edges, so the flat HEIGHTMAP_BOX case is
+  // unaffected, and a box floating above the ridge touches nothing
+  T1.translation()(2) = 1.51;
+  CollisionResult missResult;
+  EXPECT_EQ(
+      collideBoxHeightmap(
+          nullptr,
+          nullptr,
+          Eigen::Vector3s(1.0, 0.6, 1.0),
+          T1,
+          heightmap,
+          T0,
+          option,
+          missResult),
+      0);
+}
+#endif
+
+#ifdef ALL_TESTS
+TEST(DARTCollide, HEIGHTMAP_MULTI_SPHERE_HULL)
+{
+  // A ridge of height 1 running along the Y axis, at x = 0
+  dynamics::HeightmapShaped::HeightField heights
+      = dynamics::HeightmapShaped::HeightField::Zero(5, 5);
+  heights.col(2).setConstant(1.0);
+  dynamics::HeightmapShaped heightmap;
+  heightmap.setHeightField(heights);
+
+  // Two spheres on either side of the ridge, far above the ground. Their
+  // hull bridges the ridge, even though neither sphere touches it.
+  dynamics::MultiSphereConvexHullShape::Spheres spheres;
+  spheres.emplace_back(0.5, Eigen::Vector3s(-1.0, 0, 0));
+  spheres.emplace_back(0.5, Eigen::Vector3s(1.0, 0, 0));
+
+  Eigen::Isometry3s T0 = Eigen::Isometry3s::Identity();
+  Eigen::Isometry3s T1 = Eigen::Isometry3s::Identity();
+  T1.translation() = Eigen::Vector3s(0, 0.5, 1.49);
+
+  CollisionResult result;
+  CollisionOption option;
+  int numContacts = collideHeightmapMultiSphere(
+      nullptr, nullptr, heightmap, T0, spheres, T1, option, result);
+  EXPECT_EQ(numContacts, 1);
+  if (result.getNumContacts() != 1)
+    return;
+  Contact contact = result.getContact(0);
+  EXPECT_EQ(contact.type, EDGE_PIPE);
+  EXPECT_TRUE(
+      equals(contact.normal, (-Eigen::Vector3s::UnitZ()).eval(), 1e-10));
+  EXPECT_TRUE(
+      equals(contact.point, Eigen::Vector3s(0, 0.5, 1.0).eval(), 1e-10));
+  EXPECT_NEAR(contact.penetrationDepth, 0.01, 1e-10);
+}
+#endif
+
 // The number of contacts shouldn't change under tiny perturbations to position,
 // and the contacts should move in predictable ways.
 
@@ -466,4 +466,82 @@ TEST(BODY_SPATIAL_TRANSLATION, RAJAGOPAL)
 
   EXPECT_TRUE(verifySpatialJacobians(skel, true));
 }
+#endif
+
+#ifdef ALL_TESTS
+TEST(SYNTHETIC_IMUS, TRAJECTORY_MATCHES_FRAMES)
+{
+  OpenSimFile file = OpenSimParser::parseOsim(
+      "dart://sample/osim/Rajagopal2015/Rajagopal2015.osim");
+  std::shared_ptr<dynamics::Skeleton> skel = file.skeleton;
+
+  dynamics::SensorMap sensors;
+  for (int i = 0; i < skel->getNumBodyNodes(); i++)
+  {
+    Eigen::Isometry3s T = Eigen::Isometry3s::Identity();
+    T.translation() = Eigen::Vector3s::Random() * 0.1;
+    T.linear() = math::expMapRot(Eigen::Vector3s::Random());
+    sensors["imu_" + skel->getBodyNode(i)->getName()]
+        = std::make_pair(skel->getBodyNode(i), T);
+  }
+
+  const int numTimesteps = 700;
+  Eigen::MatrixXs poses
+      = Eigen::MatrixXs::Random(skel->getNumDofs(), numTimesteps);
+  Eigen::MatrixXs vels
+      = Eigen::MatrixXs::Random(skel->getNumDofs(), numTimesteps);
+  Eigen::MatrixXs accs
+      = Eigen::MatrixXs::Random(skel->getNumDofs(), numTimesteps);
+
+  Eigen::VectorXs originalPos = skel->getPositions();
+  dynamics::Skeleton::TrajectorySensorReadings serial
+      = skel->getTrajectorySensorReadings(poses, vels, accs, sensors);
+  EXPECT_EQ(originalPos, skel->getPositions());
+  ASSERT_EQ(serial.sensorNames.size(), sensors.size());
+
+  std::vector<std::pair<dynamics::BodyNode*, Eigen::Isometry3s>> list;
+  for (std::string& name : serial.sensorNames)
+  {
+    list.push_back(sensors.at(name));
+  }
+  for (int t = 0; t < numTimesteps; t++)
+  {
+    skel->setPositions(poses.col(t));
+    skel->setVelocities(vels.col(t));
+    skel->setAccelerations(accs.col(t));
+    Eigen::VectorXs accReadings = serial.accReadings.col(t);
+    Eigen::VectorXs gyroReadings = serial.gyroReadings.col(t);
+    EXPECT_TRUE(equals(accReadings, skel->getAccelerometerReadings(list)));
+    EXPECT_TRUE(equals(gyroReadings, skel->getGyroReadings(list)));
+  }
+
+  dynamics::Skeleton::TrajectorySensorReadings threaded
+      = skel->getTrajectorySensorReadings(
+          poses,
+          vels,
+          accs,
+          sensors,
+          dynamics::Skeleton::SensorNoiseModel(),
+          4);
+  EXPECT_EQ(serial.accReadings, threaded.accReadings);
+  EXPECT_EQ(serial.gyroReadings, threaded.gyroReadings);
+
+  // Noisy readings should be reproducible for a given seed, no matter how
+  // many threads drew them
+  dynamics::Skeleton::SensorNoiseModel noise;
+  noise.accNoiseStddev = 0.1;
+  noise.gyroNoiseStddev = 0.01;
+  noise.accBiasStddev = 0.2;
+  noise.gyroBiasStddev = 0.02;
+  noise.seed = 7;
+  dynamics::Skeleton::TrajectorySensorReadings noisySerial
+      = skel->getTrajectorySensorReadings(poses, vels, accs, sensors, noise);
+  dynamics::Skeleton::TrajectorySensorReadings noisyThreaded
+      = skel->getTrajectorySensorReadings(
+          poses, vels, accs, sensors, noise, 3);
+  EXPECT_EQ(noisySerial.accReadings, noisyThreaded.accReadings);
+  EXPECT_EQ(noisySerial.gyroReadings, noisyThreaded.gyroReadings);
+  EXPECT_FALSE(equals(noisySerial.accReadings, serial.accReadings, 1e-3));
+  EXPECT_FALSE(equals(noisySerial.gyroReadings, serial.gyroReadings, 1e-4));
+}
 #endif
\ No newline at end of file
@@ -1191,6 +1191,23 @@ bool testResidualRootJacobians(
     return false;
   }
 
+  Eigen::Vector6s noResidualRootWithoutMassMatrix
+      = helper.calculateResidualFreeRootAccelerationWithoutMassMatrix(
+          q, dq, ddq, forces);
+  if (!equals(noResidualRootWithoutMassMatrix, noResidualRoot, 1e-8))
+  {
+    std::cout << "Residual free root acceleration without the mass matrix "
+                 "does not match the full version!"
+              << std::endl;
+    Eigen::Matrix<s_t, 6, 3> compare;
+    compare.col(0) = noResidualRootWithoutMassMatrix;
+    compare.col(1) = noResidualRoot;
+    compare.col(2) = noResidualRootWithoutMassMatrix - noResidualRoot;
+    std::cout << "Without M - With M - Diff" << std::endl
+              << compare << std::endl;
+    return false;
+  }
+
   Eigen::Vector3s noResidualAngular
       = helper.calculateResidualFreeAngularAcceleration(q, dq, ddq, forces);
   noResidualAcc = ddq;
@@ -6636,6 +6653,167 @@ TEST(DynamicsFitter, HamnerMultipleTrials)
 }
 #endif
 
+#ifdef ALL_TESTS
+TEST(DynamicsFitter, TRIAL_PARALLEL_MATCHES_SERIAL)
+{
+  std::vector<std::string> motFiles;
+  std::vector<std::string> c3dFiles;
+  std::vector<std::string> trcFiles;
+  std::vector<std::string> grfFiles;
+
+  std::string prefix = "dart://sample/osim/HamnerMultipleTrials/";
+  trcFiles.push_back(prefix + "run200.trc");
+  trcFiles.push_back(prefix + "run300.trc");
+  grfFiles.push_back(prefix + "run200_grf.mot");
+  grfFiles.push_back(prefix + "run300_grf.mot");
+  motFiles.push_back(prefix + "run200_ik.mot");
+  motFiles.push_back(prefix + "run300_ik.mot");
+
+  std::vector<std::string> footNames;
+  footNames.push_back("calcn_r");
+  footNames.push_back("calcn_l");
+
+  OpenSimFile standard = OpenSimParser::parseOsim(prefix + "final.osim");
+  std::shared_ptr<DynamicsInitialization> init = createInitialization(
+      standard.skeleton,
+      standard.markersMap,
+      standard.trackingMarkers,
+      footNames,
+      motFiles,
+      c3dFiles,
+      trcFiles,
+      grfFiles);
+
+  // Run the per-trial stages on one thread, and then on several, starting
+  // from the same initialization. Run them twice on the same fitter, so the
+  // second pass reuses the skeleton clones from the first.
+  std::vector<std::shared_ptr<DynamicsInitialization>> results;
+  for (int numThreads : {1, 4})
+  {
+    DynamicsFitter fitter(
+        standard.skeleton, init->grfBodyNodes, init->trackingMarkers);
+    fitter.setNumThreads(numThreads);
+    std::shared_ptr<DynamicsInitialization> result;
+    for (int pass = 0; pass < 2; pass++)
+    {
+      result = std::make_shared<DynamicsInitialization>(*init);
+      fitter.estimateFootGroundContactsWithHeightHeuristic(result);
+      fitter.markMissingImpacts(result, 10, true);
+      fitter.estimateFootGroundContactsWithStillness(result);
+    }
+    results.push_back(result);
+  }
+
+  std::shared_ptr<DynamicsInitialization> serial = results[0];
+  std::shared_ptr<DynamicsInitialization> parallel = results[1];
+  ASSERT_EQ(serial->poseTrials.size(), 2);
+  ASSERT_EQ(
+      serial->grfBodyForceActive.size(), parallel->grfBodyForceActive.size());
+  EXPECT_EQ(serial->contactBodies, parallel->contactBodies);
+  EXPECT_EQ(
+      serial->grfBodyContactSphereRadius, parallel->grfBodyContactSphereRadius);
+  for (int trial = 0; trial < serial->poseTrials.size(); trial++)
+  {
+    EXPECT_TRUE(serial->grfTrials[trial] == parallel->grfTrials[trial]);
+    EXPECT_EQ(
+        serial->probablyMissingGRF[trial], parallel->probablyMissingGRF[trial]);
+    EXPECT_EQ(
+        serial->missingGRFReason[trial], parallel->missingGRFReason[trial]);
+    EXPECT_EQ(
+        serial->defaultForcePlateCorners[trial],
+        parallel->defaultForcePlateCorners[trial]);
+  }
+  for (int i = 0; i < serial->grfBodyForceActive.size(); i++)
+  {
+    EXPECT_TRUE(
+        serial->grfBodyForceActive[i] == parallel->grfBodyForceActive[i]);
+    EXPECT_TRUE(
+        serial->grfBodySphereInContact[i]
+        == parallel->grfBodySphereInContact[i]);
+    EXPECT_TRUE(
+        serial->grfBodyOffForcePlate[i] == parallel->grfBodyOffForcePlate[i]);
+  }
+}
+#endif
+
+#ifdef JACOBIAN_TESTS
+TEST(DynamicsFitter, FIT_PROBLEM_PARALLEL_IS_DETERMINISTIC)
+{
+  std::vector<std::string> motFiles;
+  std::vector<std::string> c3dFiles;
+  std::vector<std::string> trcFiles;
+  std::vector<std::string> grfFiles;
+
+  motFiles.push_back("dart://sample/grf/Subject4/IK/walking1_ik.mot");
+  trcFiles.push_back("dart://sample/grf/Subject4/MarkerData/walking1.trc");
+  grfFiles.push_back("dart://sample/grf/Subject4/ID/walking1_grf.mot");
+
+  OpenSimFile standard = OpenSimParser::parseOsim(
+      "dart://sample/grf/Subject4/Models/"
+      "optimized_scale_and_markers.osim");
+
+  std::vector<std::string> footNames;
+  footNames.push_back("calcn_r");
+  footNames.push_back("calcn_l");
+
+  std::shared_ptr<DynamicsInitialization> init = createInitialization(
+      standard.skeleton,
+      standard.markersMap,
+      standard.trackingMarkers,
+      footNames,
+      motFiles,
+      c3dFiles,
+      trcFiles,
+      grfFiles,
+      50);
+
+  srand(42);
+  Eigen::VectorXs offset;
+
+  // Threads claim blocks in whatever order they get to them, so this checks
+  // that neither the thread count nor the scheduling changes the loss or the
+  // gradient, down to the last bit.
+  s_t expectedLoss = 0.0;
+  Eigen::VectorXs expectedGrad;
+  for (int numThreads : {1, 3, 8})
+  {
+    DynamicsFitProblemConfig config(standard.skeleton);
+    config.setIncludeBodyScales(true);
+    config.setIncludeCOMs(true);
+    config.setIncludeInertias(true);
+    config.setIncludeMarkerOffsets(true);
+    config.setIncludeMasses(true);
+    config.setIncludePoses(true);
+    config.setMaxBlockSize(10);
+    config.setNumThreads(numThreads);
+
+    DynamicsFitProblem problem(
+        init, standard.skeleton, standard.trackingMarkers, config);
+    ASSERT_GT(problem.mBlocks.size(), 1);
+
+    Eigen::VectorXs x = problem.flatten();
+    if (offset.size() == 0)
+    {
+      offset = Eigen::VectorXs::Random(x.size()) * 0.01;
+    }
+    x += offset;
+
+    for (int pass = 0; pass < 3; pass++)
+    {
+      s_t loss = problem.computeLossParallel(x);
+      Eigen::VectorXs grad = problem.computeGradientParallel(x);
+      if (expectedGrad.size() == 0)
+      {
+        expectedLoss = loss;
+        expectedGrad = grad;
+      }
+      EXPECT_EQ(expectedLoss, loss);
+      EXPECT_TRUE(expectedGrad == grad);
+    }
+  }
+}
+#endif
+
 #ifdef ALL_TESTS
 TEST(DynamicsFitter, GRFBlipTest)
 {
@@ -263,4 +263,106 @@ TEST(ENERGY_ACCOUNTING, ENERGY_GRADIENTS_WITH_REFERENCE_VEL)
     EXPECT_NEAR(fdPotential, gradPotential, 5e-4);
   }
 }
-#endif
\ No newline at end of file
+#endif
+#ifdef ALL_TESTS
+TEST(ENERGY_ACCOUNTING, TRAJECTORY_MATCHES_FRAMES)
+{
+  std::shared_ptr<dynamics::Skeleton> skel = dynamics::Skeleton::create();
+  skel->setGravity(Eigen::Vector3s::UnitY() * -9.81);
+  auto pair = skel->createJointAndBodyNodePair<dynamics::EulerFreeJoint>();
+  pair.first->setName("joint0");
+  pair.second->setMass(1.0);
+  pair.second->setMomentOfInertia(0.5, 0.7, 0.9, 0.1, 0.2, 0.3);
+  auto pair2 = pair.second->createChildJointAndBodyNodePair<
+      dynamics::RevoluteJoint>();
+  pair2.first->setName("joint1");
+  pair2.second->setMass(2.0);
+
+  const int numTimesteps = 10;
+  const s_t dt = 0.01;
+  Eigen::MatrixXs poses = Eigen::MatrixXs::Random(7, numTimesteps);
+  Eigen::MatrixXs vels = Eigen::MatrixXs::Random(7, numTimesteps);
+  Eigen::MatrixXs accs = Eigen::MatrixXs::Random(7, numTimesteps);
+  Eigen::MatrixXs forces = Eigen::MatrixXs::Random(3, numTimesteps);
+  Eigen::MatrixXs moments = Eigen::MatrixXs::Random(3, numTimesteps);
+  Eigen::Vector3s referenceVel = Eigen::Vector3s::Random();
+  std::vector<dynamics::BodyNode*> contactBodies;
+  contactBodies.push_back(pair2.second);
+
+  Eigen::VectorXs originalPos = skel->getPositions();
+  auto serial = skel->getTrajectoryEnergyAccounting(
+      poses, vels, accs, dt, 0.5, referenceVel, contactBodies, forces, moments);
+  auto parallel = skel->getTrajectoryEnergyAccounting(
+      poses,
+      vels,
+      accs,
+      dt,
+      0.5,
+      referenceVel,
+      contactBodies,
+      forces,
+      moments,
+      4);
+  EXPECT_EQ(skel->getPositions(), originalPos);
+
+  s_t contactWork = 0.0;
+  for (int t = 0; t < numTimesteps; t++)
+  {
+    skel->setPositions(poses.col(t));
+    skel->setVelocities(vels.col(t));
+    skel->setAccelerations(accs.col(t));
+    std::vector<Eigen::Vector3s> cops;
+    cops.push_back(Eigen::Vector3s::Zero());
+    std::vector<Eigen::Vector3s> frameForces;
+    frameForces.push_back(forces.col(t));
+    std::vector<Eigen::Vector3s> frameMoments;
+    frameMoments.push_back(moments.col(t));
+    auto frame = skel->getEnergyAccounting(
+        0.5, referenceVel, contactBodies, cops, frameForces, frameMoments);
+
+    for (auto* result : {&serial, &parallel})
+    {
+      EXPECT_TRUE(equals(
+          frame.bodyKineticEnergy,
+          Eigen::VectorXs(result->bodyKineticEnergy.col(t)),
+          1e-12));
+      EXPECT_TRUE(equals(
+          frame.bodyPotentialEnergy,
+          Eigen::VectorXs(result->bodyPotentialEnergy.col(t)),
+          1e-12));
+      EXPECT_TRUE(equals(
+          frame.bodyKineticEnergyDeriv,
+          Eigen::VectorXs(result->bodyKineticEnergyDeriv.col(t)),
+          1e-12));
+      EXPECT_TRUE(equals(
+          frame.bodyPotentialEnergyDeriv,
+          Eigen::VectorXs(result->bodyPotentialEnergyDeriv.col(t)),
+          1e-12));
+      EXPECT_TRUE(equals(
+          frame.bodyParentJointPower,
+          Eigen::VectorXs(result->bodyParentJointPower.col(t)),
+          1e-12));
+      EXPECT_TRUE(equals(
+          frame.bodyChildJointPowerSum,
+          Eigen::VectorXs(result->bodyChildJointPowerSum.col(t)),
+          1e-12));
+      for (int j = 0; j < frame.joints.size(); j++)
+      {
+        EXPECT_NEAR(
+            frame.joints[j].powerToChild,
+            result->jointPowerToChild(j, t),
+            1e-12);
+        EXPECT_NEAR(
+            frame.joints[j].powerToParent,
+            result->jointPowerToParent(j, t),
+            1e-12);
+      }
+      EXPECT_NEAR(
+          frame.contacts[0].powerToBody, result->contactPower(0, t), 1e-12);
+    }
+    contactWork += frame.contacts[0].powerToBody * dt;
+  }
+  EXPECT_NEAR(serial.contactWork(0), contactWork, 1e-10);
+  EXPECT_NEAR(parallel.contactWork(0), contactWork, 1e-10);
+}
+#endif
@@ -0,0 +1,273 @@
+#include <thread>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <ccd/ccd.h>
+#include <gtest/gtest.h>
+
+#include "dart/collision/CollisionResult.hpp"
+#include "dart/collision/dart/DARTCollide.hpp"
+#include "dart/collision/dart/DARTGJK.hpp"
+
+using namespace dart;
+using namespace collision;
+
+//==============================================================================
+TEST(GJK, SPHERE_SPHERE_PENETRATION)
+{
+  Eigen::Isometry3s T0 = Eigen::Isometry3s::Identity();
+  Eigen::Isometry3s T1 = Eigen::Isometry3s::Identity();
+  T1.translation() = Eigen::Vector3s(0.3, 1.5, -0.2).normalized() * 1.9;
+
+  ccdSphere sphere0;
+  sphere0.radius = 1.0;
+  sphere0.transform = &T0;
+  ccdSphere sphere1;
+  sphere1.radius = 1.0;
+  sphere1.transform = &T1;
+
+  GJKShape a{&sphere0, ccdSupportSphere, ccdCenterSphere};
+  GJKShape b{&sphere1, ccdSupportSphere, ccdCenterSphere};
+  GJKResult gjk = gjkPenetration(a, b);
+
+  EXPECT_TRUE(gjk.intersecting);
+  EXPECT_NEAR(gjk.depth, 0.1, 1e-3);
+  // Points from B to A
+  Eigen::Vector3s expectedNormal = -T1.translation().normalized();
+  EXPECT_GT(gjk.normal.dot(expectedNormal), 1.0 - 1e-4);
+}
+
+//==============================================================================
+TEST(GJK, BOX_BOX_SEPARATED)
+{
+  Eigen::Vector3s size = Eigen::Vector3s::Ones();
+  Eigen::Isometry3s T0 = Eigen::Isometry3s::Identity();
+  Eigen::Isometry3s T1 = Eigen::Isometry3s::Identity();
+  T1.translation() = Eigen::Vector3s(1.25, 0.2, 0.1);
+
+  ccdBox box0;
+  box0.size = &size;
+  box0.transform = &T0;
+  ccdBox box1;
+  box1.size = &size;
+  box1.transform = &T1;
+
+  GJKShape a{&box0, ccdSupportBox, ccdCenterBox};
+  GJKShape b{&box1, ccdSupportBox, ccdCenterBox};
+  GJKResult gjk = gjkPenetration(a, b);
+
+  EXPECT_FALSE(gjk.intersecting);
+  EXPECT_NEAR(gjk.distance, 0.25, 1e-8);
+  EXPECT_NEAR(gjk.normal(0), -1.0, 1e-8);
+  EXPECT_NEAR((gjk.pointA - gjk.pointB).norm(), 0.25, 1e-8);
+}
+
+//==============================================================================
+TEST(GJK, BOX_BOX_PENETRATION)
+{
+  Eigen::Vector3s size = Eigen::Vector3s::Ones();
+  Eigen::Isometry3s T0 = Eigen::Isometry3s::Identity();
+  Eigen::Isometry3s T1 = Eigen::Isometry3s::Identity();
+  T1.translation() = Eigen::Vector3s(0.1, 0.05, 0.95);
+
+  ccdBox box0;
+  box0.size = &size;
+  box0.transform = &T0;
+  ccdBox box1;
+  box1.size = &size;
+  box1.transform = &T1;
+
+  GJKShape a{&box0, ccdSupportBox, ccdCenterBox};
+  GJKShape b{&box1, ccdSupportBox, ccdCenterBox};
+  GJKResult gjk = gjkPenetration(a, b);
+
+  EXPECT_TRUE(gjk.intersecting);
+  EXPECT_NEAR(gjk.depth, 0.05, 1e-6);
+  EXPECT_NEAR(gjk.normal(2), -1.0, 1e-6);
+}
+
+//==============================================================================
+TEST(GJK, CAPSULE_BOX_PENETRATION)
+{
+  Eigen::Vector3s size = Eigen::Vector3s(2.0, 2.0, 1.0);
+  Eigen::Isometry3s boxT = Eigen::Isometry3s::Identity();
+  // A vertical capsule whose bottom cap dips 0.02 into the top of the box
+  Eigen::Isometry3s capsuleT = Eigen::Isometry3s::Identity();
+  capsuleT.translation() = Eigen::Vector3s(0.1, -0.2, 0.5 + 0.5 + 0.2 - 0.02);
+
+  ccdCapsule capsule;
+  capsule.radius = 0.2;
+  capsule.height = 1.0;
+  capsule.transform = &capsuleT;
+  ccdBox box;
+  box.size = &size;
+  box.transform = &boxT;
+
+  GJKShape a{&capsule, ccdSupportCapsule, ccdCenterCapsule};
+  GJKShape b{&box, ccdSupportBox, ccdCenterBox};
+  GJKResult gjk = gjkPenetration(a, b);
+
+  EXPECT_TRUE(gjk.intersecting);
+  EXPECT_NEAR(gjk.depth, 0.02, 1e-4);
+  EXPECT_GT(gjk.normal(2), 1.0 - 1e-4);
+}
+
+//==============================================================================
+TEST(GJK, WARM_START_REDUCES_SUPPORT_CALLS)
+{
+  Eigen::Vector3s size = Eigen::Vector3s::Ones();
+  Eigen::Isometry3s T0 = Eigen::Isometry3s::Identity();
+  Eigen::Isometry3s T1 = Eigen::Isometry3s::Identity();
+
+  ccdBox box0;
+  box0.size = &size;
+  box0.transform = &T0;
+  ccdBox box1;
+  box1.size = &size;
+  box1.transform = &T1;
+  GJKShape a{&box0, ccdSupportBox, ccdCenterBox};
+  GJKShape b{&box1, ccdSupportBox, ccdCenterBox};
+
+  GJKCache cache;
+  int coldCalls = 0;
+  int warmCalls = 0;
+  for (int i = 0; i < 20; i++)
+  {
+    // Slide box 1 along slowly, with a little spin, while staying separated
+    T1.translation() = Eigen::Vector3s(1.3 + 0.001 * i, 0.4, 0.3 - 0.01 * i);
+    T1.linear() = Eigen::AngleAxis_s(0.01 * i, Eigen::Vector3s::UnitZ())
+                      .toRotationMatrix();
+
+    GJKResult cold = gjkPenetration(a, b);
+    GJKResult warm = gjkPenetration(a, b, &cache);
+    EXPECT_FALSE(cold.intersecting);
+    EXPECT_FALSE(warm.intersecting);
+    EXPECT_NEAR(cold.distance, warm.distance, 1e-8);
+    if (i > 0)
+    {
+      coldCalls += cold.numSupportCalls;
+      warmCalls += warm.numSupportCalls;
+    }
+  }
+  EXPECT_LT(warmCalls, coldCalls);
+}
+
+//==============================================================================
+TEST(GJK, MULTI_SPHERE_SUPPORT)
+{
+  dynamics::MultiSphereConvexHullShape::Spheres spheres;
+  spheres.emplace_back(0.1, Eigen::Vector3s(-1, 0, 0));
+  spheres.emplace_back(0.3, Eigen::Vector3s(1, 0, 0));
+  Eigen::Isometry3s T = Eigen::Isometry3s::Identity();
+  T.translation() = Eigen::Vector3s(0, 0, 2);
+
+  ccdMultiSphere hull;
+  hull.spheres = &spheres;
+  hull.transform = &T;
+
+  ccd_vec3_t dir;
+  dir.v[0] = 0.0;
+  dir.v[1] = 0.0;
+  dir.v[2] = -5.0;
+  ccd_vec3_t out;
+  ccdSupportMultiSphere(&hull, &dir, &out);
+
+  // The larger sphere reaches lower
+  EXPECT_NEAR(out.v[0], 1.0, 1e-12);
+  EXPECT_NEAR(out.v[1], 0.0, 1e-12);
+  EXPECT_NEAR(out.v[2], 1.7, 1e-12);
+}
+
+//==============================================================================
+TEST(GJK, MULTI_SPHERE_BOX)
+{
+  // A capsule-like hull lying flat on top of a box, sinking in by 0.01
+  dynamics::MultiSphereConvexHullShape::Spheres spheres;
+  spheres.emplace_back(0.1, Eigen::Vector3s(-0.5, 0, 0));
+  spheres.emplace_back(0.1, Eigen::Vector3s(0.5, 0, 0));
+  spheres.emplace_back(0.05, Eigen::Vector3s(0, 0, 0.2));
+  Eigen::Isometry3s hullT = Eigen::Isometry3s::Identity();
+  hullT.translation() = Eigen::Vector3s(0, 0, 0.5 + 0.1 - 0.01);
+
+  Eigen::Vector3s size = Eigen::Vector3s(2.0, 2.0, 1.0);
+  Eigen::Isometry3s boxT = Eigen::Isometry3s::Identity();
+
+  CollisionOption option;
+  CollisionResult result;
+  int numContacts = collideMultiSphereBox(
+      nullptr, nullptr, spheres, hullT, size, boxT, option, result);
+  EXPECT_EQ(numContacts, 2);
+  for (int i = 0; i < numContacts; i++)
+  {
+    const Contact& contact = result.getContact(i);
+    EXPECT_NEAR(contact.penetrationDepth, 0.01, 1e-8);
+    // Points from the box (o2) to the hull (o1)
+    EXPECT_NEAR(contact.normal(2), 1.0, 1e-8);
+  }
+
+  // Flipping the objects flips the normal
+  CollisionResult flipped;
+  numContacts = collideBoxMultiSphere(
+      nullptr, nullptr, size, boxT, spheres, hullT, option, flipped);
+  EXPECT_EQ(numContacts, 2);
+  for (int i = 0; i < numContacts; i++)
+    EXPECT_NEAR(flipped.getContact(i).normal(2), -1.0, 1e-8);
+
+  // Lifting the hull off the box clears the contacts
+  hullT.translation()(2) += 0.05;
+  CollisionResult separated;
+  EXPECT_EQ(
+      collideMultiSphereBox(
+          nullptr, nullptr, spheres, hullT, size, boxT, option, separated),
+      0);
+}
+
+//==============================================================================
+TEST(GJK, MULTI_SPHERE_MULTI_SPHERE)
+{
+  dynamics::MultiSphereConvexHullShape::Spheres spheres;
+  spheres.emplace_back(0.2, Eigen::Vector3s(0, 0, -0.5));
+  spheres.emplace_back(0.2, Eigen::Vector3s(0, 0, 0.5));
+  Eigen::Isometry3s T0 = Eigen::Isometry3s::Identity();
+  Eigen::Isometry3s T1 = Eigen::Isometry3s::Identity();
+  // Crossed, so that the hulls touch along their middles
+  T1.linear() = Eigen::AngleAxis_s(M_PI / 2, Eigen::Vector3s::UnitY())
+                    .toRotationMatrix();
+  T1.translation() = Eigen::Vector3s(0, 0.39, 0);
+
+  CollisionOption option;
+  CollisionResult result;
+  int numContacts = collideMultiSphereMultiSphere(
+      nullptr, nullptr, spheres, T0, spheres, T1, option, result);
+
+  // The spheres themselves don't touch, so this falls back on the EPA contact,
+  // which is annotated as a vertex-face contact so it gets gradients
+  EXPECT_EQ(numContacts, 1);
+  EXPECT_EQ(result.getContact(0).type, VERTEX_FACE);
+  EXPECT_NEAR(result.getContact(0).penetrationDepth, 0.01, 1e-4);
+  EXPECT_NEAR(result.getContact(0).normal(1), -1.0, 1e-4);
+}
+
+//==============================================================================
+TEST(GJK, CACHE_IS_SHARED_BETWEEN_THREADS)
+{
+  clearGJKCache();
+  CollisionObject* o1 = reinterpret_cast<CollisionObject*>(0x10);
+  CollisionObject* o2 = reinterpret_cast<CollisionObject*>(0x20);
+  EXPECT_EQ(loadGJKCache(o1, o2).numDirections, 0);
+
+  GJKCache cache;
+  cache.numDirections = 1;
+  cache.directions[0] = Eigen::Vector3s::UnitX();
+  std::thread([&]() { storeGJKCache(o1, o2, cache); }).join();
+
+  // A warm start saved by a worker thread that has since exited is still
+  // there for the next thread that sees this pair
+  GJKCache loaded;
+  std::thread([&]() { loaded = loadGJKCache(o2, o1); }).join();
+  EXPECT_EQ(loaded.numDirections, 1);
+  EXPECT_TRUE(loaded.directions[0].isApprox(Eigen::Vector3s::UnitX()));
+
+  clearGJKCache();
+  EXPECT_EQ(loadGJKCache(o1, o2).numDirections, 0);
+}
@@ -178,6 +178,18 @@ bool testJacobians(std::shared_ptr<dynamics::Skeleton> osim)
       std::cout << "Testing WRT " << wrt->name() << std::endl;
       Eigen::MatrixXs analyticalJac
           = osim->getJointDistanceToOtherJointsJacobianWrt(joints, i, wrt);
+      Eigen::MatrixXs sparseJac = Eigen::MatrixXs(
+          osim->getJointDistanceToOtherJointsSparseJacobianWrt(
+              joints, i, wrt));
+      if (!equals(sparseJac, analyticalJac, 1e-10))
+      {
+        std::cout << "Sparse joint distance jacobian wrt " << wrt->name()
+                  << " disagrees with the dense one for joint " << i << "!"
+                  << std::endl;
+        std::cout << "Diff: " << std::endl
+                  << sparseJac - analyticalJac << std::endl;
+        return false;
+      }
       Eigen::MatrixXs bruteForceJac
           = osim->finiteDifferenceJointDistanceToOtherJointsJacobianWrt(
               joints, i, wrt);
@@ -242,4 +242,65 @@ TEST(LINEARIZED_MASS_MAPPING, JACOBIAN_OF_M)
     EXPECT_TRUE(equals(analytical, fd, 1e-8));
   }
 }
-#endif
\ No newline at end of file
+#endif
+#ifdef ALL_TESTS
+TEST(LINEARIZED_MASS_MAPPING, TRAJECTORY_JACOBIANS)
+{
+  OpenSimFile standard = OpenSimParser::parseOsim(
+      "dart://sample/grf/Sprinter/Models/"
+      "optimized_scale_and_markers.osim");
+  standard.skeleton->autogroupSymmetricSuffixes();
+
+  int numTimesteps = 7;
+  int dofs = standard.skeleton->getNumDofs();
+  Eigen::MatrixXs poses = Eigen::MatrixXs::Random(dofs, numTimesteps);
+  Eigen::MatrixXs vels = Eigen::MatrixXs::Random(dofs, numTimesteps);
+  Eigen::MatrixXs accs = Eigen::MatrixXs::Random(dofs, numTimesteps);
+
+  std::vector<Eigen::MatrixXs> comJacs;
+  std::vector<Eigen::MatrixXs> accOffsetJacs;
+  standard.skeleton->getLinearizedMassesJacobiansOverTrajectory(
+      poses, vels, accs, comJacs, accOffsetJacs, 3);
+  EXPECT_EQ(comJacs.size(), numTimesteps);
+  EXPECT_EQ(accOffsetJacs.size(), numTimesteps);
+
+  for (int t = 0; t < numTimesteps; t++)
+  {
+    standard.skeleton->setPositions(poses.col(t));
+    standard.skeleton->setVelocities(vels.col(t));
+    standard.skeleton->setAccelerations(accs.col(t));
+
+    Eigen::MatrixXs comJac
+        = standard.skeleton->getUnnormalizedCOMJacobianWrtLinearizedMasses();
+    Eigen::MatrixXs accOffsetJac
+        = standard.skeleton
+              ->getUnnormalizedCOMAccelerationOffsetJacobianWrtLinearizedMasses();
+    EXPECT_TRUE(equals(comJac, comJacs[t], 1e-12));
+    EXPECT_TRUE(equals(accOffsetJac, accOffsetJacs[t], 1e-12));
+    EXPECT_TRUE(equals(
+        comJac,
+        Eigen::MatrixXs(
+            standard.skeleton->getBodyCOMs()
+            * standard.skeleton->getLinearizedMassesBodyMap()),
+        1e-12));
+  }
+
+  // Reusing the same clones for a second trajectory gives the same result as
+  // cloning fresh ones
+  std::vector<std::shared_ptr<dynamics::Skeleton>> threadSkels;
+  for (int i = 0; i < 2; i++)
+    threadSkels.push_back(standard.skeleton->cloneSkeleton());
+  std::vector<Eigen::MatrixXs> reusedComJacs;
+  std::vector<Eigen::MatrixXs> reusedAccOffsetJacs;
+  for (int pass = 0; pass < 2; pass++)
+  {
+    standard.skeleton->getLinearizedMassesJacobiansOverTrajectory(
+        poses, vels, accs, reusedComJacs, reusedAccOffsetJacs, threadSkels);
+    for (int t = 0; t < numTimesteps; t++)
+    {
+      EXPECT_TRUE(equals(reusedComJacs[t], comJacs[t], 1e-12));
+      EXPECT_TRUE(equals(reusedAccOffsetJacs[t], accOffsetJacs[t], 1e-12));
+    }
+  }
+}
+#endif
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
@@ -22,6 +23,7 @@
 #include "dart/biomechanics/OpenSimParser.hpp"
 #include "dart/dynamics/BallJoint.hpp"
 #include "dart/dynamics/BodyNode.hpp"
+#include "dart/dynamics/EulerJoint.hpp"
 #include "dart/dynamics/FreeJoint.hpp"
 #include "dart/dynamics/Joint.hpp"
 #include "dart/dynamics/Skeleton.hpp"
@@ -2304,6 +2306,229 @@ TEST(MarkerFitter, ROTATE_IN_BOUNDS)
 }
 #endif
 
+#ifdef FUNCTIONAL_TESTS
+TEST(MarkerFitter, SLIDING_WINDOWS)
+{
+  std::vector<std::pair<int, int>> windows
+      = MarkerFitter::getSlidingWindows(25, 10, 3);
+  ASSERT_EQ(windows.size(), 4);
+  EXPECT_EQ(windows[0], std::make_pair(0, 10));
+  EXPECT_EQ(windows[1], std::make_pair(7, 10));
+  EXPECT_EQ(windows[2], std::make_pair(14, 10));
+  EXPECT_EQ(windows[3], std::make_pair(21, 4));
+
+  windows = MarkerFitter::getSlidingWindows(5, 10, 3);
+  ASSERT_EQ(windows.size(), 1);
+  EXPECT_EQ(windows[0], std::make_pair(0, 5));
+
+  // Blending two constant windows should ramp across the overlap, and leave
+  // everything else untouched
+  Eigen::MatrixXs series = Eigen::MatrixXs::Zero(2, 6);
+  MarkerFitter::blendSlidingWindow(
+      series, Eigen::MatrixXs::Zero(2, 4), 0, 0);
+  MarkerFitter::blendSlidingWindow(
+      series, Eigen::MatrixXs::Ones(2, 4) * 3, 2, 2);
+  EXPECT_NEAR(series(0, 1), 0.0, 1e-12);
+  EXPECT_NEAR(series(0, 2), 1.0, 1e-12);
+  EXPECT_NEAR(series(1, 3), 2.0, 1e-12);
+  EXPECT_NEAR(series(0, 4), 3.0, 1e-12);
+  EXPECT_NEAR(series(1, 5), 3.0, 1e-12);
+
+  // An Euler joint that crosses +/-pi between windows shouldn't get blended
+  // through zero
+  std::shared_ptr<dynamics::Skeleton> skel = dynamics::Skeleton::create();
+  skel->createJointAndBodyNodePair<dynamics::EulerJoint>();
+  Eigen::MatrixXs poses = Eigen::MatrixXs::Zero(3, 4);
+  Eigen::MatrixXs before = Eigen::MatrixXs::Zero(3, 2);
+  before.row(0).setConstant(M_PI - 0.1);
+  Eigen::MatrixXs after = Eigen::MatrixXs::Zero(3, 3);
+  after.row(0).setConstant(-M_PI + 0.1);
+  MarkerFitter::blendSlidingWindow(poses, before, 0, 0, skel);
+  MarkerFitter::blendSlidingWindow(poses, after, 1, 1, skel);
+  EXPECT_NEAR(poses(0, 0), M_PI - 0.1, 1e-9);
+  EXPECT_NEAR(poses(0, 1), M_PI, 1e-9);
+  EXPECT_NEAR(poses(0, 2), M_PI + 0.1, 1e-9);
+  EXPECT_NEAR(poses(0, 3), M_PI + 0.1, 1e-9);
+}
+#endif
+
+#ifdef FUNCTIONAL_TESTS
+TEST(MarkerFitter, SLIDING_WINDOW_IK_MATCHES_GLOBAL)
+{
+  OpenSimFile standard = OpenSimParser::parseOsim(
+      "dart://sample/osim/Rajagopal2015/Rajagopal2015.osim");
+  standard.skeleton->autogroupSymmetricSuffixes();
+  OpenSimTRC markerTrajectories = OpenSimParser::loadTRC(
+      "dart://sample/osim/Rajagopal2015_v3_scaled/"
+      "S01DN603.trc");
+  OpenSimFile moddedBase = OpenSimParser::parseOsim(
+      "dart://sample/osim/Rajagopal2015_v3_scaled/"
+      "Rajagopal2015_passiveCal_hipAbdMoved.osim");
+  standard.markersMap
+      = standard.skeleton->convertMarkerMap(moddedBase.markersMap);
+
+  MarkerFitter fitter(standard.skeleton, standard.markersMap);
+  fitter.setInitialIKSatisfactoryLoss(0.05);
+  fitter.setInitialIKMaxRestarts(50);
+  fitter.setIterationLimit(100);
+  fitter.setTriadsToTracking();
+
+  std::vector<std::map<std::string, Eigen::Vector3s>> markerObservations;
+  for (int i = 0; i < 300; i++)
+  {
+    markerObservations.push_back(markerTrajectories.markerTimesteps[i]);
+  }
+  std::vector<bool> newClip(markerObservations.size(), false);
+  MarkerInitialization init = fitter.getInitialization(
+      markerObservations, newClip, InitialMarkerFitParams());
+  const int numTimesteps = markerObservations.size();
+
+  // Small windows, so that the trial gets split into several of them
+  fitter.setSlidingWindowIKSize(100);
+  fitter.setSlidingWindowIKOverlap(20);
+
+  fitter.setSlidingWindowIK(false);
+  MarkerInitialization globalFit = fitter.fineTuneIK(
+      markerObservations, 1, std::map<std::string, s_t>(), init);
+  fitter.setSlidingWindowIK(true);
+  MarkerInitialization windowFit = fitter.fineTuneIK(
+      markerObservations, 1, std::map<std::string, s_t>(), init);
+
+  ASSERT_EQ(windowFit.poses.cols(), numTimesteps);
+  ASSERT_EQ(windowFit.poseScores.size(), numTimesteps);
+  // The windows should fit the markers about as well as the global solve,
+  // including on the blended timesteps
+  EXPECT_LT(windowFit.poseScores.mean(), globalFit.poseScores.mean() * 1.25);
+  s_t meanPoseDist = 0.0;
+  for (int t = 0; t < numTimesteps; t++)
+  {
+    meanPoseDist += (standard.skeleton->unwrapPositionToNearest(
+                         windowFit.poses.col(t), globalFit.poses.col(t))
+                     - globalFit.poses.col(t))
+                        .norm();
+  }
+  meanPoseDist /= numTimesteps;
+  EXPECT_LT(meanPoseDist, 0.1);
+
+  // Smoothing in windows should stay close to smoothing the whole trial at
+  // once
+  AccelerationSmoother smoother(numTimesteps, 1.0, 0.001);
+  Eigen::MatrixXs globalSmoothed = smoother.smooth(init.poses);
+  MarkerInitialization windowSmoothed
+      = fitter.smoothOutIK(markerObservations, newClip, init);
+  ASSERT_EQ(windowSmoothed.poses.cols(), numTimesteps);
+  s_t meanSmoothedDist = 0.0;
+  for (int t = 0; t < numTimesteps; t++)
+  {
+    meanSmoothedDist
+        += (windowSmoothed.poses.col(t) - globalSmoothed.col(t)).norm();
+  }
+  meanSmoothedDist /= numTimesteps;
+  EXPECT_LT(meanSmoothedDist, 0.01);
+}
+#endif
+
+#ifdef FUNCTIONAL_TESTS
+TEST(MarkerFitter, WARM_START_IK_MATCHES_SERIAL)
+{
+  OpenSimFile standard = OpenSimParser::parseOsim(
+      "dart://sample/osim/Rajagopal2015/Rajagopal2015.osim");
+  standard.skeleton->autogroupSymmetricSuffixes();
+  OpenSimTRC markerTrajectories = OpenSimParser::loadTRC(
+      "dart://sample/osim/Rajagopal2015_v3_scaled/"
+      "S01DN603.trc");
+  OpenSimFile moddedBase = OpenSimParser::parseOsim(
+      "dart://sample/osim/Rajagopal2015_v3_scaled/"
+      "Rajagopal2015_passiveCal_hipAbdMoved.osim");
+  standard.markersMap
+      = standard.skeleton->convertMarkerMap(moddedBase.markersMap);
+
+  MarkerFitter fitter(standard.skeleton, standard.markersMap);
+  fitter.setInitialIKSatisfactoryLoss(0.05);
+  fitter.setInitialIKMaxRestarts(50);
+  fitter.setIterationLimit(100);
+  fitter.setTriadsToTracking();
+
+  // fitTrajectory() expects only markers that are in the model
+  const int numTimesteps = 200;
+  std::vector<std::map<std::string, Eigen::Vector3s>> markerObservations;
+  for (int i = 0; i < numTimesteps; i++)
+  {
+    markerObservations.emplace_back();
+    for (auto& pair : markerTrajectories.markerTimesteps[i])
+    {
+      if (standard.markersMap.count(pair.first))
+      {
+        markerObservations.back()[pair.first] = pair.second;
+      }
+    }
+  }
+  MarkerInitialization init = fitter.getInitialization(
+      markerObservations,
+      std::vector<bool>(numTimesteps, false),
+      InitialMarkerFitParams());
+
+  // Just fit the markers, without any joint centers
+  const int numDofs = standard.skeleton->getNumDofs();
+  std::vector<Eigen::VectorXs> noJointData(numTimesteps, Eigen::VectorXs());
+  auto fit = [&](Eigen::MatrixXs& poses, Eigen::VectorXs& scores) {
+    poses = Eigen::MatrixXs::Zero(numDofs, numTimesteps);
+    scores = Eigen::VectorXs::Zero(numTimesteps);
+    MarkerFitter::fitTrajectory(
+        &fitter,
+        init.groupScales,
+        init.poses.col(0),
+        markerObservations,
+        std::map<std::string, s_t>(),
+        init.markerOffsets,
+        std::vector<dynamics::Joint*>(),
+        noJointData,
+        Eigen::VectorXs(),
+        noJointData,
+        Eigen::VectorXs(),
+        init.observedJoints,
+        poses,
+        scores);
+  };
+
+  Eigen::MatrixXs serialPoses;
+  Eigen::VectorXs serialScores;
+  fit(serialPoses, serialScores);
+
+  fitter.setWarmStartIK(true);
+  fitter.setWarmStartIKMaxRestarts(3);
+  for (int numChunks : {1, 4})
+  {
+    fitter.setWarmStartIKNumChunks(numChunks);
+    Eigen::MatrixXs warmPoses;
+    Eigen::VectorXs warmScores;
+    fit(warmPoses, warmScores);
+
+    // The warm start should fit the markers about as well as the serial path,
+    // and land on about the same poses
+    EXPECT_LT(warmScores.mean(), serialScores.mean() * 1.1 + 1e-4);
+    s_t meanPoseDist = 0.0;
+    for (int t = 0; t < numTimesteps; t++)
+    {
+      meanPoseDist += (standard.skeleton->unwrapPositionToNearest(
+                           warmPoses.col(t), serialPoses.col(t))
+                       - serialPoses.col(t))
+                          .norm();
+    }
+    meanPoseDist /= numTimesteps;
+    EXPECT_LT(meanPoseDist, 0.05);
+
+    // Each chunk draws its restarts from its own generator, so running again
+    // should give exactly the same answer, however the threads get scheduled
+    Eigen::MatrixXs againPoses;
+    Eigen::VectorXs againScores;
+    fit(againPoses, againScores);
+    EXPECT_TRUE(againPoses == warmPoses);
+    EXPECT_TRUE(againScores == warmScores);
+  }
+}
+#endif
+
 #ifdef ALL_TESTS
 TEST(MarkerFitter, CLAMP_WEIRDNESS)
 {
@@ -3429,6 +3654,269 @@ TEST(MarkerFitter, INITIALIZATION)
 }
 #endif
 
+#ifdef FUNCTIONAL_TESTS
+// This is the serial scan checkForFlippedMarkers() used to do, which returns
+// the warnings it would have produced for each pair of swapped markers
+std::vector<std::string> serialFlippedMarkerWarnings(
+    std::shared_ptr<dynamics::Skeleton> skel,
+    const std::vector<std::map<std::string, Eigen::Vector3s>>&
+        markerObservations,
+    const MarkerInitialization& init)
+{
+  std::vector<std::string> observedMarkers;
+  for (auto& obs : markerObservations)
+  {
+    for (auto& pair : obs)
+    {
+      if (std::find(observedMarkers.begin(), observedMarkers.end(), pair.first)
+          == observedMarkers.end())
+      {
+        observedMarkers.push_back(pair.first);
+      }
+    }
+  }
+  std::sort(observedMarkers.begin(), observedMarkers.end());
+
+  std::map<std::string, std::map<std::string, s_t>> totalDistances;
+  std::map<std::string, std::map<std::string, int>> totalObservations;
+  for (std::string& marker : observedMarkers)
+  {
+    for (std::string& innerMarker : observedMarkers)
+    {
+      totalDistances[marker][innerMarker] = 0.0;
+      totalObservations[marker][innerMarker] = 0;
+    }
+  }
+
+  skel->setGroupScales(init.groupScales);
+  for (int i = 0; i < init.poses.cols() && i < markerObservations.size(); i++)
+  {
+    skel->setPositions(init.poses.col(i));
+    for (auto& pair :
+         skel->getMarkerMapWorldPositions(init.updatedMarkerMap))
+    {
+      if (!totalDistances.count(pair.first))
+        continue;
+      for (auto& innerPair : markerObservations.at(i))
+      {
+        totalDistances[pair.first][innerPair.first]
+            += (pair.second - innerPair.second).norm();
+        totalObservations[pair.first][innerPair.first]++;
+      }
+    }
+  }
+
+  std::map<std::string, std::string> closestMarkers;
+  for (std::string& marker : observedMarkers)
+  {
+    int selfObserved = totalObservations[marker][marker];
+    std::string closestMarker = marker;
+    s_t closestMarkerDistance = totalDistances[marker][marker]
+                                / (selfObserved > 0 ? selfObserved : 1.0);
+    for (std::string& innerMarker : observedMarkers)
+    {
+      int observed = totalObservations[marker][innerMarker];
+      if (observed > 0)
+      {
+        s_t avgDist = totalDistances[marker][innerMarker] / observed;
+        if (avgDist < closestMarkerDistance)
+        {
+          closestMarker = innerMarker;
+          closestMarkerDistance = avgDist;
+        }
+      }
+    }
+    closestMarkers[marker] = closestMarker;
+  }
+
+  std::vector<std::string> warnings;
+  std::map<std::string, std::string> swapped;
+  for (std::string& marker : observedMarkers)
+  {
+    const std::string closest = closestMarkers.at(marker);
+    if (closest != marker && closestMarkers.at(closest) == marker
+        && swapped.count(closest) == 0)
+    {
+      warnings.push_back(
+          "Marker \"" + marker + "\" seems it was swapped with \"" + closest
+          + "\" for the whole clip.");
+      swapped[marker] = closest;
+      swapped[closest] = marker;
+    }
+  }
+  return warnings;
+}
+
+TEST(MarkerFitter, CHECK_FOR_FLIPPED_MARKERS_MATCHES_SERIAL)
+{
+  OpenSimFile standard = OpenSimParser::parseOsim(
+      "dart://sample/osim/Rajagopal2015/Rajagopal2015.osim");
+  standard.skeleton->autogroupSymmetricSuffixes();
+  OpenSimTRC markerTrajectories = OpenSimParser::loadTRC(
+      "dart://sample/osim/Rajagopal2015_v3_scaled/"
+      "S01DN603.trc");
+  OpenSimFile moddedBase = OpenSimParser::parseOsim(
+      "dart://sample/osim/Rajagopal2015_v3_scaled/"
+      "Rajagopal2015_passiveCal_hipAbdMoved.osim");
+  standard.markersMap
+      = standard.skeleton->convertMarkerMap(moddedBase.markersMap);
+
+  MarkerFitter fitter(standard.skeleton, standard.markersMap);
+  fitter.setInitialIKSatisfactoryLoss(0.05);
+  fitter.setInitialIKMaxRestarts(50);
+  fitter.setIterationLimit(100);
+  fitter.setTriadsToTracking();
+
+  // 300 frames is enough to split the scan across several threads
+  std::vector<std::map<std::string, Eigen::Vector3s>> original;
+  for (int i = 0; i < 300; i++)
+  {
+    original.push_back(markerTrajectories.markerTimesteps[i]);
+  }
+  MarkerInitialization init = fitter.getInitialization(
+      original,
+      std::vector<bool>(original.size(), false),
+      InitialMarkerFitParams());
+
+  // Swap the first and last marker names for the whole clip
+  const std::string a = original[0].begin()->first;
+  const std::string b = original[0].rbegin()->first;
+  std::vector<std::map<std::string, Eigen::Vector3s>> swapped = original;
+  for (auto& obs : swapped)
+  {
+    if (obs.count(a) && obs.count(b))
+    {
+      std::swap(obs.at(a), obs.at(b));
+    }
+  }
+
+  for (auto* observations : {&original, &swapped})
+  {
+    Eigen::VectorXs originalPose = standard.skeleton->getPositions();
+    std::vector<std::string> expected
+        = serialFlippedMarkerWarnings(standard.skeleton, *observations, init);
+    standard.skeleton->setPositions(originalPose);
+
+    std::shared_ptr<MarkersErrorReport> report
+        = std::make_shared<MarkersErrorReport>();
+    bool anySwapped
+        = fitter.checkForFlippedMarkers(*observations, init, report);
+    EXPECT_EQ(anySwapped, expected.size() > 0);
+    EXPECT_EQ(report->warnings, expected);
+  }
+
+  // The swap we made should have been found and undone
+  std::shared_ptr<MarkersErrorReport> report
+      = std::make_shared<MarkersErrorReport>();
+  EXPECT_TRUE(fitter.checkForFlippedMarkers(swapped, init, report));
+  ASSERT_EQ(report->markerObservationsAttemptedFixed.size(), original.size());
+  for (int i = 0; i < original.size(); i++)
+  {
+    const std::map<std::string, Eigen::Vector3s>& fixed
+        = report->markerObservationsAttemptedFixed[i];
+    for (auto& pair : original[i])
+    {
+      ASSERT_TRUE(fixed.count(pair.first));
+      EXPECT_TRUE(fixed.at(pair.first).isApprox(pair.second));
+    }
+  }
+}
+#endif
+
+#ifdef FUNCTIONAL_TESTS
+TEST(MarkerFitter, AUTOROTATE_C3D_MATCHES_EXHAUSTIVE_SEARCH)
+{
+  OpenSimFile standard = OpenSimParser::parseOsim(
+      "dart://sample/osim/ComplexKnee/gait2392_frontHingeKnee_dem.osim");
+  standard.skeleton->autogroupSymmetricSuffixes();
+  standard.skeleton->zeroTranslationInCustomFunctions();
+
+  C3D c3d
+      = C3DLoader::loadC3D("dart://sample/osim/ComplexKnee/2022_01_0403.c3d");
+  C3DLoader::fixupMarkerFlips(&c3d);
+  ASSERT_EQ(c3d.forcePlates.size(), 0);
+  // The coarse pass only kicks in on trials longer than 400 frames, so keep
+  // enough frames to exercise it, but not so many that the exhaustive search
+  // below takes forever
+  ASSERT_GT(c3d.markerTimesteps.size(), 1000);
+  c3d.markerTimesteps.resize(1000);
+  // Lay the data on its side, so the identity isn't the right answer
+  Eigen::Matrix3s tilt
+      = math::eulerXYZToMatrix(Eigen::Vector3s(M_PI / 2, 0, 0));
+  for (auto& timestep : c3d.markerTimesteps)
+  {
+    for (auto& pair : timestep)
+    {
+      pair.second = tilt * pair.second;
+    }
+  }
+  MarkerFitter fitter(standard.skeleton, standard.markersMap);
+  fitter.setInitialIKSatisfactoryLoss(0.005);
+  fitter.setInitialIKMaxRestarts(200);
+  fitter.setIterationLimit(300);
+  fitter.setTrackingMarkers(standard.trackingMarkers);
+
+  // This is the exhaustive search autorotateC3D() used to do, scoring every
+  // candidate rotation by the average root rotation of IK on every frame
+  std::vector<Eigen::Matrix3s> rotationsToTry;
+  rotationsToTry.push_back(Eigen::Matrix3s::Identity());
+  rotationsToTry.push_back(
+      math::eulerXYZToMatrix(Eigen::Vector3s(-M_PI / 2, 0, 0)));
+  rotationsToTry.push_back(
+      math::eulerXYZToMatrix(Eigen::Vector3s(M_PI / 2, 0, 0)));
+  s_t smallestMag = std::numeric_limits<s_t>::infinity();
+  Eigen::Matrix3s expectedR = Eigen::Matrix3s::Identity();
+  for (Eigen::Matrix3s& R : rotationsToTry)
+  {
+    std::vector<std::map<std::string, Eigen::Vector3s>> markerTimesteps;
+    for (auto& timestep : c3d.markerTimesteps)
+    {
+      std::map<std::string, Eigen::Vector3s> rotatedMarkers;
+      for (auto& pair : timestep)
+      {
+        rotatedMarkers[pair.first] = R * pair.second;
+      }
+      markerTimesteps.push_back(rotatedMarkers);
+    }
+    std::vector<bool> newClip(markerTimesteps.size(), false);
+    MarkerInitialization init = fitter.getInitialization(
+        markerTimesteps,
+        newClip,
+        InitialMarkerFitParams().setNumIKTries(1).setDontRescaleBodies(true));
+
+    Eigen::VectorXs originalPose = standard.skeleton->getPositions();
+    s_t avgMag = 0.0;
+    for (int i = 0; i < init.poses.cols(); i++)
+    {
+      standard.skeleton->setPositions(init.poses.col(i));
+      avgMag += math::logMap(standard.skeleton->getJoint(0)
+                                 ->getRelativeTransform()
+                                 .linear())
+                    .norm();
+    }
+    avgMag /= init.poses.cols();
+    standard.skeleton->setPositions(originalPose);
+    if (avgMag < smallestMag)
+    {
+      smallestMag = avgMag;
+      expectedR = R;
+    }
+  }
+
+  C3D rotated = c3d;
+  fitter.autorotateC3D(&rotated);
+  for (int i = 0; i < c3d.markerTimesteps.size(); i += 100)
+  {
+    for (auto& pair : c3d.markerTimesteps[i])
+    {
+      EXPECT_TRUE(rotated.markerTimesteps[i]
+                      .at(pair.first)
+                      .isApprox(expectedR * pair.second, 1e-9));
+    }
+  }
+}
+#endif
+
 #ifdef FUNCTIONAL_TESTS
 TEST(MarkerFitter, SPHERE_FIT_GRAD)
 {
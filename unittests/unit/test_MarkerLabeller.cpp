@@ -67,4 +67,101 @@ TEST(LABELLER, RECREATE_LABELS)
 
   labeller.evaluate(markerStringMap, markersOverTime);
 }
-#endif
\ No newline at end of file
+#endif
+#ifdef ALL_TESTS
+TEST(LABELLER, BATCHED_MATCHES_PER_FRAME)
+{
+  // A stand-in for the network: the "center" joint is the mean of the cloud,
+  // and the "top" joint is the highest point in the cloud
+  auto predictFrame = [](const std::vector<Eigen::Vector3s>& cloud) {
+    std::map<std::string, Eigen::Vector3s> joints;
+    Eigen::Vector3s center = Eigen::Vector3s::Zero();
+    Eigen::Vector3s top = Eigen::Vector3s::Zero();
+    for (int i = 0; i < cloud.size(); i++)
+    {
+      center += cloud[i];
+      if (i == 0 || cloud[i](1) > top(1))
+      {
+        top = cloud[i];
+      }
+    }
+    if (cloud.size() > 0)
+    {
+      center /= cloud.size();
+    }
+    joints["center"] = center;
+    joints["top"] = top;
+    return joints;
+  };
+
+  NeuralMarkerLabeller perFrame(
+      [&](const std::vector<std::vector<Eigen::Vector3s>>& pointClouds) {
+        std::vector<std::map<std::string, Eigen::Vector3s>> result;
+        for (const auto& cloud : pointClouds)
+        {
+          result.push_back(predictFrame(cloud));
+        }
+        return result;
+      });
+
+  std::vector<std::string> jointNames;
+  jointNames.push_back("center");
+  jointNames.push_back("top");
+  int batchSize = 4;
+  int numCalls = 0;
+  NeuralMarkerLabeller batched(
+      [&](const Eigen::MatrixXs& points, const Eigen::VectorXi& numPoints) {
+        numCalls++;
+        EXPECT_EQ(numPoints.size(), batchSize);
+        int width = points.cols() / batchSize;
+        Eigen::MatrixXs jointCenters = Eigen::MatrixXs::Zero(6, batchSize);
+        for (int b = 0; b < batchSize; b++)
+        {
+          std::vector<Eigen::Vector3s> cloud;
+          for (int i = 0; i < numPoints(b); i++)
+          {
+            cloud.push_back(points.col(b * width + i));
+          }
+          std::map<std::string, Eigen::Vector3s> joints = predictFrame(cloud);
+          jointCenters.block<3, 1>(0, b) = joints["center"];
+          jointCenters.block<3, 1>(3, b) = joints["top"];
+        }
+        return jointCenters;
+      },
+      jointNames,
+      batchSize,
+      6);
+
+  // 11 frames doesn't divide evenly into batches, and some of the clouds are
+  // empty or bigger than maxPoints
+  srand(42);
+  std::vector<std::vector<Eigen::Vector3s>> pointClouds;
+  for (int t = 0; t < 11; t++)
+  {
+    std::vector<Eigen::Vector3s> cloud;
+    int numPoints = (t * 3) % 10;
+    for (int i = 0; i < numPoints; i++)
+    {
+      cloud.push_back(Eigen::Vector3s::Random());
+    }
+    pointClouds.push_back(cloud);
+  }
+
+  std::vector<std::map<std::string, Eigen::Vector3s>> expected
+      = perFrame.guessJointLocations(pointClouds);
+  std::vector<std::map<std::string, Eigen::Vector3s>> actual
+      = batched.guessJointLocations(pointClouds);
+
+  EXPECT_EQ(numCalls, 3);
+  ASSERT_EQ(expected.size(), actual.size());
+  for (int t = 0; t < expected.size(); t++)
+  {
+    ASSERT_EQ(expected[t].size(), actual[t].size());
+    for (auto& pair : expected[t])
+    {
+      ASSERT_TRUE(actual[t].count(pair.first));
+      EXPECT_TRUE(equals(pair.second, actual[t][pair.first], 0));
+    }
+  }
+}
+#endif
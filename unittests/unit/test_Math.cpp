@@ -37,6 +37,7 @@
 #include "dart/common/Timer.hpp"
 #include "dart/dynamics/RevoluteJoint.hpp"
 #include "dart/dynamics/Skeleton.hpp"
+#include "dart/math/FiniteDifference.hpp"
 #include "dart/math/Geometry.hpp"
 #include "dart/math/Helpers.hpp"
 #include "dart/simulation/World.hpp"
@@ -1439,3 +1440,39 @@ TEST(MATH, PerformanceComparisonOfAdTJac)
   // Note: The best function for dynamic size Jacobian is AdTJac2, and the best
   //       function for fixed size Jacobian is AdTJac3
 }
+
+//==============================================================================
+TEST(MATH, RANDOM_DIRECTIONAL_DERIVATIVE_CHECK)
+{
+  Eigen::MatrixXs A = Eigen::MatrixXs::Random(4, 6);
+  Eigen::VectorXs x = Eigen::VectorXs::Random(6);
+
+  // f(x) = 0.5 * |A x|^2, so grad f = A^T A x
+  auto loss = [&](const Eigen::VectorXs& point) {
+    return (s_t)(0.5 * (A * point).squaredNorm());
+  };
+  Eigen::VectorXs grad = A.transpose() * A * x;
+  EXPECT_LT(checkGradientAlongRandomDirections(loss, grad, x, 3), 1e-6);
+
+  // A gradient with one wrong entry should get caught
+  Eigen::VectorXs badGrad = grad;
+  badGrad(2) += 100.0;
+  EXPECT_GT(checkGradientAlongRandomDirections(loss, badGrad, x, 3), 1e-3);
+
+  // g(x) = sin(A x), so J = diag(cos(A x)) A
+  auto eval = [&](const Eigen::VectorXs& point) {
+    return Eigen::VectorXs((A * point).array().sin().matrix());
+  };
+  Eigen::MatrixXs J = (A * x).array().cos().matrix().asDiagonal() * A;
+  auto jvp = [&](const Eigen::VectorXs& dir) {
+    return Eigen::VectorXs(J * dir);
+  };
+  EXPECT_LT(checkJacobianAlongRandomDirections(eval, jvp, x, 3), 1e-6);
+
+  Eigen::MatrixXs badJ = J;
+  badJ(1, 4) += 100.0;
+  auto badJvp = [&](const Eigen::VectorXs& dir) {
+    return Eigen::VectorXs(badJ * dir);
+  };
+  EXPECT_GT(checkJacobianAlongRandomDirections(eval, badJvp, x, 3), 1e-3);
+}
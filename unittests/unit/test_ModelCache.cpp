@@ -0,0 +1,135 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "dart/common/ResourceRetriever.hpp"
+#include "dart/dynamics/Skeleton.hpp"
+#include "dart/simulation/World.hpp"
+#include "dart/utils/DartResourceRetriever.hpp"
+#include "dart/utils/ModelCache.hpp"
+
+using namespace dart;
+using namespace utils;
+
+//==============================================================================
+TEST(ModelCache, LOADS_ARE_INDEPENDENT_COPIES)
+{
+  ModelCache cache;
+  std::shared_ptr<dynamics::Skeleton> first
+      = cache.loadSkeleton("dart://sample/sdf/atlas/ground.urdf");
+  std::shared_ptr<dynamics::Skeleton> second
+      = cache.loadSkeleton("dart://sample/sdf/atlas/ground.urdf");
+  ASSERT_TRUE(first != nullptr);
+  ASSERT_TRUE(second != nullptr);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(cache.getNumCachedModels(), 1);
+
+  EXPECT_EQ(first->getNumBodyNodes(), second->getNumBodyNodes());
+  EXPECT_EQ(first->getNumDofs(), second->getNumDofs());
+  if (first->getNumDofs() > 0)
+  {
+    first->setPositions(Eigen::VectorXs::Ones(first->getNumDofs()));
+    EXPECT_TRUE(second->getPositions().isZero());
+  }
+}
+
+//==============================================================================
+TEST(ModelCache, PARALLEL_LOAD_MATCHES_SERIAL)
+{
+  std::vector<common::Uri> uris;
+  for (int i = 0; i < 4; i++)
+  {
+    uris.push_back("dart://sample/sdf/atlas/ground.urdf");
+    uris.push_back("dart://sample/skel/test/cube_skeleton.skel");
+  }
+
+  ModelCache cache;
+  std::vector<std::shared_ptr<dynamics::Skeleton>> skeletons
+      = cache.loadSkeletons(uris);
+  ASSERT_EQ(skeletons.size(), uris.size());
+  EXPECT_EQ(cache.getNumCachedModels(), 2);
+
+  ModelCache serialCache;
+  for (std::size_t i = 0; i < uris.size(); i++)
+  {
+    std::shared_ptr<dynamics::Skeleton> serial
+        = serialCache.loadSkeleton(uris[i]);
+    ASSERT_TRUE(skeletons[i] != nullptr);
+    ASSERT_TRUE(serial != nullptr);
+    EXPECT_EQ(skeletons[i]->getName(), serial->getName());
+    EXPECT_EQ(skeletons[i]->getNumBodyNodes(), serial->getNumBodyNodes());
+  }
+
+  std::shared_ptr<simulation::World> world = cache.loadWorld(uris);
+  EXPECT_EQ(world->getNumSkeletons(), uris.size());
+}
+
+//==============================================================================
+TEST(ModelCache, MISSING_FILE_RETURNS_NULL)
+{
+  ModelCache cache;
+  EXPECT_EQ(
+      cache.loadSkeleton("dart://sample/skel/test/does_not_exist.urdf"),
+      nullptr);
+}
+
+//==============================================================================
+/// Serves a single in-memory file, whose contents change after `readAll()`
+class ChangingResourceRetriever : public common::ResourceRetriever
+{
+public:
+  std::string mBefore;
+  std::string mAfter;
+  int mNumReads = 0;
+
+  bool exists(const common::Uri& /*uri*/) override
+  {
+    return true;
+  }
+
+  common::ResourcePtr retrieve(const common::Uri& /*uri*/) override
+  {
+    // The cache should never go back to the retriever for the file itself
+    ADD_FAILURE() << "retrieve() was called after the contents were read";
+    return nullptr;
+  }
+
+  std::string readAll(const common::Uri& /*uri*/) override
+  {
+    return mNumReads++ == 0 ? mBefore : mAfter;
+  }
+};
+
+//==============================================================================
+TEST(ModelCache, PARSES_THE_CONTENTS_IT_HASHED)
+{
+  auto retriever = std::make_shared<ChangingResourceRetriever>();
+  retriever->mBefore = utils::DartResourceRetriever::create()->readAll(
+      "dart://sample/skel/test/cube_skeleton.skel");
+  retriever->mAfter = "this is not a skel file";
+
+  ModelCache cache(retriever);
+  std::shared_ptr<dynamics::Skeleton> skeleton
+      = cache.loadSkeleton("memory://cube_skeleton.skel");
+  ASSERT_TRUE(skeleton != nullptr);
+  EXPECT_GT(skeleton->getNumBodyNodes(), 0u);
+}
+
+//==============================================================================
+TEST(ModelCache, FAILED_PARSES_ARE_NOT_CACHED)
+{
+  auto retriever = std::make_shared<ChangingResourceRetriever>();
+  retriever->mBefore = "this is not a skel file";
+  retriever->mAfter = utils::DartResourceRetriever::create()->readAll(
+      "dart://sample/skel/test/cube_skeleton.skel");
+
+  ModelCache cache(retriever);
+  EXPECT_EQ(cache.loadSkeleton("memory://cube_skeleton.skel"), nullptr);
+  EXPECT_EQ(cache.getNumCachedModels(), 0);
+
+  // Once the file is fixed, the next load picks it up
+  EXPECT_TRUE(cache.loadSkeleton("memory://cube_skeleton.skel") != nullptr);
+  EXPECT_EQ(cache.getNumCachedModels(), 1);
+}
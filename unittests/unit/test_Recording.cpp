@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/stat.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include "dart/simulation/Recording.hpp"
+#include "dart/simulation/detail/RecordingBuffer.hpp"
+
+#include "TestHelpers.hpp"
+
+using namespace dart;
+using namespace simulation;
+
+namespace {
+
+//==============================================================================
+Eigen::VectorXs makeState(int totalDofs, int numContacts, int frame)
+{
+  Eigen::VectorXs state(totalDofs + 6 * numContacts);
+  for (int i = 0; i < state.size(); i++)
+    state(i) = frame * 1000 + i;
+  return state;
+}
+
+//==============================================================================
+void checkFrames(const Recording& recording, int numFrames)
+{
+  const int totalDofs = recording.getTotalNumDofs();
+  ASSERT_EQ(numFrames, recording.getNumFrames());
+  for (int frame = 0; frame < numFrames; frame++)
+  {
+    const int numContacts = frame % 3;
+    const Eigen::VectorXs state = makeState(totalDofs, numContacts, frame);
+
+    EXPECT_EQ(numContacts, recording.getNumContacts(frame));
+    EXPECT_TRUE(equals(
+        Eigen::VectorXs(state.head(totalDofs)),
+        Eigen::VectorXs(recording.getConfigs().col(frame))));
+
+    int offset = 0;
+    for (int skel = 0; skel < recording.getNumSkeletons(); skel++)
+    {
+      const int numDofs = recording.getNumDofs(skel);
+      EXPECT_TRUE(equals(
+          Eigen::VectorXs(state.segment(offset, numDofs)),
+          Eigen::VectorXs(recording.getConfig(frame, skel))));
+      for (int dof = 0; dof < numDofs; dof++)
+        EXPECT_EQ(state(offset + dof), recording.getGenCoord(frame, skel, dof));
+      offset += numDofs;
+    }
+
+    for (int contact = 0; contact < numContacts; contact++)
+    {
+      EXPECT_TRUE(equals(
+          Eigen::Vector3s(state.segment<3>(totalDofs + 6 * contact)),
+          Eigen::Vector3s(recording.getContactPoint(frame, contact))));
+      EXPECT_TRUE(equals(
+          Eigen::Vector3s(state.segment<3>(totalDofs + 6 * contact + 3)),
+          Eigen::Vector3s(recording.getContactForce(frame, contact))));
+    }
+  }
+}
+
+} // namespace
+
+//==============================================================================
+TEST(Recording, ContiguousFrames)
+{
+  Recording recording(std::vector<int>{3, 0, 7});
+  EXPECT_EQ(10, recording.getTotalNumDofs());
+
+  const int numFrames = 50;
+  recording.reserve(numFrames);
+  for (int frame = 0; frame < numFrames; frame++)
+    recording.addState(makeState(10, frame % 3, frame));
+  checkFrames(recording, numFrames);
+
+  // A state that does not match the layout is rejected
+  recording.addState(Eigen::VectorXs::Zero(12));
+  EXPECT_EQ(numFrames, recording.getNumFrames());
+
+  recording.clear();
+  EXPECT_EQ(0, recording.getNumFrames());
+}
+
+//==============================================================================
+TEST(Recording, MemoryMappedFile)
+{
+  if (!simulation::detail::RecordingBuffer::supportsMemoryMapping())
+    return;
+
+  const std::string path = "testRecording";
+  Recording recording(std::vector<int>{6, 4});
+
+  // Frames recorded before mapping are carried over to the file
+  const int numFrames = 2000;
+  for (int frame = 0; frame < numFrames / 2; frame++)
+    recording.addState(makeState(10, frame % 3, frame));
+
+  // Use a tiny budget so that pages are evicted over and over
+  ASSERT_TRUE(recording.setMemoryMappedFile(path, 4096));
+  for (int frame = numFrames / 2; frame < numFrames; frame++)
+    recording.addState(makeState(10, frame % 3, frame));
+  checkFrames(recording, numFrames);
+
+  recording.flush();
+  std::ifstream configs(path + ".configs", std::ios::binary);
+  ASSERT_TRUE(configs.good());
+  std::vector<s_t> firstFrame(10);
+  configs.read(
+      reinterpret_cast<char*>(firstFrame.data()), 10 * sizeof(s_t));
+  for (int i = 0; i < 10; i++)
+    EXPECT_EQ(i, firstFrame[i]);
+  configs.close();
+
+  std::remove((path + ".configs").c_str());
+  std::remove((path + ".contacts").c_str());
+}
+
+#ifdef __linux__
+//==============================================================================
+TEST(Recording, MemoryMappedFileFailures)
+{
+  if (!simulation::detail::RecordingBuffer::supportsMemoryMapping())
+    return;
+
+  const std::string path = "testRecordingFailures";
+  Recording recording(std::vector<int>{1});
+  const int numFrames = 30;
+  for (int frame = 0; frame < numFrames; frame++)
+    recording.addState(makeState(1, frame % 3, frame));
+
+  // A directory where the contacts file should go makes only the second
+  // mapping fail. Neither buffer should end up mapped, and nothing is lost.
+  ASSERT_EQ(0, mkdir((path + ".contacts").c_str(), 0755));
+  EXPECT_FALSE(recording.setMemoryMappedFile(path));
+  rmdir((path + ".contacts").c_str());
+  checkFrames(recording, numFrames);
+  recording.addState(makeState(1, numFrames % 3, numFrames));
+  checkFrames(recording, numFrames + 1);
+
+  // Cap the file size at a single page, so the mapped buffers can't grow past
+  // their first page. Frames that don't fit are dropped whole.
+  recording.clear();
+  ASSERT_TRUE(recording.setMemoryMappedFile(path));
+  struct rlimit oldLimit;
+  ASSERT_EQ(0, getrlimit(RLIMIT_FSIZE, &oldLimit));
+  struct rlimit limit = oldLimit;
+  limit.rlim_cur = 4096;
+  void (*oldHandler)(int) = std::signal(SIGXFSZ, SIG_IGN);
+  ASSERT_EQ(0, setrlimit(RLIMIT_FSIZE, &limit));
+  const int numAttempted = 1000;
+  for (int frame = 0; frame < numAttempted; frame++)
+    recording.addState(makeState(1, frame % 3, frame));
+  setrlimit(RLIMIT_FSIZE, &oldLimit);
+  std::signal(SIGXFSZ, oldHandler);
+
+  // Once the contacts are full, only frames without contacts still fit, so
+  // the frames that were kept are not consecutive. Every kept frame must
+  // still line up with its own contacts.
+  const int numKept = recording.getNumFrames();
+  EXPECT_GT(numKept, 0);
+  EXPECT_LT(numKept, numAttempted);
+  for (int i = 0; i < numKept; i++)
+  {
+    const int frame = static_cast<int>(recording.getGenCoord(i, 0, 0)) / 1000;
+    const Eigen::VectorXs state = makeState(1, frame % 3, frame);
+    ASSERT_EQ(frame % 3, recording.getNumContacts(i));
+    EXPECT_EQ(state(0), recording.getGenCoord(i, 0, 0));
+    for (int contact = 0; contact < frame % 3; contact++)
+    {
+      EXPECT_TRUE(equals(
+          Eigen::Vector3s(state.segment<3>(1 + 6 * contact)),
+          Eigen::Vector3s(recording.getContactPoint(i, contact))));
+      EXPECT_TRUE(equals(
+          Eigen::Vector3s(state.segment<3>(1 + 6 * contact + 3)),
+          Eigen::Vector3s(recording.getContactForce(i, contact))));
+    }
+  }
+
+  recording.clear();
+  std::remove((path + ".configs").c_str());
+  std::remove((path + ".contacts").c_str());
+}
+#endif
@@ -544,6 +544,9 @@ TEST(SkeletonConverter, SCALE_EQUALITY_CONSTRAINTS)
   Eigen::MatrixXs scaleJac
       = osim->getJointWorldPositionsJacobianWrtGroupScales(joints);
   EXPECT_EQ(scaleJac.cols(), osim->getGroupScaleDim());
+  Eigen::MatrixXs sparseScaleJac = Eigen::MatrixXs(
+      osim->getJointWorldPositionsSparseJacobianWrtGroupScales(joints));
+  EXPECT_TRUE(equals(sparseScaleJac, scaleJac, 1e-12));
   Eigen::MatrixXs scaleJac_fd
       = osim->finiteDifferenceJointWorldPositionsJacobianWrtGroupScales(joints);
   if (!equals(scaleJac, scaleJac_fd, THRESHOLD))
@@ -627,6 +630,10 @@ TEST(SkeletonConverter, IK_JACOBIANS)
   Eigen::MatrixXs posJac
       = osim->getJointWorldPositionsJacobianWrtJointPositions(
           converter.getSourceJoints());
+  Eigen::MatrixXs sparsePosJac = Eigen::MatrixXs(
+      osim->getJointWorldPositionsSparseJacobianWrtJointPositions(
+          converter.getSourceJoints()));
+  EXPECT_TRUE(equals(sparsePosJac, posJac, 1e-12));
   Eigen::MatrixXs posJac_fd
       = osim->finiteDifferenceJointWorldPositionsJacobianWrtJointPositions(
           converter.getSourceJoints());
@@ -658,6 +665,10 @@ TEST(SkeletonConverter, IK_JACOBIANS)
   // Check the body scale Jacobian is accurate
   Eigen::MatrixXs scaleJac = osim->getJointWorldPositionsJacobianWrtBodyScales(
       converter.getSourceJoints());
+  Eigen::MatrixXs sparseScaleJac = Eigen::MatrixXs(
+      osim->getJointWorldPositionsSparseJacobianWrtBodyScales(
+          converter.getSourceJoints()));
+  EXPECT_TRUE(equals(sparseScaleJac, scaleJac, 1e-12));
   Eigen::MatrixXs scaleJac_fd
       = osim->finiteDifferenceJointWorldPositionsJacobianWrtBodyScales(
           converter.getSourceJoints());
@@ -135,4 +135,48 @@ TEST(MARKER_TRACES_BASICS, MAKING_MIXED_FEATURES)
   // std::endl; std::cout << "Trace IDs: " << std::endl << traceIDs <<
   // std::endl;
 }
-#endif
\ No newline at end of file
+#endif
+#ifdef ALL_TESTS
+TEST(MARKER_TRACES_BASICS, BATCHED_CLASSIFIER)
+{
+  int numClasses = 5;
+  int maxPoints = 8;
+  StreamingMarkerTraces markerTraces(numClasses, 20);
+
+  int numCalls = 0;
+  Eigen::VectorXi lastNumPoints;
+  markerTraces.setBatchedTraceClassifier(
+      [&](const Eigen::MatrixXs& features, const Eigen::VectorXi& numPoints) {
+        numCalls++;
+        lastNumPoints = numPoints;
+        Eigen::MatrixXs logits
+            = Eigen::MatrixXs::Zero(numClasses, features.cols());
+        logits.row(2).setOnes();
+        return logits;
+      },
+      2,
+      maxPoints,
+      1000);
+
+  for (int i = 0; i <= 10; i++)
+  {
+    std::vector<Eigen::Vector3s> markers;
+    markers.push_back(Eigen::Vector3s::Ones() * 0.01 * i);
+    markerTraces.observeMarkers(markers, i);
+  }
+
+  EXPECT_FALSE(markerTraces.queueTraceFeatures(5, 2, 10, true));
+  EXPECT_EQ(numCalls, 0);
+  EXPECT_TRUE(markerTraces.queueTraceFeatures(5, 2, 10, true));
+  EXPECT_EQ(numCalls, 1);
+  EXPECT_EQ(lastNumPoints.size(), 2);
+  EXPECT_EQ(lastNumPoints(0), 5);
+  EXPECT_EQ(lastNumPoints(1), 5);
+
+  std::vector<Eigen::Vector3s> markers;
+  markers.push_back(Eigen::Vector3s::Ones() * 0.11);
+  std::vector<int> classes = markerTraces.observeMarkers(markers, 11).first;
+  EXPECT_EQ(classes.size(), 1);
+  EXPECT_EQ(classes[0], 2);
+}
+#endif
@@ -1,4 +1,6 @@
 #include <cstdlib>
+#include <fstream>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <vector>
@@ -1125,6 +1127,110 @@ TEST(SubjectOnDisk, MINIMAL_WRITE_READ)
 }
 #endif
 
+#ifdef ALL_TESTS
+TEST(SubjectOnDisk, SHARD_PACK_READ_UNPACK)
+{
+  srand(42);
+
+  // Write a couple of small subjects with different trial lengths
+  std::vector<std::string> paths;
+  for (int subject = 0; subject < 2; subject++)
+  {
+    std::string path = "./testShardSubject" + std::to_string(subject) + ".b3d";
+    std::shared_ptr<SubjectOnDiskHeader> header
+        = std::make_shared<SubjectOnDiskHeader>();
+    header->setAgeYears(30 + subject);
+    for (int trial = 0; trial < 2; trial++)
+    {
+      auto trialData = header->addTrial();
+      std::vector<std::map<std::string, Eigen::Vector3s>> markerTrial;
+      for (int t = 0; t < 3 + subject + trial; t++)
+      {
+        std::map<std::string, Eigen::Vector3s> markers;
+        markers["marker_0"] = Eigen::Vector3s::Random();
+        markerTrial.push_back(markers);
+      }
+      trialData->setMarkerObservations(markerTrial);
+    }
+    SubjectOnDisk::writeB3D(path, header);
+    paths.push_back(path);
+  }
+
+  // Pack them, and check the index matches the originals
+  std::string shardPath = "./testShard.b3ds";
+  ASSERT_TRUE(SubjectOnDiskShard::packB3Ds(paths, shardPath));
+  SubjectOnDiskShard shard(shardPath);
+  ASSERT_EQ(shard.getNumSubjects(), 2);
+  for (int subject = 0; subject < 2; subject++)
+  {
+    SubjectOnDisk original(paths[subject]);
+    std::shared_ptr<SubjectOnDisk> packed = shard.getSubject(subject);
+    ASSERT_TRUE(packed != nullptr);
+    EXPECT_EQ(
+        shard.getSubjectName(subject),
+        "testShardSubject" + std::to_string(subject) + ".b3d");
+    EXPECT_EQ(packed->getAgeYears(), original.getAgeYears());
+    ASSERT_EQ(shard.getSubjectNumTrials(subject), original.getNumTrials());
+    for (int trial = 0; trial < original.getNumTrials(); trial++)
+    {
+      int length = original.getTrialLength(trial);
+      EXPECT_EQ(shard.getSubjectTrialLength(subject, trial), length);
+      EXPECT_EQ(packed->getTrialLength(trial), length);
+
+      // Frames read out of the shard should match the original file
+      auto originalFrames = original.readFrames(trial, 0, length);
+      auto packedFrames = packed->readFrames(trial, 0, length);
+      ASSERT_EQ(packedFrames.size(), originalFrames.size());
+      for (int t = 0; t < originalFrames.size(); t++)
+      {
+        ASSERT_EQ(
+            packedFrames[t]->markerObservations.size(),
+            originalFrames[t]->markerObservations.size());
+        for (int m = 0; m < originalFrames[t]->markerObservations.size(); m++)
+        {
+          Eigen::Vector3s a = packedFrames[t]->markerObservations[m].second;
+          Eigen::Vector3s b = originalFrames[t]->markerObservations[m].second;
+          EXPECT_TRUE(equals(a, b, 0));
+        }
+      }
+    }
+  }
+
+  // Unpacking should give back byte-identical files. The unpacked files keep
+  // their original names, so we read the originals into memory first.
+  std::vector<std::string> originalBytes;
+  for (int subject = 0; subject < 2; subject++)
+  {
+    std::ifstream in(paths[subject], std::ios::binary);
+    originalBytes.emplace_back(
+        (std::istreambuf_iterator<char>(in)),
+        std::istreambuf_iterator<char>());
+    EXPECT_GT(originalBytes.back().size(), 0);
+  }
+  std::vector<std::string> unpacked
+      = SubjectOnDiskShard::unpackB3Ds(shardPath, ".");
+  ASSERT_EQ(unpacked.size(), 2);
+  for (int subject = 0; subject < 2; subject++)
+  {
+    std::ifstream in(unpacked[subject], std::ios::binary);
+    std::string unpackedBytes(
+        (std::istreambuf_iterator<char>(in)),
+        std::istreambuf_iterator<char>());
+    EXPECT_EQ(unpackedBytes, originalBytes[subject]);
+  }
+
+  // Bad inputs should fail without touching the shard we already wrote: two
+  // B3Ds with the same file name would overwrite each other when unpacked,
+  // and a missing B3D would leave the index pointing past the end of the file
+  EXPECT_FALSE(
+      SubjectOnDiskShard::packB3Ds({paths[0], paths[0]}, shardPath));
+  EXPECT_FALSE(SubjectOnDiskShard::packB3Ds(
+      {paths[0], "./testShardSubjectMissing.b3d"}, shardPath));
+  SubjectOnDiskShard stillThere(shardPath);
+  EXPECT_EQ(stillThere.getNumSubjects(), 2);
+}
+#endif
+
 double computeMean(const std::vector<double>& values)
 {
   double sum = 0.0;
@@ -1255,6 +1361,61 @@ TEST(SubjectOnDisk, READ_RUNNING_TRIAL)
 }
 #endif
 
+#ifdef ALL_TESTS
+TEST(SubjectOnDisk, PARALLEL_COMPUTE_VALUES_MATCHES_SERIAL)
+{
+  auto newRetriever = std::make_shared<utils::CompositeResourceRetriever>();
+  newRetriever->addSchemaRetriever(
+      "dart", utils::DartResourceRetriever::create());
+  std::string path
+      = newRetriever->getFilePath("dart://sample/b3d/subject10.b3d");
+  SubjectOnDisk read_back(path);
+  read_back.loadAllFrames();
+
+  std::shared_ptr<dynamics::Skeleton> skel = read_back.readSkel(0);
+  std::vector<std::string> footBodies = read_back.getGroundForceBodies();
+  std::vector<ForcePlate> forcePlates = read_back.readForcePlates(0);
+  s_t timestep = read_back.getTrialTimestep(0);
+  Eigen::MatrixXs poses
+      = read_back.getHeaderProto()->getTrials()[0]->getPasses()[0]->getPoses();
+
+  SubjectOnDiskTrialPass serial;
+  serial.computeValuesFromForcePlates(
+      skel, timestep, poses, footBodies, forcePlates);
+  SubjectOnDiskTrialPass parallel;
+  parallel.computeValuesFromForcePlates(
+      skel,
+      timestep,
+      poses,
+      footBodies,
+      forcePlates,
+      5,
+      1,
+      Eigen::MatrixXs::Zero(0, 0),
+      Eigen::MatrixXs::Zero(0, 0),
+      3.0,
+      4);
+
+  // The frames are independent, so the results must match bit-for-bit
+  EXPECT_TRUE(serial.getVels() == parallel.getVels());
+  EXPECT_TRUE(serial.getAccs() == parallel.getAccs());
+  EXPECT_TRUE(serial.getTaus() == parallel.getTaus());
+  EXPECT_TRUE(serial.getComPoses() == parallel.getComPoses());
+  EXPECT_TRUE(
+      serial.getComAccsInRootFrame() == parallel.getComAccsInRootFrame());
+  EXPECT_TRUE(serial.getJointCentersInRootFrame()
+              == parallel.getJointCentersInRootFrame());
+  EXPECT_TRUE(serial.getResidualWrenchInRootFrame()
+              == parallel.getResidualWrenchInRootFrame());
+  EXPECT_TRUE(serial.getGroundBodyCopTorqueForceInRootFrame()
+              == parallel.getGroundBodyCopTorqueForceInRootFrame());
+  EXPECT_TRUE(serial.getRootEulerHistoryInRootFrame()
+              == parallel.getRootEulerHistoryInRootFrame());
+  EXPECT_TRUE(serial.getLinearResidual() == parallel.getLinearResidual());
+  EXPECT_TRUE(serial.getAngularResidual() == parallel.getAngularResidual());
+}
+#endif
+
 /*
 #ifdef ALL_TESTS
 TEST(SubjectOnDisk, READ_LOCAL_TRIAL)
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "dart/dynamics/BodyNode.hpp"
+#include "dart/dynamics/BoxShape.hpp"
+#include "dart/dynamics/FreeJoint.hpp"
+#include "dart/dynamics/Skeleton.hpp"
+#include "dart/simulation/World.hpp"
+#include "dart/simulation/WorldJsonExporter.hpp"
+
+using namespace dart;
+using namespace dynamics;
+using namespace simulation;
+
+namespace {
+
+//==============================================================================
+BodyNode* addBox(const SkeletonPtr& skel, BodyNode* parent)
+{
+  auto pair = skel->createJointAndBodyNodePair<FreeJoint>(parent);
+  pair.second->createShapeNodeWith<VisualAspect>(
+      std::make_shared<BoxShape>(Eigen::Vector3s::Ones()));
+  return pair.second;
+}
+
+} // namespace
+
+//==============================================================================
+TEST(WorldJsonExporter, OnlyExportsChangedBodies)
+{
+  WorldPtr world = World::create();
+  SkeletonPtr skel = Skeleton::create("skel");
+  BodyNode* root = addBox(skel, nullptr);
+  BodyNode* child = addBox(skel, root);
+  world->addSkeleton(skel);
+
+  WorldJsonExporter exporter(world);
+
+  // The first export has everything, and matches the full export
+  EXPECT_EQ(world->positionsToJson(), exporter.positionsToJson());
+  EXPECT_EQ(2u, exporter.getNumExportedBodies());
+  EXPECT_EQ(world->colorsToJson(), exporter.colorsToJson());
+  EXPECT_EQ(2u, exporter.getNumExportedBodies());
+
+  // Nothing changed
+  EXPECT_EQ("{}", exporter.positionsToJson());
+  EXPECT_EQ("{}", exporter.colorsToJson());
+
+  // Moving the child only moves the child
+  Eigen::VectorXs positions = skel->getPositions();
+  positions(8) = 0.5;
+  skel->setPositions(positions);
+  const std::string childPositions = exporter.positionsToJson();
+  EXPECT_EQ(1u, exporter.getNumExportedBodies());
+  EXPECT_NE(std::string::npos, childPositions.find(child->getName()));
+  EXPECT_EQ(std::string::npos, childPositions.find(root->getName() + "\""));
+
+  // Recoloring the root only reports the root
+  root->getShapeNode(0)->getVisualAspect()->setColor(
+      Eigen::Vector3s(1.0, 0.0, 0.0));
+  const std::string rootColors = exporter.colorsToJson();
+  EXPECT_EQ(1u, exporter.getNumExportedBodies());
+  EXPECT_NE(std::string::npos, rootColors.find(root->getName() + "\""));
+
+  // New skeletons get picked up, and a full export marks everything clean
+  SkeletonPtr other = Skeleton::create("other");
+  addBox(other, nullptr);
+  world->addSkeleton(other);
+  exporter.positionsToJson();
+  EXPECT_EQ(1u, exporter.getNumExportedBodies());
+  EXPECT_EQ(world->toJson(), exporter.toJson());
+  EXPECT_EQ("{}", exporter.positionsToJson());
+  EXPECT_EQ("{}", exporter.colorsToJson());
+}
+
+//==============================================================================
+TEST(WorldJsonExporter, EscapesBodyNames)
+{
+  WorldPtr world = World::create();
+  SkeletonPtr skel = Skeleton::create("skel");
+  BodyNode* body = addBox(skel, nullptr);
+  body->setName("say \"hi\"\\");
+  world->addSkeleton(skel);
+
+  WorldJsonExporter exporter(world);
+  const std::string positions = exporter.positionsToJson();
+  EXPECT_NE(
+      std::string::npos, positions.find("\"skel.say \\\"hi\\\"\\\\\": {"));
+  EXPECT_EQ(world->positionsToJson(), positions);
+}